@@ -0,0 +1,104 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "Benchmark.h"
+#include "BenchHelpers.h"
+
+#include <opendnp3/ResponseLoader.h>
+#include <opendnp3/VtoReader.h>
+
+using namespace opendnp3;
+
+namespace
+{
+
+const size_t NUM_POINTS = 100;
+
+/// Captures the outstation's response to a class read so the master side can parse it
+std::vector<uint8_t> ClassResponse(int aClassVar)
+{
+	OutstationFixture os(NUM_POINTS, NUM_POINTS);
+	if(aClassVar == CLASS_1_READ) os.ChangeAnalogs(1.0);
+	os.SetReadRequest(aClassVar);
+	os.Respond();
+	return std::vector<uint8_t>(os.mResponse.GetBuffer(), os.mResponse.GetBuffer() + os.mResponse.Size());
+}
+
+void Interpret(const std::vector<uint8_t>& arFragment, BenchmarkState& arState)
+{
+	arState.mBytesPerOp = arFragment.size();
+	APDU apdu;
+	size_t headers = 0;
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		apdu.Write(&arFragment[0], arFragment.size());
+		apdu.Interpret();
+		headers += apdu.BeginRead().Count();
+	}
+	KeepAlive(headers);
+}
+
+void Load(const std::vector<uint8_t>& arFragment, BenchmarkState& arState)
+{
+	arState.mBytesPerOp = arFragment.size();
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "bench");
+	NullDataObserver observer;
+	VtoReader vto(pLogger);
+	APDU apdu;
+
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		apdu.Write(&arFragment[0], arFragment.size());
+		apdu.Interpret();
+		ResponseLoader loader(pLogger, &observer, &vto);
+		for(HeaderReadIterator hdr = apdu.BeginRead(); !hdr.IsEnd(); ++hdr) {
+			loader.Process(hdr);
+		}
+	}
+	KeepAlive(observer.mNumUpdates);
+}
+
+}
+
+BENCHMARK_CASE(InterpretClass0, "APDU/InterpretClass0")
+{
+	static const std::vector<uint8_t> fragment = ClassResponse(CLASS_0_READ);
+	Interpret(fragment, arState);
+}
+
+BENCHMARK_CASE(InterpretClass1, "APDU/InterpretClass1Events")
+{
+	static const std::vector<uint8_t> fragment = ClassResponse(CLASS_1_READ);
+	Interpret(fragment, arState);
+}
+
+BENCHMARK_CASE(LoadClass0, "ResponseLoader/Class0")
+{
+	static const std::vector<uint8_t> fragment = ClassResponse(CLASS_0_READ);
+	Load(fragment, arState);
+}
+
+BENCHMARK_CASE(LoadClass1, "ResponseLoader/Class1Events")
+{
+	static const std::vector<uint8_t> fragment = ClassResponse(CLASS_1_READ);
+	Load(fragment, arState);
+}
+
+/* vim: set ts=4 sw=4: */
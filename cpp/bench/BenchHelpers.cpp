@@ -0,0 +1,114 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "BenchHelpers.h"
+
+#include <opendnp3/ITransactable.h>
+
+namespace opendnp3
+{
+
+NullUpperLayer::NullUpperLayer(Logger* apLogger) :
+	Loggable(apLogger),
+	IUpperLayer(apLogger),
+	mNumReceived(0),
+	mNumBytes(0),
+	mNumSuccess(0)
+{}
+
+void NullUpperLayer::_OnReceive(const uint8_t*, size_t aNumBytes)
+{
+	++mNumReceived;
+	mNumBytes += aNumBytes;
+}
+
+void NullUpperLayer::_OnSendSuccess()
+{
+	++mNumSuccess;
+}
+
+CompletingLowerLayer::CompletingLowerLayer(Logger* apLogger) :
+	Loggable(apLogger),
+	ILowerLayer(apLogger),
+	mCapture(false),
+	mNumSent(0)
+{}
+
+void CompletingLowerLayer::ThisLayerUp()
+{
+	if(mpUpperLayer != NULL) mpUpperLayer->OnLowerLayerUp();
+}
+
+void CompletingLowerLayer::_Send(const uint8_t* apData, size_t aNumBytes)
+{
+	++mNumSent;
+	if(mCapture) mSent.push_back(std::vector<uint8_t>(apData, apData + aNumBytes));
+	if(mpUpperLayer != NULL) mpUpperLayer->OnSendSuccess();
+}
+
+OutstationFixture::OutstationFixture(size_t aNumPoints, size_t aMaxEvents) :
+	mLog(),
+	mpLogger(mLog.GetLogger(LEV_WARNING, "bench")),
+	mConfig(),
+	mDatabase(mpLogger),
+	mRspTypes(mConfig),
+	mContext(mpLogger, &mDatabase, &mRspTypes, EventMaxConfig(aMaxEvents, aMaxEvents, aMaxEvents, 0)),
+	mNumPoints(aNumPoints)
+{
+	mDatabase.Configure(DT_BINARY, aNumPoints, true);
+	mDatabase.Configure(DT_ANALOG, aNumPoints, true);
+	mDatabase.Configure(DT_COUNTER, aNumPoints, true);
+	mDatabase.SetClass(DT_BINARY, PC_CLASS_0);
+	mDatabase.SetClass(DT_ANALOG, PC_CLASS_1);
+	mDatabase.SetClass(DT_COUNTER, PC_CLASS_0);
+	mDatabase.SetEventBuffer(mContext.GetBuffer());
+	this->SetReadRequest(CLASS_0_READ);
+}
+
+void OutstationFixture::SetReadRequest(int aClassVar)
+{
+	const uint8_t request[] = { 0xC0, 0x01, 0x3C, static_cast<uint8_t>(aClassVar), 0x06 };
+	mRequest.Write(request, sizeof(request));
+	mRequest.Interpret();
+}
+
+void OutstationFixture::Respond()
+{
+	mContext.Reset();
+	mContext.Configure(mRequest);
+	mContext.LoadResponse(mResponse);
+
+	// the same sequence the slave follows as each fragment is confirmed
+	for(mContext.ClearWritten(); !mContext.IsComplete(); mContext.ClearWritten()) {
+		mContext.LoadResponse(mResponse);
+	}
+	mContext.Reset();
+}
+
+void OutstationFixture::ChangeAnalogs(double aValue)
+{
+	Transaction t(&mDatabase);
+	for(size_t i = 0; i < mNumPoints; ++i) mDatabase.Update(Analog(aValue, AQ_ONLINE), i);
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,204 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __BENCH_HELPERS_H_
+#define __BENCH_HELPERS_H_
+
+#include <opendnp3/APDU.h>
+#include <opendnp3/AsyncLayerInterfaces.h>
+#include <opendnp3/Database.h>
+#include <opendnp3/IDataObserver.h>
+#include <opendnp3/IFrameSink.h>
+#include <opendnp3/Log.h>
+#include <opendnp3/ResponseContext.h>
+#include <opendnp3/SlaveConfig.h>
+#include <opendnp3/SlaveResponseTypes.h>
+
+#include <vector>
+
+namespace opendnp3
+{
+
+/**
+	The stubs below do the minimum needed to keep a layer running and count
+	what they see, so the numbers belong to the code under test rather than
+	to a mock that copies and records everything.
+*/
+
+class NullFrameSink : public IFrameSink
+{
+public:
+	NullFrameSink() : mNumFrames(0), mNumBytes(0) {}
+
+	void Ack(bool, bool, uint16_t, uint16_t) {
+		++mNumFrames;
+	}
+	void Nack(bool, bool, uint16_t, uint16_t) {
+		++mNumFrames;
+	}
+	void LinkStatus(bool, bool, uint16_t, uint16_t) {
+		++mNumFrames;
+	}
+	void NotSupported(bool, bool, uint16_t, uint16_t) {
+		++mNumFrames;
+	}
+	void TestLinkStatus(bool, bool, uint16_t, uint16_t) {
+		++mNumFrames;
+	}
+	void ResetLinkStates(bool, uint16_t, uint16_t) {
+		++mNumFrames;
+	}
+	void RequestLinkStatus(bool, uint16_t, uint16_t) {
+		++mNumFrames;
+	}
+	void ConfirmedUserData(bool, bool, uint16_t, uint16_t, const uint8_t*, size_t aDataLength) {
+		++mNumFrames;
+		mNumBytes += aDataLength;
+	}
+	void UnconfirmedUserData(bool, uint16_t, uint16_t, const uint8_t*, size_t aDataLength) {
+		++mNumFrames;
+		mNumBytes += aDataLength;
+	}
+
+	size_t mNumFrames;
+	size_t mNumBytes;
+};
+
+class NullUpperLayer : public IUpperLayer
+{
+public:
+	NullUpperLayer(Logger* apLogger);
+
+	size_t mNumReceived;
+	size_t mNumBytes;
+	size_t mNumSuccess;
+
+private:
+	void _OnReceive(const uint8_t*, size_t aNumBytes);
+	void _OnSendSuccess();
+	void _OnSendFailure() {}
+	void _OnLowerLayerUp() {}
+	void _OnLowerLayerDown() {}
+};
+
+/// Completes every send immediately, optionally keeping a copy of what was sent
+class CompletingLowerLayer : public ILowerLayer
+{
+public:
+	CompletingLowerLayer(Logger* apLogger);
+
+	void ThisLayerUp();
+
+	bool mCapture;
+	size_t mNumSent;
+	std::vector< std::vector<uint8_t> > mSent;
+
+private:
+	void _Send(const uint8_t* apData, size_t aNumBytes);
+};
+
+class NullDataObserver : public IDataObserver
+{
+public:
+	NullDataObserver() : mNumUpdates(0) {}
+
+	size_t mNumUpdates;
+
+private:
+	void _Start() {}
+	void _End() {}
+	void _Update(const Binary&, size_t) {
+		++mNumUpdates;
+	}
+	void _Update(const Analog&, size_t) {
+		++mNumUpdates;
+	}
+	void _Update(const Counter&, size_t) {
+		++mNumUpdates;
+	}
+	void _Update(const ControlStatus&, size_t) {
+		++mNumUpdates;
+	}
+	void _Update(const SetpointStatus&, size_t) {
+		++mNumUpdates;
+	}
+};
+
+class NullEventBuffer : public IEventBuffer
+{
+public:
+	NullEventBuffer() : mNumEvents(0) {}
+
+	void Update(const Binary&, PointClass, size_t) {
+		++mNumEvents;
+	}
+	void Update(const Analog&, PointClass, size_t) {
+		++mNumEvents;
+	}
+	void Update(const Counter&, PointClass, size_t) {
+		++mNumEvents;
+	}
+	void Update(const VtoData&, PointClass, size_t) {
+		++mNumEvents;
+	}
+	size_t NumVtoEventsAvailable() {
+		return 0;
+	}
+
+	size_t mNumEvents;
+};
+
+// group 60 variations that read class 0 and class 1 data
+const int CLASS_0_READ = 1;
+const int CLASS_1_READ = 2;
+
+/**
+	An outstation database and response context wired up the way the Slave does it,
+	with every point online and the analogs assigned to class 1.
+*/
+class OutstationFixture
+{
+public:
+	OutstationFixture(size_t aNumPoints, size_t aMaxEvents);
+
+	/// Writes a read request for one of the class variations above
+	void SetReadRequest(int aClassVar);
+
+	/// Runs one read through the response context and leaves the final fragment in mResponse
+	void Respond();
+
+	/// Pushes one analog event per point through the database
+	void ChangeAnalogs(double aValue);
+
+	EventLog mLog;
+	Logger* mpLogger;
+	SlaveConfig mConfig;
+	Database mDatabase;
+	SlaveResponseTypes mRspTypes;
+	ResponseContext mContext;
+	APDU mRequest;
+	APDU mResponse;
+	size_t mNumPoints;
+};
+
+}
+
+#endif
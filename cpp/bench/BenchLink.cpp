@@ -0,0 +1,136 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "Benchmark.h"
+#include "BenchHelpers.h"
+
+#include <opendnp3/DNPCrc.h>
+#include <opendnp3/LinkFrame.h>
+#include <opendnp3/LinkLayerReceiver.h>
+#include <opendnp3/TransportConstants.h>
+
+#include <memory.h>
+
+using namespace opendnp3;
+
+namespace
+{
+
+// a full link frame carries one maximum sized transport segment
+const size_t USER_DATA_SIZE = TL_MAX_TPDU_LENGTH;
+
+std::vector<uint8_t> Payload(size_t aSize)
+{
+	std::vector<uint8_t> data(aSize);
+	for(size_t i = 0; i < aSize; ++i) data[i] = static_cast<uint8_t>(i);
+	return data;
+}
+
+void ParseFrames(const LinkFrame& arFrame, BenchmarkState& arState)
+{
+	EventLog log;
+	NullFrameSink sink;
+	LinkLayerReceiver rx(log.GetLogger(LEV_WARNING, "bench"), &sink);
+
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		memcpy(rx.WriteBuff(), arFrame.GetBuffer(), arFrame.GetSize());
+		rx.OnRead(arFrame.GetSize());
+	}
+
+	KeepAlive(sink.mNumFrames);
+}
+
+}
+
+BENCHMARK_CASE(CrcBlock, "Crc/Block16")
+{
+	arState.mBytesPerOp = 16;
+	std::vector<uint8_t> data = Payload(16);
+	unsigned int crc = 0;
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		data[0] = static_cast<uint8_t>(i);
+		crc += DNPCrc::CalcCrc(&data[0], data.size());
+	}
+	KeepAlive(crc);
+}
+
+BENCHMARK_CASE(CrcBody, "Crc/ValidateBody250")
+{
+	arState.mBytesPerOp = USER_DATA_SIZE;
+	LinkFrame frame;
+	std::vector<uint8_t> data = Payload(USER_DATA_SIZE);
+	frame.FormatUnconfirmedUserData(true, 1, 1024, &data[0], data.size());
+
+	size_t valid = 0;
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		if(frame.ValidateBodyCRC()) ++valid;
+	}
+	KeepAlive(valid);
+}
+
+BENCHMARK_CASE(FormatAck, "LinkFrame/FormatAck")
+{
+	LinkFrame frame;
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		frame.FormatAck(false, false, 1024, static_cast<uint16_t>(i));
+	}
+	KeepAlive(frame.GetSize());
+}
+
+BENCHMARK_CASE(FormatConfirmed, "LinkFrame/FormatConfirmedUserData250")
+{
+	arState.mBytesPerOp = USER_DATA_SIZE;
+	LinkFrame frame;
+	std::vector<uint8_t> data = Payload(USER_DATA_SIZE);
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		frame.FormatConfirmedUserData(true, (i % 2) == 0, 1, 1024, &data[0], data.size());
+	}
+	KeepAlive(frame.GetSize());
+}
+
+BENCHMARK_CASE(FormatUnconfirmed, "LinkFrame/FormatUnconfirmedUserData250")
+{
+	arState.mBytesPerOp = USER_DATA_SIZE;
+	LinkFrame frame;
+	std::vector<uint8_t> data = Payload(USER_DATA_SIZE);
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		frame.FormatUnconfirmedUserData(true, 1, 1024, &data[0], data.size());
+	}
+	KeepAlive(frame.GetSize());
+}
+
+BENCHMARK_CASE(ParseAck, "LinkLayerReceiver/ParseAck")
+{
+	LinkFrame frame;
+	frame.FormatAck(false, false, 1024, 1);
+	ParseFrames(frame, arState);
+}
+
+BENCHMARK_CASE(ParseUserData, "LinkLayerReceiver/ParseUserData250")
+{
+	arState.mBytesPerOp = USER_DATA_SIZE;
+	LinkFrame frame;
+	std::vector<uint8_t> data = Payload(USER_DATA_SIZE);
+	frame.FormatUnconfirmedUserData(true, 1, 1024, &data[0], data.size());
+	ParseFrames(frame, arState);
+}
+
+/* vim: set ts=4 sw=4: */
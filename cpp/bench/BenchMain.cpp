@@ -0,0 +1,90 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "Benchmark.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string.h>
+
+using namespace std;
+using namespace opendnp3;
+
+void PrintUsage(const char* apName)
+{
+	cout << "usage: " << apName << " [options]" << endl;
+	cout << "  --filter=<text>        only run benchmarks whose name contains <text>" << endl;
+	cout << "  --repetitions=<n>      timed runs per benchmark (default 5)" << endl;
+	cout << "  --min-time=<ms>        minimum duration of each timed run (default 100)" << endl;
+	cout << "  --output=<file>        write the JSON report to <file> instead of stdout" << endl;
+	cout << "  --list                 print the benchmark names and exit" << endl;
+}
+
+bool ReadOption(const char* apArg, const char* apName, string& arValue)
+{
+	size_t len = strlen(apName);
+	if(strncmp(apArg, apName, len) != 0 || apArg[len] != '=') return false;
+	arValue = apArg + len + 1;
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchmarkOptions options;
+	string output;
+
+	for(int i = 1; i < argc; ++i) {
+		string value;
+		if(ReadOption(argv[i], "--filter", value)) options.mFilter = value;
+		else if(ReadOption(argv[i], "--repetitions", value)) options.mRepetitions = strtoul(value.c_str(), NULL, 10);
+		else if(ReadOption(argv[i], "--min-time", value)) options.mMinTimeMs = strtoul(value.c_str(), NULL, 10);
+		else if(ReadOption(argv[i], "--output", value)) output = value;
+		else if(strcmp(argv[i], "--list") == 0) {
+			for(size_t j = 0; j < BenchmarkRegistry().size(); ++j) cout << BenchmarkRegistry()[j].mName << endl;
+			return 0;
+		}
+		else {
+			PrintUsage(argv[0]);
+			return (strcmp(argv[i], "--help") == 0) ? 0 : 1;
+		}
+	}
+
+	BenchmarkRunner runner(options);
+	if(runner.Run() == 0) {
+		cerr << "No benchmarks match filter: " << options.mFilter << endl;
+		return 1;
+	}
+
+	if(output.empty()) runner.WriteJson(cout);
+	else {
+		ofstream file(output.c_str());
+		if(!file) {
+			cerr << "Unable to open output file: " << output << endl;
+			return 1;
+		}
+		runner.WriteJson(file);
+	}
+
+	return 0;
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,180 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "Benchmark.h"
+
+#include <opendnp3/CurrentValueTable.h>
+#include <opendnp3/SimpleDataObserver.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace opendnp3;
+
+namespace
+{
+
+const size_t NUM_POINTS = 1000;
+const size_t POINTS_PER_TRANSACTION = 100;
+const size_t NUM_READERS = 4;
+
+/// The alternative to the seqlock, a table that readers and the writer share under a mutex
+class LockedTable : public IDataObserver
+{
+public:
+
+	void Read(CurrentValues& arValues) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		arValues = mValues;
+	}
+
+private:
+
+	void _Start() {
+		mMutex.lock();
+	}
+
+	void _End() {
+		++mValues.mVersion;
+		mMutex.unlock();
+	}
+
+	template <class T>
+	static void Set(std::vector<T>& arPoints, const T& arPoint, size_t aIndex) {
+		if(aIndex >= arPoints.size()) arPoints.resize(aIndex + 1);
+		arPoints[aIndex] = arPoint;
+	}
+
+	void _Update(const Binary& arPoint, size_t aIndex) {
+		Set(mValues.mBinary, arPoint, aIndex);
+	}
+	void _Update(const Analog& arPoint, size_t aIndex) {
+		Set(mValues.mAnalog, arPoint, aIndex);
+	}
+	void _Update(const Counter& arPoint, size_t aIndex) {
+		Set(mValues.mCounter, arPoint, aIndex);
+	}
+	void _Update(const ControlStatus& arPoint, size_t aIndex) {
+		Set(mValues.mControlStatus, arPoint, aIndex);
+	}
+	void _Update(const SetpointStatus& arPoint, size_t aIndex) {
+		Set(mValues.mSetpointStatus, arPoint, aIndex);
+	}
+
+	std::mutex mMutex;
+	CurrentValues mValues;
+};
+
+/// The updates a response loader makes for one response with a slice of the points
+void ApplyTransaction(IDataObserver* apObserver, size_t aCount)
+{
+	Transaction t(apObserver);
+	for(size_t i = 0; i < POINTS_PER_TRANSACTION; ++i) {
+		size_t index = (aCount * POINTS_PER_TRANSACTION + i) % NUM_POINTS;
+		apObserver->Update(Analog(static_cast<double>(aCount), AQ_ONLINE), index);
+		apObserver->Update(Binary(aCount % 2 == 0, BQ_ONLINE), index);
+	}
+}
+
+void Populate(IDataObserver* apObserver)
+{
+	for(size_t i = 0; i < NUM_POINTS / POINTS_PER_TRANSACTION; ++i) ApplyTransaction(apObserver, i);
+}
+
+/// Threads that take snapshots until they're stopped
+template <class Table>
+class Readers
+{
+public:
+
+	Readers(Table* apTable, size_t aNumReaders) : mStop(false) {
+		for(size_t i = 0; i < aNumReaders; ++i) {
+			mThreads.push_back(std::thread([this, apTable]() {
+				CurrentValues values;
+				while(!mStop.load()) apTable->Read(values);
+			}));
+		}
+	}
+
+	~Readers() {
+		mStop.store(true);
+for(auto& thread: mThreads) thread.join();
+	}
+
+private:
+
+	std::atomic<bool> mStop;
+	std::vector<std::thread> mThreads;
+};
+
+template <class Table>
+void WriteWithReaders(Table& arTable, BenchmarkState& arState)
+{
+	Populate(&arTable);
+	Readers<Table> readers(&arTable, NUM_READERS);
+	for(size_t i = 0; i < arState.mIterations; ++i) ApplyTransaction(&arTable, i);
+}
+
+}
+
+BENCHMARK_CASE(CurrentValuesSnapshot, "Master/CurrentValuesSnapshot1k")
+{
+	CurrentValueTable table(NullDataObserver::Inst());
+	Populate(&table);
+
+	CurrentValues values;
+	for(size_t i = 0; i < arState.mIterations; ++i) table.Read(values);
+	KeepAlive(values.mAnalog.size());
+}
+
+// the master thread keeps applying responses while the snapshot is taken
+BENCHMARK_CASE(CurrentValuesSnapshotWhileWriting, "Master/CurrentValuesSnapshot1kWhileWriting")
+{
+	CurrentValueTable table(NullDataObserver::Inst());
+	Populate(&table);
+
+	std::atomic<bool> stop(false);
+	std::thread writer([&]() {
+		for(size_t i = 0; !stop.load(); ++i) ApplyTransaction(&table, i);
+	});
+
+	CurrentValues values;
+	for(size_t i = 0; i < arState.mIterations; ++i) table.Read(values);
+	stop.store(true);
+	writer.join();
+	KeepAlive(values.mAnalog.size());
+}
+
+// what the master pays per response while other threads snapshot, compared to a mutex
+BENCHMARK_CASE(CurrentValuesWrite, "Master/CurrentValuesWriteWith4Readers")
+{
+	CurrentValueTable table(NullDataObserver::Inst());
+	WriteWithReaders(table, arState);
+}
+
+BENCHMARK_CASE(LockedTableWrite, "Master/LockedTableWriteWith4Readers")
+{
+	LockedTable table;
+	WriteWithReaders(table, arState);
+}
+
+/* vim: set ts=4 sw=4: */
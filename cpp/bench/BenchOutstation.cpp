@@ -0,0 +1,142 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "Benchmark.h"
+#include "BenchHelpers.h"
+
+#include <opendnp3/ITransactable.h>
+#include <opendnp3/SlaveEventBuffer.h>
+
+using namespace opendnp3;
+
+namespace
+{
+
+const size_t NUM_POINTS = 100;
+
+void MarkWritten(SlaveEventBuffer& arBuffer)
+{
+	AnalogEventIter itr;
+	arBuffer.Begin(itr);
+	for(size_t i = 0; i < arBuffer.NumSelected(BT_ANALOG); ++i, ++itr) itr->mWritten = true;
+}
+
+// A few class 1 events reported past a backlog of class 2 and 3 events that nobody is reading
+void SelectBehindBacklog(size_t aNumBacklog, BenchmarkState& arState)
+{
+	const size_t NUM_SELECTED = 10;
+	SlaveEventBuffer buffer(EventMaxConfig(0, aNumBacklog + NUM_SELECTED, 0, 0));
+	for(size_t i = 0; i < aNumBacklog; ++i) buffer.Update(Analog(static_cast<double>(i)), (i % 2) ? PC_CLASS_2 : PC_CLASS_3, i);
+
+	size_t selected = 0;
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		for(size_t j = 0; j < NUM_SELECTED; ++j) buffer.Update(Analog(static_cast<double>(i)), PC_CLASS_1, j);
+		selected += buffer.Select(PC_CLASS_1);
+		MarkWritten(buffer);
+		buffer.ClearWritten();
+		buffer.Deselect();
+	}
+	KeepAlive(selected);
+}
+
+}
+
+BENCHMARK_CASE(DatabaseUpdate, "Database/UpdateAnalogEvents100")
+{
+	EventLog log;
+	NullEventBuffer buffer;
+	Database db(log.GetLogger(LEV_WARNING, "bench"));
+	db.Configure(DT_ANALOG, NUM_POINTS, true);
+	db.SetClass(DT_ANALOG, PC_CLASS_1);
+	db.SetEventBuffer(&buffer);
+
+	// every update changes the value, so each one produces an event
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		Transaction t(&db);
+		for(size_t j = 0; j < NUM_POINTS; ++j) db.Update(Analog(static_cast<double>(i + j), AQ_ONLINE), j);
+	}
+	KeepAlive(buffer.mNumEvents);
+}
+
+BENCHMARK_CASE(DatabaseUpdateNoChange, "Database/UpdateAnalogNoChange100")
+{
+	EventLog log;
+	NullEventBuffer buffer;
+	Database db(log.GetLogger(LEV_WARNING, "bench"));
+	db.Configure(DT_ANALOG, NUM_POINTS, true);
+	db.SetClass(DT_ANALOG, PC_CLASS_1);
+	db.SetEventBuffer(&buffer);
+
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		Transaction t(&db);
+		for(size_t j = 0; j < NUM_POINTS; ++j) db.Update(Analog(1.0, AQ_ONLINE), j);
+	}
+	KeepAlive(buffer.mNumEvents);
+}
+
+BENCHMARK_CASE(EventInsertSelect, "SlaveEventBuffer/InsertSelectClear100")
+{
+	SlaveEventBuffer buffer(EventMaxConfig(0, NUM_POINTS, 0, 0));
+
+	size_t selected = 0;
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		for(size_t j = 0; j < NUM_POINTS; ++j) buffer.Update(Analog(static_cast<double>(i)), PC_CLASS_1, j);
+		selected += buffer.Select(PC_CLASS_1);
+		MarkWritten(buffer);
+		buffer.ClearWritten();
+		buffer.Deselect();
+	}
+	KeepAlive(selected);
+}
+
+BENCHMARK_CASE(EventSelectBehind1k, "SlaveEventBuffer/SelectClass1Behind1k")
+{
+	SelectBehindBacklog(1000, arState);
+}
+
+BENCHMARK_CASE(EventSelectBehind50k, "SlaveEventBuffer/SelectClass1Behind50k")
+{
+	SelectBehindBacklog(50000, arState);
+}
+
+BENCHMARK_CASE(ResponseClass0, "ResponseContext/Class0Static300")
+{
+	OutstationFixture os(NUM_POINTS, NUM_POINTS);
+	os.SetReadRequest(CLASS_0_READ);
+	for(size_t i = 0; i < arState.mIterations; ++i) os.Respond();
+	KeepAlive(os.mResponse.Size());
+}
+
+BENCHMARK_CASE(ResponseClass1, "ResponseContext/Class1Events100")
+{
+	OutstationFixture os(NUM_POINTS, NUM_POINTS);
+	os.SetReadRequest(CLASS_1_READ);
+	IEventBuffer* pBuffer = os.mContext.GetBuffer();
+
+	// the events are pushed straight into the buffer, the database cost is measured above
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		for(size_t j = 0; j < NUM_POINTS; ++j) pBuffer->Update(Analog(static_cast<double>(i), AQ_ONLINE), PC_CLASS_1, j);
+		os.Respond();
+	}
+	KeepAlive(os.mResponse.Size());
+}
+
+/* vim: set ts=4 sw=4: */
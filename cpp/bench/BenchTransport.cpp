@@ -0,0 +1,89 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "Benchmark.h"
+#include "BenchHelpers.h"
+
+#include <opendnp3/DNPConstants.h>
+#include <opendnp3/TransportLayer.h>
+
+using namespace opendnp3;
+
+namespace
+{
+
+/// A transport layer between the completing lower layer and a null upper layer
+class TransportFixture
+{
+public:
+	TransportFixture() :
+		mpLogger(mLog.GetLogger(LEV_WARNING, "bench")),
+		mTransport(mpLogger),
+		mLower(mpLogger),
+		mUpper(mpLogger),
+		mApdu(DEFAULT_FRAG_SIZE) {
+		mLower.SetUpperLayer(&mTransport);
+		mTransport.SetUpperLayer(&mUpper);
+		mLower.ThisLayerUp();
+		for(size_t i = 0; i < mApdu.size(); ++i) mApdu[i] = static_cast<uint8_t>(i);
+	}
+
+	void Send() {
+		mTransport.Send(&mApdu[0], mApdu.size());
+	}
+
+	EventLog mLog;
+	Logger* mpLogger;
+	TransportLayer mTransport;
+	CompletingLowerLayer mLower;
+	NullUpperLayer mUpper;
+	std::vector<uint8_t> mApdu;
+};
+
+}
+
+BENCHMARK_CASE(SendFragment, "Transport/TxFragment2048")
+{
+	arState.mBytesPerOp = DEFAULT_FRAG_SIZE;
+	TransportFixture t;
+	for(size_t i = 0; i < arState.mIterations; ++i) t.Send();
+	KeepAlive(t.mLower.mNumSent + t.mUpper.mNumSuccess);
+}
+
+BENCHMARK_CASE(ReceiveFragment, "Transport/RxFragment2048")
+{
+	arState.mBytesPerOp = DEFAULT_FRAG_SIZE;
+	TransportFixture t;
+
+	// the transmitter produces the segment sequence the receiver reassembles
+	t.mLower.mCapture = true;
+	t.Send();
+	std::vector< std::vector<uint8_t> > segments(t.mLower.mSent);
+
+	for(size_t i = 0; i < arState.mIterations; ++i) {
+		for(size_t j = 0; j < segments.size(); ++j) {
+			t.mTransport.OnReceive(&segments[j][0], segments[j].size());
+		}
+	}
+	KeepAlive(t.mUpper.mNumBytes);
+}
+
+/* vim: set ts=4 sw=4: */
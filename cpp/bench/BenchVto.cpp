@@ -0,0 +1,156 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "Benchmark.h"
+#include "BenchHelpers.h"
+
+#include <opendnp3/ResponseLoader.h>
+#include <opendnp3/VtoReader.h>
+#include <opendnp3/VtoStreamWriter.h>
+#include <opendnp3/VtoWriter.h>
+
+using namespace opendnp3;
+
+namespace
+{
+
+const size_t TRANSFER_SIZE = 64 * 1024;
+const size_t STREAM_BUFFER_SIZE = 16 * 1024;
+const uint8_t CHANNEL_ID = 1;
+
+/// Counts the bytes that arrive at the master
+class ByteSink : public IVtoDataHandler
+{
+public:
+	ByteSink() : IVtoDataHandler(CHANNEL_ID), mNumBytes(0) {}
+
+	void OnVtoDataReceived(const VtoData& arData) {
+		mNumBytes += arData.GetSize();
+	}
+
+	size_t mNumBytes;
+};
+
+/**
+	Connects the outstation's vto writer and response context to the master's
+	response loader with unsolicited fragments that are confirmed immediately.
+	The link and transport layers are left out so only the vto path is measured.
+	A stream buffer size of zero uses the chunked VtoWriter.
+*/
+class VtoLoopback
+{
+public:
+
+	VtoLoopback(size_t aStreamBufferSize) :
+		mLog(),
+		mpLogger(mLog.GetLogger(LEV_WARNING, "bench")),
+		mConfig(),
+		mDatabase(mpLogger),
+		mRspTypes(mConfig),
+		mContext(mpLogger, &mDatabase, &mRspTypes, EventMaxConfig()),
+		mChunkWriter(mpLogger, DEFAULT_VTO_WRITER_QUEUE_SIZE),
+		mStreamWriter(mpLogger, aStreamBufferSize),
+		mStreaming(aStreamBufferSize > 0),
+		mReader(mpLogger),
+		mNumFragments(0) {
+		if(mStreaming) mContext.SetVtoStream(&mStreamWriter);
+		mReader.AddVtoChannel(&mSink);
+	}
+
+	void Transfer(const std::vector<uint8_t>& arData) {
+		IVtoWriter* pWriter = mStreaming ? static_cast<IVtoWriter*>(&mStreamWriter) : &mChunkWriter;
+		size_t written = 0;
+		mSink.mNumBytes = 0;
+
+		while(mSink.mNumBytes < arData.size()) {
+			// the writer only takes as much as its buffer has room for, like a tunneled socket
+			if(written < arData.size()) written += pWriter->Write(&arData[written], arData.size() - written, CHANNEL_ID);
+
+			// the same hand off the slave makes in Slave::FlushVtoUpdates
+			if(!mStreaming) mChunkWriter.Flush(mContext.GetBuffer(), mContext.GetBuffer()->NumVtoEventsAvailable());
+
+			this->SendFragment();
+		}
+	}
+
+	size_t mNumFragments;
+
+private:
+
+	void SendFragment() {
+		mContext.LoadUnsol(mUnsol, mIIN, ClassMask(true, false, false));
+
+		mRx.Write(mUnsol.GetBuffer(), mUnsol.Size());
+		mRx.Interpret();
+		ResponseLoader loader(mpLogger, &mObserver, &mReader);
+		for(HeaderReadIterator hdr = mRx.BeginRead(); !hdr.IsEnd(); ++hdr) loader.Process(hdr);
+
+		// the master confirms the fragment
+		mContext.ClearAndReset();
+		++mNumFragments;
+	}
+
+	EventLog mLog;
+	Logger* mpLogger;
+	SlaveConfig mConfig;
+	Database mDatabase;
+	SlaveResponseTypes mRspTypes;
+	ResponseContext mContext;
+	VtoWriter mChunkWriter;
+	VtoStreamWriter mStreamWriter;
+	bool mStreaming;
+	VtoReader mReader;
+	ByteSink mSink;
+	NullDataObserver mObserver;
+	IINField mIIN;
+	APDU mUnsol;
+	APDU mRx;
+};
+
+std::vector<uint8_t> TransferData()
+{
+	std::vector<uint8_t> data(TRANSFER_SIZE);
+	for(size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i);
+	return data;
+}
+
+void Transfer(size_t aStreamBufferSize, BenchmarkState& arState)
+{
+	arState.mBytesPerOp = TRANSFER_SIZE;
+	std::vector<uint8_t> data = TransferData();
+	VtoLoopback loopback(aStreamBufferSize);
+	for(size_t i = 0; i < arState.mIterations; ++i) loopback.Transfer(data);
+	KeepAlive(loopback.mNumFragments);
+}
+
+}
+
+BENCHMARK_CASE(VtoChunked, "Vto/ChunkedLoopback64k")
+{
+	Transfer(0, arState);
+}
+
+BENCHMARK_CASE(VtoStreamed, "Vto/StreamedLoopback64k")
+{
+	Transfer(STREAM_BUFFER_SIZE, arState);
+}
+
+/* vim: set ts=4 sw=4: */
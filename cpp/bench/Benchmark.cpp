@@ -0,0 +1,168 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "Benchmark.h"
+
+#include <opendnp3/Clock.h>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+
+namespace opendnp3
+{
+
+std::vector<BenchmarkCase>& BenchmarkRegistry()
+{
+	static std::vector<BenchmarkCase> cases;
+	return cases;
+}
+
+volatile size_t gKeepAlive = 0;
+
+void KeepAlive(size_t aValue)
+{
+	gKeepAlive = gKeepAlive + aValue;
+}
+
+double BenchmarkResult::MedianNanos() const
+{
+	std::vector<double> sorted(mNanosPerOp);
+	std::sort(sorted.begin(), sorted.end());
+	size_t mid = sorted.size() / 2;
+	return (sorted.size() % 2) ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+}
+
+double BenchmarkResult::MinNanos() const
+{
+	return *std::min_element(mNanosPerOp.begin(), mNanosPerOp.end());
+}
+
+double BenchmarkResult::MaxNanos() const
+{
+	return *std::max_element(mNanosPerOp.begin(), mNanosPerOp.end());
+}
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkOptions& arOptions) :
+	mOptions(arOptions)
+{
+	if(mOptions.mRepetitions == 0) mOptions.mRepetitions = 1;
+}
+
+size_t BenchmarkRunner::Run()
+{
+	std::vector<BenchmarkCase>& cases = BenchmarkRegistry();
+	for(size_t i = 0; i < cases.size(); ++i) {
+		if(cases[i].mName.find(mOptions.mFilter) != std::string::npos) {
+			mResults.push_back(this->Run(cases[i]));
+		}
+	}
+	return mResults.size();
+}
+
+BenchmarkResult BenchmarkRunner::Run(const BenchmarkCase& arCase)
+{
+	BenchmarkResult result;
+	result.mName = arCase.mName;
+
+	// warm up, then double until one run covers the minimum time
+	const double minNanos = mOptions.mMinTimeMs * 1e6;
+	BenchmarkState state(1);
+	this->TimeNanos(arCase, state);
+	for(double elapsed = this->TimeNanos(arCase, state); elapsed < minNanos; elapsed = this->TimeNanos(arCase, state)) {
+		// jump straight to the estimate once the timing is above the clock's noise
+		size_t estimate = (elapsed > 1e6) ? static_cast<size_t>(state.mIterations * 1.2 * minNanos / elapsed) : 0;
+		state.mIterations = std::max(state.mIterations * 2, estimate);
+	}
+
+	result.mIterations = state.mIterations;
+	for(size_t i = 0; i < mOptions.mRepetitions; ++i) {
+		result.mNanosPerOp.push_back(this->TimeNanos(arCase, state) / state.mIterations);
+	}
+	result.mBytesPerOp = state.mBytesPerOp;
+
+	return result;
+}
+
+double BenchmarkRunner::TimeNanos(const BenchmarkCase& arCase, BenchmarkState& arState)
+{
+	timer_clock::time_point start = timer_clock::now();
+	arCase.mBody(arState);
+	timer_clock::duration elapsed = timer_clock::now() - start;
+	return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+std::string JsonString(const std::string& arValue)
+{
+	std::string ret("\"");
+	for(size_t i = 0; i < arValue.size(); ++i) {
+		if(arValue[i] == '"' || arValue[i] == '\\') ret += '\\';
+		ret += arValue[i];
+	}
+	return ret + "\"";
+}
+
+void BenchmarkRunner::WriteJson(std::ostream& arStream) const
+{
+	char date[32];
+	time_t now = time(NULL);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+#ifdef OPENDNP3_LATENCY_TRACE
+	const char* latencyTrace = "true";
+#else
+	const char* latencyTrace = "false";
+#endif
+
+	arStream << std::fixed << std::setprecision(2);
+	arStream << "{" << std::endl;
+	arStream << "  \"context\": {" << std::endl;
+	arStream << "    \"date\": " << JsonString(date) << "," << std::endl;
+	arStream << "    \"repetitions\": " << mOptions.mRepetitions << "," << std::endl;
+	arStream << "    \"min_time_ms\": " << mOptions.mMinTimeMs << "," << std::endl;
+	arStream << "    \"latency_trace\": " << latencyTrace << std::endl;
+	arStream << "  }," << std::endl;
+	arStream << "  \"benchmarks\": [";
+
+	for(size_t i = 0; i < mResults.size(); ++i) {
+		const BenchmarkResult& r = mResults[i];
+		double median = r.MedianNanos();
+
+		arStream << ((i == 0) ? "" : ",") << std::endl;
+		arStream << "    {" << std::endl;
+		arStream << "      \"name\": " << JsonString(r.mName) << "," << std::endl;
+		arStream << "      \"iterations\": " << r.mIterations << "," << std::endl;
+		arStream << "      \"median_ns\": " << median << "," << std::endl;
+		arStream << "      \"min_ns\": " << r.MinNanos() << "," << std::endl;
+		arStream << "      \"max_ns\": " << r.MaxNanos() << "," << std::endl;
+		arStream << "      \"ops_per_sec\": " << ((median > 0) ? 1e9 / median : 0) << "," << std::endl;
+		arStream << "      \"bytes_per_op\": " << r.mBytesPerOp << "," << std::endl;
+		arStream << "      \"mb_per_sec\": " << ((median > 0) ? r.mBytesPerOp * 1e3 / median : 0) << std::endl;
+		arStream << "    }";
+	}
+
+	arStream << std::endl << "  ]" << std::endl << "}" << std::endl;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,131 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __BENCHMARK_H_
+#define __BENCHMARK_H_
+
+#include <opendnp3/Uncopyable.h>
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+
+namespace opendnp3
+{
+
+struct BenchmarkState {
+	BenchmarkState(size_t aIterations) : mIterations(aIterations), mBytesPerOp(0) {}
+
+	size_t mIterations;	// number of times the body runs the measured operation
+	size_t mBytesPerOp;	// payload bytes handled per iteration, left at 0 if throughput isn't meaningful
+};
+
+/**
+	A benchmark body runs the measured operation mIterations times.
+	Any setup it does before the loop is timed too, so it is amortized
+	over the iterations rather than excluded.
+*/
+typedef std::function<void (BenchmarkState&)> BenchmarkBody;
+
+struct BenchmarkCase {
+	BenchmarkCase(const std::string& arName, const BenchmarkBody& arBody) :
+		mName(arName), mBody(arBody)
+	{}
+
+	std::string mName;
+	BenchmarkBody mBody;
+};
+
+struct BenchmarkResult {
+	std::string mName;
+	size_t mIterations;	// iterations per repetition after calibration
+	size_t mBytesPerOp;
+	std::vector<double> mNanosPerOp; // one sample per repetition
+
+	double MedianNanos() const;
+	double MinNanos() const;
+	double MaxNanos() const;
+};
+
+struct BenchmarkOptions {
+	BenchmarkOptions() : mRepetitions(5), mMinTimeMs(100) {}
+
+	std::string mFilter;	// only run cases whose name contains this string
+	size_t mRepetitions;	// timed runs per case, the median is the headline number
+	size_t mMinTimeMs;		// each timed run lasts at least this long
+};
+
+/// Every case registered with BENCHMARK_CASE, in registration order
+std::vector<BenchmarkCase>& BenchmarkRegistry();
+
+class BenchmarkRegistrar
+{
+public:
+	BenchmarkRegistrar(const std::string& arName, const BenchmarkBody& arBody) {
+		BenchmarkRegistry().push_back(BenchmarkCase(arName, arBody));
+	}
+};
+
+/**
+	Defines and registers a benchmark body, which sees its state as arState.
+
+	BENCHMARK_CASE(CrcBlock, "Crc/Block16") { for(size_t i = 0; i < arState.mIterations; ++i) ... }
+*/
+#define BENCHMARK_CASE(id, name) \
+	static void id(opendnp3::BenchmarkState& arState); \
+	static opendnp3::BenchmarkRegistrar id##_registrar(name, &id); \
+	static void id(opendnp3::BenchmarkState& arState)
+
+/// Keeps the compiler from discarding results that are otherwise unused
+void KeepAlive(size_t aValue);
+
+/// Quotes and escapes a string for the JSON reports
+std::string JsonString(const std::string& arValue);
+
+/**
+	Runs the registered cases. Each case is warmed up, the iteration count is doubled
+	until a run lasts the minimum time, then the case is repeated at that count.
+*/
+class BenchmarkRunner : private Uncopyable
+{
+public:
+	BenchmarkRunner(const BenchmarkOptions& arOptions);
+
+	/// Runs every registered case that matches the filter, returns the number run
+	size_t Run();
+
+	void WriteJson(std::ostream& arStream) const;
+
+private:
+
+	BenchmarkResult Run(const BenchmarkCase& arCase);
+	double TimeNanos(const BenchmarkCase& arCase, BenchmarkState& arState);
+
+	BenchmarkOptions mOptions;
+	std::vector<BenchmarkResult> mResults;
+};
+
+}
+
+#endif
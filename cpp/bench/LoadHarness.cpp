@@ -0,0 +1,512 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "LoadHarness.h"
+
+#include "Benchmark.h"
+
+#include <opendnp3/ControlRelayOutputBlock.h>
+#include <opendnp3/ICommandProcessor.h>
+#include <opendnp3/IChannel.h>
+#include <opendnp3/IMaster.h>
+#include <opendnp3/IOutstation.h>
+#include <opendnp3/ITransactable.h>
+#include <opendnp3/MasterStackConfig.h>
+#include <opendnp3/SimpleCommandHandler.h>
+#include <opendnp3/SlaveStackConfig.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include <time.h>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+namespace opendnp3
+{
+
+LoadConfig::LoadConfig() :
+	mNumOutstations(10),
+	mNumPoints(100),
+	mEventRate(100),
+	mIntegrityMs(60000),
+	mExceptionMs(0),
+	mCommandRate(1),
+	mMaxInFlight(16),
+	mWarmupMs(2000),
+	mDurationMs(10000),
+	mTickMs(10),
+	mTransport(LT_TCP),
+	mThreads(std::max<uint32_t>(1, std::thread::hardware_concurrency())),
+	mStartPort(30000)
+{}
+
+void LatencySamples::Finalize()
+{
+	std::sort(mSamples.begin(), mSamples.end());
+}
+
+uint64_t LatencySamples::Percentile(double aFraction) const
+{
+	if(mSamples.empty()) return 0;
+	size_t rank = static_cast<size_t>(std::ceil(aFraction * mSamples.size()));
+	return mSamples[std::min(mSamples.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+void LatencySamples::Append(const LatencySamples& arOther)
+{
+	mSamples.insert(mSamples.end(), arOther.mSamples.begin(), arOther.mSamples.end());
+}
+
+uint64_t MicrosSince(const timer_clock::time_point& arStart, const timer_clock::time_point& arNow)
+{
+	return static_cast<uint64_t>(duration_cast<microseconds>(std::max(arNow - arStart, timer_clock::duration::zero())).count());
+}
+
+DeliveryObserver::DeliveryObserver(const timer_clock::time_point& arEpoch, size_t aNumPoints, const std::atomic<bool>& arMeasuring) :
+	mEpoch(arEpoch),
+	mMeasuring(arMeasuring),
+	mLastSeen(aNumPoints, 0),
+	mDelivered(0)
+{}
+
+void DeliveryObserver::_Update(const Analog& arPoint, size_t aIndex)
+{
+	// the startup values and anything older than what was already seen aren't deliveries
+	if(aIndex >= mLastSeen.size() || arPoint.GetValue() <= mLastSeen[aIndex]) return;
+
+	mLastSeen[aIndex] = arPoint.GetValue();
+	if(!mMeasuring.load(std::memory_order_relaxed)) return;
+
+	uint64_t now = MicrosSince(mEpoch, timer_clock::now());
+	uint64_t published = static_cast<uint64_t>(arPoint.GetValue());
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	++mDelivered;
+	mLatency.Add(now > published ? now - published : 0);
+}
+
+void DeliveryObserver::Collect(size_t& arDelivered, LatencySamples& arLatency)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	arDelivered += mDelivered;
+	arLatency.Append(mLatency);
+	mDelivered = 0;
+	mLatency = LatencySamples();
+}
+
+CommandTracker::CommandTracker(const std::atomic<bool>& arMeasuring) :
+	mMeasuring(arMeasuring),
+	mInFlight(0),
+	mSucceeded(0),
+	mFailed(0)
+{}
+
+bool CommandTracker::TryStart(size_t aMaxInFlight)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if(mInFlight >= aMaxInFlight) return false;
+	++mInFlight;
+	return true;
+}
+
+void CommandTracker::OnResponse(const timer_clock::time_point& arStart, CommandResponse aResponse)
+{
+	timer_clock::time_point now = timer_clock::now();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	--mInFlight;
+	if(!mMeasuring.load(std::memory_order_relaxed)) return;
+
+	if(aResponse.mResult == CS_SUCCESS) {
+		++mSucceeded;
+		mLatency.Add(MicrosSince(arStart, now));
+	}
+	else ++mFailed;
+}
+
+void CommandTracker::Collect(size_t& arSucceeded, size_t& arFailed, LatencySamples& arLatency)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	arSucceeded += mSucceeded;
+	arFailed += mFailed;
+	arLatency.Append(mLatency);
+	mSucceeded = mFailed = 0;
+	mLatency = LatencySamples();
+}
+
+LoadHarness::LoadHarness(const LoadConfig& arConfig) :
+	mConfig(arConfig),
+	mEpoch(timer_clock::now()),
+	mMeasuring(false),
+	mpManager(new DNP3Manager(arConfig.mThreads)),
+	mOnlineMs(0),
+	mRssBefore(0),
+	mRssAfter(0),
+	mRssEnd(0),
+	mMeasuredSeconds(0),
+	mProcessCpuMicros(0),
+	mDriverCpuMicros(0),
+	mPublished(0),
+	mIssued(0),
+	mSkipped(0),
+	mDelivered(0),
+	mSucceeded(0),
+	mFailed(0),
+	mOverflows(0),
+	mPollTraced(false)
+{}
+
+LoadHarness::~LoadHarness()
+{
+	// stop the stacks before the observers they call back into go away
+	mpManager->Shutdown();
+}
+
+bool LoadHarness::Start(millis_t aTimeoutMs)
+{
+	mRssBefore = ResidentBytes();
+	timer_clock::time_point start = timer_clock::now();
+
+	for(size_t i = 0; i < mConfig.mNumOutstations; ++i) this->AddPair(i);
+
+	timer_clock::time_point deadline = start + milliseconds(aTimeoutMs);
+	while(this->NumOnline() < mPairs.size() && timer_clock::now() < deadline) {
+		std::this_thread::sleep_for(milliseconds(10));
+	}
+
+	mOnlineMs = duration_cast<milliseconds>(timer_clock::now() - start).count();
+	mRssAfter = ResidentBytes();
+	return this->NumOnline() == mPairs.size();
+}
+
+void LoadHarness::AddPair(size_t aIndex)
+{
+	std::ostringstream oss;
+	oss << aIndex;
+	std::string master = "master" + oss.str();
+	std::string outstation = "outstation" + oss.str();
+
+	IChannel* pClient = NULL;
+	IChannel* pServer = NULL;
+	if(mConfig.mTransport == LT_SHARED_MEMORY) {
+		std::ostringstream segment;
+		segment << "dnp3load_" << getpid() << "_" << aIndex;
+		pServer = mpManager->AddSharedMemoryServer(outstation, LEV_WARNING, 1000, segment.str());
+		pClient = mpManager->AddSharedMemoryClient(master, LEV_WARNING, 1000, segment.str());
+	}
+	else {
+		uint16_t port = mConfig.mStartPort + static_cast<uint16_t>(aIndex);
+		pServer = mpManager->AddTCPServer(outstation, LEV_WARNING, 1000, "127.0.0.1", port);
+		pClient = mpManager->AddTCPClient(master, LEV_WARNING, 1000, "127.0.0.1", port);
+	}
+
+	Pair pair;
+	pair.mpObserver.reset(new DeliveryObserver(mEpoch, mConfig.mNumPoints, mMeasuring));
+	pair.mpCommands.reset(new CommandTracker(mMeasuring));
+	pair.mpOnline.reset(new std::atomic<bool>(false));
+	pair.mPublishDebt = 0;
+	pair.mCommandDebt = 0;
+	pair.mNextIndex = 0;
+	pair.mNextCommand = 0;
+
+	bool unsol = mConfig.mExceptionMs == 0;
+
+	{
+		MasterStackConfig cfg;
+		cfg.master.IntegrityRate = mConfig.mIntegrityMs;
+		cfg.master.DoUnsolOnStartup = true;
+		cfg.master.EnableUnsol = unsol;
+		cfg.master.UnsolClassMask = PC_ALL_EVENTS;
+		if(!unsol) cfg.master.AddExceptionScan(PC_ALL_EVENTS, mConfig.mExceptionMs);
+		pair.mpMaster = pClient->AddMaster(master, LEV_WARNING, pair.mpObserver.get(), cfg);
+	}
+
+	{
+		SlaveStackConfig cfg;
+		cfg.slave.mDisableUnsol = !unsol;
+		cfg.slave.mUnsolPackDelay = 0;
+		cfg.device = DeviceTemplate(mConfig.mNumPoints, mConfig.mNumPoints, mConfig.mNumPoints);
+		pair.mpOutstation = pServer->AddOutstation(outstation, LEV_WARNING, SuccessCommandHandler::Inst(), cfg);
+		pair.mpPublisher = pair.mpOutstation->GetDataObserver();
+	}
+
+	std::shared_ptr< std::atomic<bool> > pOnline = pair.mpOnline;
+	pair.mpMaster->AddStateListener([pOnline](StackState aState) {
+		pOnline->store(aState == SS_COMMS_UP);
+	});
+
+	mPairs.push_back(pair);
+}
+
+size_t LoadHarness::NumOnline() const
+{
+	size_t num = 0;
+	for(size_t i = 0; i < mPairs.size(); ++i) {
+		if(mPairs[i].mpOnline->load()) ++num;
+	}
+	return num;
+}
+
+void LoadHarness::Run()
+{
+	const timer_clock::duration tick = milliseconds(mConfig.mTickMs);
+	const double tickSeconds = mConfig.mTickMs / 1000.0;
+
+	timer_clock::time_point next = timer_clock::now();
+	timer_clock::time_point measureStart = next + milliseconds(mConfig.mWarmupMs);
+	timer_clock::time_point end = measureStart + milliseconds(mConfig.mDurationMs);
+
+	StageLatency pollBase;
+	uint64_t processCpuStart = 0;
+	uint64_t driverCpuStart = 0;
+
+	// the schedule advances a fixed tick at a time, so a late wakeup catches up rather than drifting
+	while(next < end) {
+		if(!mMeasuring && next >= measureStart) {
+			size_t discard = 0;
+			LatencySamples samples;
+			for(size_t i = 0; i < mPairs.size(); ++i) {
+				mPairs[i].mpObserver->Collect(discard, samples);
+				mPairs[i].mpCommands->Collect(discard, discard, samples);
+			}
+			pollBase = this->PollLatency();
+			processCpuStart = ProcessCpuMicros();
+			driverCpuStart = ThreadCpuMicros();
+			mMeasuring = true;
+		}
+
+		std::this_thread::sleep_until(next);
+		this->Tick(tickSeconds);
+		next += tick;
+	}
+
+	mMeasuring = false;
+	mProcessCpuMicros = ProcessCpuMicros() - processCpuStart;
+	mDriverCpuMicros = ThreadCpuMicros() - driverCpuStart;
+	mMeasuredSeconds = mConfig.mDurationMs / 1000.0;
+
+	for(size_t i = 0; i < mPairs.size(); ++i) {
+		mPairs[i].mpObserver->Collect(mDelivered, mDeliveryLatency);
+		mPairs[i].mpCommands->Collect(mSucceeded, mFailed, mCommandLatency);
+		mOverflows += mPairs[i].mpOutstation->GetStatistics().mNumEventOverflows;
+	}
+	mDeliveryLatency.Finalize();
+	mCommandLatency.Finalize();
+
+	mPollLatency = this->PollLatency();
+	mPollTraced = mPairs.empty() ? false : mPairs[0].mpMaster->GetLatencyStatistics().mEnabled;
+	mPollLatency.mNumSamples -= pollBase.mNumSamples;
+	mPollLatency.mTotalMicros -= pollBase.mTotalMicros;
+	for(size_t i = 0; i < StageLatency::NUM_BUCKETS; ++i) mPollLatency.mBuckets[i] -= pollBase.mBuckets[i];
+
+	mRssEnd = ResidentBytes();
+}
+
+void LoadHarness::Tick(double aSeconds)
+{
+	for(size_t i = 0; i < mPairs.size(); ++i) {
+		Pair& pair = mPairs[i];
+
+		pair.mPublishDebt += mConfig.mEventRate * aSeconds;
+		size_t events = static_cast<size_t>(pair.mPublishDebt);
+		pair.mPublishDebt -= events;
+		if(events > 0) this->Publish(pair, events);
+
+		pair.mCommandDebt += mConfig.mCommandRate * aSeconds;
+		size_t commands = static_cast<size_t>(pair.mCommandDebt);
+		pair.mCommandDebt -= commands;
+		if(commands > 0) this->IssueCommands(pair, commands);
+	}
+}
+
+void LoadHarness::Publish(Pair& arPair, size_t aNum)
+{
+	if(mConfig.mNumPoints == 0) return;
+
+	// the value is the publish time, nudged forward so repeated points within a tick still change
+	double value = static_cast<double>(MicrosSince(mEpoch, timer_clock::now()));
+
+	Transaction t(arPair.mpPublisher);
+	for(size_t i = 0; i < aNum; ++i) {
+		arPair.mpPublisher->Update(Analog(value + (i / mConfig.mNumPoints), AQ_ONLINE), arPair.mNextIndex);
+		arPair.mNextIndex = (arPair.mNextIndex + 1) % mConfig.mNumPoints;
+	}
+
+	if(mMeasuring) mPublished += aNum;
+}
+
+void LoadHarness::IssueCommands(Pair& arPair, size_t aNum)
+{
+	ICommandProcessor* pProcessor = arPair.mpMaster->GetCommandProcessor();
+	std::shared_ptr<CommandTracker> pTracker = arPair.mpCommands;
+
+	for(size_t i = 0; i < aNum; ++i) {
+		if(!pTracker->TryStart(mConfig.mMaxInFlight)) {
+			if(mMeasuring) ++mSkipped;
+			continue;
+		}
+
+		timer_clock::time_point start = timer_clock::now();
+		size_t index = arPair.mNextCommand++ % std::max<size_t>(mConfig.mNumPoints, 1);
+		pProcessor->SelectAndOperate(ControlRelayOutputBlock(CC_LATCH_ON), index, [pTracker, start](CommandResponse aResponse) {
+			pTracker->OnResponse(start, aResponse);
+		});
+		if(mMeasuring) ++mIssued;
+	}
+}
+
+StageLatency LoadHarness::PollLatency() const
+{
+	StageLatency sum;
+	for(size_t i = 0; i < mPairs.size(); ++i) {
+		const StageLatency& s = mPairs[i].mpMaster->GetLatencyStatistics().mStages[LS_POLL_ROUND_TRIP];
+		for(size_t j = 0; j < StageLatency::NUM_BUCKETS; ++j) sum.mBuckets[j] += s.mBuckets[j];
+		sum.mNumSamples += s.mNumSamples;
+		sum.mTotalMicros += s.mTotalMicros;
+		sum.mMaxMicros = std::max(sum.mMaxMicros, s.mMaxMicros);
+	}
+	return sum;
+}
+
+uint64_t CpuMicros(clockid_t aClock)
+{
+	timespec ts;
+	if(clock_gettime(aClock, &ts) != 0) return 0;
+	return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint64_t LoadHarness::ProcessCpuMicros()
+{
+	return CpuMicros(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+uint64_t LoadHarness::ThreadCpuMicros()
+{
+	return CpuMicros(CLOCK_THREAD_CPUTIME_ID);
+}
+
+uint64_t LoadHarness::ResidentBytes()
+{
+	// the second field of statm is the resident set in pages, only available on Linux
+	std::ifstream statm("/proc/self/statm");
+	uint64_t size = 0;
+	uint64_t resident = 0;
+	if(!(statm >> size >> resident)) return 0;
+	return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+void WriteSamples(std::ostream& arStream, const LatencySamples& arSamples)
+{
+	arStream << "{\"p50\": " << arSamples.Percentile(0.5)
+	         << ", \"p90\": " << arSamples.Percentile(0.9)
+	         << ", \"p99\": " << arSamples.Percentile(0.99)
+	         << ", \"p999\": " << arSamples.Percentile(0.999)
+	         << ", \"max\": " << arSamples.Percentile(1.0) << "}";
+}
+
+void LoadHarness::WriteJson(std::ostream& arStream) const
+{
+	const double seconds = (mMeasuredSeconds > 0) ? mMeasuredSeconds : 1;
+	const size_t numStacks = std::max<size_t>(1, 2 * mPairs.size());
+	const size_t numOutstations = std::max<size_t>(1, mPairs.size());
+	uint64_t stackCpu = (mProcessCpuMicros > mDriverCpuMicros) ? mProcessCpuMicros - mDriverCpuMicros : 0;
+	uint64_t stackBytes = (mRssAfter > mRssBefore) ? mRssAfter - mRssBefore : 0;
+
+#ifdef OPENDNP3_LATENCY_TRACE
+	const char* latencyTrace = "true";
+#else
+	const char* latencyTrace = "false";
+#endif
+
+	arStream << std::fixed << std::setprecision(2);
+	arStream << "{" << std::endl;
+
+	arStream << "  \"config\": {" << std::endl;
+	arStream << "    \"transport\": " << JsonString((mConfig.mTransport == LT_TCP) ? "tcp" : "shm") << "," << std::endl;
+	arStream << "    \"outstations\": " << mConfig.mNumOutstations << "," << std::endl;
+	arStream << "    \"points\": " << mConfig.mNumPoints << "," << std::endl;
+	arStream << "    \"event_rate\": " << mConfig.mEventRate << "," << std::endl;
+	arStream << "    \"integrity_ms\": " << mConfig.mIntegrityMs << "," << std::endl;
+	arStream << "    \"exception_ms\": " << mConfig.mExceptionMs << "," << std::endl;
+	arStream << "    \"command_rate\": " << mConfig.mCommandRate << "," << std::endl;
+	arStream << "    \"warmup_ms\": " << mConfig.mWarmupMs << "," << std::endl;
+	arStream << "    \"duration_ms\": " << mConfig.mDurationMs << "," << std::endl;
+	arStream << "    \"threads\": " << mConfig.mThreads << "," << std::endl;
+	arStream << "    \"latency_trace\": " << latencyTrace << std::endl;
+	arStream << "  }," << std::endl;
+
+	arStream << "  \"setup\": {\"online_ms\": " << mOnlineMs << "}," << std::endl;
+
+	arStream << "  \"events\": {" << std::endl;
+	arStream << "    \"published\": " << mPublished << "," << std::endl;
+	arStream << "    \"delivered\": " << mDelivered << "," << std::endl;
+	arStream << "    \"delivered_per_sec\": " << mDelivered / seconds << "," << std::endl;
+	arStream << "    \"overflows\": " << mOverflows << "," << std::endl;
+	arStream << "    \"latency_us\": ";
+	WriteSamples(arStream, mDeliveryLatency);
+	arStream << std::endl << "  }," << std::endl;
+
+	arStream << "  \"polls\": {" << std::endl;
+	arStream << "    \"traced\": " << (mPollTraced ? "true" : "false") << "," << std::endl;
+	arStream << "    \"completed\": " << mPollLatency.mNumSamples << "," << std::endl;
+	arStream << "    \"latency_us\": {\"mean\": " << mPollLatency.MeanMicros()
+	         << ", \"p50\": " << mPollLatency.PercentileMicros(0.5)
+	         << ", \"p90\": " << mPollLatency.PercentileMicros(0.9)
+	         << ", \"p99\": " << mPollLatency.PercentileMicros(0.99)
+	         << ", \"max\": " << mPollLatency.mMaxMicros << "}" << std::endl;
+	arStream << "  }," << std::endl;
+
+	arStream << "  \"commands\": {" << std::endl;
+	arStream << "    \"issued\": " << mIssued << "," << std::endl;
+	arStream << "    \"succeeded\": " << mSucceeded << "," << std::endl;
+	arStream << "    \"failed\": " << mFailed << "," << std::endl;
+	arStream << "    \"skipped\": " << mSkipped << "," << std::endl;
+	arStream << "    \"per_sec\": " << mSucceeded / seconds << "," << std::endl;
+	arStream << "    \"latency_us\": ";
+	WriteSamples(arStream, mCommandLatency);
+	arStream << std::endl << "  }," << std::endl;
+
+	arStream << "  \"cpu\": {" << std::endl;
+	arStream << "    \"stack_cpu_sec\": " << stackCpu / 1e6 << "," << std::endl;
+	arStream << "    \"driver_cpu_sec\": " << mDriverCpuMicros / 1e6 << "," << std::endl;
+	arStream << "    \"cores_used\": " << stackCpu / 1e6 / seconds << "," << std::endl;
+	arStream << "    \"cpu_ms_per_sec_per_outstation\": " << stackCpu / 1e3 / seconds / numOutstations << std::endl;
+	arStream << "  }," << std::endl;
+
+	arStream << "  \"memory\": {" << std::endl;
+	arStream << "    \"rss_before_bytes\": " << mRssBefore << "," << std::endl;
+	arStream << "    \"rss_online_bytes\": " << mRssAfter << "," << std::endl;
+	arStream << "    \"rss_end_bytes\": " << mRssEnd << "," << std::endl;
+	arStream << "    \"bytes_per_stack\": " << stackBytes / numStacks << std::endl;
+	arStream << "  }" << std::endl;
+
+	arStream << "}" << std::endl;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
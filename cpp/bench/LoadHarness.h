@@ -0,0 +1,229 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __LOAD_HARNESS_H_
+#define __LOAD_HARNESS_H_
+
+#include <opendnp3/Clock.h>
+#include <opendnp3/CommandResponse.h>
+#include <opendnp3/DNP3Manager.h>
+#include <opendnp3/IDataObserver.h>
+#include <opendnp3/LatencyStatistics.h>
+#include <opendnp3/Uncopyable.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace opendnp3
+{
+
+class IMaster;
+class IOutstation;
+
+enum LoadTransport {
+	LT_TCP,				// one local TCP connection per pair
+	LT_SHARED_MEMORY	// one in-memory shared memory segment per pair
+};
+
+/**
+	Describes the workload. Every outstation gets the same database and the same
+	schedule, so two runs with the same configuration do the same work.
+*/
+struct LoadConfig {
+	LoadConfig();
+
+	size_t mNumOutstations;	// master/outstation pairs
+	size_t mNumPoints;		// binaries, analogs and counters in each outstation
+	double mEventRate;		// analog changes per second published by each outstation
+	millis_t mIntegrityMs;	// integrity poll period, -1 polls once at startup
+	millis_t mExceptionMs;	// class 1/2/3 poll period, 0 reports events unsolicited instead
+	double mCommandRate;	// select before operate commands per second to each outstation
+	size_t mMaxInFlight;	// commands allowed to wait for a response on each master before new ones are skipped
+	millis_t mWarmupMs;		// run time before the measurement starts
+	millis_t mDurationMs;	// measured run time
+	millis_t mTickMs;		// period of the publishing and command schedule
+	LoadTransport mTransport;
+	uint32_t mThreads;		// size of the manager's thread pool
+	uint16_t mStartPort;	// TCP port of the first pair
+};
+
+/// Latency samples in microseconds, summarized as exact percentiles
+class LatencySamples
+{
+public:
+	void Add(uint64_t aMicros) {
+		mSamples.push_back(aMicros);
+	}
+
+	size_t Count() const {
+		return mSamples.size();
+	}
+
+	/// Sorts the samples, call before reading percentiles
+	void Finalize();
+
+	uint64_t Percentile(double aFraction) const;
+
+	void Append(const LatencySamples& arOther);
+
+private:
+	std::vector<uint64_t> mSamples;
+};
+
+/**
+	The master side observer of one pair. Each published analog carries the time it was
+	published, so every value newer than the last one seen for the point is a delivered
+	change and its age is the delivery latency.
+*/
+class DeliveryObserver : public IDataObserver, private Uncopyable
+{
+public:
+	DeliveryObserver(const timer_clock::time_point& arEpoch, size_t aNumPoints, const std::atomic<bool>& arMeasuring);
+
+	/// Moves the counts and samples gathered so far out of the observer
+	void Collect(size_t& arDelivered, LatencySamples& arLatency);
+
+private:
+	void _Start() {}
+	void _End() {}
+	void _Update(const Binary&, size_t) {}
+	void _Update(const Analog& arPoint, size_t aIndex);
+	void _Update(const Counter&, size_t) {}
+	void _Update(const ControlStatus&, size_t) {}
+	void _Update(const SetpointStatus&, size_t) {}
+
+	const timer_clock::time_point mEpoch;
+	const std::atomic<bool>& mMeasuring;
+	std::vector<double> mLastSeen;
+
+	std::mutex mMutex;
+	size_t mDelivered;
+	LatencySamples mLatency;
+};
+
+/// Round trip times of the commands issued to one master
+class CommandTracker : private Uncopyable
+{
+public:
+	CommandTracker(const std::atomic<bool>& arMeasuring);
+
+	/// @return false if too many commands are already waiting for a response
+	bool TryStart(size_t aMaxInFlight);
+
+	void OnResponse(const timer_clock::time_point& arStart, CommandResponse aResponse);
+
+	void Collect(size_t& arSucceeded, size_t& arFailed, LatencySamples& arLatency);
+
+private:
+	const std::atomic<bool>& mMeasuring;
+
+	std::mutex mMutex;
+	size_t mInFlight;
+	size_t mSucceeded;
+	size_t mFailed;
+	LatencySamples mLatency;
+};
+
+/**
+	Wires N master/outstation pairs together through one DNP3Manager, drives them with the
+	configured workload and reports what was delivered, how long it took and what it cost.
+*/
+class LoadHarness : private Uncopyable
+{
+public:
+	LoadHarness(const LoadConfig& arConfig);
+	~LoadHarness();
+
+	/**
+		Creates the stacks and waits for every master to come online
+		@return false if they weren't all online within the timeout
+	*/
+	bool Start(millis_t aTimeoutMs);
+
+	/// Runs the warmup and the measurement on the calling thread
+	void Run();
+
+	void WriteJson(std::ostream& arStream) const;
+
+private:
+
+	struct Pair {
+		IMaster* mpMaster;
+		IOutstation* mpOutstation;
+		IDataObserver* mpPublisher;
+		std::shared_ptr<DeliveryObserver> mpObserver;
+		std::shared_ptr<CommandTracker> mpCommands;
+		std::shared_ptr< std::atomic<bool> > mpOnline;
+		double mPublishDebt;	// events due but not yet published
+		double mCommandDebt;
+		size_t mNextIndex;
+		size_t mNextCommand;
+	};
+
+	void AddPair(size_t aIndex);
+	size_t NumOnline() const;
+
+	void Tick(double aSeconds);
+	void Publish(Pair& arPair, size_t aNum);
+	void IssueCommands(Pair& arPair, size_t aNum);
+
+	/// Sum of the poll round trips recorded by the masters
+	StageLatency PollLatency() const;
+
+	static uint64_t ProcessCpuMicros();
+	static uint64_t ThreadCpuMicros();
+	static uint64_t ResidentBytes();
+
+	const LoadConfig mConfig;
+	const timer_clock::time_point mEpoch;
+	std::atomic<bool> mMeasuring;
+
+	std::auto_ptr<DNP3Manager> mpManager;
+	std::vector<Pair> mPairs;
+
+	// results
+	millis_t mOnlineMs;
+	uint64_t mRssBefore;
+	uint64_t mRssAfter;
+	uint64_t mRssEnd;
+	double mMeasuredSeconds;
+	uint64_t mProcessCpuMicros;
+	uint64_t mDriverCpuMicros;
+	size_t mPublished;
+	size_t mIssued;
+	size_t mSkipped;
+	size_t mDelivered;
+	size_t mSucceeded;
+	size_t mFailed;
+	uint64_t mOverflows;
+	LatencySamples mDeliveryLatency;
+	LatencySamples mCommandLatency;
+	StageLatency mPollLatency;
+	bool mPollTraced;
+};
+
+}
+
+#endif
@@ -0,0 +1,114 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "LoadHarness.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string.h>
+
+using namespace std;
+using namespace opendnp3;
+
+void PrintUsage(const char* apName)
+{
+	LoadConfig defaults;
+	cout << "usage: " << apName << " [options]" << endl;
+	cout << "  --outstations=<n>      master/outstation pairs (default " << defaults.mNumOutstations << ")" << endl;
+	cout << "  --points=<n>           binaries, analogs and counters per outstation (default " << defaults.mNumPoints << ")" << endl;
+	cout << "  --event-rate=<n>       analog changes per second per outstation (default " << defaults.mEventRate << ")" << endl;
+	cout << "  --integrity-ms=<ms>    integrity poll period, -1 for startup only (default " << defaults.mIntegrityMs << ")" << endl;
+	cout << "  --exception-ms=<ms>    event poll period, 0 for unsolicited reporting (default " << defaults.mExceptionMs << ")" << endl;
+	cout << "  --command-rate=<n>     commands per second per outstation (default " << defaults.mCommandRate << ")" << endl;
+	cout << "  --max-in-flight=<n>    outstanding commands per master before skipping (default " << defaults.mMaxInFlight << ")" << endl;
+	cout << "  --warmup-ms=<ms>       unmeasured run time after startup (default " << defaults.mWarmupMs << ")" << endl;
+	cout << "  --duration-ms=<ms>     measured run time (default " << defaults.mDurationMs << ")" << endl;
+	cout << "  --tick-ms=<ms>         publishing and command schedule period (default " << defaults.mTickMs << ")" << endl;
+	cout << "  --transport=<tcp|shm>  local TCP or in-memory shared memory channels (default tcp)" << endl;
+	cout << "  --threads=<n>          manager thread pool size (default " << defaults.mThreads << ")" << endl;
+	cout << "  --port=<n>             first TCP port (default " << defaults.mStartPort << ")" << endl;
+	cout << "  --output=<file>        write the JSON report to <file> instead of stdout" << endl;
+}
+
+bool ReadOption(const char* apArg, const char* apName, string& arValue)
+{
+	size_t len = strlen(apName);
+	if(strncmp(apArg, apName, len) != 0 || apArg[len] != '=') return false;
+	arValue = apArg + len + 1;
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	LoadConfig cfg;
+	string output;
+
+	for(int i = 1; i < argc; ++i) {
+		string value;
+		if(ReadOption(argv[i], "--outstations", value)) cfg.mNumOutstations = strtoul(value.c_str(), NULL, 10);
+		else if(ReadOption(argv[i], "--points", value)) cfg.mNumPoints = strtoul(value.c_str(), NULL, 10);
+		else if(ReadOption(argv[i], "--event-rate", value)) cfg.mEventRate = strtod(value.c_str(), NULL);
+		else if(ReadOption(argv[i], "--integrity-ms", value)) cfg.mIntegrityMs = strtol(value.c_str(), NULL, 10);
+		else if(ReadOption(argv[i], "--exception-ms", value)) cfg.mExceptionMs = strtol(value.c_str(), NULL, 10);
+		else if(ReadOption(argv[i], "--command-rate", value)) cfg.mCommandRate = strtod(value.c_str(), NULL);
+		else if(ReadOption(argv[i], "--max-in-flight", value)) cfg.mMaxInFlight = strtoul(value.c_str(), NULL, 10);
+		else if(ReadOption(argv[i], "--warmup-ms", value)) cfg.mWarmupMs = strtol(value.c_str(), NULL, 10);
+		else if(ReadOption(argv[i], "--duration-ms", value)) cfg.mDurationMs = strtol(value.c_str(), NULL, 10);
+		else if(ReadOption(argv[i], "--tick-ms", value)) cfg.mTickMs = strtol(value.c_str(), NULL, 10);
+		else if(ReadOption(argv[i], "--threads", value)) cfg.mThreads = strtoul(value.c_str(), NULL, 10);
+		else if(ReadOption(argv[i], "--port", value)) cfg.mStartPort = static_cast<uint16_t>(strtoul(value.c_str(), NULL, 10));
+		else if(ReadOption(argv[i], "--output", value)) output = value;
+		else if(ReadOption(argv[i], "--transport", value) && (value == "tcp" || value == "shm")) {
+			cfg.mTransport = (value == "tcp") ? LT_TCP : LT_SHARED_MEMORY;
+		}
+		else {
+			PrintUsage(argv[0]);
+			return (strcmp(argv[i], "--help") == 0) ? 0 : 1;
+		}
+	}
+
+	if(cfg.mTickMs <= 0 || cfg.mThreads == 0) {
+		cerr << "The tick and the thread count must be greater than zero" << endl;
+		return 1;
+	}
+
+	LoadHarness harness(cfg);
+	if(!harness.Start(30000)) {
+		cerr << "Not every master came online" << endl;
+		return 1;
+	}
+	harness.Run();
+
+	if(output.empty()) harness.WriteJson(cout);
+	else {
+		ofstream file(output.c_str());
+		if(!file) {
+			cerr << "Unable to open output file: " << output << endl;
+			return 1;
+		}
+		harness.WriteJson(file);
+	}
+
+	return 0;
+}
+
+/* vim: set ts=4 sw=4: */
@@ -99,59 +99,66 @@ std::string GetDataTypeName(DataTypes aType);
   has a its own defintion of the quality field that indicate specific conditions but all of the
   datatypes define an XX_ONLINE bit, that is the default "nominal" value. This quality field is not
   for applying alarming information, that needs to be done with Binaries or in other channels.
+
+  The data types have no virtual functions and store nothing but the time, value and quality, so
+  they're trivially copyable and standard layout. The database, event buffers and change buffer
+  keep them by value and can copy them with memcpy.
 */
+template <class T>
 class DataPoint
 {
 public:
-	virtual ~DataPoint() {}
 
-	DataTypes GetType() const;
 	millis_t GetTime() const;
 
-	virtual uint8_t GetQuality() const;
+	uint8_t GetQuality() const;
 	bool CheckQualityBit(uint8_t aQualMask) const;
 
-	virtual void SetQuality(uint8_t aQuality);
+	void SetQuality(uint8_t aQuality);
 	void SetTime(millis_t aTime);
 
-#ifndef OPENDNP3_STRIP_LOG_MESSAGES
-	virtual std::string ToString() const = 0;
-#endif
-
 protected:
 
 	//These constructors can only be invoked by super classes
-	DataPoint(uint8_t aQuality, DataTypes aType);
+	DataPoint(uint8_t aQuality);
 
-	uint8_t mQuality;	//	bitfield that stores type specific quality information
 	millis_t mTime;		//	timestamp associated with the measurement, -1 if it was never timestamped
+	T mValue;
+	uint8_t mQuality;	//	bitfield that stores type specific quality information
 
 private:
 	DataPoint();
-	DataTypes mType;
 };
 
-inline DataTypes DataPoint::GetType() const
-{
-	return mType;
-}
-inline millis_t DataPoint::GetTime() const
+template <class T>
+inline DataPoint<T>::DataPoint(uint8_t aQuality) :
+	mTime(0),
+	mValue(),
+	mQuality(aQuality)
+{}
+
+template <class T>
+inline millis_t DataPoint<T>::GetTime() const
 {
 	return mTime;
 }
-inline uint8_t  DataPoint::GetQuality() const
+template <class T>
+inline uint8_t DataPoint<T>::GetQuality() const
 {
 	return mQuality;
 }
-inline bool DataPoint::CheckQualityBit(uint8_t aQualMask) const
+template <class T>
+inline bool DataPoint<T>::CheckQualityBit(uint8_t aQualMask) const
 {
 	return (aQualMask & mQuality) != 0;
 }
-inline void DataPoint::SetTime(millis_t arTime)
+template <class T>
+inline void DataPoint<T>::SetTime(millis_t arTime)
 {
 	mTime = arTime;
 }
-inline void DataPoint::SetQuality(uint8_t aQuality)
+template <class T>
+inline void DataPoint<T>::SetQuality(uint8_t aQuality)
 {
 	mQuality = aQuality;
 }
@@ -159,14 +166,18 @@ inline void DataPoint::SetQuality(uint8_t aQuality)
 /**
    Base class for Binary and ControlStatus data types, shouldn't be used directly.
 */
-class BoolDataPoint : public DataPoint
+class BoolDataPoint : public DataPoint<bool>
 {
 public:
 
+	// the bit of the quality that reports the value, BQ_STATE and TQ_STATE
+	static const uint8_t STATE_MASK = 0x80;
+
 	bool GetValue() const;
 	void SetValue(bool aValue);
 
 	uint8_t GetQuality() const;
+	bool CheckQualityBit(uint8_t aQualMask) const;
 	void SetQuality(uint8_t aQuality);
 
 	void SetQualityValue(uint8_t aFlag);
@@ -182,43 +193,48 @@ public:
 	}
 
 protected:
-	//BoolDataPoint(const BoolDataPoint& arRHS);
-	BoolDataPoint(uint8_t aQuality, DataTypes aType, uint8_t aValueMask);
+	BoolDataPoint(uint8_t aQuality);
 
 private:
 	BoolDataPoint();
-	// bool data points store their value as a bit in the quality field
-	uint8_t mValueMask;
 };
 
+// bool data points keep their value apart from the other quality bits, but report it in the quality
 inline void BoolDataPoint::SetValue(bool aValue)
 {
-	mQuality = (aValue) ? (mQuality | mValueMask) : (mQuality & (~mValueMask));
+	mValue = aValue;
 }
 inline bool BoolDataPoint::GetValue() const
 {
-	return (mQuality & mValueMask) != 0;
+	return mValue;
 }
 
 inline uint8_t BoolDataPoint::GetQuality() const
 {
-	return mQuality;
+	return mValue ? (mQuality | STATE_MASK) : mQuality;
+}
+
+inline bool BoolDataPoint::CheckQualityBit(uint8_t aQualMask) const
+{
+	return (aQualMask & GetQuality()) != 0;
 }
 
 inline void BoolDataPoint::SetQualityValue(uint8_t aFlag)
 {
-	mQuality = aFlag;
+	mValue = (aFlag & STATE_MASK) != 0;
+	mQuality = aFlag & ~STATE_MASK;
 }
 
 inline void BoolDataPoint::SetQuality(uint8_t aQuality)
 {
-	mQuality = (mQuality & (mValueMask));
-	mQuality |= aQuality;
+	// a state bit in the quality sets the value, it never clears it
+	if(aQuality & STATE_MASK) mValue = true;
+	mQuality = aQuality & ~STATE_MASK;
 }
 
 inline bool BoolDataPoint::ShouldGenerateEvent(const BoolDataPoint& arRHS, double /*aDeadband*/, uint32_t /*aLastReportedVal*/) const
 {
-	return mQuality != arRHS.mQuality;
+	return mValue != arRHS.mValue || mQuality != arRHS.mQuality;
 }
 
 template <class T>
@@ -243,15 +259,15 @@ bool ExceedsDeadband<double>(const double& val1, const double& val2, double aDea
 
 /// Common subclass to analogs and counters
 template <class T>
-class TypedDataPoint : public DataPoint
+class TypedDataPoint : public DataPoint<T>
 {
 public:
 
 	T GetValue() const {
-		return mValue;
+		return this->mValue;
 	}
 	void SetValue(T aValue) {
-		mValue = aValue;
+		this->mValue = aValue;
 	}
 
 	bool ShouldGenerateEvent(const TypedDataPoint<T>& arRHS, double aDeadband, T aLastReportedVal) const;
@@ -266,13 +282,11 @@ public:
 #endif
 
 	bool operator==(const TypedDataPoint<T>& rhs) {
-		return GetValue() == rhs.GetValue() && GetQuality() == rhs.GetQuality();
+		return GetValue() == rhs.GetValue() && this->GetQuality() == rhs.GetQuality();
 	}
 
 protected:
-	// IntDataPoints have seperate fields for quality and value
-	TypedDataPoint(uint8_t aQuality, DataTypes aType);
-	T mValue;
+	TypedDataPoint(uint8_t aQuality);
 
 private:
 	TypedDataPoint();
@@ -285,9 +299,8 @@ template <class T>
 const T TypedDataPoint<T>::MIN_VALUE = MaxMinWrapper<T>::Min();
 
 template <class T>
-TypedDataPoint<T>::TypedDataPoint(uint8_t aQuality, DataTypes aType) :
-	DataPoint(aQuality, aType),
-	mValue(0)
+TypedDataPoint<T>::TypedDataPoint(uint8_t aQuality) :
+	DataPoint<T>(aQuality)
 {
 
 }
@@ -295,7 +308,7 @@ TypedDataPoint<T>::TypedDataPoint(uint8_t aQuality, DataTypes aType) :
 template <class T>
 bool TypedDataPoint<T>::ShouldGenerateEvent(const TypedDataPoint<T>& arRHS, double aDeadband, T aLastReportedVal) const
 {
-	if (mQuality != arRHS.mQuality)	return true;
+	if (this->mQuality != arRHS.mQuality)	return true;
 
 	return ExceedsDeadband<T>(arRHS.GetValue(), aLastReportedVal, aDeadband);
 }
@@ -305,7 +318,7 @@ template <class T>
 std::string TypedDataPoint<T>::ToString() const
 {
 	std::ostringstream oss;
-	oss << "Value: " << GetValue() << " Quality: " << static_cast<int>(GetQuality());
+	oss << "Value: " << GetValue() << " Quality: " << static_cast<int>(this->GetQuality());
 	return oss.str();
 }
 #endif
@@ -0,0 +1,61 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __COMMAND_BATCH_H_
+#define __COMMAND_BATCH_H_
+
+#include "CommandResponse.h"
+
+#include <functional>
+#include <stddef.h>
+#include <vector>
+
+namespace opendnp3
+{
+
+/**
+* A command and the index it is addressed to, one element of a command batch
+*/
+template <class T>
+struct IndexedCommand {
+	IndexedCommand(const T& arCommand, size_t aIndex) :
+		mCommand(arCommand),
+		mIndex(aIndex)
+	{}
+
+	/// The command to operate
+	T mCommand;
+
+	/// The index of the command
+	size_t mIndex;
+};
+
+/**
+* Callback for a batch of commands. There is one response for every command, in the
+* same order as the batch.
+*/
+typedef std::function<void (std::vector<CommandResponse>)> BatchCallback;
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
@@ -0,0 +1,53 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __CURRENT_VALUES_H_
+#define __CURRENT_VALUES_H_
+
+#include "DataTypes.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace opendnp3
+{
+
+/**
+* A consistent copy of the latest value of every point a master has received from its
+* outstation, by point index. Indices the outstation hasn't reported hold restart quality.
+*/
+struct CurrentValues {
+
+	CurrentValues() : mVersion(0) {}
+
+	/// Number of transactions the master had applied when the copy was taken
+	uint64_t mVersion;
+
+	std::vector<Binary> mBinary;
+	std::vector<Analog> mAnalog;
+	std::vector<Counter> mCounter;
+	std::vector<ControlStatus> mControlStatus;
+	std::vector<SetpointStatus> mSetpointStatus;
+};
+
+}
+
+#endif
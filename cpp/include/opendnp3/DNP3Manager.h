@@ -31,6 +31,7 @@
 
 #include <string>
 #include <set>
+#include <map>
 #include <stdint.h>
 #include <memory>
 #include <functional>
@@ -38,6 +39,8 @@
 #include "Types.h"
 #include "LogTypes.h"
 #include "DestructorHook.h"
+#include "TransportBackend.h"
+#include "OpenRetryPolicy.h"
 
 #ifndef OPENDNP3_NO_SERIAL
 #include "SerialTypes.h"
@@ -77,6 +80,12 @@ class EventLog;
 class Logger;
 class IChannel;
 class DNP3Channel;
+class BusScheduler;
+class UringService;
+class UDPSocketService;
+class OpenLimiter;
+class DeliveryPool;
+class DecodePool;
 
 /**
 The root class for all dnp3 applications. Used to retrieve communication channels on
@@ -117,47 +126,134 @@ public:
 	*/
 	void Shutdown();
 
+	/**
+	* Limit how many channels can be opening their physical layer at the same time. Channels
+	* over the limit wait their turn, so a mass reconnect after a network outage doesn't
+	* flood the network and the thread pool. Applies to existing and future channels.
+	*
+	* @param aMaxOpens maximum number of concurrent opens, 0 (the default) means unlimited
+	*/
+	void SetMaxConcurrentOpens(size_t aMaxOpens);
+
+	/// @return the number of channels currently opening their physical layer
+	size_t GetNumOpensInFlight();
+
+	/// @return the number of channels waiting for their turn to open
+	size_t GetNumOpensWaiting();
+
+	/**
+	* Set the number of threads that pass measurements to the observers of masters configured
+	* with a delivery queue (see MasterStackConfig::delivery). The threads start when the first
+	* measurement is queued and make the same start and exit callbacks as the thread pool.
+	*
+	* @param aThreads number of delivery threads, defaults to 1. Raising it takes effect immediately, lowering it doesn't stop running threads.
+	*/
+	void SetDeliveryConcurrency(size_t aThreads);
+
+	/**
+	* Set the number of threads that decode data responses for masters configured with
+	* MasterConfig::OffloadDecode. The threads start when the first response is handed to them
+	* and make the same start and exit callbacks as the thread pool.
+	*
+	* @param aThreads number of decode threads, defaults to the number of hardware threads. Raising it takes effect immediately, lowering it doesn't stop running threads.
+	*/
+	void SetDecodeConcurrency(size_t aThreads);
+
 	/**
 	* Add a tcp client channel
 	*
 	* @param arLoggerId name that will be used in all log messages
 	* @param aLevel lowest log level of all messages
-	* @param aOpenRetry connection retry interval on failure in milliseconds
+	* @param arOpenRetry connection retry interval on failure in milliseconds, or a policy with backoff and jitter
 	* @param arHost IP address of remote outstation (i.e. 127.0.0.1 or www.google.com)
 	* @param aPort Port of remote outstation is listening on
+	* @param aBackend I/O implementation used by the channel
 	*/
-	IChannel* AddTCPClient(const std::string& arLoggerId, FilterLevel aLevel, millis_t aOpenRetry, const std::string& arHost, uint16_t aPort);
+	IChannel* AddTCPClient(const std::string& arLoggerId, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, const std::string& arHost, uint16_t aPort, TransportBackend aBackend = TB_ASIO);
 
 	/**
 	* Add a tcp server channel
 	*
 	* @param arLoggerId name that will be used in all log messages
 	* @param aLevel lowest log level of all messages
-	* @param aOpenRetry connection retry interval on bind failure in milliseconds
+	* @param arOpenRetry connection retry interval on bind failure in milliseconds, or a policy with backoff and jitter
 	* @param arEndpoint Network adapter to listen on, i.e. 127.0.0.1 or 0.0.0.0
 	* @param aPort Port to listen on
+	* @param aBackend I/O implementation used by the channel
+	*/
+	IChannel* AddTCPServer(const std::string& arLoggerId, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, const std::string& arEndpoint, uint16_t aPort, TransportBackend aBackend = TB_ASIO);
+
+	/**
+	* Add a UDP channel to one remote endpoint. Channels with the same local endpoint
+	* share a single socket, so polling many outstations doesn't need a socket or a
+	* connection per outstation. Received datagrams are routed to the channel registered
+	* for the sender's endpoint.
+	*
+	* @param arLoggerId name that will be used in all log messages
+	* @param aLevel lowest log level of all messages
+	* @param arOpenRetry retry interval in milliseconds if the local endpoint can't be bound, or a policy with backoff and jitter
+	* @param arLocalEndpoint Network adapter to bind, i.e. 127.0.0.1 or 0.0.0.0
+	* @param aLocalPort Port to bind
+	* @param arRemoteAddress IP address of the remote device
+	* @param aRemotePort Port of the remote device
+	* @param aLinkAddress Outstation link address used to tell apart channels that share a remote
+	*        endpoint, matched against the source or destination of each frame. -1 routes on the endpoint alone.
+	*/
+	IChannel* AddUDPChannel(const std::string& arLoggerId, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, const std::string& arLocalEndpoint, uint16_t aLocalPort, const std::string& arRemoteAddress, uint16_t aRemotePort, int32_t aLinkAddress = -1);
+
+	/**
+	* Add a shared memory server channel for a master or outstation in another
+	* process or thread on the same host. The server creates the named segment and
+	* the open completes once a client attaches. Requires a Linux build.
+	*
+	* @param arLoggerId name that will be used in all log messages
+	* @param aLevel lowest log level of all messages
+	* @param arOpenRetry retry interval in milliseconds if the segment can't be created, or a policy with backoff and jitter
+	* @param arSegment name of the shared memory segment
+	* @param aCapacity bytes buffered in each direction, rounded up to a power of two
 	*/
-	IChannel* AddTCPServer(const std::string& arLoggerId, FilterLevel aLevel, millis_t aOpenRetry, const std::string& arEndpoint, uint16_t aPort);
+	IChannel* AddSharedMemoryServer(const std::string& arLoggerId, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, const std::string& arSegment, size_t aCapacity = 65536);
+
+	/**
+	* Add a shared memory client channel that attaches to a segment created by AddSharedMemoryServer
+	*
+	* @param arLoggerId name that will be used in all log messages
+	* @param aLevel lowest log level of all messages
+	* @param arOpenRetry retry interval in milliseconds while no server is listening, or a policy with backoff and jitter
+	* @param arSegment name of the shared memory segment
+	*/
+	IChannel* AddSharedMemoryClient(const std::string& arLoggerId, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, const std::string& arSegment);
 
 #ifndef OPENDNP3_NO_SERIAL
 	/**
 	* Add a serial channel
 	* @param arLoggerId name that will be used in all log messages
 	* @param aLevel lowest log level of all messages
-	* @param aOpenRetry connection retry interval on open failure in milliseconds
+	* @param arOpenRetry connection retry interval on open failure in milliseconds, or a policy with backoff and jitter
 	* @param aSettings settings object that fully parameterizes the serial port
 	*/
-	IChannel* AddSerial(const std::string& arLoggerId, FilterLevel aLevel, millis_t aOpenRetry, SerialSettings aSettings);
+	IChannel* AddSerial(const std::string& arLoggerId, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, SerialSettings aSettings);
 #endif
 
 private:
 
 	void OnChannelShutdownCallback(DNP3Channel* apChannel);
 
-	IChannel* CreateChannel(Logger* apLogger, millis_t aOpenRetry, IPhysicalLayerAsync* apPhys);
+	IChannel* CreateChannel(Logger* apLogger, const OpenRetryPolicy& arOpenRetry, IPhysicalLayerAsync* apPhys, BusScheduler* apScheduler = NULL);
+
+	// the ring shared by all io_uring channels, created on first use
+	UringService* GetUringService();
+
+	// the socket shared by all UDP channels on a local endpoint, created on first use
+	UDPSocketService* GetUDPService(const std::string& arEndpoint, uint16_t aPort);
 
 	std::auto_ptr<EventLog> mpLog;
 	std::auto_ptr<IOServiceThreadPool> mpThreadPool;
+	std::shared_ptr<OpenLimiter> mpOpenLimiter;
+	std::shared_ptr<DeliveryPool> mpDeliveryPool;
+	std::shared_ptr<DecodePool> mpDecodePool;
+	std::shared_ptr<UringService> mpUringService; // shared_ptr so the type can stay incomplete here
+	std::map<std::string, std::shared_ptr<UDPSocketService>> mUDPServices;
 	std::set<DNP3Channel*> mChannels;
 };
 
@@ -42,11 +42,11 @@ namespace opendnp3
 class Binary : public BoolDataPoint
 {
 public:
-	Binary(bool aValue, uint8_t aQuality = BQ_RESTART) : BoolDataPoint(BQ_RESTART, DT_BINARY, BQ_STATE) {
+	Binary(bool aValue, uint8_t aQuality = BQ_RESTART) : BoolDataPoint(BQ_RESTART) {
 		SetQuality(aQuality);
 		SetValue(aValue);
 	}
-	Binary() : BoolDataPoint(BQ_RESTART, DT_BINARY, BQ_STATE) {}
+	Binary() : BoolDataPoint(BQ_RESTART) {}
 
 	typedef bool ValueType;
 	typedef BinaryQuality QualityType;
@@ -54,6 +54,10 @@ public:
 	// Describes the static data type of the measurement as an enum
 	static const DataTypes MeasEnum = DT_BINARY;
 
+	DataTypes GetType() const {
+		return MeasEnum;
+	}
+
 	static const int ONLINE = BQ_ONLINE;
 
 	operator ValueType() const {
@@ -74,18 +78,22 @@ class ControlStatus : public BoolDataPoint
 {
 public:
 
-	ControlStatus(bool aValue, uint8_t aQuality = TQ_RESTART) : BoolDataPoint(TQ_RESTART, DT_CONTROL_STATUS, TQ_STATE) {
+	ControlStatus(bool aValue, uint8_t aQuality = TQ_RESTART) : BoolDataPoint(TQ_RESTART) {
 		SetValue(aValue);
 		SetQuality(aQuality);
 	}
 
-	ControlStatus() : BoolDataPoint(TQ_RESTART, DT_CONTROL_STATUS, TQ_STATE) {}
+	ControlStatus() : BoolDataPoint(TQ_RESTART) {}
 
 	typedef bool ValueType;
 	typedef ControlQuality QualityType;
 
 	static const DataTypes MeasEnum = DT_CONTROL_STATUS;
 
+	DataTypes GetType() const {
+		return MeasEnum;
+	}
+
 	static const int ONLINE = TQ_ONLINE;
 
 	operator ValueType() const {
@@ -105,9 +113,9 @@ public:
 class Analog : public TypedDataPoint<double>
 {
 public:
-	Analog() : TypedDataPoint<double>(AQ_RESTART, DT_ANALOG) {}
+	Analog() : TypedDataPoint<double>(AQ_RESTART) {}
 
-	Analog(double aVal, uint8_t aQuality = AQ_RESTART) : TypedDataPoint<double>(AQ_RESTART, DT_ANALOG) {
+	Analog(double aVal, uint8_t aQuality = AQ_RESTART) : TypedDataPoint<double>(AQ_RESTART) {
 		SetValue(aVal);
 		SetQuality(aQuality);
 	}
@@ -118,6 +126,10 @@ public:
 
 	static const DataTypes MeasEnum = DT_ANALOG;
 
+	DataTypes GetType() const {
+		return MeasEnum;
+	}
+
 	static const int ONLINE = AQ_ONLINE;
 
 	operator ValueType() const {
@@ -138,8 +150,8 @@ public:
 class Counter : public TypedDataPoint<uint32_t>
 {
 public:
-	Counter() : TypedDataPoint<uint32_t>(CQ_RESTART, DT_COUNTER) {}
-	Counter(uint32_t aVal, uint8_t aQuality = CQ_RESTART) : TypedDataPoint<uint32_t>(CQ_RESTART, DT_COUNTER) {
+	Counter() : TypedDataPoint<uint32_t>(CQ_RESTART) {}
+	Counter(uint32_t aVal, uint8_t aQuality = CQ_RESTART) : TypedDataPoint<uint32_t>(CQ_RESTART) {
 		SetValue(aVal);
 		SetQuality(aQuality);
 	}
@@ -151,6 +163,10 @@ public:
 
 	static const DataTypes MeasEnum = DT_COUNTER;
 
+	DataTypes GetType() const {
+		return MeasEnum;
+	}
+
 	operator ValueType() const {
 		return this->GetValue();
 	}
@@ -167,8 +183,8 @@ public:
 class SetpointStatus : public TypedDataPoint<double>
 {
 public:
-	SetpointStatus() : TypedDataPoint<double>(PQ_RESTART, DT_SETPOINT_STATUS) {}
-	SetpointStatus(double aVal, uint8_t aQuality = PQ_RESTART) : TypedDataPoint<double>(PQ_RESTART, DT_SETPOINT_STATUS) {
+	SetpointStatus() : TypedDataPoint<double>(PQ_RESTART) {}
+	SetpointStatus(double aVal, uint8_t aQuality = PQ_RESTART) : TypedDataPoint<double>(PQ_RESTART) {
 		SetValue(aVal);
 		SetQuality(aQuality);
 	}
@@ -180,6 +196,10 @@ public:
 
 	static const DataTypes MeasEnum = DT_SETPOINT_STATUS;
 
+	DataTypes GetType() const {
+		return MeasEnum;
+	}
+
 	operator ValueType() const {
 		return this->GetValue();
 	}
@@ -0,0 +1,58 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __DELIVERY_CONFIG_H_
+#define __DELIVERY_CONFIG_H_
+
+#include <stddef.h>
+
+namespace opendnp3
+{
+
+/// What a full delivery queue does with new measurements
+enum DeliveryPolicy {
+	DP_BLOCK,		// the stack waits for the observer to catch up, nothing is lost
+	DP_DROP_OLDEST,	// the oldest queued measurements are discarded
+	DP_CONFLATE		// a queued measurement is replaced by a newer one for the same point, the oldest are discarded if it is still full
+};
+
+/** Configuration of the optional delivery queue
+
+When a capacity is provided, the master queues decoded measurements instead of calling the
+IDataObserver on the channel's thread. The manager's delivery threads pass them to the observer,
+so a slow observer can't stall link keep alives, application timers, or other stacks sharing
+the thread. Each batch a delivery thread takes is delivered as one transaction.
+*/
+struct DeliveryConfig {
+	DeliveryConfig() : mCapacity(0), mPolicy(DP_BLOCK) {}
+
+	DeliveryConfig(size_t aCapacity, DeliveryPolicy aPolicy = DP_BLOCK) : mCapacity(aCapacity), mPolicy(aPolicy) {}
+
+	/// Maximum number of queued measurements, 0 disables the queue
+	size_t mCapacity;
+
+	/// What happens to new measurements when the queue is full
+	DeliveryPolicy mPolicy;
+};
+
+}
+
+#endif
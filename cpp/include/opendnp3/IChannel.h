@@ -34,6 +34,8 @@
 #include "LogTypes.h"
 #include "ChannelStates.h"
 #include "DestructorHook.h"
+#include "OpenRetryPolicy.h"
+#include "Statistics.h"
 
 #include <functional>
 
@@ -87,6 +89,28 @@ public:
 	*/
 	virtual void AddStateListener(std::function<void (ChannelState)> aListener) = 0;
 
+	/**
+	* The fraction of time the bus was occupied since the previous call, estimated by charging every byte
+	* written or read with its transmission time at the configured baud rate. Always 0 for non-serial channels.
+	*
+	* @return utilization between 0 and 1
+	*/
+	virtual double GetBusUtilization() = 0;
+
+	/**
+	* Counters for the channel's attempts to open its physical layer. Safe to call from any thread.
+	*
+	* @return a snapshot of the counters
+	*/
+	virtual OpenStatistics GetOpenStatistics() = 0;
+
+	/**
+	* Frame, byte and error counters for the channel's link router. Safe to call from any thread.
+	*
+	* @return a snapshot of the counters
+	*/
+	virtual ChannelStatistics GetStatistics() = 0;
+
 #ifndef OPENDNP3_NO_MASTER
 
 	/**
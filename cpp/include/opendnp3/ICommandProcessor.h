@@ -31,9 +31,11 @@
 
 #include "AnalogOutput.h"
 #include "ControlRelayOutputBlock.h"
+#include "CommandBatch.h"
 #include "CommandResponse.h"
 
 #include <functional>
+#include <vector>
 
 namespace opendnp3
 {
@@ -124,6 +126,83 @@ public:
 	* @param aCallback callback that will be invoked upon completion or failure
 	*/
 	virtual void DirectOperate(const AnalogOutputDouble64& arCommand, size_t aIndex, std::function<void (CommandResponse)> aCallback) = 0;
+
+	/*
+	* Batches pack commands of the same type into as few multi-object requests as the
+	* fragment size allows, so the outstation must be configured to accept more than one
+	* control per request (SlaveConfig::mMaxControls). Commands that were never sent because
+	* the batch was aborted respond with CS_UNDEFINED.
+	*/
+
+	/**
+	* Select and operate a batch of ControlRelayOutputBlocks
+	* @param arCommands commands to operate and their indices
+	* @param aCallback callback that will be invoked once with the responses to all of the commands
+	*/
+	virtual void SelectAndOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback) = 0;
+
+	/**
+	* Direct operate a batch of ControlRelayOutputBlocks
+	* @param arCommands commands to operate and their indices
+	* @param aCallback callback that will be invoked once with the responses to all of the commands
+	*/
+	virtual void DirectOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback) = 0;
+
+	/**
+	* Select and operate a batch of 16 bit analog outputs
+	* @param arCommands commands to operate and their indices
+	* @param aCallback callback that will be invoked once with the responses to all of the commands
+	*/
+	virtual void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback) = 0;
+
+	/**
+	* Direct operate a batch of 16 bit analog outputs
+	* @param arCommands commands to operate and their indices
+	* @param aCallback callback that will be invoked once with the responses to all of the commands
+	*/
+	virtual void DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback) = 0;
+
+	/**
+	* Select and operate a batch of 32 bit analog outputs
+	* @param arCommands commands to operate and their indices
+	* @param aCallback callback that will be invoked once with the responses to all of the commands
+	*/
+	virtual void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback) = 0;
+
+	/**
+	* Direct operate a batch of 32 bit analog outputs
+	* @param arCommands commands to operate and their indices
+	* @param aCallback callback that will be invoked once with the responses to all of the commands
+	*/
+	virtual void DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback) = 0;
+
+	/**
+	* Select and operate a batch of single precision analog outputs
+	* @param arCommands commands to operate and their indices
+	* @param aCallback callback that will be invoked once with the responses to all of the commands
+	*/
+	virtual void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback) = 0;
+
+	/**
+	* Direct operate a batch of single precision analog outputs
+	* @param arCommands commands to operate and their indices
+	* @param aCallback callback that will be invoked once with the responses to all of the commands
+	*/
+	virtual void DirectOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback) = 0;
+
+	/**
+	* Select and operate a batch of double precision analog outputs
+	* @param arCommands commands to operate and their indices
+	* @param aCallback callback that will be invoked once with the responses to all of the commands
+	*/
+	virtual void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback) = 0;
+
+	/**
+	* Direct operate a batch of double precision analog outputs
+	* @param arCommands commands to operate and their indices
+	* @param aCallback callback that will be invoked once with the responses to all of the commands
+	*/
+	virtual void DirectOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback) = 0;
 };
 
 }
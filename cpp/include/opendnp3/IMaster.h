@@ -29,6 +29,7 @@
 #define __I_MASTER_H_
 
 #include "IStack.h"
+#include "CurrentValues.h"
 
 namespace opendnp3
 {
@@ -53,6 +54,14 @@ public:
     * @return Interface used to invoke commands
     */
     virtual ICommandProcessor* GetCommandProcessor() = 0;
+
+    /**
+    * Copy the latest value of every point received from the outstation. Can be called from
+    * any thread and never blocks the master.
+    * @param arValues Receives a consistent snapshot, taken between two transactions
+    * @return False if the current value table isn't enabled in the MasterConfig
+    */
+    virtual bool ReadCurrentValues(CurrentValues& arValues) = 0;
 };
 
 }
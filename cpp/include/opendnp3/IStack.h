@@ -35,6 +35,8 @@
 #include "VtoRouterSettings.h"
 #include "DestructorHook.h"
 #include "StackState.h"
+#include "Statistics.h"
+#include "LatencyStatistics.h"
 
 namespace boost
 {
@@ -95,6 +97,21 @@ public:
 	*/
 	virtual void AddStateListener(std::function<void (StackState)> aListener) = 0;
 
+	/**
+	* Counters for the stack's link, transport and application layers. Safe to call from any thread.
+	*
+	* @return a snapshot of the counters
+	*/
+	virtual StackStatistics GetStatistics() = 0;
+
+	/**
+	* Per stage latencies of the fragments the stack has sent and received. Only recorded when the
+	* library is built with OPENDNP3_LATENCY_TRACE. Safe to call from any thread.
+	*
+	* @return a snapshot of the latency histograms
+	*/
+	virtual LatencyStatistics GetLatencyStatistics() = 0;
+
 	/// Synchronously shutdown the endpoint
 	virtual void Shutdown() = 0;
 
@@ -0,0 +1,109 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __LATENCY_STATISTICS_H_
+#define __LATENCY_STATISTICS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace opendnp3
+{
+
+/**
+* The stages an application fragment is timed through. Transmit stages end at the write
+* completion of the physical layer, receive stages start at the read completion.
+*/
+enum LatencyStage {
+	LS_TX_QUEUE,		///< From being queued in the application layer to being handed to the transport layer
+	LS_TX_SEGMENT,		///< From the transport layer to the last segment reaching the router, including link confirms of earlier segments
+	LS_TX_LINK_QUEUE,	///< From a frame reaching the router to the start of its physical write
+	LS_TX_WIRE,			///< The physical write of a frame
+	LS_TX_TOTAL,		///< From being queued in the application layer to the write completion of the last segment
+	LS_RX_REASSEMBLY,	///< From the read of the first segment to the transport layer completing the fragment
+	LS_RX_DISPATCH,		///< Application layer handling of a fragment, including building any response
+	LS_POLL_ROUND_TRIP,	///< Masters only, from starting an integrity or event poll to handling its final response
+	LS_NUM_STAGES
+};
+
+/**
+* Histogram of the latencies recorded for one stage, in power of two buckets of microseconds.
+* Bucket 0 counts latencies below 1 microsecond and bucket i counts latencies in [2^(i-1), 2^i)
+* microseconds. The last bucket also counts everything above it.
+*/
+struct StageLatency {
+
+	static const size_t NUM_BUCKETS = 32;
+
+	StageLatency() :
+		mNumSamples(0),
+		mTotalMicros(0),
+		mMaxMicros(0) {
+		std::fill(mBuckets, mBuckets + NUM_BUCKETS, 0);
+	}
+
+	uint64_t MeanMicros() const {
+		return (mNumSamples == 0) ? 0 : mTotalMicros / mNumSamples;
+	}
+
+	/**
+	* @param aFraction Fraction of the samples between 0 and 1, i.e. 0.99 for the 99th percentile
+	* @return a bound in microseconds that the given fraction of the samples do not exceed, at the resolution of the buckets
+	*/
+	uint64_t PercentileMicros(double aFraction) const {
+		if(mNumSamples == 0) return 0;
+		uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(aFraction * mNumSamples)));
+		uint64_t count = 0;
+		for(size_t i = 0; i < NUM_BUCKETS; ++i) {
+			count += mBuckets[i];
+			if(count >= target) return std::min(static_cast<uint64_t>(1) << i, mMaxMicros);
+		}
+		return mMaxMicros;
+	}
+
+	uint64_t mBuckets[NUM_BUCKETS];
+	uint64_t mNumSamples;
+	uint64_t mTotalMicros;
+	uint64_t mMaxMicros;
+};
+
+/**
+* Per stage latencies of the fragments sent and received by a master or an outstation since the
+* stack was created. Tracing is only available when the library is built with
+* OPENDNP3_LATENCY_TRACE, otherwise every stage is empty.
+*/
+struct LatencyStatistics {
+
+	LatencyStatistics() : mEnabled(false)
+	{}
+
+	/// True if the library was built with latency tracing
+	bool mEnabled;
+
+	/// Indexed by LatencyStage
+	StageLatency mStages[LS_NUM_STAGES];
+};
+
+}
+
+#endif
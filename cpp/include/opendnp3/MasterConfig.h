@@ -54,7 +54,12 @@ struct MasterConfig {
 		EnableUnsol(true),
 		UnsolClassMask(PC_ALL_EVENTS),
 		IntegrityRate(5000),
-		TaskRetryRate(5000)
+		TaskRetryRate(5000),
+		CommandDeadline(-1),
+		PollAgingRate(-1),
+		UseCurrentValueTable(false),
+		PublishChangesOnly(false),
+		OffloadDecode(false)
 	{}
 
 	/** Adds a periodic exception scan to the configuration
@@ -67,6 +72,17 @@ struct MasterConfig {
 		mScans.push_back(ex);
 	}
 
+	/** Adds an exception scan whose period adapts to how much event data the outstation has
+
+		@param aClassMask	Bitwise mask representing the classes to scan
+		@param aMinPeriod	Shortest period of the scan in milliseconds, used while the outstation reports more data
+		@param aMaxPeriod	Longest period of the scan in milliseconds, reached while responses are empty
+	*/
+	void AddAdaptiveExceptionScan(int aClassMask, millis_t aMinPeriod, millis_t aMaxPeriod) {
+		ExceptionScan ex(aClassMask, aMinPeriod, aMaxPeriod);
+		mScans.push_back(ex);
+	}
+
 	/// Maximum fragment size to use for requests
 	size_t FragSize;
 
@@ -94,6 +110,26 @@ struct MasterConfig {
 	/// Time delay between task retries
 	millis_t TaskRetryRate;
 
+	/// Maximum delay in milliseconds between queueing a command and sending it, -1 for none. Commands with a deadline are sent ahead of any queued polls.
+	millis_t CommandDeadline;
+
+	/// Polls waiting to run gain one level of priority for every period of this many milliseconds so they can't be starved, -1 to disable
+	millis_t PollAgingRate;
+
+	/// If true, the master keeps the latest value of every point it receives so any thread can read them with IMaster::ReadCurrentValues
+	bool UseCurrentValueTable;
+
+	/// If true, static values that match the last value, quality and time published for the point aren't published again. Events are always published.
+	bool PublishChangesOnly;
+
+	/**
+	* If true, data responses are decoded and published on the manager's decode threads (see DNP3Manager::SetDecodeConcurrency)
+	* while the channel carries on with confirms and requests. Measurements still reach the observer in the order they arrived,
+	* but may do so after the poll that requested them has completed. With PublishChangesOnly, StackStatistics::mPollSuppressedPoints
+	* covers the last poll whose final fragment the decode threads have published.
+	*/
+	bool OffloadDecode;
+
 	/// vector that holds exception scans
 	std::vector<ExceptionScan> mScans;
 };
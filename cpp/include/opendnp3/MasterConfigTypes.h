@@ -29,6 +29,7 @@
 #ifndef __EXCEPTION_SCAN_H_
 #define __EXCEPTION_SCAN_H_
 
+#include "PointClass.h"
 #include "Types.h"
 
 namespace  opendnp3
@@ -42,19 +43,36 @@ struct ExceptionScan {
 	/// Defaults to all events every 5 seconds
 	ExceptionScan() :
 		ClassMask(PC_ALL_EVENTS),
-		ScanRate(5000)
+		ScanRate(5000),
+		MaxScanRate(-1)
 	{}
 
 	ExceptionScan(int aClassMask, millis_t aScanRate) :
 		ClassMask(aClassMask),
-		ScanRate(aScanRate)
+		ScanRate(aScanRate),
+		MaxScanRate(-1)
 	{}
 
+	ExceptionScan(int aClassMask, millis_t aMinScanRate, millis_t aMaxScanRate) :
+		ClassMask(aClassMask),
+		ScanRate(aMinScanRate),
+		MaxScanRate(aMaxScanRate)
+	{}
+
+	/// @return true if the period adapts between ScanRate and MaxScanRate
+	bool IsAdaptive() const {
+		return ScanRate >= 0 && MaxScanRate > ScanRate;
+	}
+
 	/// Bitmask for which classes will be scanned
 	int ClassMask;
 
-	/// Scan period in milliseconds
+	/// Scan period in milliseconds, the shortest period of an adaptive scan
 	millis_t ScanRate;
+
+	/// If greater than ScanRate, the period doubles up to this many milliseconds while
+	/// responses are empty and halves back toward ScanRate while the outstation has more data
+	millis_t MaxScanRate;
 };
 
 }
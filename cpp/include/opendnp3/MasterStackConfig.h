@@ -32,6 +32,7 @@
 #include "MasterConfig.h"
 #include "AppConfig.h"
 #include "LinkConfig.h"
+#include "DeliveryConfig.h"
 
 namespace opendnp3
 {
@@ -53,6 +54,9 @@ struct MasterStackConfig {
 	/// Link layer config
 	LinkConfig link;
 
+	/// Optional queue between the master and its IDataObserver
+	DeliveryConfig delivery;
+
 
 };
 
@@ -0,0 +1,90 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __OPEN_RETRY_POLICY_H_
+#define __OPEN_RETRY_POLICY_H_
+
+#include "Types.h"
+
+#include <stdint.h>
+
+namespace opendnp3
+{
+
+/**
+* Controls how long a channel waits before retrying a failed open. Every failure multiplies
+* the delay by the backoff factor, up to the maximum, and a successful open resets it to the
+* minimum. Jitter shortens each delay by a random fraction so that channels that failed
+* together don't all retry at the same instant.
+*/
+struct OpenRetryPolicy {
+
+	/// A fixed retry period with no backoff or jitter, the behavior of a plain millisecond value
+	OpenRetryPolicy(millis_t aRetry) :
+		mMinRetry(aRetry),
+		mMaxRetry(aRetry),
+		mBackoffFactor(1.0),
+		mJitter(0.0)
+	{}
+
+	OpenRetryPolicy(millis_t aMinRetry, millis_t aMaxRetry, double aBackoffFactor = 2.0, double aJitter = 0.5) :
+		mMinRetry(aMinRetry),
+		mMaxRetry(aMaxRetry),
+		mBackoffFactor(aBackoffFactor),
+		mJitter(aJitter)
+	{}
+
+	/// Delay in milliseconds after the first failure
+	millis_t mMinRetry;
+	/// Upper bound on the delay in milliseconds
+	millis_t mMaxRetry;
+	/// Multiplier applied to the delay after each consecutive failure, usually 2
+	double mBackoffFactor;
+	/// Largest fraction of a delay removed at random, between 0 (none) and 1 (anywhere from 0 to the delay)
+	double mJitter;
+};
+
+/// Counters describing the open attempts made by a channel
+struct OpenStatistics {
+
+	OpenStatistics() :
+		mNumAttempts(0),
+		mNumSuccess(0),
+		mNumFailure(0),
+		mNumDeferred(0),
+		mCurrentRetry(0)
+	{}
+
+	/// Number of times the physical layer was asked to open
+	uint64_t mNumAttempts;
+	/// Number of attempts that opened the physical layer
+	uint64_t mNumSuccess;
+	/// Number of attempts that failed
+	uint64_t mNumFailure;
+	/// Number of opens that had to wait because too many other channels were opening
+	uint64_t mNumDeferred;
+	/// Delay in milliseconds that will be used after the next failure, before jitter
+	millis_t mCurrentRetry;
+};
+
+}
+
+#endif
@@ -77,6 +77,9 @@ struct SerialSettings {
 	FlowType mFlowType;
 };
 
+/// @return the number of bits on the wire for every byte, including the start, parity, and stop bits
+int GetBitsPerCharacter(const SerialSettings& arSettings);
+
 }
 
 #endif
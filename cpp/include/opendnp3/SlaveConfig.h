@@ -30,6 +30,7 @@
 #define __SLAVE_CONFIG_H_
 
 #include <assert.h>
+#include <string>
 
 #include "Exception.h"
 #include "ClassMask.h"
@@ -58,6 +59,55 @@ struct EventMaxConfig {
 	size_t mMaxVtoEvents;
 };
 
+/// Controls when the event journal forces its dirty pages to disk
+enum JournalSyncPolicy {
+	JSP_NONE,		// never msync, the journal survives a process crash but not a power loss
+	JSP_BATCHED,	// msync after every mSyncBatch journal mutations
+	JSP_ALWAYS		// msync after every journal mutation
+};
+
+/** Configuration of the optional persistent event journal
+
+When a path is provided, every buffered binary, analog, and counter event is also recorded in
+an append-only memory-mapped ring file. Events are released from the file when the master
+confirms them, and any unconfirmed events are reloaded into the event buffer at startup.
+*/
+struct EventJournalConfig {
+	EventJournalConfig();
+
+	EventJournalConfig(const std::string& arPath, size_t aCapacity, JournalSyncPolicy aSyncPolicy = JSP_BATCHED, size_t aSyncBatch = 64);
+
+	/// Path of the journal file, an empty path disables journaling
+	std::string mPath;
+
+	/// The number of event records in the ring, should be at least twice the total of EventMaxConfig
+	size_t mCapacity;
+
+	/// When the journal is synchronized to disk
+	JournalSyncPolicy mSyncPolicy;
+
+	/// The number of mutations between synchronizations when using JSP_BATCHED
+	size_t mSyncBatch;
+};
+
+/** Configuration of the optional database snapshot
+
+When a path is provided, the values, qualities, and timestamps of the static database are
+written to a columnar snapshot file periodically and on shutdown. The snapshot is loaded at
+startup so the first integrity poll reports the last known values instead of restart quality.
+*/
+struct DatabaseSnapshotConfig {
+	DatabaseSnapshotConfig();
+
+	DatabaseSnapshotConfig(const std::string& arPath, millis_t aPeriod = 0);
+
+	/// Path of the snapshot file, an empty path disables snapshots
+	std::string mPath;
+
+	/// How often the snapshot is rewritten in milliseconds ( <= 0 == only on shutdown)
+	millis_t mPeriod;
+};
+
 /** Configuration information for a dnp3 slave (outstation)
 
 Used as both input describing the startup configuration of the slave, and as configuration state of mutable properties (i.e. unsolicited responses).
@@ -89,6 +139,13 @@ struct SlaveConfig {
 	/// The amount of time the slave will wait before sending new unsolicited data ( <= 0 == immediate)
 	millis_t mUnsolPackDelay;
 
+	/// If true, mUnsolPackDelay is ignored and the slave chooses the delay from the recent event
+	/// rate and confirm round trip time, waiting to fill fragments only when events are arriving
+	bool mAdaptiveUnsolPack;
+
+	/// With mAdaptiveUnsolPack, the latency ceiling for an event including half a round trip
+	millis_t mUnsolMaxPackDelay;
+
 	/// How long the slave will wait before retrying an unsuccessful unsol response
 	millis_t mUnsolRetryDelay;
 
@@ -101,9 +158,27 @@ struct SlaveConfig {
 	/// The number of objects to store in the VtoWriter queue.
 	size_t mVtoWriterQueueSize;
 
+	/// When greater than zero, vto data is streamed from a ring of this many bytes per channel
+	/// and cut directly into response fragments instead of being queued as 255 byte events
+	size_t mVtoStreamBufferSize;
+
+	/// How long streamed vto data with no events waits to fill a fragment before it is sent
+	/// unsolicited, never longer than the unsolicited pack delay when that is positive ( <= 0 == immediate)
+	millis_t mVtoPackDelay;
+
+	/// The window of unconfirmed streamed vto data is sized to drain in about this long at the
+	/// measured confirm round trip time ( <= 0 == the smallest window that keeps fragments full)
+	millis_t mVtoWindowDelay;
+
 	/// Structure that defines the maximum number of events to buffer
 	EventMaxConfig mEventMaxConfig;
 
+	/// Structure that defines the optional persistent event journal
+	EventJournalConfig mEventJournal;
+
+	/// Structure that defines the optional database snapshot used for warm starts
+	DatabaseSnapshotConfig mSnapshot;
+
 	// default static response types
 
 	/// The default group/variation to use for static binary responses
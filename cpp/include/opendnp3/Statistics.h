@@ -0,0 +1,147 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __STATISTICS_H_
+#define __STATISTICS_H_
+
+#include <stdint.h>
+
+namespace opendnp3
+{
+
+/**
+* Counters for the traffic on a communication channel. The counters are read as one consistent
+* snapshot and count from the creation of the channel.
+*/
+struct ChannelStatistics {
+
+	ChannelStatistics() :
+		mNumFramesRx(0),
+		mNumFramesTx(0),
+		mNumBytesRx(0),
+		mNumBytesTx(0),
+		mNumCrcErrors(0),
+		mNumResyncs(0),
+		mNumUnknownRoute(0),
+		mTransmitQueueDepth(0)
+	{}
+
+	/// Number of valid link frames received
+	uint64_t mNumFramesRx;
+	/// Number of link frames written to the physical layer
+	uint64_t mNumFramesTx;
+	/// Number of bytes read from the physical layer
+	uint64_t mNumBytesRx;
+	/// Number of bytes written to the physical layer
+	uint64_t mNumBytesTx;
+	/// Number of frames discarded because of a bad header or body CRC
+	uint64_t mNumCrcErrors;
+	/// Number of times the parser discarded a byte to search for the next start of frame
+	uint64_t mNumResyncs;
+	/// Number of frames received for a route without a bound master or outstation
+	uint64_t mNumUnknownRoute;
+	/// Number of frames currently waiting to be written
+	uint64_t mTransmitQueueDepth;
+};
+
+/**
+* Counters for a master or an outstation. The counters are read as one consistent snapshot and
+* count from the creation of the stack.
+*/
+struct StackStatistics {
+
+	StackStatistics() :
+		mNumLinkRetries(0),
+		mNumTransportDrops(0),
+		mNumAppTimeouts(0),
+		mNumUnsolConfirms(0),
+		mNumEventOverflows(0),
+		mSendQueueDepth(0),
+		mEventBufferDepth(0),
+		mVtoBytesPerSecond(0),
+		mVtoWindowBytes(0),
+		mVtoRoundTripMicros(0),
+		mUnsolFillPercent(0),
+		mUnsolPackDelayMillis(0),
+		mNumEventScans(0),
+		mEventScanPeriodMillis(0),
+		mNumSuppressedPoints(0),
+		mPollSuppressedPoints(0),
+		mDeliveryQueueDepth(0),
+		mDeliveryQueueMaxDepth(0),
+		mNumDeliveryDrops(0),
+		mNumDeliveryConflations(0),
+		mNumOffloadedFragments(0),
+		mDecodeBacklog(0),
+		mNumHeldBackFragments(0)
+	{}
+
+	/// Number of confirmed link frames sent again after a missing acknowledgement
+	uint64_t mNumLinkRetries;
+	/// Number of transport segments discarded, along with any partial fragment they belonged to
+	uint64_t mNumTransportDrops;
+	/// Number of application layer responses or confirms that timed out
+	uint64_t mNumAppTimeouts;
+	/// Number of confirms to unsolicited responses, sent by a master or received by an outstation
+	uint64_t mNumUnsolConfirms;
+	/// Number of events an outstation discarded because its event buffers were full
+	uint64_t mNumEventOverflows;
+	/// Number of application fragments waiting to be sent
+	uint64_t mSendQueueDepth;
+	/// Number of events an outstation is holding until they are confirmed
+	uint64_t mEventBufferDepth;
+	/// Streamed vto bytes an outstation had confirmed per second over the last interval of at least a second
+	uint64_t mVtoBytesPerSecond;
+	/// Number of unconfirmed streamed vto bytes an outstation currently lets each channel queue
+	uint64_t mVtoWindowBytes;
+	/// Smoothed time between an outstation sending streamed vto data and its confirm
+	uint64_t mVtoRoundTripMicros;
+	/// Smoothed share of each unsolicited fragment an outstation filled, in percent
+	uint64_t mUnsolFillPercent;
+	/// The delay an outstation last chose before sending new unsolicited data
+	uint64_t mUnsolPackDelayMillis;
+	/// Number of exception scans a master completed
+	uint64_t mNumEventScans;
+	/// Current period of a master's most frequent exception scan, which adaptive scans change with the outstation's load
+	uint64_t mEventScanPeriodMillis;
+	/// Number of unchanged static values a master with MasterConfig::PublishChangesOnly didn't publish
+	uint64_t mNumSuppressedPoints;
+	/// Number of unchanged static values suppressed from a master's last completed poll, or with MasterConfig::OffloadDecode the last poll published in full
+	uint64_t mPollSuppressedPoints;
+	/// Number of measurements waiting in a master's delivery queue
+	uint64_t mDeliveryQueueDepth;
+	/// Most measurements a master's delivery queue has held
+	uint64_t mDeliveryQueueMaxDepth;
+	/// Number of measurements a full delivery queue discarded
+	uint64_t mNumDeliveryDrops;
+	/// Number of queued measurements a conflating delivery queue replaced with a newer value for the same point
+	uint64_t mNumDeliveryConflations;
+	/// Number of response fragments a master handed to the decode threads
+	uint64_t mNumOffloadedFragments;
+	/// Number of fragments handed to the decode threads that haven't been published yet
+	uint64_t mDecodeBacklog;
+	/// Number of fragments that finished decoding before an earlier fragment and waited for it to be published
+	uint64_t mNumHeldBackFragments;
+};
+
+}
+
+#endif
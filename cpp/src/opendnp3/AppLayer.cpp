@@ -40,6 +40,8 @@ AppLayer::AppLayer(Logger* apLogger, IExecutor* apExecutor, AppConfig aAppCfg) :
 	mSending(false),
 	mConfirmSending(false),
 	mpUser(NULL),
+	mpCounters(NULL),
+	mpTrace(NULL),
 	mSolicited(apLogger->GetSubLogger("sol"), this, apExecutor, aAppCfg.RspTimeout),
 	mUnsolicited(apLogger->GetSubLogger("unsol"), this, apExecutor, aAppCfg.RspTimeout),
 	mNumRetry(aAppCfg.NumRetry)
@@ -136,6 +138,8 @@ void AppLayer::_OnReceive(const uint8_t* apBuffer, size_t aSize)
 	catch(const Exception& ex) {
 		EXCEPTION_BLOCK(LEV_WARNING, ex);
 	}
+
+	LATENCY_TRACE(mpTrace, OnApduDispatched(timer_clock::now()));
 }
 
 void AppLayer::_OnLowerLayerUp()
@@ -151,6 +155,8 @@ void AppLayer::_OnLowerLayerDown()
 
 	//reset the transmitter state
 	mSendQueue.erase(mSendQueue.begin(), mSendQueue.end());
+	if(mpCounters) mpCounters->Set(SC_SEND_QUEUE_DEPTH, 0);
+	LATENCY_TRACE(mpTrace, Reset());
 	mSending = false;
 
 	//notify the user
@@ -168,6 +174,7 @@ void AppLayer::OnSendResult(bool aSuccess)
 
 	FunctionCodes func = mSendQueue.front()->GetFunction();
 	mSendQueue.pop_front();
+	if(mpCounters) mpCounters->Set(SC_SEND_QUEUE_DEPTH, mSendQueue.size());
 
 	if(func == FC_CONFIRM) {
 		assert(mConfirmSending);
@@ -243,6 +250,7 @@ void AppLayer::OnConfirm(const AppControlField& arCtrl, APDU& arAPDU)
 			MACRO_THROW_EXCEPTION_WITH_CODE(Exception, "", ALERR_UNEXPECTED_CONFIRM);
 		}
 
+		if(mpCounters) mpCounters->Increment(SC_UNSOL_CONFIRMS);
 		mUnsolicited.OnConfirm(arCtrl.SEQ);
 	}
 	else {
@@ -297,6 +305,7 @@ void AppLayer::QueueConfirm(bool aUnsol, int aSeq)
 
 	mConfirmSending = true;
 	mConfirm.SetControl(true, true, false, aUnsol, aSeq);
+	if(aUnsol && mpCounters) mpCounters->Increment(SC_UNSOL_CONFIRMS);
 
 	this->QueueFrame(mConfirm);
 }
@@ -304,6 +313,8 @@ void AppLayer::QueueConfirm(bool aUnsol, int aSeq)
 void AppLayer::QueueFrame(const APDU& arAPDU)
 {
 	mSendQueue.push_back(&arAPDU);
+	if(mpCounters) mpCounters->Set(SC_SEND_QUEUE_DEPTH, mSendQueue.size());
+	LATENCY_TRACE(mpTrace, OnApduQueued(timer_clock::now()));
 	this->CheckForSend();
 }
 
@@ -313,6 +324,7 @@ void AppLayer::CheckForSend()
 		mSending = true;
 		const APDU* pAPDU = mSendQueue.front();
 		LOG_BLOCK(LEV_INTERPRET, "=> AL " << pAPDU->ToString());
+		LATENCY_TRACE(mpTrace, OnApduSent(timer_clock::now()));
 		mpLowerLayer->Send(pAPDU->GetBuffer(), pAPDU->Size());
 	}
 }
@@ -30,6 +30,8 @@
 #include "AppInterfaces.h"
 #include "SolicitedChannel.h"
 #include "UnsolicitedChannel.h"
+#include "StatisticsCounters.h"
+#include "LatencyTrace.h"
 
 #include <opendnp3/AppConfig.h>
 
@@ -57,6 +59,16 @@ public:
 
 	void SetUser(IAppUser*);
 
+	/// Optional counters for timeouts, confirms and the send queue, owned by the stack
+	void SetCounters(StackCounters* apCounters) {
+		mpCounters = apCounters;
+	}
+
+	/// Optional latency trace, owned by the stack
+	void SetLatencyTrace(LatencyTrace* apTrace) {
+		mpTrace = apTrace;
+	}
+
 	/////////////////////////////////
 	// Implement IAppLayer
 	/////////////////////////////////
@@ -106,6 +118,8 @@ private:
 	SendQueue mSendQueue;				// Buffer of send operations
 
 	IAppUser* mpUser;				// Interface for dispatching callbacks
+	StackCounters* mpCounters;
+	LatencyTrace* mpTrace;
 
 	SolicitedChannel mSolicited;			// Channel used for solicited communications
 	UnsolicitedChannel mUnsolicited;		// Channel used for unsolicited communications
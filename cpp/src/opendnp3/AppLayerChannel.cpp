@@ -142,6 +142,7 @@ void AppLayerChannel::ChangeState(ACS_Base* apState)
 void AppLayerChannel::Timeout()
 {
 	mpTimer = NULL;
+	if(mpAppLayer->mpCounters) mpAppLayer->mpCounters->Increment(SC_APP_TIMEOUTS);
 	mpState->OnTimeout(this);
 }
 
@@ -34,6 +34,25 @@ ApplicationStack::ApplicationStack(Logger* apLogger, IExecutor* apExecutor, AppC
 {
 	mLink.SetUpperLayer(&mTransport);
 	mTransport.SetUpperLayer(&mApplication);
+
+	mLink.SetCounters(&mCounters);
+	mTransport.SetCounters(&mCounters);
+	mApplication.SetCounters(&mCounters);
+
+#ifdef OPENDNP3_LATENCY_TRACE
+	mLink.SetLatencyTrace(&mTrace);
+	mTransport.SetLatencyTrace(&mTrace);
+	mApplication.SetLatencyTrace(&mTrace);
+#endif
+}
+
+LatencyStatistics ApplicationStack::GetLatencyStatistics() const
+{
+#ifdef OPENDNP3_LATENCY_TRACE
+	return mTrace.Snapshot();
+#else
+	return LatencyStatistics();
+#endif
 }
 
 }
@@ -40,6 +40,13 @@ class DLL_LOCAL ApplicationStack
 public:
 	ApplicationStack(Logger* apLogger, IExecutor* apExecutor, AppConfig aAppCfg, LinkConfig aCfg);
 
+	/// Safe to call from any thread, empty unless built with OPENDNP3_LATENCY_TRACE
+	LatencyStatistics GetLatencyStatistics() const;
+
+	StackCounters mCounters;	// written by all three layers on the stack's strand
+#ifdef OPENDNP3_LATENCY_TRACE
+	LatencyTrace mTrace;
+#endif
 	LinkLayer mLink;
 	TransportLayer mTransport;
 	AppLayer mApplication;
@@ -26,7 +26,11 @@
 #include <opendnp3/Exception.h>
 #include <opendnp3/Location.h>
 
+#include <algorithm>
+#include <limits>
+
 #include "AsyncTaskGroup.h"
+#include "BusScheduler.h"
 
 
 namespace opendnp3
@@ -47,7 +51,20 @@ AsyncTaskBase::AsyncTaskBase(int aPriority,
 	mpGroup(apGroup),
 	mNextRunTime(arInitialTime),
 	M_INITIAL_TIME(arInitialTime),
-	mFlags(0)
+	mFlags(0),
+	mpDevice(NULL),
+	mDeadline(-1),
+	mAging(-1),
+	mIdleSince(timer_clock::time_point::min()),
+	mDeadlineTime(timer_clock::time_point::max()),
+	mEffectivePriority(aPriority),
+	mNumDeadlineMisses(0),
+	mSequence(0),
+	mLastServed(0),
+	mWakeTime(timer_clock::time_point::max()),
+	mIsQueued(false),
+	mIsTimed(false),
+	mpBlockedBy(NULL)
 {
 
 }
@@ -66,13 +83,39 @@ void AsyncTaskBase::Enable()
 
 void AsyncTaskBase::SilentEnable()
 {
+	if(!mIsEnabled) mIdleSince = mpGroup->GetUTC();
 	mIsEnabled = true;
+	mpGroup->OnTaskChange(this);
 }
 
 void AsyncTaskBase::SilentDisable()
 {
-	this->Reset();
 	mIsEnabled = false;
+	this->Reset();
+}
+
+void AsyncTaskBase::SetDevice(BusDevice* apDevice)
+{
+	mpDevice = apDevice;
+	mpGroup->OnTaskChange(this);
+}
+
+void AsyncTaskBase::SetDeadline(millis_t aDeadline)
+{
+	mDeadline = aDeadline;
+	mpGroup->OnTaskChange(this);
+}
+
+void AsyncTaskBase::SetDemandTime(const std::function<timer_clock::time_point ()>& arDemandTime)
+{
+	mDemandTime = arDemandTime;
+	mpGroup->OnTaskChange(this);
+}
+
+void AsyncTaskBase::SetAging(millis_t aAging)
+{
+	mAging = aAging;
+	mpGroup->OnTaskChange(this);
 }
 
 void AsyncTaskBase::Dispatch()
@@ -80,6 +123,10 @@ void AsyncTaskBase::Dispatch()
 	if(mIsRunning) MACRO_THROW_EXCEPTION(InvalidStateException, "Running");
 	if(!mIsEnabled) MACRO_THROW_EXCEPTION(InvalidStateException, "Disabled");
 
+	timer_clock::time_point now = mpGroup->GetUTC();
+	mLatency.Record(now - this->ScheduledTime());
+	if(this->HasDeadline() && now > mDeadlineTime) ++mNumDeadlineMisses;
+
 	mIsRunning = true;
 	mIsComplete = false;
 	mIsExpired = false;
@@ -95,6 +142,7 @@ void AsyncTaskBase::AddDependency(const AsyncTaskBase* apTask)
 		MACRO_THROW_EXCEPTION(ArgumentException, "Circular dependencies not allowed");
 
 	mDependencies.push_back(apTask);
+	mpGroup->OnTaskChange(this);
 }
 
 bool AsyncTaskBase::IsDependency(const AsyncTaskBase* apTask) const
@@ -113,10 +161,11 @@ void AsyncTaskBase::OnComplete(bool aSuccess)
 		MACRO_THROW_EXCEPTION(InvalidStateException, "Not Running");
 	}
 	mIsRunning = false;
+	mIdleSince = mpGroup->GetUTC();
 
 	this->_OnComplete(aSuccess);
 
-	mpGroup->OnCompletion();
+	mpGroup->OnCompletion(this, aSuccess);
 }
 
 void AsyncTaskBase::Reset()
@@ -124,60 +173,69 @@ void AsyncTaskBase::Reset()
 	mIsComplete = mIsExpired = mIsRunning = false;
 	mNextRunTime = M_INITIAL_TIME;
 	this->_Reset();
+	mpGroup->OnTaskChange(this);
 }
 
-void AsyncTaskBase::UpdateTime(const timer_clock::time_point& arTime)
+timer_clock::time_point AsyncTaskBase::ReadyTime() const
 {
-	if(arTime >= mNextRunTime) {
-		mIsComplete = false;
-		mIsExpired = true;
-	}
-	else {
-		mIsExpired = false;
-	}
+	if(mpDevice == NULL) return mNextRunTime;
+	return std::max(mNextRunTime, mpDevice->BackoffUntil());
 }
 
-bool AsyncTaskBase::LessThan(const AsyncTaskBase* l, const AsyncTaskBase* r)
+timer_clock::time_point AsyncTaskBase::ScheduledTime() const
 {
-	// if a dependency is incomplete, it always blocks
-	if(l->IsDependency(r) && !r->IsComplete()) return true;
-	if(r->IsDependency(l) && !l->IsComplete()) return false;
+	return std::max(this->ReadyTime(), mIdleSince);
+}
 
-	if(!l->IsEnabled() && r->IsEnabled()) return true;
-	if(!r->IsEnabled() && l->IsEnabled()) return false;
+void AsyncTaskBase::Expire(const timer_clock::time_point& arTime)
+{
+	mIsComplete = false;
+	mIsExpired = true;
 
-	if(l->IsExpired()) {
-		if(r->IsExpired()) { //if they're both expired, resolve using priority
-			return l->Priority() < r->Priority();
-		}
-		else {
-			return false; // left expired but right is not
-		}
+	timer_clock::time_point scheduled = this->ScheduledTime();
+	mDeadlineTime = timer_clock::time_point::max();
+	if(this->HasDeadline()) {
+		timer_clock::time_point origin = mDemandTime ? std::min(scheduled, mDemandTime()) : scheduled;
+		mDeadlineTime = origin + std::chrono::milliseconds(mDeadline);
 	}
-	else if(r->IsExpired()) {
-		return true; // right expired but left is not
-	}
-	else { // if they're both not expired, the one with the lowest run time is higher
-		return l->NextRunTime() > r->NextRunTime();
+
+	mEffectivePriority = mPriority;
+	mWakeTime = timer_clock::time_point::max();
+	if(mAging > 0) {
+		int64_t levels = 0;
+		if(arTime > scheduled) levels = std::chrono::duration_cast<std::chrono::milliseconds>(arTime - scheduled).count() / mAging;
+		// bounded so that the sum can't overflow
+		mEffectivePriority += static_cast<int>(std::min<int64_t>(levels, std::numeric_limits<int>::max() / 2));
+		mWakeTime = scheduled + std::chrono::milliseconds((levels + 1) * mAging);
 	}
 }
 
-bool AsyncTaskBase::LessThanGroupLevelNoString(const AsyncTaskBase* l, const AsyncTaskBase* r)
+AsyncTaskBase* AsyncTaskBase::Blocker() const
 {
-	// Only one task can be running at a time at the group level;
-	if(l->IsRunning()) return false;
-	if(r->IsRunning()) return true;
+for(const AsyncTaskBase * p: mDependencies) {
+		if(p->IsEnabled() && !p->IsComplete()) return const_cast<AsyncTaskBase*>(p);
+		AsyncTaskBase* pBlocker = p->Blocker();
+		if(pBlocker != NULL) return pBlocker;
+	}
 
-	// if dependencies aren't an issue, compare based upon other criteria
-	return LessThan(l, r);
+	return NULL;
 }
 
-bool AsyncTaskBase::LessThanGroupLevel(const AsyncTaskBase* l, const AsyncTaskBase* r)
+bool AsyncTaskBase::ReadyOrder::operator()(const AsyncTaskBase* l, const AsyncTaskBase* r) const
 {
-	return LessThanGroupLevelNoString(l, r);
+	// tasks without a deadline have time_point::max(), so they run after all of the others
+	if(l->mDeadlineTime != r->mDeadlineTime) return l->mDeadlineTime < r->mDeadlineTime;
+	if(l->mEffectivePriority != r->mEffectivePriority) return l->mEffectivePriority > r->mEffectivePriority;
+	// on a shared bus, the device that was served most recently waits
+	if(l->mLastServed != r->mLastServed) return l->mLastServed < r->mLastServed;
+	return l->mSequence < r->mSequence;
 }
 
-
+bool AsyncTaskBase::WakeOrder::operator()(const AsyncTaskBase* l, const AsyncTaskBase* r) const
+{
+	if(l->mWakeTime != r->mWakeTime) return l->mWakeTime < r->mWakeTime;
+	return l->mSequence < r->mSequence;
+}
 
 } //end ns
 
@@ -30,19 +30,29 @@
 #include <opendnp3/Visibility.h>
 #include <opendnp3/Clock.h>
 
+#include "LatencyHistogram.h"
+
 #include <vector>
 #include <chrono>
+#include <functional>
 #include <string>
 
 namespace opendnp3
 {
 
 class AsyncTaskGroup;
+class BusDevice;
 
 /**
  * Asynchronous task. Task execution order is controlled by the period, retry,
  * priority (for resolving ties) and task dependencies.
  *
+ * Tasks that are ready to run are ordered by deadline first. Tasks with a deadline
+ * run ahead of tasks without one, the earliest deadline first. The remaining ties are
+ * resolved by priority, which grows while the task waits if aging is enabled.
+ *
+ * The group keeps its tasks in ordered queues keyed on these values, so every change
+ * to a task's state or scheduling parameters is reported to the group.
  */
 class DLL_LOCAL AsyncTaskBase : public ITask, private Uncopyable
 {
@@ -77,9 +87,50 @@ public:
 		return mName;
 	}
 
-	static bool LessThan(const AsyncTaskBase* l, const AsyncTaskBase* r);
-	static bool LessThanGroupLevel(const AsyncTaskBase* l, const AsyncTaskBase* r);
-	static bool LessThanGroupLevelNoString(const AsyncTaskBase* l, const AsyncTaskBase* r);
+	// Associate the task with a device on a shared bus, its backoff delays the task
+	void SetDevice(BusDevice* apDevice);
+	BusDevice* GetDevice() const {
+		return mpDevice;
+	}
+
+	/**
+		@param aDeadline Maximum delay in milliseconds between the task becoming ready and it being
+		dispatched, -1 for none. Tasks with a deadline run ahead of tasks without one.
+	*/
+	void SetDeadline(millis_t aDeadline);
+
+	/**
+		@param arDemandTime Returns when the oldest request served by the task was made, or
+		time_point::max() if there is none. The deadline is measured from that time when it
+		is earlier than the task becoming ready.
+	*/
+	void SetDemandTime(const std::function<timer_clock::time_point ()>& arDemandTime);
+
+	/**
+		@param aAging While the task waits to run, its priority is raised by one for every period
+		of this many milliseconds so it can't be starved by higher priority tasks, -1 to disable
+	*/
+	void SetAging(millis_t aAging);
+
+	// @return delays between the scheduled and actual start of the task
+	const LatencyHistogram& GetLatency() const {
+		return mLatency;
+	}
+
+	// @return the number of times the task was dispatched after its deadline
+	size_t NumDeadlineMisses() const {
+		return mNumDeadlineMisses;
+	}
+
+	// Orders the group's ready queue, the task that should run next first
+	struct ReadyOrder {
+		bool operator()(const AsyncTaskBase* l, const AsyncTaskBase* r) const;
+	};
+
+	// Orders the group's timer queue by the time the group next has to look at a task
+	struct WakeOrder {
+		bool operator()(const AsyncTaskBase* l, const AsyncTaskBase* r) const;
+	};
 
 protected:
 
@@ -103,9 +154,12 @@ protected:
 	// Run the task if it is not currently executing
 	virtual void Dispatch();
 
-	// Update the task's completion and expired status
-	// base upon the input time
-	void UpdateTime(const timer_clock::time_point& arTime);
+	// Mark a ready task as expired and compute the deadline, effective priority
+	// and next aging step that order it at the input time
+	void Expire(const timer_clock::time_point& arTime);
+
+	// @returns an enabled dependency that hasn't completed and has to run first, or NULL
+	AsyncTaskBase* Blocker() const;
 
 	bool IsEnabled() const {
 		return mIsEnabled;
@@ -136,6 +190,12 @@ protected:
 		return mNextRunTime;
 	}
 
+	// @returns the later of the next run time and the end of the device's backoff
+	timer_clock::time_point ReadyTime() const;
+
+	// @returns the time the task should have started, the ready time or when it last became idle
+	timer_clock::time_point ScheduledTime() const;
+
 	std::string mName;						// Every task has a name
 	bool mIsEnabled;						// Tasks can be enabled or disabled
 	bool mIsComplete;						// Every task has a flag that
@@ -152,6 +212,31 @@ protected:
 	timer_clock::time_point mNextRunTime;	// next execution time for the task
 	const timer_clock::time_point M_INITIAL_TIME;
 	int mFlags;
+	BusDevice* mpDevice;					// optional device on a shared bus
+
+	millis_t mDeadline;
+	std::function<timer_clock::time_point ()> mDemandTime;
+	millis_t mAging;
+	timer_clock::time_point mIdleSince;		// last time the task was enabled or completed
+	timer_clock::time_point mDeadlineTime;	// absolute deadline, valid while expired
+	int mEffectivePriority;					// priority including aging, valid while expired
+	LatencyHistogram mLatency;
+	size_t mNumDeadlineMisses;
+
+	// queueing state maintained by the group
+	uint64_t mSequence;						// order of creation, resolves the remaining ties
+	uint64_t mLastServed;					// service order of the device when the task was queued
+	timer_clock::time_point mWakeTime;		// ready time or next aging step, valid while timed
+	bool mIsQueued;							// in the group's ready queue
+	bool mIsTimed;							// in the group's timer queue
+	AsyncTaskBase* mpBlockedBy;				// dependency the task is parked on
+	std::vector<AsyncTaskBase*> mBlocked;	// tasks parked on this one
+
+private:
+
+	bool HasDeadline() const {
+		return mDeadline >= 0;
+	}
 };
 
 }
@@ -26,6 +26,7 @@
 #include "AsyncTaskPeriodic.h"
 #include "AsyncTaskNonPeriodic.h"
 #include "AsyncTaskContinuous.h"
+#include "BusScheduler.h"
 #include "IExecutor.h"
 #include "ITimeSource.h"
 
@@ -44,7 +45,10 @@ AsyncTaskGroup::AsyncTaskGroup(IExecutor* apExecutor, ITimeSource* apTimeSrc) :
 	mShutdown(false),
 	mpExecutor(apExecutor),
 	mpTimeSrc(apTimeSrc),
-	mpTimer(NULL)
+	mpTimer(NULL),
+	mpScheduler(NULL),
+	mpRunning(NULL),
+	mNextSequence(0)
 {
 
 }
@@ -58,13 +62,17 @@ for(AsyncTaskBase * p: mTaskVec) delete p;
 
 AsyncTaskBase* AsyncTaskGroup::Add(millis_t aPeriod, millis_t aRetryDelay, int aPriority, const TaskHandler& arCallback, const std::string& arName)
 {
-	AsyncTaskBase* pTask;
-	if(aPeriod >= 0)
-		pTask = new AsyncTaskPeriodic(aPeriod, aRetryDelay, aPriority, arCallback, this, arName);
-	else
-		pTask = new AsyncTaskNonPeriodic(aRetryDelay, aPriority, arCallback, this, arName);
+	if(aPeriod >= 0) return this->AddPeriodic(aPeriod, aRetryDelay, aPriority, arCallback, arName);
 
-	mTaskVec.push_back(pTask);
+	AsyncTaskBase* pTask = new AsyncTaskNonPeriodic(aRetryDelay, aPriority, arCallback, this, arName);
+	this->Track(pTask);
+	return pTask;
+}
+
+AsyncTaskPeriodic* AsyncTaskGroup::AddPeriodic(millis_t aPeriod, millis_t aRetryDelay, int aPriority, const TaskHandler& arCallback, const std::string& arName)
+{
+	AsyncTaskPeriodic* pTask = new AsyncTaskPeriodic(aPeriod, aRetryDelay, aPriority, arCallback, this, arName);
+	this->Track(pTask);
 	return pTask;
 }
 
@@ -78,16 +86,29 @@ for(AsyncTaskBase * p: mTaskVec) {
 AsyncTaskContinuous* AsyncTaskGroup::AddContinuous(int aPriority, const TaskHandler& arCallback, const std::string& arName)
 {
 	AsyncTaskContinuous* pTask = new AsyncTaskContinuous(aPriority, arCallback, this, arName);
-	mTaskVec.push_back(pTask);
+	this->Track(pTask);
 	return pTask;
 }
 
+void AsyncTaskGroup::Track(AsyncTaskBase* apTask)
+{
+	apTask->mSequence = mNextSequence++;
+	mTaskVec.push_back(apTask);
+}
+
 void AsyncTaskGroup::Remove(AsyncTaskBase* apTask)
 {
 	for(TaskVec::iterator i = mTaskVec.begin(); i != mTaskVec.end(); ++i) {
 		if(*i == apTask) {
+			this->Unqueue(apTask);
+			if(mpRunning == apTask) mpRunning = NULL;
+			this->Release(apTask, this->GetUTC());
 			delete *i;
 			mTaskVec.erase(i);
+			for(AsyncTaskBase * p: mTaskVec) {
+				AsyncTaskBase::DependencyVec& deps = p->mDependencies;
+				deps.erase(std::remove(deps.begin(), deps.end(), apTask), deps.end());
+			}
 			return;
 		}
 	}
@@ -138,16 +159,103 @@ for(AsyncTaskBase * p: mTaskVec) {
 
 AsyncTaskBase* AsyncTaskGroup::GetNext(const timer_clock::time_point& arTime)
 {
-	this->Update(arTime);
-	TaskVec::iterator max = max_element(mTaskVec.begin(), mTaskVec.end(), AsyncTaskBase::LessThanGroupLevel);
+	// tasks that became due or gained an aging level since the last pass
+	while(!mTimed.empty() && (*mTimed.begin())->mWakeTime <= arTime) {
+		this->Requeue(*mTimed.begin(), arTime);
+	}
+
+	// Only one task can be running at a time at the group level
+	if(mpRunning != NULL) return NULL;
 
-	AsyncTaskBase* pRet = NULL;
-	if(max != mTaskVec.end()) {
-		AsyncTaskBase* p = *max;
-		if(!p->IsRunning() && p->IsEnabled()) pRet = p;
+	// Keys go stale without the group hearing about it when a device backs off or is
+	// served, or when a dependency expires again. Checking the front is enough since
+	// those only ever make a task less urgent than its key says.
+	while(!mReady.empty()) {
+		AsyncTaskBase* p = *mReady.begin();
+		if(this->IsCurrent(p, arTime)) return p;
+		this->Requeue(p, arTime);
 	}
 
-	return pRet;
+	return NULL;
+}
+
+bool AsyncTaskGroup::IsCurrent(AsyncTaskBase* apTask, const timer_clock::time_point& arTime) const
+{
+	if(apTask->ReadyTime() > arTime) return false;
+	if(apTask->mpDevice && apTask->mpDevice->LastServed() != apTask->mLastServed) return false;
+	return apTask->Blocker() == NULL;
+}
+
+void AsyncTaskGroup::OnTaskChange(AsyncTaskBase* apTask)
+{
+	timer_clock::time_point now = this->GetUTC();
+	this->Requeue(apTask, now);
+	this->Release(apTask, now);
+}
+
+void AsyncTaskGroup::Requeue(AsyncTaskBase* apTask, const timer_clock::time_point& arTime)
+{
+	this->Unqueue(apTask);
+	if(mpRunning == apTask && !apTask->IsRunning()) mpRunning = NULL;
+	if(!apTask->IsEnabled() || apTask->IsRunning()) return;
+
+	timer_clock::time_point ready = apTask->ReadyTime();
+	if(ready == timer_clock::time_point::max()) return; // won't run again until it's reset
+
+	if(ready > arTime) {
+		apTask->mIsExpired = false;
+		apTask->mWakeTime = ready;
+		apTask->mIsTimed = true;
+		mTimed.insert(apTask);
+		return;
+	}
+
+	apTask->Expire(arTime);
+
+	AsyncTaskBase* pBlocker = apTask->Blocker();
+	if(pBlocker != NULL) {
+		apTask->mpBlockedBy = pBlocker;
+		pBlocker->mBlocked.push_back(apTask);
+		return;
+	}
+
+	apTask->mLastServed = apTask->mpDevice ? apTask->mpDevice->LastServed() : 0;
+	apTask->mIsQueued = true;
+	mReady.insert(apTask);
+
+	// aging tasks are looked at again when they gain a level
+	if(apTask->mWakeTime != timer_clock::time_point::max()) {
+		apTask->mIsTimed = true;
+		mTimed.insert(apTask);
+	}
+}
+
+void AsyncTaskGroup::Unqueue(AsyncTaskBase* apTask)
+{
+	// the keys are unchanged since insertion, so erase finds the entries
+	if(apTask->mIsQueued) {
+		mReady.erase(apTask);
+		apTask->mIsQueued = false;
+	}
+	if(apTask->mIsTimed) {
+		mTimed.erase(apTask);
+		apTask->mIsTimed = false;
+	}
+	if(apTask->mpBlockedBy != NULL) {
+		std::vector<AsyncTaskBase*>& blocked = apTask->mpBlockedBy->mBlocked;
+		blocked.erase(std::find(blocked.begin(), blocked.end(), apTask));
+		apTask->mpBlockedBy = NULL;
+	}
+}
+
+void AsyncTaskGroup::Release(AsyncTaskBase* apTask, const timer_clock::time_point& arTime)
+{
+	std::vector<AsyncTaskBase*> blocked;
+	blocked.swap(apTask->mBlocked);
+for(AsyncTaskBase * p: blocked) {
+		p->mpBlockedBy = NULL;
+		this->Requeue(p, arTime);
+	}
 }
 
 void AsyncTaskGroup::CheckState()
@@ -156,23 +264,24 @@ void AsyncTaskGroup::CheckState()
 		timer_clock::time_point now = GetUTC();
 		AsyncTaskBase* pTask = GetNext(now);
 
-		if(pTask == NULL) return;
-		if(pTask->NextRunTime() == timer_clock::time_point::max()) return;
-
-		if(pTask->NextRunTime() <= now) {
+		if(pTask != NULL) {
+			this->Unqueue(pTask);
+			mpRunning = pTask;
 			mIsRunning = true;
 			pTask->Dispatch();
 		}
-		else {
-			this->RestartTimer(pTask->NextRunTime());
+		else if(mpRunning == NULL && !mTimed.empty()) {
+			this->RestartTimer((*mTimed.begin())->mWakeTime);
 		}
 	}
 }
 
-void AsyncTaskGroup::OnCompletion()
+void AsyncTaskGroup::OnCompletion(AsyncTaskBase* apTask, bool aSuccess)
 {
 	if(!mIsRunning) MACRO_THROW_EXCEPTION(InvalidStateException, "Not running");
 	mIsRunning = false;
+	if(mpScheduler && apTask->GetDevice()) mpScheduler->OnComplete(apTask->GetDevice(), aSuccess);
+	this->OnTaskChange(apTask);
 	this->CheckState();
 }
 
@@ -181,13 +290,6 @@ timer_clock::time_point AsyncTaskGroup::GetUTC() const
 	return mpTimeSrc->GetUTC();
 }
 
-void AsyncTaskGroup::Update(const timer_clock::time_point& arTime)
-{
-for(AsyncTaskBase * p: mTaskVec) {
-		p->UpdateTime(arTime);
-	}
-}
-
 void AsyncTaskGroup::RestartTimer(const timer_clock::time_point& arTime)
 {
 	if(mpTimer != NULL) {
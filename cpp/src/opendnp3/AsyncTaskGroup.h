@@ -28,6 +28,7 @@
 #include <opendnp3/Uncopyable.h>
 #include <opendnp3/Visibility.h>
 
+#include "AsyncTaskBase.h"
 #include "AsyncTaskInterfaces.h"
 #include "TimeSource.h"
 
@@ -43,12 +44,20 @@ class AsyncTaskBase;
 class AsyncTaskPeriodic;
 class AsyncTaskNonPeriodic;
 class AsyncTaskContinuous;
+class BusScheduler;
 class IExecutor;
 class ITimeSource;
 class ITimer;
 
 /**
  A collection of related tasks with optional dependencies
+
+ Enabled tasks that are waiting for their run time sit in a timer queue ordered by
+ that time. Once they are due they move to a ready queue ordered by deadline and
+ effective priority, and tasks that age stay in the timer queue so they are re-keyed
+ when they gain a level. A task whose dependency still has to run is parked on that
+ dependency until it completes. Picking the next task is O(log n) in the number of
+ tasks, which matters when every master on a multidrop channel shares the group.
 */
 class DLL_LOCAL AsyncTaskGroup : private Uncopyable
 {
@@ -61,6 +70,7 @@ public:
 	~AsyncTaskGroup();
 
 	AsyncTaskBase* Add(millis_t aPeriod, millis_t aRetryDelay, int aPriority, const TaskHandler& arCallback, const std::string& arName = "");
+	AsyncTaskPeriodic* AddPeriodic(millis_t aPeriod, millis_t aRetryDelay, int aPriority, const TaskHandler& arCallback, const std::string& arName = "");
 	AsyncTaskContinuous* AddContinuous(int aPriority, const TaskHandler& arCallback, const std::string& arName = "");
 	void Remove(AsyncTaskBase* apTask);
 
@@ -76,30 +86,57 @@ public:
 
 	void CheckState();
 
+	// Arbitrate the group's tasks between the devices of a shared bus
+	void SetScheduler(BusScheduler* apScheduler) {
+		mpScheduler = apScheduler;
+	}
+	BusScheduler* GetScheduler() {
+		return mpScheduler;
+	}
+
 	bool IsRunning() {
 		return mIsRunning;
 	}
 
 	timer_clock::time_point GetUTC() const;
 
+	ITimeSource* GetTimeSource() {
+		return mpTimeSrc;
+	}
+
 private:
 
-	void OnCompletion();
+	void Track(AsyncTaskBase* apTask);
+	void OnCompletion(AsyncTaskBase* apTask, bool aSuccess);
 	void RestartTimer(const timer_clock::time_point& arTime);
 	void OnTimerExpiration();
-	void Update(const timer_clock::time_point& arTime);
 	AsyncTaskBase* GetNext(const timer_clock::time_point& arTime);
 
+	// Re-key a task after its state or scheduling parameters changed
+	void OnTaskChange(AsyncTaskBase* apTask);
+	void Requeue(AsyncTaskBase* apTask, const timer_clock::time_point& arTime);
+	void Unqueue(AsyncTaskBase* apTask);
+	// Requeue the tasks parked on a dependency
+	void Release(AsyncTaskBase* apTask, const timer_clock::time_point& arTime);
+	// @return true if the task's key and queue still match its state at the input time
+	bool IsCurrent(AsyncTaskBase* apTask, const timer_clock::time_point& arTime) const;
+
 	bool mIsRunning;
 	bool mShutdown;
 	IExecutor* mpExecutor;
 	ITimeSource* mpTimeSrc;
 	ITimer* mpTimer;
-
-
+	BusScheduler* mpScheduler;
+	AsyncTaskBase* mpRunning;
+	uint64_t mNextSequence;
 
 	typedef std::vector< AsyncTaskBase* > TaskVec;
 	TaskVec mTaskVec;
+
+	typedef std::set<AsyncTaskBase*, AsyncTaskBase::ReadyOrder> ReadyQueue;
+	ReadyQueue mReady;
+	typedef std::set<AsyncTaskBase*, AsyncTaskBase::WakeOrder> TimerQueue;
+	TimerQueue mTimed;
 };
 
 }
@@ -51,6 +51,14 @@ public:
 
 	virtual ~AsyncTaskPeriodic() {}
 
+	// Takes effect the next time the task completes successfully
+	void SetPeriod(millis_t aPeriod) {
+		mPeriod = aPeriod;
+	}
+	millis_t GetPeriod() const {
+		return mPeriod;
+	}
+
 private:
 
 	// Implements ITaskCompletion
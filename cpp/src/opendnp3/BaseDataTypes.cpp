@@ -48,20 +48,11 @@ std::string GetDataTypeName(DataTypes aType)
 #endif
 
 
-// DataPoint
-
-
-DataPoint::DataPoint(uint8_t aQuality, DataTypes aType) :
-	mQuality(aQuality), mTime(0),
-	mType(aType)
-{}
-
 // BoolDataPoint
 
 
-BoolDataPoint::BoolDataPoint(uint8_t aQuality, DataTypes aType, uint8_t aValueMask) :
-	DataPoint(aQuality, aType),
-	mValueMask(aValueMask)
+BoolDataPoint::BoolDataPoint(uint8_t aQuality) :
+	DataPoint<bool>(aQuality)
 {}
 
 #ifndef OPENDNP3_STRIP_LOG_MESSAGES
@@ -0,0 +1,128 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "BusScheduler.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Location.h>
+
+#include "ITimeSource.h"
+
+#include <algorithm>
+
+using namespace std::chrono;
+
+namespace opendnp3
+{
+
+BusDevice::BusDevice(millis_t aMinBackoff) :
+	mMinBackoff(aMinBackoff),
+	mNumTransactions(0),
+	mNumFailures(0),
+	mNumConsecutiveFailures(0),
+	mBackoffUntil(timer_clock::time_point::min()),
+	mLastServed(0)
+{
+
+}
+
+BusScheduler::BusScheduler(ITimeSource* apTimeSrc, int aBaud, int aBitsPerChar, millis_t aMaxBackoff) :
+	mpTimeSrc(apTimeSrc),
+	mCharTime(0),
+	mMaxBackoff(aMaxBackoff),
+	mNumCompletions(0),
+	mNumBytes(0),
+	mSampleBytes(0),
+	mSampleTime(apTimeSrc->GetUTC())
+{
+	if(aBaud <= 0) MACRO_THROW_EXCEPTION(ArgumentException, "Baud rate must be greater than zero");
+	if(aBitsPerChar <= 0) MACRO_THROW_EXCEPTION(ArgumentException, "Bits per character must be greater than zero");
+
+	mCharTime = nanoseconds((static_cast<int64_t>(aBitsPerChar) * 1000000000) / aBaud);
+}
+
+BusScheduler::~BusScheduler()
+{
+	for(BusDevice * p: mDevices) delete p;
+}
+
+BusDevice* BusScheduler::AddDevice(millis_t aMinBackoff)
+{
+	BusDevice* pDevice = new BusDevice(aMinBackoff);
+	mDevices.insert(pDevice);
+	return pDevice;
+}
+
+void BusScheduler::RemoveDevice(BusDevice* apDevice)
+{
+	DeviceSet::iterator i = mDevices.find(apDevice);
+	if(i == mDevices.end()) MACRO_THROW_EXCEPTION(ArgumentException, "Device not found");
+	delete *i;
+	mDevices.erase(i);
+}
+
+timer_clock::duration BusScheduler::TransmitTime(size_t aNumBytes) const
+{
+	return duration_cast<timer_clock::duration>(mCharTime * aNumBytes);
+}
+
+void BusScheduler::OnTraffic(size_t aNumBytes)
+{
+	mNumBytes += aNumBytes;
+}
+
+double BusScheduler::SampleUtilization()
+{
+	timer_clock::time_point now = mpTimeSrc->GetUTC();
+	timer_clock::duration elapsed = now - mSampleTime;
+	timer_clock::duration busy = this->TransmitTime(static_cast<size_t>(mNumBytes - mSampleBytes));
+
+	mSampleTime = now;
+	mSampleBytes = mNumBytes;
+
+	if(elapsed <= timer_clock::duration::zero()) return 0.0;
+	return std::min(1.0, duration_cast<duration<double>>(busy).count() / duration_cast<duration<double>>(elapsed).count());
+}
+
+void BusScheduler::OnComplete(BusDevice* apDevice, bool aSuccess)
+{
+	timer_clock::time_point now = mpTimeSrc->GetUTC();
+	++apDevice->mNumTransactions;
+	apDevice->mLastServed = ++mNumCompletions;
+
+	if(aSuccess) {
+		apDevice->mNumConsecutiveFailures = 0;
+		apDevice->mBackoffUntil = timer_clock::time_point::min();
+	}
+	else {
+		++apDevice->mNumFailures;
+		++apDevice->mNumConsecutiveFailures;
+
+		// double the backoff for every consecutive failure, the shift is bounded so it can't overflow
+		size_t shift = std::min<size_t>(apDevice->mNumConsecutiveFailures - 1, 16);
+		millis_t backoff = std::min(apDevice->mMinBackoff << shift, mMaxBackoff);
+		apDevice->mBackoffUntil = now + milliseconds(backoff);
+	}
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,155 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __BUS_SCHEDULER_H_
+#define __BUS_SCHEDULER_H_
+
+#include <opendnp3/Clock.h>
+#include <opendnp3/Types.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include <chrono>
+#include <set>
+
+namespace opendnp3
+{
+
+class ITimeSource;
+
+/**
+ Scheduling state of one device (a master and the outstation it polls) on a shared bus
+*/
+class DLL_LOCAL BusDevice : private Uncopyable
+{
+	friend class BusScheduler;
+
+public:
+
+	/// @return true if the device is backing off after a failure and its tasks should be skipped
+	bool IsInBackoff(const timer_clock::time_point& arTime) const {
+		return arTime < mBackoffUntil;
+	}
+
+	/// @return the time at which the device may use the bus again
+	timer_clock::time_point BackoffUntil() const {
+		return mBackoffUntil;
+	}
+
+	/// @return the bus-wide sequence number of the device's last completed transaction, 0 if none have
+	uint64_t LastServed() const {
+		return mLastServed;
+	}
+
+	size_t NumTransactions() const {
+		return mNumTransactions;
+	}
+
+	size_t NumFailures() const {
+		return mNumFailures;
+	}
+
+	size_t NumConsecutiveFailures() const {
+		return mNumConsecutiveFailures;
+	}
+
+private:
+
+	BusDevice(millis_t aMinBackoff);
+
+	millis_t mMinBackoff;
+	size_t mNumTransactions;
+	size_t mNumFailures;
+	size_t mNumConsecutiveFailures;
+	timer_clock::time_point mBackoffUntil;
+	uint64_t mLastServed;
+};
+
+/**
+ Arbitrates the bus shared by all of the masters on a serial channel.
+
+ The masters on a channel share one AsyncTaskGroup, so only one transaction is on the
+ bus at a time. The scheduler decides whose task goes next: devices that are backing off
+ after a failed transaction are skipped so bus time isn't spent waiting on response
+ timeouts, and ties between tasks of equal priority go to the device that has waited the
+ longest. Occupancy is estimated by charging every byte written or read with its
+ transmission time at the configured baud rate.
+*/
+class DLL_LOCAL BusScheduler : private Uncopyable
+{
+public:
+
+	/**
+		@param apTimeSrc Time source used for backoff and utilization measurements
+		@param aBaud Bit rate of the bus
+		@param aBitsPerChar Bits on the wire for every byte, including start, parity, and stop bits
+		@param aMaxBackoff Upper limit of the exponential backoff of a failing device in milliseconds
+	*/
+	BusScheduler(ITimeSource* apTimeSrc, int aBaud, int aBitsPerChar, millis_t aMaxBackoff = 60000);
+	~BusScheduler();
+
+	/**
+		Register a device that will share the bus
+		@param aMinBackoff Backoff after the first failure in milliseconds, doubled for each consecutive failure
+		@return the device, owned by the scheduler until it is removed
+	*/
+	BusDevice* AddDevice(millis_t aMinBackoff);
+	void RemoveDevice(BusDevice* apDevice);
+
+	size_t NumDevices() const {
+		return mDevices.size();
+	}
+
+	/// @return how long the bus is occupied transmitting aNumBytes
+	timer_clock::duration TransmitTime(size_t aNumBytes) const;
+
+	/// Charge the bus for bytes that were written or read
+	void OnTraffic(size_t aNumBytes);
+
+	/// @return the fraction of time the bus was occupied since the previous sample, between 0 and 1
+	double SampleUtilization();
+
+	/// @return the total number of bytes charged to the bus
+	uint64_t NumBytes() const {
+		return mNumBytes;
+	}
+
+	/// Record the outcome of a transaction, failures put the device into backoff
+	void OnComplete(BusDevice* apDevice, bool aSuccess);
+
+private:
+
+	ITimeSource* mpTimeSrc;
+	std::chrono::nanoseconds mCharTime;
+	millis_t mMaxBackoff;
+
+	uint64_t mNumCompletions;
+	uint64_t mNumBytes;
+	uint64_t mSampleBytes;
+	timer_clock::time_point mSampleTime;
+
+	typedef std::set<BusDevice*> DeviceSet;
+	DeviceSet mDevices;
+};
+
+}
+
+#endif
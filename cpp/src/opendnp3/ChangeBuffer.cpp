@@ -30,10 +30,29 @@ namespace opendnp3
 size_t ChangeBuffer::FlushUpdates(IDataObserver* apObserver)
 {
 	assert(this->InProgress());
-	size_t count = this->mChangeQueue.size();
+	size_t count = this->mOrder.size();
 	if(count > 0) {
 		Transaction t(apObserver);
-for(auto f: mChangeQueue) f(apObserver);
+		size_t binary = 0, analog = 0, counter = 0, control = 0, setpoint = 0;
+for(auto type: mOrder) {
+			switch(type) {
+			case(DT_BINARY):
+				Dispatch(apObserver, mBinary, binary);
+				break;
+			case(DT_ANALOG):
+				Dispatch(apObserver, mAnalog, analog);
+				break;
+			case(DT_COUNTER):
+				Dispatch(apObserver, mCounter, counter);
+				break;
+			case(DT_CONTROL_STATUS):
+				Dispatch(apObserver, mControlStatus, control);
+				break;
+			case(DT_SETPOINT_STATUS):
+				Dispatch(apObserver, mSetpointStatus, setpoint);
+				break;
+			}
+		}
 	}
 	this->Clear();
 	return count;
@@ -54,32 +73,27 @@ void ChangeBuffer::_End()
 
 void ChangeBuffer::_Update(const Binary& arPoint, size_t aIndex)
 {
-	mChangeQueue.push_back(std::bind(&ChangeBuffer::Dispatch<Binary>, std::placeholders::_1, arPoint, aIndex));
-	mNotify = true;
+	this->Add(mBinary, arPoint, aIndex);
 }
 
 void ChangeBuffer::_Update(const Analog& arPoint, size_t aIndex)
 {
-	mChangeQueue.push_back(std::bind(&ChangeBuffer::Dispatch<Analog>, std::placeholders::_1, arPoint, aIndex));
-	mNotify = true;
+	this->Add(mAnalog, arPoint, aIndex);
 }
 
 void ChangeBuffer::_Update(const Counter& arPoint, size_t aIndex)
 {
-	mChangeQueue.push_back(std::bind(&ChangeBuffer::Dispatch<Counter>, std::placeholders::_1, arPoint, aIndex));
-	mNotify = true;
+	this->Add(mCounter, arPoint, aIndex);
 }
 
 void ChangeBuffer::_Update(const ControlStatus& arPoint, size_t aIndex)
 {
-	mChangeQueue.push_back(std::bind(&ChangeBuffer::Dispatch<ControlStatus>, std::placeholders::_1, arPoint, aIndex));
-	mNotify = true;
+	this->Add(mControlStatus, arPoint, aIndex);
 }
 
 void ChangeBuffer::_Update(const SetpointStatus& arPoint, size_t aIndex)
 {
-	mChangeQueue.push_back(std::bind(&ChangeBuffer::Dispatch<SetpointStatus>, std::placeholders::_1, arPoint, aIndex));
-	mNotify = true;
+	this->Add(mSetpointStatus, arPoint, aIndex);
 }
 
 void ChangeBuffer::Clear()
@@ -90,7 +104,12 @@ void ChangeBuffer::Clear()
 
 void ChangeBuffer::_Clear()
 {
-	mChangeQueue.clear();
+	mOrder.clear();
+	mBinary.clear();
+	mAnalog.clear();
+	mCounter.clear();
+	mControlStatus.clear();
+	mSetpointStatus.clear();
 }
 
 }
@@ -28,8 +28,8 @@
 #include <opendnp3/SubjectBase.h>
 #include <opendnp3/Visibility.h>
 
-#include <queue>
 #include <mutex>
+#include <vector>
 
 namespace opendnp3
 {
@@ -57,8 +57,16 @@ public:
 private:
 
 	template <class T>
-	static void Dispatch(IDataObserver* apObs, T& arMeas, size_t aIndex) {
-		apObs->Update(arMeas, aIndex);
+	void Add(std::vector< Change<T> >& arChanges, const T& arMeas, size_t aIndex) {
+		arChanges.push_back(Change<T>(arMeas, aIndex));
+		mOrder.push_back(arMeas.GetType());
+		mNotify = true;
+	}
+
+	template <class T>
+	static void Dispatch(IDataObserver* apObs, const std::vector< Change<T> >& arChanges, size_t& arPosition) {
+		const Change<T>& change = arChanges[arPosition++];
+		apObs->Update(change.mValue, change.mIndex);
 	}
 
 
@@ -66,7 +74,14 @@ private:
 
 	bool mNotify;
 
-	std::deque<std::function<void (IDataObserver*)>> mChangeQueue;
+	// Updates are stored by value, one vector per type. mOrder has the type of every
+	// update so they're flushed in the order they arrived.
+	std::vector<DataTypes> mOrder;
+	std::vector< Change<Binary> > mBinary;
+	std::vector< Change<Analog> > mAnalog;
+	std::vector< Change<Counter> > mCounter;
+	std::vector< Change<ControlStatus> > mControlStatus;
+	std::vector< Change<SetpointStatus> > mSetpointStatus;
 	std::mutex mMutex;
 };
 
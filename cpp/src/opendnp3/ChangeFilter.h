@@ -0,0 +1,138 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __CHANGE_FILTER_H_
+#define __CHANGE_FILTER_H_
+
+#include <opendnp3/DataTypes.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace opendnp3
+{
+
+/**
+* Remembers the last value, quality and time the master published for every point so that
+* static values repeated by integrity polls can be dropped. Each point is packed into two
+* 64 bit words, the value bits and the time (48 bits, the width of a DNP3 time) together with
+* the quality and a set flag, so a comparison is two word compares no matter the type.
+*/
+class DLL_LOCAL ChangeFilter : private Uncopyable
+{
+public:
+
+	// indices above this are always published
+	static const size_t MAX_INDEX = 65535;
+
+	ChangeFilter() {}
+
+	/**
+	* Records a point the loader is about to publish
+	* @param aStatic True for static objects, which are dropped if nothing has changed. Events are always published.
+	* @return True if the point should be published
+	*/
+	template <class T>
+	bool Publish(const T& arPoint, size_t aIndex, bool aStatic);
+
+private:
+
+	struct PackedPoint {
+		PackedPoint() : mValue(0), mTimeQuality(0) {}
+
+		bool operator==(const PackedPoint& arRHS) const {
+			return mValue == arRHS.mValue && mTimeQuality == arRHS.mTimeQuality;
+		}
+
+		uint64_t mValue;
+		uint64_t mTimeQuality;
+	};
+
+	static const uint64_t TIME_MASK = 0xFFFFFFFFFFFFULL;
+	static const uint64_t SET_FLAG = 1ULL << 56;
+
+	static uint64_t ValueBits(bool aValue) {
+		return aValue ? 1 : 0;
+	}
+	static uint64_t ValueBits(uint32_t aValue) {
+		return aValue;
+	}
+	static uint64_t ValueBits(double aValue) {
+		uint64_t bits;
+		memcpy(&bits, &aValue, sizeof(bits));
+		return bits;
+	}
+
+	template <class T>
+	static PackedPoint Pack(const T& arPoint) {
+		PackedPoint packed;
+		packed.mValue = ValueBits(arPoint.GetValue());
+		packed.mTimeQuality = (static_cast<uint64_t>(arPoint.GetTime()) & TIME_MASK) | (static_cast<uint64_t>(arPoint.GetQuality()) << 48) | SET_FLAG;
+		return packed;
+	}
+
+	std::vector<PackedPoint>& Column(const Binary&) {
+		return mBinary;
+	}
+	std::vector<PackedPoint>& Column(const Analog&) {
+		return mAnalog;
+	}
+	std::vector<PackedPoint>& Column(const Counter&) {
+		return mCounter;
+	}
+	std::vector<PackedPoint>& Column(const ControlStatus&) {
+		return mControlStatus;
+	}
+	std::vector<PackedPoint>& Column(const SetpointStatus&) {
+		return mSetpointStatus;
+	}
+
+	std::vector<PackedPoint> mBinary;
+	std::vector<PackedPoint> mAnalog;
+	std::vector<PackedPoint> mCounter;
+	std::vector<PackedPoint> mControlStatus;
+	std::vector<PackedPoint> mSetpointStatus;
+};
+
+template <class T>
+bool ChangeFilter::Publish(const T& arPoint, size_t aIndex, bool aStatic)
+{
+	if(aIndex > MAX_INDEX) return true;
+
+	std::vector<PackedPoint>& column = this->Column(arPoint);
+	if(aIndex >= column.size()) column.resize(aIndex + 1);
+
+	// a slot that was never set can't match because it lacks the set flag
+	PackedPoint packed = Pack(arPoint);
+	if(aStatic && column[aIndex] == packed) return false;
+
+	column[aIndex] = packed;
+	return true;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
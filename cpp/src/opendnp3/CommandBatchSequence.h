@@ -0,0 +1,195 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __COMMAND_BATCH_SEQUENCE_H_
+#define __COMMAND_BATCH_SEQUENCE_H_
+
+#include <opendnp3/APDUConstants.h>
+#include <opendnp3/CommandBatch.h>
+#include <opendnp3/Exception.h>
+#include <opendnp3/Location.h>
+#include <opendnp3/ObjectInterfaces.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include "APDU.h"
+#include "CopyableBuffer.h"
+#include "ObjectReadIterator.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace opendnp3
+{
+
+/**
+ Splits a batch of commands into requests that fit in a fragment and collects the
+ response to every command as the echoed responses are validated.
+
+ Select and operate batches select a chunk of commands and then operate the ones that
+ were selected successfully. Direct operate batches send each chunk once.
+*/
+template <class T>
+class DLL_LOCAL CommandBatchSequence : private Uncopyable
+{
+public:
+
+	CommandBatchSequence(const std::vector< IndexedCommand<T> >& arCommands, CommandObject<T>* apObj, bool aSelectBeforeOperate);
+
+	/**
+		@param arCode Receives the function code of the next request
+		@return false if the batch is finished
+	*/
+	bool GetNextCode(FunctionCodes& arCode) const;
+
+	/// Write as many of the next commands as fit in the fragment
+	void Format(APDU& arAPDU, FunctionCodes aCode);
+
+	/**
+		Validate a response against the request in a single pass over the echoed objects
+		@return CS_SUCCESS if the response echoes the request, the responses to the individual commands are recorded
+	*/
+	CommandStatus Validate(const APDU& arAPDU, FunctionCodes aCode);
+
+	/// Respond to the commands of the request in flight with a failure
+	void Fail(CommandStatus aStatus);
+
+	const std::vector<CommandResponse>& GetResponses() const {
+		return mResponses;
+	}
+
+private:
+
+	std::vector< IndexedCommand<T> > mCommands;
+	std::vector<CommandResponse> mResponses;
+	CommandObject<T>* mpObj;
+	bool mSelectBeforeOperate;
+
+	size_t mNumSent;							// commands that have been sent at least once
+	std::vector<size_t> mChunk;					// positions of the commands in the request in flight
+	std::vector<CopyableBuffer> mChunkData;		// value bytes of the commands in flight
+	bool mAwaitingOperate;
+};
+
+template <class T>
+CommandBatchSequence<T>::CommandBatchSequence(const std::vector< IndexedCommand<T> >& arCommands, CommandObject<T>* apObj, bool aSelectBeforeOperate) :
+	mCommands(arCommands),
+	mResponses(arCommands.size(), CommandResponse(CS_UNDEFINED)),
+	mpObj(apObj),
+	mSelectBeforeOperate(aSelectBeforeOperate),
+	mNumSent(0),
+	mAwaitingOperate(false)
+{
+
+}
+
+template <class T>
+bool CommandBatchSequence<T>::GetNextCode(FunctionCodes& arCode) const
+{
+	if(mAwaitingOperate) {
+		arCode = FC_OPERATE;
+		return true;
+	}
+
+	if(mNumSent < mCommands.size()) {
+		arCode = mSelectBeforeOperate ? FC_SELECT : FC_DIRECT_OPERATE;
+		return true;
+	}
+
+	return false;
+}
+
+template <class T>
+void CommandBatchSequence<T>::Format(APDU& arAPDU, FunctionCodes aCode)
+{
+	arAPDU.Set(aCode, true, true, false, false);
+
+	// an operate repeats the commands that were selected, anything else starts the next chunk
+	if(aCode != FC_OPERATE) {
+		mChunk.clear();
+		for(size_t i = mNumSent; i < mCommands.size(); ++i) mChunk.push_back(i);
+	}
+
+	size_t max_index = 0;
+	for(size_t pos : mChunk) max_index = std::max(max_index, mCommands[pos].mIndex);
+
+	IndexedWriteIterator i = arAPDU.WriteIndexed(mpObj, mChunk.size(), max_index);
+	if(i.Count() == 0) MACRO_THROW_EXCEPTION(InvalidStateException, "Fragment can't hold a command");
+
+	mChunk.resize(i.Count());
+	mChunkData.clear();
+	for(size_t pos : mChunk) {
+		i.SetIndex(mCommands[pos].mIndex);
+		mpObj->Write(*i, mCommands[pos].mCommand);
+		mChunkData.push_back(mpObj->GetValueBytes(*i));
+		++i;
+	}
+
+	if(aCode != FC_OPERATE) mNumSent += mChunk.size();
+}
+
+template <class T>
+CommandStatus CommandBatchSequence<T>::Validate(const APDU& arAPDU, FunctionCodes aCode)
+{
+	HeaderReadIterator hdr = arAPDU.BeginRead();
+	if(hdr.Count() != 1 || hdr->GetGroup() != mpObj->GetGroup() || hdr->GetVariation() != mpObj->GetVariation()) return CS_UNDEFINED;
+
+	ObjectReadIterator obj = hdr.BeginRead();
+	if(obj.Count() != mChunk.size()) return CS_UNDEFINED;
+
+	std::vector<CommandStatus> status;
+	status.reserve(mChunk.size());
+	for(size_t i = 0; i < mChunk.size(); ++i, ++obj) {
+		if(obj->Index() != mCommands[mChunk[i]].mIndex) return CS_UNDEFINED;
+		T cmd = mpObj->Read(*obj);
+		status.push_back((mChunkData[i] == mpObj->GetValueBytes(*obj)) ? cmd.mStatus : CS_FORMAT_ERROR);
+	}
+
+	if(aCode == FC_SELECT) {
+		// commands that failed to select are finished, the rest are operated
+		std::vector<size_t> selected;
+		for(size_t i = 0; i < mChunk.size(); ++i) {
+			if(status[i] == CS_SUCCESS) selected.push_back(mChunk[i]);
+			else mResponses[mChunk[i]] = CommandResponse(status[i]);
+		}
+		mChunk.swap(selected);
+		mAwaitingOperate = !mChunk.empty();
+	}
+	else {
+		for(size_t i = 0; i < mChunk.size(); ++i) mResponses[mChunk[i]] = CommandResponse(status[i]);
+		mChunk.clear();
+		mAwaitingOperate = false;
+	}
+
+	return CS_SUCCESS;
+}
+
+template <class T>
+void CommandBatchSequence<T>::Fail(CommandStatus aStatus)
+{
+	for(size_t pos : mChunk) mResponses[pos] = CommandResponse(aStatus);
+	mChunk.clear();
+	mAwaitingOperate = false;
+}
+
+}
+
+#endif
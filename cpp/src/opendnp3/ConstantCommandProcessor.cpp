@@ -115,5 +115,63 @@ void ConstantCommandProcessor::DirectOperate(const AnalogOutputDouble64& arComma
 	});
 }
 
+void ConstantCommandProcessor::SelectAndOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback)
+{
+	this->RespondToBatch(arCommands.size(), aCallback);
+}
+
+void ConstantCommandProcessor::DirectOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback)
+{
+	this->RespondToBatch(arCommands.size(), aCallback);
+}
+
+void ConstantCommandProcessor::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback)
+{
+	this->RespondToBatch(arCommands.size(), aCallback);
+}
+
+void ConstantCommandProcessor::DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback)
+{
+	this->RespondToBatch(arCommands.size(), aCallback);
+}
+
+void ConstantCommandProcessor::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback)
+{
+	this->RespondToBatch(arCommands.size(), aCallback);
+}
+
+void ConstantCommandProcessor::DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback)
+{
+	this->RespondToBatch(arCommands.size(), aCallback);
+}
+
+void ConstantCommandProcessor::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback)
+{
+	this->RespondToBatch(arCommands.size(), aCallback);
+}
+
+void ConstantCommandProcessor::DirectOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback)
+{
+	this->RespondToBatch(arCommands.size(), aCallback);
+}
+
+void ConstantCommandProcessor::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback)
+{
+	this->RespondToBatch(arCommands.size(), aCallback);
+}
+
+void ConstantCommandProcessor::DirectOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback)
+{
+	this->RespondToBatch(arCommands.size(), aCallback);
+}
+
+void ConstantCommandProcessor::RespondToBatch(size_t aNumCommands, BatchCallback aCallback)
+{
+	std::vector<CommandResponse> responses(aNumCommands, mResponse);
+	mpExecutor->Post([ = ]() {
+		aCallback(responses);
+	});
+}
+
 }
 
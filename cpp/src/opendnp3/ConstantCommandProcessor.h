@@ -56,7 +56,25 @@ public:
 	void SelectAndOperate(const AnalogOutputDouble64& arCommand, size_t aIndex, std::function<void (CommandResponse)> aCallback);
 	void DirectOperate(const AnalogOutputDouble64& arCommand, size_t aIndex, std::function<void (CommandResponse)> aCallback);
 
+	void SelectAndOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback);
+
 private:
+
+	void RespondToBatch(size_t aNumCommands, BatchCallback aCallback);
+
 	IExecutor* mpExecutor;
 	CommandResponse mResponse;
 };
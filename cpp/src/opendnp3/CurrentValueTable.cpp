@@ -0,0 +1,105 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "CurrentValueTable.h"
+
+#include <thread>
+
+namespace opendnp3
+{
+
+CurrentValueTable::CurrentValueTable(IDataObserver* apNext) :
+	mpNext(apNext),
+	mSequence(0)
+{
+
+}
+
+void CurrentValueTable::Read(CurrentValues& arValues) const
+{
+	while(true) {
+		uint64_t sequence = mSequence.load(std::memory_order_acquire);
+
+		if(sequence % 2 == 0) {
+			mBinary.Read(arValues.mBinary);
+			mAnalog.Read(arValues.mAnalog);
+			mCounter.Read(arValues.mCounter);
+			mControlStatus.Read(arValues.mControlStatus);
+			mSetpointStatus.Read(arValues.mSetpointStatus);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if(mSequence.load(std::memory_order_relaxed) == sequence) {
+				arValues.mVersion = sequence / 2;
+				return;
+			}
+		}
+
+		// a transaction is being applied, give the master thread a chance to finish it
+		std::this_thread::yield();
+	}
+}
+
+void CurrentValueTable::_Start()
+{
+	mSequence.store(mSequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	mpNext->Start();
+}
+
+void CurrentValueTable::_End()
+{
+	mSequence.store(mSequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	mpNext->End();
+}
+
+void CurrentValueTable::_Update(const Binary& arPoint, size_t aIndex)
+{
+	mBinary.Set(arPoint, aIndex);
+	mpNext->Update(arPoint, aIndex);
+}
+
+void CurrentValueTable::_Update(const Analog& arPoint, size_t aIndex)
+{
+	mAnalog.Set(arPoint, aIndex);
+	mpNext->Update(arPoint, aIndex);
+}
+
+void CurrentValueTable::_Update(const Counter& arPoint, size_t aIndex)
+{
+	mCounter.Set(arPoint, aIndex);
+	mpNext->Update(arPoint, aIndex);
+}
+
+void CurrentValueTable::_Update(const ControlStatus& arPoint, size_t aIndex)
+{
+	mControlStatus.Set(arPoint, aIndex);
+	mpNext->Update(arPoint, aIndex);
+}
+
+void CurrentValueTable::_Update(const SetpointStatus& arPoint, size_t aIndex)
+{
+	mSetpointStatus.Set(arPoint, aIndex);
+	mpNext->Update(arPoint, aIndex);
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
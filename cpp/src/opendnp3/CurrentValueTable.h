@@ -0,0 +1,188 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __CURRENT_VALUE_TABLE_H_
+#define __CURRENT_VALUE_TABLE_H_
+
+#include <opendnp3/CurrentValues.h>
+#include <opendnp3/IDataObserver.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <vector>
+
+namespace opendnp3
+{
+
+/**
+* One measurement type of the current value table. Values, qualities and times are kept
+* in separate arrays that grow to the highest index seen. Every slot is an atomic so the
+* writer never blocks a reader, and storage that has been outgrown is retired rather than
+* freed because a reader may still be copying from it.
+*/
+template <class T, class V>
+class DLL_LOCAL CurrentValueColumn : private Uncopyable
+{
+public:
+
+	// indices above this aren't kept, so a malformed response can't make the table huge
+	static const size_t MAX_INDEX = 65535;
+
+	CurrentValueColumn() : mpStorage(NULL), mSize(0) {}
+
+	// only called by the writer
+	void Set(const T& arPoint, size_t aIndex);
+
+	// readers validate the copy against the table's sequence number
+	void Read(std::vector<T>& arPoints) const;
+
+	size_t Size() const {
+		return mSize.load(std::memory_order_relaxed);
+	}
+
+private:
+
+	struct Storage {
+		Storage(size_t aCapacity);
+
+		std::vector< std::atomic<V> > mValues;
+		std::vector< std::atomic<uint8_t> > mQualities;
+		std::vector< std::atomic<millis_t> > mTimes;
+	};
+
+	void Grow(size_t aSize);
+
+	std::atomic<Storage*> mpStorage;
+	std::atomic<size_t> mSize;
+	std::deque<Storage> mStorage;	// the current storage and every one it replaced
+};
+
+/**
+* Keeps the latest value of every point the master receives and forwards each transaction
+* to the user's observer. The master thread is the only writer. Any thread can take a
+* consistent snapshot with Read(), which never blocks the writer: each transaction makes
+* a sequence number odd then even again, and a reader retries if the number was odd or
+* changed while it was copying.
+*/
+class DLL_LOCAL CurrentValueTable : public IDataObserver
+{
+public:
+
+	CurrentValueTable(IDataObserver* apNext);
+
+	void Read(CurrentValues& arValues) const;
+
+	// Number of transactions applied so far
+	uint64_t Version() const {
+		return mSequence.load(std::memory_order_acquire) / 2;
+	}
+
+private:
+
+	void _Start();
+	void _End();
+
+	void _Update(const Binary& arPoint, size_t aIndex);
+	void _Update(const Analog& arPoint, size_t aIndex);
+	void _Update(const Counter& arPoint, size_t aIndex);
+	void _Update(const ControlStatus& arPoint, size_t aIndex);
+	void _Update(const SetpointStatus& arPoint, size_t aIndex);
+
+	IDataObserver* mpNext;
+	std::atomic<uint64_t> mSequence;
+
+	CurrentValueColumn<Binary, bool> mBinary;
+	CurrentValueColumn<Analog, double> mAnalog;
+	CurrentValueColumn<Counter, uint32_t> mCounter;
+	CurrentValueColumn<ControlStatus, bool> mControlStatus;
+	CurrentValueColumn<SetpointStatus, double> mSetpointStatus;
+};
+
+template <class T, class V>
+CurrentValueColumn<T, V>::Storage::Storage(size_t aCapacity) :
+	mValues(aCapacity),
+	mQualities(aCapacity),
+	mTimes(aCapacity)
+{
+	T point;
+	for(size_t i = 0; i < aCapacity; ++i) {
+		mValues[i].store(point.GetValue(), std::memory_order_relaxed);
+		mQualities[i].store(point.GetQuality(), std::memory_order_relaxed);
+		mTimes[i].store(point.GetTime(), std::memory_order_relaxed);
+	}
+}
+
+template <class T, class V>
+void CurrentValueColumn<T, V>::Set(const T& arPoint, size_t aIndex)
+{
+	if(aIndex > MAX_INDEX) return;
+	if(aIndex >= mSize.load(std::memory_order_relaxed)) this->Grow(aIndex + 1);
+
+	Storage* pStorage = mpStorage.load(std::memory_order_relaxed);
+	pStorage->mValues[aIndex].store(arPoint.GetValue(), std::memory_order_relaxed);
+	pStorage->mQualities[aIndex].store(arPoint.GetQuality(), std::memory_order_relaxed);
+	pStorage->mTimes[aIndex].store(arPoint.GetTime(), std::memory_order_relaxed);
+}
+
+template <class T, class V>
+void CurrentValueColumn<T, V>::Grow(size_t aSize)
+{
+	Storage* pOld = mpStorage.load(std::memory_order_relaxed);
+	size_t capacity = (pOld == NULL) ? 0 : pOld->mValues.size();
+
+	if(aSize > capacity) {
+		size_t size = mSize.load(std::memory_order_relaxed);
+		mStorage.emplace_back(std::max<size_t>(std::max<size_t>(2 * capacity, aSize), 16));
+		Storage* pNew = &mStorage.back();
+		for(size_t i = 0; i < size; ++i) {
+			pNew->mValues[i].store(pOld->mValues[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			pNew->mQualities[i].store(pOld->mQualities[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			pNew->mTimes[i].store(pOld->mTimes[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		mpStorage.store(pNew, std::memory_order_release);
+	}
+
+	// published after the storage so a reader that sees the size also sees room for it
+	mSize.store(aSize, std::memory_order_release);
+}
+
+template <class T, class V>
+void CurrentValueColumn<T, V>::Read(std::vector<T>& arPoints) const
+{
+	size_t size = mSize.load(std::memory_order_acquire);
+	const Storage* pStorage = mpStorage.load(std::memory_order_acquire);
+
+	arPoints.resize(size);
+	for(size_t i = 0; i < size; ++i) {
+		T point(pStorage->mValues[i].load(std::memory_order_relaxed), pStorage->mQualities[i].load(std::memory_order_relaxed));
+		point.SetTime(pStorage->mTimes[i].load(std::memory_order_relaxed));
+		arPoints[i] = point;
+	}
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
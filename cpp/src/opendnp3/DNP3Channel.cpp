@@ -33,17 +33,28 @@
 namespace opendnp3
 {
 
-DNP3Channel::DNP3Channel(Logger* apLogger, millis_t aOpenRetry, boost::asio::io_service* apService, IPhysicalLayerAsync* apPhys, ITimeSource* apTimeSource, std::function<void (DNP3Channel*)> aOnShutdown) :
+DNP3Channel::DNP3Channel(Logger* apLogger, const OpenRetryPolicy& arOpenRetry, boost::asio::io_service* apService, IPhysicalLayerAsync* apPhys, ITimeSource* apTimeSource, std::function<void (DNP3Channel*)> aOnShutdown, BusScheduler* apScheduler, OpenLimiter* apLimiter, DeliveryPool* apDeliveryPool, DecodePool* apDecodePool) :
 	Loggable(apLogger),
 	mpService(apService),
 	mpPhys(apPhys),
 	mOnShutdown(aOnShutdown),
-	mRouter(apLogger->GetSubLogger("Router"), mpPhys.get(), aOpenRetry)
+	mpScheduler(apScheduler),
+	mpDeliveryPool(apDeliveryPool),
+	mpDecodePool(apDecodePool),
+	mRouter(apLogger->GetSubLogger("Router"), mpPhys.get(), arOpenRetry, apLimiter)
 #ifndef OPENDNP3_NO_MASTER
 	, mGroup(apPhys->GetExecutor(), apTimeSource)
 #endif
 {
-
+	if(mpScheduler.get()) {
+		BusScheduler* pScheduler = mpScheduler.get();
+		mRouter.SetTrafficHandler([pScheduler](size_t aNumBytes) {
+			pScheduler->OnTraffic(aNumBytes);
+		});
+#ifndef OPENDNP3_NO_MASTER
+		mGroup.SetScheduler(pScheduler);
+#endif
+	}
 }
 
 DNP3Channel::~DNP3Channel()
@@ -62,6 +73,23 @@ void DNP3Channel::AddStateListener(std::function<void (ChannelState)> aListener)
 	mRouter.AddStateListener(aListener);
 }
 
+double DNP3Channel::GetBusUtilization()
+{
+	if(mpScheduler.get() == NULL) return 0.0;
+	ExecutorPause p(mpPhys->GetExecutor());
+	return mpScheduler->SampleUtilization();
+}
+
+OpenStatistics DNP3Channel::GetOpenStatistics()
+{
+	return mRouter.GetOpenStatistics();
+}
+
+ChannelStatistics DNP3Channel::GetStatistics()
+{
+	return mRouter.GetStatistics();
+}
+
 void DNP3Channel::Cleanup()
 {
 	std::set<IStack*> copy(mStacks);
@@ -88,7 +116,7 @@ IMaster* DNP3Channel::AddMaster(const std::string& arLoggerId, FilterLevel aLeve
 		auto pLogger = mpLogger->GetSubLogger(arLoggerId, aLevel);
 		auto pMaster = new MasterStackImpl(pLogger, mpService, mpPhys->GetExecutor(), apPublisher, &mGroup, arCfg, [this, route](IStack * apStack) {
 			this->OnStackShutdown(apStack, route);
-		});
+		}, mpDeliveryPool, mpDecodePool);
 		pMaster->SetLinkRouter(&mRouter);
 		mStacks.insert(pMaster);
 		mRouter.AddContext(pMaster->GetLinkContext(), route);
@@ -27,6 +27,7 @@
 #include <opendnp3/SlaveStackConfig.h>
 #include <opendnp3/Visibility.h>
 
+#include "BusScheduler.h"
 #include "LinkLayerRouter.h"
 #include "Loggable.h"
 
@@ -53,11 +54,19 @@ class ITimeSource;
 class IStack;
 class IOutstation;
 class ICommandHandler;
+class DeliveryPool;
+class DecodePool;
 
 class DLL_LOCAL DNP3Channel: public IChannel, private Loggable
 {
 public:
-	DNP3Channel(Logger* apLogger, millis_t aOpenRetry, boost::asio::io_service* apService, IPhysicalLayerAsync* apPhys, ITimeSource* apTimerSource, std::function<void (DNP3Channel*)> aOnShutdown);
+	/**
+		@param apScheduler Optional bus scheduler for serial channels, the channel takes ownership
+		@param apLimiter Optional limit on concurrent opens shared by the manager's channels
+		@param apDeliveryPool Optional threads that serve the delivery queues of masters, shared by the manager's channels
+		@param apDecodePool Optional threads that decode data responses for masters, shared by the manager's channels
+	*/
+	DNP3Channel(Logger* apLogger, const OpenRetryPolicy& arOpenRetry, boost::asio::io_service* apService, IPhysicalLayerAsync* apPhys, ITimeSource* apTimerSource, std::function<void (DNP3Channel*)> aOnShutdown, BusScheduler* apScheduler = NULL, OpenLimiter* apLimiter = NULL, DeliveryPool* apDeliveryPool = NULL, DecodePool* apDecodePool = NULL);
 	~DNP3Channel();
 
 	// Implement IChannel - these are exposed to clients
@@ -66,6 +75,12 @@ public:
 
 	void AddStateListener(std::function<void (ChannelState)> aListener);
 
+	double GetBusUtilization();
+
+	OpenStatistics GetOpenStatistics();
+
+	ChannelStatistics GetStatistics();
+
 #ifndef OPENDNP3_NO_MASTER
 
 	IMaster* AddMaster(		const std::string& arLoggerId,
@@ -91,6 +106,9 @@ private:
 	boost::asio::io_service* mpService;
 	std::auto_ptr<IPhysicalLayerAsync> mpPhys;
 	std::function<void (DNP3Channel*)> mOnShutdown;
+	std::auto_ptr<BusScheduler> mpScheduler;
+	DeliveryPool* mpDeliveryPool;
+	DecodePool* mpDecodePool;
 	LinkLayerRouter mRouter;
 
 #ifndef OPENDNP3_NO_MASTER
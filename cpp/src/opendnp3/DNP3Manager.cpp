@@ -24,6 +24,17 @@
 
 #include "PhysicalLayerAsyncTCPClient.h"
 #include "PhysicalLayerAsyncTCPServer.h"
+#include "PhysicalLayerAsyncUDP.h"
+#include "UDPSocketService.h"
+#ifdef OPENDNP3_IO_URING
+#include "PhysicalLayerAsyncUringTCPClient.h"
+#include "PhysicalLayerAsyncUringTCPServer.h"
+#include "UringService.h"
+#endif
+#ifdef OPENDNP3_SHARED_MEMORY
+#include "PhysicalLayerAsyncSharedMemoryClient.h"
+#include "PhysicalLayerAsyncSharedMemoryServer.h"
+#endif
 #ifndef OPENDNP3_NO_SERIAL
 #include "PhysicalLayerAsyncSerial.h"
 #endif
@@ -31,13 +42,25 @@
 #include "IOServiceThreadPool.h"
 #include "Log.h"
 #include "DNP3Channel.h"
+#include "BusScheduler.h"
+#include "OpenLimiter.h"
+#include "DeliveryPool.h"
+#include "DecodePool.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Location.h>
+
+#include <sstream>
 
 namespace opendnp3
 {
 
 DNP3Manager::DNP3Manager(uint32_t aConcurrency, std::function<void()> aOnThreadStart, std::function<void()> aOnThreadExit) :
 	mpLog(new EventLog()),
-	mpThreadPool(new IOServiceThreadPool(mpLog->GetLogger(LEV_INFO, "ThreadPool"),  aConcurrency, aOnThreadStart, aOnThreadExit))
+	mpThreadPool(new IOServiceThreadPool(mpLog->GetLogger(LEV_INFO, "ThreadPool"),  aConcurrency, aOnThreadStart, aOnThreadExit)),
+	mpOpenLimiter(new OpenLimiter()),
+	mpDeliveryPool(new DeliveryPool(1, aOnThreadStart, aOnThreadExit)),
+	mpDecodePool(new DecodePool(std::thread::hardware_concurrency(), aOnThreadStart, aOnThreadExit))
 {
 
 }
@@ -45,6 +68,17 @@ DNP3Manager::DNP3Manager(uint32_t aConcurrency, std::function<void()> aOnThreadS
 DNP3Manager::~DNP3Manager()
 {
 	this->Shutdown();
+
+	// shared sockets and rings stop waiting on the pool before the pool is joined
+	bool sharedServices = !mUDPServices.empty();
+for(auto& pair: mUDPServices) pair.second->Shutdown();
+#ifdef OPENDNP3_IO_URING
+	if(mpUringService.get() != NULL) {
+		mpUringService->Shutdown();
+		sharedServices = true;
+	}
+#endif
+	if(sharedServices) mpThreadPool->Shutdown();
 }
 
 void DNP3Manager::AddLogSubscriber(ILogBase* apLog)
@@ -58,38 +92,129 @@ void DNP3Manager::Shutdown()
 for(auto pChannel: copy) pChannel->Shutdown();
 }
 
-IChannel* DNP3Manager::AddTCPClient(const std::string& arName, FilterLevel aLevel, millis_t aOpenRetry, const std::string& arAddr, uint16_t aPort)
+void DNP3Manager::SetMaxConcurrentOpens(size_t aMaxOpens)
+{
+	mpOpenLimiter->SetMaxInFlight(aMaxOpens);
+}
+
+size_t DNP3Manager::GetNumOpensInFlight()
+{
+	return mpOpenLimiter->GetNumInFlight();
+}
+
+size_t DNP3Manager::GetNumOpensWaiting()
+{
+	return mpOpenLimiter->GetNumWaiting();
+}
+
+void DNP3Manager::SetDeliveryConcurrency(size_t aThreads)
+{
+	mpDeliveryPool->SetConcurrency(aThreads);
+}
+
+void DNP3Manager::SetDecodeConcurrency(size_t aThreads)
+{
+	mpDecodePool->SetConcurrency(aThreads);
+}
+
+IChannel* DNP3Manager::AddTCPClient(const std::string& arName, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, const std::string& arAddr, uint16_t aPort, TransportBackend aBackend)
 {
 	auto pLogger = mpLog->GetLogger(aLevel, arName);
-	auto pPhys = new PhysicalLayerAsyncTCPClient(pLogger, mpThreadPool->GetIOService(), arAddr, aPort);
-	return CreateChannel(pLogger, aOpenRetry, pPhys);
+	IPhysicalLayerAsync* pPhys = NULL;
+	if(aBackend == TB_IO_URING) {
+#ifdef OPENDNP3_IO_URING
+		pPhys = new PhysicalLayerAsyncUringTCPClient(pLogger, mpThreadPool->GetIOService(), GetUringService(), arAddr, aPort);
+#endif
+	}
+	else pPhys = new PhysicalLayerAsyncTCPClient(pLogger, mpThreadPool->GetIOService(), arAddr, aPort);
+	return CreateChannel(pLogger, arOpenRetry, pPhys);
 }
 
-IChannel* DNP3Manager::AddTCPServer(const std::string& arName, FilterLevel aLevel, millis_t aOpenRetry, const std::string& arEndpoint, uint16_t aPort)
+IChannel* DNP3Manager::AddTCPServer(const std::string& arName, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, const std::string& arEndpoint, uint16_t aPort, TransportBackend aBackend)
 {
 	auto pLogger = mpLog->GetLogger(aLevel, arName);
-	auto pPhys = new PhysicalLayerAsyncTCPServer(pLogger, mpThreadPool->GetIOService(), arEndpoint, aPort);
-	return CreateChannel(pLogger, aOpenRetry, pPhys);
+	IPhysicalLayerAsync* pPhys = NULL;
+	if(aBackend == TB_IO_URING) {
+#ifdef OPENDNP3_IO_URING
+		pPhys = new PhysicalLayerAsyncUringTCPServer(pLogger, mpThreadPool->GetIOService(), GetUringService(), arEndpoint, aPort);
+#endif
+	}
+	else pPhys = new PhysicalLayerAsyncTCPServer(pLogger, mpThreadPool->GetIOService(), arEndpoint, aPort);
+	return CreateChannel(pLogger, arOpenRetry, pPhys);
+}
+
+IChannel* DNP3Manager::AddUDPChannel(const std::string& arName, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, const std::string& arLocalEndpoint, uint16_t aLocalPort, const std::string& arRemoteAddress, uint16_t aRemotePort, int32_t aLinkAddress)
+{
+	auto pLogger = mpLog->GetLogger(aLevel, arName);
+	auto pPhys = new PhysicalLayerAsyncUDP(pLogger, mpThreadPool->GetIOService(), GetUDPService(arLocalEndpoint, aLocalPort), arRemoteAddress, aRemotePort, aLinkAddress);
+	return CreateChannel(pLogger, arOpenRetry, pPhys);
+}
+
+IChannel* DNP3Manager::AddSharedMemoryServer(const std::string& arName, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, const std::string& arSegment, size_t aCapacity)
+{
+	auto pLogger = mpLog->GetLogger(aLevel, arName);
+	IPhysicalLayerAsync* pPhys = NULL;
+#ifdef OPENDNP3_SHARED_MEMORY
+	pPhys = new PhysicalLayerAsyncSharedMemoryServer(pLogger, mpThreadPool->GetIOService(), arSegment, aCapacity);
+#endif
+	return CreateChannel(pLogger, arOpenRetry, pPhys);
+}
+
+IChannel* DNP3Manager::AddSharedMemoryClient(const std::string& arName, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, const std::string& arSegment)
+{
+	auto pLogger = mpLog->GetLogger(aLevel, arName);
+	IPhysicalLayerAsync* pPhys = NULL;
+#ifdef OPENDNP3_SHARED_MEMORY
+	pPhys = new PhysicalLayerAsyncSharedMemoryClient(pLogger, mpThreadPool->GetIOService(), arSegment);
+#endif
+	return CreateChannel(pLogger, arOpenRetry, pPhys);
 }
 
 #ifndef OPENDNP3_NO_SERIAL
-IChannel* DNP3Manager::AddSerial(const std::string& arName, FilterLevel aLevel, millis_t aOpenRetry, SerialSettings aSettings)
+IChannel* DNP3Manager::AddSerial(const std::string& arName, FilterLevel aLevel, const OpenRetryPolicy& arOpenRetry, SerialSettings aSettings)
 {
 	auto pLogger = mpLog->GetLogger(aLevel, arName);
 	auto pPhys = new PhysicalLayerAsyncSerial(pLogger, mpThreadPool->GetIOService(), aSettings);
-	return CreateChannel(pLogger, aOpenRetry, pPhys);
+	auto pScheduler = new BusScheduler(TimeSource::Inst(), aSettings.mBaud, GetBitsPerCharacter(aSettings));
+	return CreateChannel(pLogger, arOpenRetry, pPhys, pScheduler);
 }
 #endif
 
-IChannel* DNP3Manager::CreateChannel(Logger* apLogger, millis_t aOpenRetry, IPhysicalLayerAsync* apPhys)
+IChannel* DNP3Manager::CreateChannel(Logger* apLogger, const OpenRetryPolicy& arOpenRetry, IPhysicalLayerAsync* apPhys, BusScheduler* apScheduler)
 {
-	auto pChannel = new DNP3Channel(apLogger, aOpenRetry, mpThreadPool->GetIOService(), apPhys, TimeSource::Inst(), [this](DNP3Channel * apChannel) {
+	if(apPhys == NULL) MACRO_THROW_EXCEPTION(ArgumentException, "Transport backend is not supported by this build");
+
+	auto pChannel = new DNP3Channel(apLogger, arOpenRetry, mpThreadPool->GetIOService(), apPhys, TimeSource::Inst(), [this](DNP3Channel * apChannel) {
 		this->OnChannelShutdownCallback(apChannel);
-	});
+	}, apScheduler, mpOpenLimiter.get(), mpDeliveryPool.get(), mpDecodePool.get());
 	mChannels.insert(pChannel);
 	return pChannel;
 }
 
+UringService* DNP3Manager::GetUringService()
+{
+#ifdef OPENDNP3_IO_URING
+	if(mpUringService.get() == NULL) {
+		mpUringService.reset(new UringService(mpLog->GetLogger(LEV_INFO, "io_uring"), mpThreadPool->GetIOService()));
+	}
+#endif
+	return mpUringService.get();
+}
+
+UDPSocketService* DNP3Manager::GetUDPService(const std::string& arEndpoint, uint16_t aPort)
+{
+	std::ostringstream oss;
+	oss << arEndpoint << ":" << aPort;
+
+	auto iter = mUDPServices.find(oss.str());
+	if(iter != mUDPServices.end()) return iter->second.get();
+
+	boost::asio::ip::udp::endpoint local(boost::asio::ip::address::from_string(arEndpoint), aPort);
+	std::shared_ptr<UDPSocketService> pService(new UDPSocketService(mpLog->GetLogger(LEV_INFO, "udp-" + oss.str()), mpThreadPool->GetIOService(), local));
+	mUDPServices[oss.str()] = pService;
+	return pService.get();
+}
+
 void DNP3Manager::OnChannelShutdownCallback(DNP3Channel* apChannel)
 {
 	mChannels.erase(apChannel);
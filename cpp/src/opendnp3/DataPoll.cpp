@@ -29,6 +29,7 @@
 #include "ITimeSource.h"
 #include "APDU.h"
 #include "ResponseLoader.h"
+#include "DecodePipeline.h"
 
 #include "VtoReader.h"
 
@@ -37,43 +38,71 @@ namespace opendnp3
 
 /* DataPoll - base class */
 
-DataPoll::DataPoll(Logger* apLogger, IDataObserver* apObs, VtoReader* apVtoReader) :
+DataPoll::DataPoll(Logger* apLogger, IDataObserver* apObs, VtoReader* apVtoReader, ChangeFilter* apFilter) :
 	MasterTaskBase(apLogger),
 	mpObs(apObs),
-	mpVtoReader(apVtoReader)
+	mpVtoReader(apVtoReader),
+	mpFilter(apFilter),
+	mpDecoder(NULL),
+	mNumFragments(0),
+	mNumObjects(0),
+	mNumBytes(0),
+	mNumSuppressed(0),
+	mPollId(0)
 {}
 
+void DataPoll::Init()
+{
+	++mPollId;
+	mNumFragments = mNumObjects = mNumBytes = mNumSuppressed = 0;
+	mLastIIN.Zero();
+}
+
 TaskResult DataPoll::_OnPartialResponse(const APDU& f)
 {
-	this->ReadData(f);
+	this->ReadData(f, false);
 	return TR_CONTINUE;
 }
 
 TaskResult DataPoll::_OnFinalResponse(const APDU& f)
 {
-	this->ReadData(f);
+	this->ReadData(f, true);
 	return TR_SUCCESS;
 }
 
-void DataPoll::ReadData(const APDU& f)
+void DataPoll::ReadData(const APDU& f, bool aFinal)
 {
-	ResponseLoader loader(mpLogger, mpObs, mpVtoReader);
+	++mNumFragments;
+	mNumBytes += f.Size();
+	mLastIIN = f.GetIIN();
+
 	HeaderReadIterator hdr = f.BeginRead();
+	if(mpDecoder) {
+		for ( ; !hdr.IsEnd(); ++hdr) ++mNumObjects;
+		mpDecoder->Submit(f, mPollId, aFinal);
+		return;
+	}
+
+	ResponseLoader loader(mpLogger, mpObs, mpVtoReader, mpFilter);
 	for ( ; !hdr.IsEnd(); ++hdr) {
 		loader.Process(hdr);
+		++mNumObjects;
 	}
+	mNumSuppressed += loader.NumSuppressed();
 }
 
 /* Class Poll */
 
-ClassPoll::ClassPoll(Logger* apLogger, IDataObserver* apObs, VtoReader* apVtoReader) :
-	DataPoll(apLogger, apObs, apVtoReader),
-	mClassMask(PC_INVALID)
+ClassPoll::ClassPoll(Logger* apLogger, IDataObserver* apObs, VtoReader* apVtoReader, ChangeFilter* apFilter) :
+	DataPoll(apLogger, apObs, apVtoReader, apFilter),
+	mClassMask(PC_INVALID),
+	mpScan(NULL)
 {}
 
-void ClassPoll::Set(int aClassMask)
+void ClassPoll::Set(int aClassMask, EventScan* apScan)
 {
 	mClassMask = aClassMask;
+	mpScan = apScan;
 }
 
 void ClassPoll::ConfigureRequest(APDU& arAPDU)
@@ -23,6 +23,7 @@
 #ifndef __DATA_POLL_H_
 #define __DATA_POLL_H_
 
+#include "AppHeader.h"
 #include "MasterTaskBase.h"
 #include "VtoReader.h"
 
@@ -32,6 +33,9 @@ namespace opendnp3
 {
 
 class IDataObserver;
+class EventScan;
+class ChangeFilter;
+class DecodePipeline;
 
 /**
  * Base class for all data acquistion polls
@@ -40,11 +44,38 @@ class DLL_LOCAL DataPoll : public MasterTaskBase
 {
 public:
 
-	DataPoll(Logger*, IDataObserver*, VtoReader*);
+	DataPoll(Logger*, IDataObserver*, VtoReader*, ChangeFilter*);
+
+	void Init();
+
+	// Fragments are handed to the pipeline instead of being loaded here, NULL to load them here
+	void SetDecoder(DecodePipeline* apDecoder) {
+		mpDecoder = apDecoder;
+	}
+
+	// Totals over the fragments of the current poll
+	size_t NumFragments() const {
+		return mNumFragments;
+	}
+	size_t NumObjects() const {
+		return mNumObjects;
+	}
+	size_t NumBytes() const {
+		return mNumBytes;
+	}
+	// Always zero when the fragments go to a decoder, which counts them per poll as it publishes
+	size_t NumSuppressed() const {
+		return mNumSuppressed;
+	}
+
+	// IIN of the last fragment of the current poll
+	const IINField& LastIIN() const {
+		return mLastIIN;
+	}
 
 private:
 
-	void ReadData(const APDU&);
+	void ReadData(const APDU&, bool aFinal);
 
 	//Implement MasterTaskBase
 	TaskResult _OnPartialResponse(const APDU&);
@@ -53,6 +84,15 @@ private:
 	IDataObserver* mpObs;
 
 	VtoReader* mpVtoReader;
+	ChangeFilter* mpFilter;
+	DecodePipeline* mpDecoder;
+
+	size_t mNumFragments;
+	size_t mNumObjects;
+	size_t mNumBytes;
+	size_t mNumSuppressed;
+	uint64_t mPollId;		// tags the fragments handed to the decoder, 0 is never used
+	IINField mLastIIN;
 
 };
 
@@ -62,9 +102,15 @@ class DLL_LOCAL ClassPoll : public DataPoll
 {
 public:
 
-	ClassPoll(Logger*, IDataObserver*, VtoReader*);
+	// @param apFilter Drops unchanged static values, NULL to publish everything
+	ClassPoll(Logger*, IDataObserver*, VtoReader*, ChangeFilter* apFilter = NULL);
+
+	// @param apScan The exception scan being run, NULL for an integrity poll
+	void Set(int aClassMask, EventScan* apScan = NULL);
 
-	void Set(int aClassMask);
+	EventScan* GetScan() {
+		return mpScan;
+	}
 
 	//Implement MasterTaskBase
 	void ConfigureRequest(APDU& arAPDU);
@@ -75,6 +121,7 @@ public:
 private:
 
 	int mClassMask;
+	EventScan* mpScan;
 
 };
 
@@ -28,6 +28,7 @@
 #include <opendnp3/DNPConstants.h>
 #include <opendnp3/DeviceTemplate.h>
 
+#include "DatabaseSnapshot.h"
 #include "LoggableMacros.h"
 
 
@@ -193,6 +194,36 @@ void Database::SetEventBuffer(IEventBuffer* apEventBuffer)
 	mpEventBuffer = apEventBuffer;
 }
 
+void Database::SaveSnapshot(const std::string& arPath)
+{
+	SnapshotWriter writer(arPath);
+	writer.Write(DT_BINARY, mBinaryVec);
+	writer.Write(DT_ANALOG, mAnalogVec);
+	writer.Write(DT_COUNTER, mCounterVec);
+	writer.Write(DT_CONTROL_STATUS, mControlStatusVec);
+	writer.Write(DT_SETPOINT_STATUS, mSetpointStatusVec);
+	writer.Commit();
+}
+
+size_t Database::LoadSnapshot(const std::string& arPath)
+{
+	SnapshotReader reader(arPath);
+	if(!reader.IsValid()) {
+		LOG_BLOCK(LEV_WARNING, "No usable snapshot at: " << arPath);
+		return 0;
+	}
+
+	size_t num = 0;
+	num += reader.Read(DT_BINARY, mBinaryVec);
+	num += reader.Read(DT_ANALOG, mAnalogVec);
+	num += reader.Read(DT_COUNTER, mCounterVec);
+	num += reader.Read(DT_CONTROL_STATUS, mControlStatusVec);
+	num += reader.Read(DT_SETPOINT_STATUS, mSetpointStatusVec);
+
+	LOG_BLOCK(LEV_INFO, "Restored " << num << " points from snapshot: " << arPath);
+	return num;
+}
+
 ////////////////////////////////////////////////////
 // IDataObserver interfae - Private NVII functions -
 ////////////////////////////////////////////////////
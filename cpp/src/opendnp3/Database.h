@@ -33,6 +33,7 @@
 #include <opendnp3/Visibility.h>
 
 #include <set>
+#include <string>
 #include <vector>
 #include <limits>
 
@@ -73,6 +74,23 @@ public:
 
 	void SetEventBuffer(IEventBuffer*);
 
+	/* Snapshot functions */
+
+	/**
+	* Writes the value, quality, and timestamp of every point to a snapshot file.
+	* The previous snapshot at the path is only replaced once the new one is complete.
+	* @param arPath path of the snapshot file
+	*/
+	void SaveSnapshot(const std::string& arPath);
+
+	/**
+	* Restores values, qualities, and timestamps from a snapshot without generating events.
+	* Call after Configure, points beyond the configured counts are left at their defaults.
+	* @param arPath path of the snapshot file
+	* @return the number of points restored, 0 if the snapshot is missing or unusable
+	*/
+	size_t LoadSnapshot(const std::string& arPath);
+
 	/* Functions for obtaining iterators */
 
 	void Begin(BinaryIterator& arIter)		{
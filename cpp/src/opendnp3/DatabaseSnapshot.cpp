@@ -0,0 +1,134 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "DatabaseSnapshot.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Location.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace boost::interprocess;
+
+namespace opendnp3
+{
+
+const uint32_t SNAPSHOT_MAGIC = 0x53504E44; // "DNPS"
+const uint32_t SNAPSHOT_VERSION = 1;
+
+SnapshotWriter::SnapshotWriter(const std::string& arPath) :
+	mPath(arPath),
+	mTempPath(arPath + ".tmp"),
+	mOffset(sizeof(SnapshotHeader)),
+	mCommitted(false)
+{
+	if(mPath.empty()) MACRO_THROW_EXCEPTION(ArgumentException, "Snapshot path is empty");
+
+	mFile.open(mTempPath.c_str(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+	if(!mFile.is_open()) MACRO_THROW_EXCEPTION(ArgumentException, "Unable to create snapshot: " + mTempPath);
+
+	// reserve space for the header, it's completed on commit
+	memset(&mHeader, 0, sizeof(mHeader));
+	this->WriteBytes(&mHeader, sizeof(mHeader));
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+	if(!mCommitted) {
+		mFile.close();
+		remove(mTempPath.c_str());
+	}
+}
+
+void SnapshotWriter::Commit()
+{
+	mHeader.mMagic = SNAPSHOT_MAGIC;
+	mHeader.mVersion = SNAPSHOT_VERSION;
+	mFile.seekp(0);
+	this->WriteBytes(&mHeader, sizeof(mHeader));
+	mFile.close();
+	if(mFile.fail()) MACRO_THROW_EXCEPTION(Exception, "Unable to write snapshot: " + mTempPath);
+
+#ifdef WIN32
+	// rename doesn't replace an existing file on windows
+	remove(mPath.c_str());
+#endif
+
+	if(rename(mTempPath.c_str(), mPath.c_str()) != 0) {
+		MACRO_THROW_EXCEPTION(Exception, "Unable to replace snapshot: " + mPath);
+	}
+
+	mCommitted = true;
+}
+
+void SnapshotWriter::WriteBytes(const void* apData, size_t aSize)
+{
+	mFile.write(reinterpret_cast<const char*>(apData), aSize);
+	if(mFile.fail()) MACRO_THROW_EXCEPTION(Exception, "Unable to write snapshot: " + mTempPath);
+}
+
+SnapshotReader::SnapshotReader(const std::string& arPath) :
+	mpHeader(NULL),
+	mValid(false)
+{
+	// a missing snapshot is normal on the first start, don't let the mapping throw
+	std::ifstream existing(arPath.c_str(), std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+	bool readable = existing.is_open() && existing.tellg() >= static_cast<std::streamoff>(sizeof(SnapshotHeader));
+	existing.close();
+	if(!readable) return;
+
+	file_mapping mapping(arPath.c_str(), read_only);
+	mapped_region region(mapping, read_only);
+	mRegion.swap(region);
+
+	mpHeader = reinterpret_cast<const SnapshotHeader*>(mRegion.get_address());
+	mValid = this->Validate();
+}
+
+bool SnapshotReader::Validate() const
+{
+	if(mpHeader->mMagic != SNAPSHOT_MAGIC || mpHeader->mVersion != SNAPSHOT_VERSION) return false;
+
+	uint64_t sizes[SNAPSHOT_NUM_SECTIONS] = {
+		SnapshotSectionSize<Binary>(mpHeader->mCount[DT_BINARY]),
+		SnapshotSectionSize<Analog>(mpHeader->mCount[DT_ANALOG]),
+		SnapshotSectionSize<Counter>(mpHeader->mCount[DT_COUNTER]),
+		SnapshotSectionSize<ControlStatus>(mpHeader->mCount[DT_CONTROL_STATUS]),
+		SnapshotSectionSize<SetpointStatus>(mpHeader->mCount[DT_SETPOINT_STATUS])
+	};
+
+	uint64_t size = mRegion.get_size();
+	for(size_t i = 0; i < SNAPSHOT_NUM_SECTIONS; ++i) {
+		// guards against counts large enough to wrap the size calculation
+		if(mpHeader->mCount[i] > size) return false;
+		if(mpHeader->mOffset[i] % 8 != 0) return false;
+		if(mpHeader->mOffset[i] > size || sizes[i] > size - mpHeader->mOffset[i]) return false;
+	}
+
+	return true;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,233 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __DATABASE_SNAPSHOT_H_
+#define __DATABASE_SNAPSHOT_H_
+
+#include <opendnp3/DataTypes.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include "DNPDatabaseTypes.h"
+
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace opendnp3
+{
+
+/// One section per DataTypes value, in enum order
+const size_t SNAPSHOT_NUM_SECTIONS = 5;
+
+/**
+Fixed size header at the start of a snapshot file.
+
+Each data type is stored as its own section of parallel columns: timestamps,
+then values, then qualities. Sections start on 8 byte boundaries so a mapped
+snapshot can be read in place without copying it first.
+*/
+struct DLL_LOCAL SnapshotHeader {
+	uint32_t mMagic;
+	uint32_t mVersion;
+	uint64_t mCount[SNAPSHOT_NUM_SECTIONS];		// number of points in each section
+	uint64_t mOffset[SNAPSHOT_NUM_SECTIONS];	// file offset of each section
+};
+
+/// Describes the value column of a type. Bool types carry their state in the quality column.
+template <class T>
+struct SnapshotColumn {
+	typedef typename T::Type Type;
+	static const bool STORED = true;
+
+	static Type Get(const T& arValue) {
+		return arValue.GetValue();
+	}
+
+	static void Restore(PointInfo<T>& arPoint, const Type* apValues, uint8_t aQuality, size_t aIndex) {
+		arPoint.mValue.SetValue(apValues[aIndex]);
+		arPoint.mValue.SetQuality(aQuality);
+		arPoint.mLastEventValue = arPoint.mValue.GetValue();
+	}
+};
+
+template <class T>
+struct SnapshotBoolColumn {
+	typedef uint8_t Type;
+	static const bool STORED = false;
+
+	static Type Get(const T&) {
+		return 0;
+	}
+
+	static void Restore(PointInfo<T>& arPoint, const Type*, uint8_t aQuality, size_t) {
+		arPoint.mValue.SetQualityValue(aQuality);
+	}
+};
+
+template <>
+struct SnapshotColumn<Binary> : public SnapshotBoolColumn<Binary> {};
+
+template <>
+struct SnapshotColumn<ControlStatus> : public SnapshotBoolColumn<ControlStatus> {};
+
+/// Size of a section holding aCount points, padded to keep the next section aligned
+template <class T>
+uint64_t SnapshotSectionSize(uint64_t aCount)
+{
+	uint64_t size = aCount * (sizeof(millis_t) + sizeof(uint8_t));
+	if(SnapshotColumn<T>::STORED) size += aCount * sizeof(typename SnapshotColumn<T>::Type);
+	return (size + 7) & ~static_cast<uint64_t>(7);
+}
+
+/**
+Writes a snapshot to a temporary file beside the target path and renames it
+into place on Commit, so a crash mid-write leaves the previous snapshot intact.
+*/
+class DLL_LOCAL SnapshotWriter : private Uncopyable
+{
+public:
+
+	SnapshotWriter(const std::string& arPath);
+	~SnapshotWriter();
+
+	template <class T>
+	void Write(DataTypes aType, const std::vector< PointInfo<T> >& arPoints);
+
+	/// Completes the header and replaces any existing snapshot at the target path
+	void Commit();
+
+private:
+
+	void WriteBytes(const void* apData, size_t aSize);
+
+	std::string mPath;
+	std::string mTempPath;
+	std::ofstream mFile;
+	SnapshotHeader mHeader;
+	uint64_t mOffset;
+	bool mCommitted;
+};
+
+/**
+Maps a snapshot read-only and copies its columns into the database vectors.
+The snapshot is only used if the header and section bounds are consistent.
+*/
+class DLL_LOCAL SnapshotReader : private Uncopyable
+{
+public:
+
+	SnapshotReader(const std::string& arPath);
+
+	/// @return false if the file doesn't exist or isn't a readable snapshot
+	bool IsValid() const {
+		return mValid;
+	}
+
+	size_t NumPoints(DataTypes aType) const {
+		return mValid ? static_cast<size_t>(mpHeader->mCount[aType]) : 0;
+	}
+
+	/**
+	Restores the first min(snapshot count, vector size) points of a type
+	@return the number of points restored
+	*/
+	template <class T>
+	size_t Read(DataTypes aType, std::vector< PointInfo<T> >& arPoints) const;
+
+private:
+
+	bool Validate() const;
+
+	boost::interprocess::mapped_region mRegion;
+	const SnapshotHeader* mpHeader;
+	bool mValid;
+};
+
+template <class T>
+void SnapshotWriter::Write(DataTypes aType, const std::vector< PointInfo<T> >& arPoints)
+{
+	typedef typename SnapshotColumn<T>::Type ValueType;
+	size_t num = arPoints.size();
+
+	std::vector<millis_t> times(num);
+	std::vector<ValueType> values(SnapshotColumn<T>::STORED ? num : 0);
+	std::vector<uint8_t> qualities(num);
+
+	for(size_t i = 0; i < num; ++i) {
+		const T& value = arPoints[i].mValue;
+		times[i] = value.GetTime();
+		if(SnapshotColumn<T>::STORED) values[i] = SnapshotColumn<T>::Get(value);
+		qualities[i] = value.GetQuality();
+	}
+
+	mHeader.mCount[aType] = num;
+	mHeader.mOffset[aType] = mOffset;
+
+	uint64_t size = SnapshotSectionSize<T>(num);
+	uint64_t written = 0;
+	if(num > 0) {
+		this->WriteBytes(&times[0], num * sizeof(millis_t));
+		written += num * sizeof(millis_t);
+		if(SnapshotColumn<T>::STORED) {
+			this->WriteBytes(&values[0], num * sizeof(ValueType));
+			written += num * sizeof(ValueType);
+		}
+		this->WriteBytes(&qualities[0], num);
+		written += num;
+	}
+
+	const uint8_t padding[8] = { 0 };
+	this->WriteBytes(padding, static_cast<size_t>(size - written));
+	mOffset += size;
+}
+
+template <class T>
+size_t SnapshotReader::Read(DataTypes aType, std::vector< PointInfo<T> >& arPoints) const
+{
+	typedef typename SnapshotColumn<T>::Type ValueType;
+	if(!mValid) return 0;
+
+	uint64_t count = mpHeader->mCount[aType];
+	size_t num = static_cast<size_t>(std::min<uint64_t>(count, arPoints.size()));
+
+	const uint8_t* pSection = reinterpret_cast<const uint8_t*>(mRegion.get_address()) + mpHeader->mOffset[aType];
+	const millis_t* pTimes = reinterpret_cast<const millis_t*>(pSection);
+	const ValueType* pValues = reinterpret_cast<const ValueType*>(pSection + count * sizeof(millis_t));
+	const uint8_t* pQualities = pSection + count * sizeof(millis_t);
+	if(SnapshotColumn<T>::STORED) pQualities += count * sizeof(ValueType);
+
+	for(size_t i = 0; i < num; ++i) {
+		SnapshotColumn<T>::Restore(arPoints[i], pValues, pQualities[i], i);
+		arPoints[i].mValue.SetTime(pTimes[i]);
+	}
+
+	return num;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
@@ -0,0 +1,226 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "DecodePipeline.h"
+
+#include <opendnp3/Exception.h>
+
+#include "ChangeFilter.h"
+#include "DecodePool.h"
+#include "HeaderReadIterator.h"
+#include "LoggableMacros.h"
+#include "ResponseLoader.h"
+
+namespace opendnp3
+{
+
+DecodedFragment::DecodedFragment(uint64_t aSequence, const APDU& arAPDU, uint64_t aPoll, bool aEndsPoll) :
+	mSequence(aSequence),
+	mAPDU(arAPDU.Size()),
+	mPoll(aPoll),
+	mEndsPoll(aEndsPoll),
+	mStatic(true),
+	mHasVto(false)
+{
+	mAPDU.Write(arAPDU.GetBuffer(), arAPDU.Size());
+}
+
+DecodePipeline::DecodePipeline(Logger* apLogger, IDataObserver* apPublisher, VtoReader* apVtoReader, ChangeFilter* apFilter) :
+	Loggable(apLogger),
+	mpPublisher(apPublisher),
+	mpVtoReader(apVtoReader),
+	mpFilter(apFilter),
+	mpPool(NULL),
+	mNextSubmit(0),
+	mNextPublish(0),
+	mPublishing(false),
+	mClosed(false),
+	mPoll(0),
+	mPollSuppressed(0),
+	mBacklog(0),
+	mNumFragments(0),
+	mNumHeldBack(0),
+	mNumSuppressed(0),
+	mLastPollSuppressed(0)
+{
+
+}
+
+DecodePipeline::~DecodePipeline()
+{
+	this->Close();
+}
+
+void DecodePipeline::Close()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mClosed = true;
+		mWaiting.clear();
+		mDecoded.clear();
+		mBacklog = 0;
+	}
+	if(mpPool) mpPool->Remove(this);
+}
+
+void DecodePipeline::Submit(const APDU& arAPDU, uint64_t aPoll, bool aEndsPoll)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if(mClosed) return;
+		mWaiting.push_back(std::unique_ptr<DecodedFragment>(new DecodedFragment(mNextSubmit++, arAPDU, aPoll, aEndsPoll)));
+		++mBacklog;
+		++mNumFragments;
+	}
+	mpPool->Submit(this);
+}
+
+void DecodePipeline::Decode()
+{
+	std::unique_ptr<DecodedFragment> pFragment;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if(mWaiting.empty()) return;
+		pFragment = std::move(mWaiting.front());
+		mWaiting.pop_front();
+	}
+
+	this->Load(*pFragment);
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	if(mClosed) return;
+	if(pFragment->mSequence != mNextPublish) ++mNumHeldBack;
+	mDecoded[pFragment->mSequence] = std::move(pFragment);
+	if(mPublishing) return;
+
+	// publish everything that's next in order, including what other threads decode meanwhile
+	mPublishing = true;
+	while(true) {
+		auto i = mDecoded.find(mNextPublish);
+		if(i == mDecoded.end()) break;
+		std::unique_ptr<DecodedFragment> pNext = std::move(i->second);
+		mDecoded.erase(i);
+		++mNextPublish;
+
+		lock.unlock();
+		this->Publish(*pNext);
+		lock.lock();
+
+		if(mBacklog > 0) --mBacklog;
+	}
+	mPublishing = false;
+}
+
+void DecodePipeline::ReadStatistics(StackStatistics& arStats) const
+{
+	arStats.mNumOffloadedFragments = mNumFragments;
+	arStats.mDecodeBacklog = mBacklog;
+	arStats.mNumHeldBackFragments = mNumHeldBack;
+	arStats.mNumSuppressedPoints += mNumSuppressed;
+	arStats.mPollSuppressedPoints = mLastPollSuppressed;
+}
+
+void DecodePipeline::Load(DecodedFragment& arFragment)
+{
+	try {
+		arFragment.mAPDU.Interpret();
+
+		for(HeaderReadIterator hdr = arFragment.mAPDU.BeginRead(); !hdr.IsEnd(); ++hdr) {
+			int grp = hdr->GetGroup();
+			if(grp == 112 || grp == 113) {
+				arFragment.mHasVto = true;
+				return;
+			}
+		}
+
+		ResponseLoader loader(mpLogger, &arFragment, mpVtoReader);
+		for(HeaderReadIterator hdr = arFragment.mAPDU.BeginRead(); !hdr.IsEnd(); ++hdr) {
+			arFragment.mStatic = !hdr->GetBaseObject()->IsEvent();
+			loader.Process(hdr);
+		}
+	}
+	catch(const Exception& ex) {
+		EXCEPTION_BLOCK(LEV_WARNING, ex)
+	}
+}
+
+void DecodePipeline::Publish(DecodedFragment& arFragment)
+{
+	size_t suppressed = 0;
+
+	try {
+		if(arFragment.mHasVto) {
+			ResponseLoader loader(mpLogger, mpPublisher, mpVtoReader, mpFilter);
+			for(HeaderReadIterator hdr = arFragment.mAPDU.BeginRead(); !hdr.IsEnd(); ++hdr) loader.Process(hdr);
+			suppressed = loader.NumSuppressed();
+		}
+		else {
+			Transaction t(mpPublisher);
+			size_t binary = 0, analog = 0, counter = 0, control = 0, setpoint = 0;
+			for(auto type: arFragment.mOrder) {
+				switch(type) {
+				case(DT_BINARY):
+					this->Replay(arFragment.mBinary, binary, suppressed);
+					break;
+				case(DT_ANALOG):
+					this->Replay(arFragment.mAnalog, analog, suppressed);
+					break;
+				case(DT_COUNTER):
+					this->Replay(arFragment.mCounter, counter, suppressed);
+					break;
+				case(DT_CONTROL_STATUS):
+					this->Replay(arFragment.mControlStatus, control, suppressed);
+					break;
+				case(DT_SETPOINT_STATUS):
+					this->Replay(arFragment.mSetpointStatus, setpoint, suppressed);
+					break;
+				}
+			}
+		}
+	}
+	catch(const Exception& ex) {
+		EXCEPTION_BLOCK(LEV_WARNING, ex)
+	}
+
+	mNumSuppressed += suppressed;
+
+	if(arFragment.mPoll != 0) {
+		// a poll that never got its final fragment doesn't carry over into the next one
+		if(arFragment.mPoll != mPoll) {
+			mPoll = arFragment.mPoll;
+			mPollSuppressed = 0;
+		}
+		mPollSuppressed += suppressed;
+		if(arFragment.mEndsPoll) mLastPollSuppressed = mPollSuppressed;
+	}
+}
+
+template <class T>
+void DecodePipeline::Replay(const std::vector< DecodedFragment::Point<T> >& arPoints, size_t& arPosition, size_t& arSuppressed)
+{
+	const DecodedFragment::Point<T>& p = arPoints[arPosition++];
+	if(mpFilter == NULL || mpFilter->Publish(p.mValue, p.mIndex, p.mStatic)) mpPublisher->Update(p.mValue, p.mIndex);
+	else ++arSuppressed;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,188 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __DECODE_PIPELINE_H_
+#define __DECODE_PIPELINE_H_
+
+#include <opendnp3/DataTypes.h>
+#include <opendnp3/IDataObserver.h>
+#include <opendnp3/Statistics.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include "APDU.h"
+#include "Loggable.h"
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace opendnp3
+{
+
+class ChangeFilter;
+class DecodePool;
+class VtoReader;
+
+/**
+* A response fragment copied off the master's strand, and the measurements a pool thread
+* decoded from it. The loader publishes into the fragment, which keeps the points until
+* every earlier fragment has been published.
+*/
+class DLL_LOCAL DecodedFragment : public IDataObserver
+{
+public:
+
+	template <class T>
+	struct Point {
+		Point(const T& arValue, size_t aIndex, bool aStatic) : mValue(arValue), mIndex(aIndex), mStatic(aStatic) {}
+
+		T mValue;
+		size_t mIndex;
+		bool mStatic;	// events bypass the change filter
+	};
+
+	DecodedFragment(uint64_t aSequence, const APDU& arAPDU, uint64_t aPoll, bool aEndsPoll);
+
+	uint64_t mSequence;
+	APDU mAPDU;
+	uint64_t mPoll;		// id of the poll the fragment answers, 0 if it isn't part of one
+	bool mEndsPoll;		// the final fragment of its poll
+	bool mStatic;		// whether the header being decoded holds static objects
+	bool mHasVto;		// decoded entirely by the publishing thread so VTO data reaches the reader in order
+
+	// Points are stored by value, one vector per type. mOrder has the type of every point
+	// so they're replayed in the order the loader found them.
+	std::vector<DataTypes> mOrder;
+	std::vector< Point<Binary> > mBinary;
+	std::vector< Point<Analog> > mAnalog;
+	std::vector< Point<Counter> > mCounter;
+	std::vector< Point<ControlStatus> > mControlStatus;
+	std::vector< Point<SetpointStatus> > mSetpointStatus;
+
+private:
+
+	template <class T>
+	void Add(std::vector< Point<T> >& arPoints, const T& arValue, size_t aIndex) {
+		arPoints.push_back(Point<T>(arValue, aIndex, mStatic));
+		mOrder.push_back(arValue.GetType());
+	}
+
+	void _Start() {}
+	void _End() {}
+
+	void _Update(const Binary& arPoint, size_t aIndex) {
+		this->Add(mBinary, arPoint, aIndex);
+	}
+	void _Update(const Analog& arPoint, size_t aIndex) {
+		this->Add(mAnalog, arPoint, aIndex);
+	}
+	void _Update(const Counter& arPoint, size_t aIndex) {
+		this->Add(mCounter, arPoint, aIndex);
+	}
+	void _Update(const ControlStatus& arPoint, size_t aIndex) {
+		this->Add(mControlStatus, arPoint, aIndex);
+	}
+	void _Update(const SetpointStatus& arPoint, size_t aIndex) {
+		this->Add(mSetpointStatus, arPoint, aIndex);
+	}
+};
+
+/**
+* Moves the decoding of a master's data responses off its strand. The strand submits a copy of
+* each response and carries on with confirms and the next request. Pool threads decode the
+* fragments in parallel, then whichever thread finishes the oldest outstanding fragment
+* publishes it and any later ones that are already decoded, so the observer still sees one
+* transaction per fragment in the order the fragments arrived. The change filter is only
+* touched by the publishing thread.
+*/
+class DLL_LOCAL DecodePipeline : public Loggable, private Uncopyable
+{
+public:
+
+	DecodePipeline(Logger* apLogger, IDataObserver* apPublisher, VtoReader* apVtoReader, ChangeFilter* apFilter);
+	~DecodePipeline();
+
+	/// Fragments are only submitted once there's a pool, before the master starts
+	void SetPool(DecodePool* apPool) {
+		mpPool = apPool;
+	}
+
+	bool IsEnabled() const {
+		return mpPool != NULL;
+	}
+
+	/**
+	* Copies an interpreted response and queues it for decoding, called from the master's strand
+	* @param aPoll Id of the poll the response answers, 0 if it isn't part of one
+	* @param aEndsPoll True for the final fragment of the poll
+	*/
+	void Submit(const APDU& arAPDU, uint64_t aPoll = 0, bool aEndsPoll = false);
+
+	/// Called by a pool thread, decodes the oldest waiting fragment and publishes whatever is next in order
+	void Decode();
+
+	/// Discards waiting fragments and waits for the pool to finish with the pipeline. Later submissions are dropped.
+	void Close();
+
+	/// Copies the pipeline's metrics, safe from any thread
+	void ReadStatistics(StackStatistics& arStats) const;
+
+private:
+
+	void Load(DecodedFragment& arFragment);
+	void Publish(DecodedFragment& arFragment);
+
+	template <class T>
+	void Replay(const std::vector< DecodedFragment::Point<T> >& arPoints, size_t& arPosition, size_t& arSuppressed);
+
+	IDataObserver* mpPublisher;
+	VtoReader* mpVtoReader;
+	ChangeFilter* mpFilter;
+	DecodePool* mpPool;
+
+	std::mutex mMutex;
+	std::deque< std::unique_ptr<DecodedFragment> > mWaiting;				// submitted, not yet picked up by a thread
+	std::map< uint64_t, std::unique_ptr<DecodedFragment> > mDecoded;		// decoded, waiting for earlier fragments
+	uint64_t mNextSubmit;
+	uint64_t mNextPublish;
+	bool mPublishing;		// a thread is publishing, the others leave what they decode in mDecoded
+	bool mClosed;
+
+	// only touched by the publishing thread
+	uint64_t mPoll;				// poll of the last published fragment
+	size_t mPollSuppressed;		// points suppressed from that poll so far
+
+	std::atomic<size_t> mBacklog;
+	std::atomic<uint64_t> mNumFragments;
+	std::atomic<uint64_t> mNumHeldBack;
+	std::atomic<uint64_t> mNumSuppressed;
+	std::atomic<uint64_t> mLastPollSuppressed;	// points suppressed from the last poll published in full
+};
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
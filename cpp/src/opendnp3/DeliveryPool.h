@@ -0,0 +1,50 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __DELIVERY_POOL_H_
+#define __DELIVERY_POOL_H_
+
+#include <opendnp3/Visibility.h>
+
+#include "WorkerPool.h"
+
+namespace opendnp3
+{
+
+class DeliveryQueue;
+
+/**
+* The threads that pass queued measurements to the observers of a manager's masters. A queue
+* with something to deliver is submitted once and waits its turn behind the other queues, so
+* a single busy master can't starve the rest.
+*/
+class DLL_LOCAL DeliveryPool : public WorkerPool<DeliveryQueue>
+{
+public:
+
+	DeliveryPool(size_t aConcurrency, std::function<void()> aOnThreadStart, std::function<void()> aOnThreadExit);
+};
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
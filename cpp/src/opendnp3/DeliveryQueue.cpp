@@ -0,0 +1,243 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "DeliveryQueue.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Location.h>
+
+#include "DeliveryPool.h"
+
+#include <string.h>
+
+namespace opendnp3
+{
+
+template <class T>
+void PublishPoint(IDataObserver* apObserver, T aPoint, size_t aIndex, millis_t aTime)
+{
+	aPoint.SetTime(aTime);
+	apObserver->Update(aPoint, aIndex);
+}
+
+DeliveryQueue::DeliveryQueue(IDataObserver* apObserver, const DeliveryConfig& arConfig, DeliveryPool* apPool) :
+	mpObserver(apObserver),
+	mPolicy(arConfig.mPolicy),
+	mCapacity(arConfig.mCapacity),
+	mpPool(apPool),
+	mFrontSequence(0),
+	mScheduled(false),
+	mClosed(false),
+	mDepth(0),
+	mMaxDepth(0),
+	mNumDropped(0),
+	mNumConflated(0)
+{
+	if(mCapacity > 0 && mpPool == NULL) MACRO_THROW_EXCEPTION(ArgumentException, "A delivery queue needs a delivery pool");
+}
+
+DeliveryQueue::~DeliveryQueue()
+{
+	this->Close();
+}
+
+void DeliveryQueue::Close()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mClosed = true;
+		mRecords.clear();
+		mQueued.clear();
+		mDepth = 0;
+	}
+	mSpace.notify_all();
+	if(mpPool != NULL) mpPool->Remove(this);
+}
+
+void DeliveryQueue::ReadStatistics(StackStatistics& arStats) const
+{
+	arStats.mDeliveryQueueDepth = mDepth.load();
+	arStats.mDeliveryQueueMaxDepth = mMaxDepth.load();
+	arStats.mNumDeliveryDrops = mNumDropped.load();
+	arStats.mNumDeliveryConflations = mNumConflated.load();
+}
+
+void DeliveryQueue::_Start()
+{
+	mTransaction.clear();
+}
+
+void DeliveryQueue::_End()
+{
+	if(mTransaction.empty()) return;
+
+	bool schedule = false;
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+
+		// a transaction is queued whole, one larger than the queue waits for it to empty
+		if(mPolicy == DP_BLOCK) {
+			while(!mClosed && !mRecords.empty() && mRecords.size() + mTransaction.size() > mCapacity) mSpace.wait(lock);
+		}
+
+		if(!mClosed) {
+for(auto& record: mTransaction) this->Push(record);
+
+			mDepth = mRecords.size();
+			if(mRecords.size() > mMaxDepth.load()) mMaxDepth = mRecords.size();
+
+			schedule = !mScheduled;
+			mScheduled = true;
+		}
+	}
+
+	mTransaction.clear();
+	if(schedule) mpPool->Submit(this);
+}
+
+void DeliveryQueue::Push(const Record& arRecord)
+{
+	if(mPolicy == DP_CONFLATE) {
+		std::unordered_map<uint64_t, uint64_t>::iterator i = mQueued.find(arRecord.mKey);
+		if(i != mQueued.end()) {
+			mRecords[static_cast<size_t>(i->second - mFrontSequence)] = arRecord;
+			++mNumConflated;
+			return;
+		}
+	}
+
+	if(mPolicy != DP_BLOCK && mRecords.size() >= mCapacity) {
+		if(mPolicy == DP_CONFLATE) mQueued.erase(mRecords.front().mKey);
+		mRecords.pop_front();
+		++mFrontSequence;
+		++mNumDropped;
+	}
+
+	if(mPolicy == DP_CONFLATE) mQueued[arRecord.mKey] = mFrontSequence + mRecords.size();
+	mRecords.push_back(arRecord);
+}
+
+void DeliveryQueue::Deliver()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if(mClosed || mRecords.empty()) {
+			mScheduled = false;
+			return;
+		}
+
+		mBatch.swap(mRecords);
+		mFrontSequence += mBatch.size();
+		mQueued.clear();
+		mDepth = 0;
+	}
+	mSpace.notify_all();
+
+	{
+		Transaction t(mpObserver);
+for(auto& record: mBatch) this->Publish(record);
+	}
+	mBatch.clear();
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if(mClosed || mRecords.empty()) {
+			mScheduled = false;
+			return;
+		}
+	}
+
+	// more arrived during the delivery, go to the back of the line behind the other queues
+	mpPool->Submit(this);
+}
+
+void DeliveryQueue::Add(DataTypes aType, size_t aIndex, uint64_t aValue, uint8_t aQuality, millis_t aTime)
+{
+	Record record;
+	record.mKey = (static_cast<uint64_t>(aType) << 32) | static_cast<uint32_t>(aIndex);
+	record.mValue = aValue;
+	record.mTime = aTime;
+	record.mQuality = aQuality;
+	mTransaction.push_back(record);
+}
+
+void DeliveryQueue::_Update(const Binary& arPoint, size_t aIndex)
+{
+	this->Add(DT_BINARY, aIndex, 0, arPoint.GetQuality(), arPoint.GetTime());
+}
+
+void DeliveryQueue::_Update(const Analog& arPoint, size_t aIndex)
+{
+	double value = arPoint.GetValue();
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	this->Add(DT_ANALOG, aIndex, bits, arPoint.GetQuality(), arPoint.GetTime());
+}
+
+void DeliveryQueue::_Update(const Counter& arPoint, size_t aIndex)
+{
+	this->Add(DT_COUNTER, aIndex, arPoint.GetValue(), arPoint.GetQuality(), arPoint.GetTime());
+}
+
+void DeliveryQueue::_Update(const ControlStatus& arPoint, size_t aIndex)
+{
+	this->Add(DT_CONTROL_STATUS, aIndex, 0, arPoint.GetQuality(), arPoint.GetTime());
+}
+
+void DeliveryQueue::_Update(const SetpointStatus& arPoint, size_t aIndex)
+{
+	double value = arPoint.GetValue();
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	this->Add(DT_SETPOINT_STATUS, aIndex, bits, arPoint.GetQuality(), arPoint.GetTime());
+}
+
+void DeliveryQueue::Publish(const Record& arRecord)
+{
+	size_t index = static_cast<size_t>(arRecord.mKey & 0xFFFFFFFF);
+	double value;
+	memcpy(&value, &arRecord.mValue, sizeof(value));
+
+	// bool points carry their state in the quality
+	switch(static_cast<DataTypes>(arRecord.mKey >> 32)) {
+	case(DT_BINARY):
+		PublishPoint(mpObserver, Binary((arRecord.mQuality & BQ_STATE) != 0, arRecord.mQuality), index, arRecord.mTime);
+		break;
+	case(DT_ANALOG):
+		PublishPoint(mpObserver, Analog(value, arRecord.mQuality), index, arRecord.mTime);
+		break;
+	case(DT_COUNTER):
+		PublishPoint(mpObserver, Counter(static_cast<uint32_t>(arRecord.mValue), arRecord.mQuality), index, arRecord.mTime);
+		break;
+	case(DT_CONTROL_STATUS):
+		PublishPoint(mpObserver, ControlStatus((arRecord.mQuality & TQ_STATE) != 0, arRecord.mQuality), index, arRecord.mTime);
+		break;
+	case(DT_SETPOINT_STATUS):
+		PublishPoint(mpObserver, SetpointStatus(value, arRecord.mQuality), index, arRecord.mTime);
+		break;
+	default:
+		break;
+	}
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
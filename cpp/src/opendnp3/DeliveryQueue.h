@@ -0,0 +1,116 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __DELIVERY_QUEUE_H_
+#define __DELIVERY_QUEUE_H_
+
+#include <opendnp3/DeliveryConfig.h>
+#include <opendnp3/IDataObserver.h>
+#include <opendnp3/Statistics.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace opendnp3
+{
+
+class DeliveryPool;
+
+/**
+* Bounded queue between a master and its IDataObserver. The master's thread is the only
+* producer: it collects a transaction's updates without locking and queues them together
+* when the transaction ends. A pool thread is the only consumer at any one time, and it takes
+* everything queued in one step, so the lock is held once per transaction on each side rather
+* than once per point. Drop oldest and conflation both need the producer to change records the
+* consumer hasn't taken yet, which is why the queue is guarded by a mutex rather than being
+* lock free.
+*/
+class DLL_LOCAL DeliveryQueue : public IDataObserver, private Uncopyable
+{
+public:
+
+	DeliveryQueue(IDataObserver* apObserver, const DeliveryConfig& arConfig, DeliveryPool* apPool);
+	~DeliveryQueue();
+
+	/// Discards anything queued and waits for a delivery in progress. Later updates are dropped.
+	void Close();
+
+	/// Called by a pool thread, delivers everything queued as one transaction
+	void Deliver();
+
+	/// Copies the queue's metrics, safe from any thread
+	void ReadStatistics(StackStatistics& arStats) const;
+
+private:
+
+	struct Record {
+		uint64_t mKey;			// type and index
+		uint64_t mValue;		// bits of the value
+		millis_t mTime;
+		uint8_t mQuality;
+	};
+
+	void _Start();
+	void _End();
+
+	void _Update(const Binary& arPoint, size_t aIndex);
+	void _Update(const Analog& arPoint, size_t aIndex);
+	void _Update(const Counter& arPoint, size_t aIndex);
+	void _Update(const ControlStatus& arPoint, size_t aIndex);
+	void _Update(const SetpointStatus& arPoint, size_t aIndex);
+
+	void Add(DataTypes aType, size_t aIndex, uint64_t aValue, uint8_t aQuality, millis_t aTime);
+	void Push(const Record& arRecord);
+	void Publish(const Record& arRecord);
+
+	IDataObserver* mpObserver;
+	DeliveryPolicy mPolicy;
+	size_t mCapacity;
+	DeliveryPool* mpPool;
+
+	std::vector<Record> mTransaction;		// producer only
+	std::deque<Record> mBatch;				// consumer only
+
+	std::mutex mMutex;
+	std::condition_variable mSpace;
+	std::deque<Record> mRecords;
+	uint64_t mFrontSequence;							// sequence number of mRecords.front()
+	std::unordered_map<uint64_t, uint64_t> mQueued;		// key to sequence number, only when conflating
+	bool mScheduled;
+	bool mClosed;
+
+	std::atomic<size_t> mDepth;
+	std::atomic<size_t> mMaxDepth;
+	std::atomic<uint64_t> mNumDropped;
+	std::atomic<uint64_t> mNumConflated;
+};
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
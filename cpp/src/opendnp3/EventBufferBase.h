@@ -24,6 +24,7 @@
 #define __EVENT_BUFFER_BASE_H_
 
 #include "ClassCounter.h"
+#include "EventJournal.h"
 #include "EventTypes.h"
 
 #include <opendnp3/Visibility.h>
@@ -61,6 +62,27 @@ public:
 	 */
 	void Update(const typename EventType::MeasType& arVal, PointClass aClass, size_t aIndex);
 
+	/**
+	 * Adds an event that was recovered from the journal. The event keeps its
+	 * existing journal record instead of being appended again.
+	 *
+	 * @param arVal			Event update to add to the buffer
+	 * @param aClass		Class of the measurement
+	 * @param aIndex		Index of the measurement
+	 * @param aJournalId	Id of the event in the journal
+	 */
+	void Restore(const typename EventType::MeasType& arVal, PointClass aClass, size_t aIndex, size_t aJournalId);
+
+	/**
+	 * Attaches a persistent journal. New events are appended to the journal
+	 * and released from it when they are cleared or discarded.
+	 *
+	 * @param apJournal		the journal, or NULL to keep events in memory only
+	 */
+	void SetJournal(EventJournal* apJournal) {
+		mpJournal = apJournal;
+	}
+
 	/**
 	 * Returns true if the buffer contains any data matching the given
 	 * PointClass.
@@ -126,7 +148,9 @@ public:
 	 * @return				the number of events not selected
 	 */
 	size_t NumUnselected() {
-		return mEventSet.size();
+		size_t num = 0;
+		for(size_t i = 0; i < NUM_PARTITIONS; ++i) num += mEventSets[i].size();
+		return num;
 	}
 
 	/**
@@ -136,7 +160,7 @@ public:
 	 * @return				the number of events
 	 */
 	size_t Size() {
-		return mSelectedEvents.size() + mEventSet.size();
+		return mSelectedEvents.size() + this->NumUnselected();
 	}
 
 	/**
@@ -155,6 +179,13 @@ public:
 	 */
 	bool IsOverflown();
 
+	/**
+	 * @return the total number of events dropped because the buffer overflowed
+	 */
+	size_t NumDropped() {
+		return mNumDropped;
+	}
+
 	/**
 	 * Returns a flag to indicate whether the buffer is full.  A subsequent
 	 * write the buffer at this point would lead to IsOverflown() returning
@@ -182,45 +213,151 @@ protected:
 
 	/**
 	 * Overridable NVII function called by Update.  The default
-	 * implementation does a simple insert into mEventSet.
+	 * implementation does a simple insert into the event's partition.
 	 *
 	 * @param arEvent		Event update to add to the buffer
 	 */
 	virtual void _Update(const EventType& arEvent);
 
+	/**
+	 * Inserts the event and drops the oldest event if the buffer overflows.
+	 */
+	void Insert(EventType& arEvent);
+
+	/**
+	 * Releases the persistent copy of an event that is leaving the buffer.
+	 */
+	void Release(const EventType& arEvent) {
+		if(mpJournal != NULL) mpJournal->Release(arEvent.mJournalId);
+	}
+
+	typedef typename SetType::Type EventSet;
+
+	// class 1, 2, and 3 each have a partition, events of any other class share the last one
+	static const size_t NUM_PARTITIONS = 4;
+
+	static size_t PartitionIndex(PointClass aClass);
+
+	EventSet& PartitionOf(const EventType& arEvent) {
+		return mEventSets[PartitionIndex(arEvent.mClass)];
+	}
+
+	/**
+	 * Orders events across partitions. Events the set considers equivalent
+	 * are ordered by insertion.
+	 */
+	bool Before(const EventType& arLeft, const EventType& arRight) const;
+
+	EventJournal* mpJournal;	// optional persistent copy of the buffered events
 	ClassCounter mCounter;		// counter for class events
 	const size_t M_MAX_EVENTS;	// max number of events to accept before setting overflow
 	size_t mSequence;			// used to track the insertion order of events into the buffer
 	bool mIsOverflown;			// flag that tracks when an overflow occurs
+	size_t mNumDropped;			// running count of events lost to overflow
 
-	// vector to hold all selected events until they are cleared or failed back into mEventSet
+	// vector to hold all selected events until they are cleared or failed back into the
+	// partition of their class in mEventSets, see PartitionOf()
 	typename std::vector< EventType > mSelectedEvents;
 
-	// store to keep and order incoming events
-	typename SetType::Type mEventSet;
+	// stores that keep and order the unselected events of each partition, so a
+	// selection only visits the partitions of the requested classes
+	EventSet mEventSets[NUM_PARTITIONS];
+
+private:
+
+	// the next event at or after aItr in the partition that matches aClass
+	typename EventSet::iterator NextMatch(size_t aPartition, typename EventSet::iterator aItr, PointClass aClass);
+
+	// the partition holding the oldest unselected event, NUM_PARTITIONS if there are none
+	size_t OldestPartition();
 };
 
 template <class EventType, class SetType>
 EventBufferBase <EventType, SetType> :: EventBufferBase(size_t aMaxEvents) :
+	mpJournal(NULL),
 	M_MAX_EVENTS(aMaxEvents),
 	mSequence(0),
-	mIsOverflown(false)
+	mIsOverflown(false),
+	mNumDropped(0)
 {}
 
 template <class EventType, class SetType>
 void EventBufferBase<EventType, SetType> :: Update(const typename EventType::MeasType& arVal, PointClass aClass, size_t aIndex)
 {
 	EventType evt(arVal, aClass, aIndex);
-	this->Update(evt, true);
+	if(mpJournal != NULL) evt.mJournalId = mpJournal->Append(arVal, aClass, aIndex);
+	this->Insert(evt);
+}
+
+template <class EventType, class SetType>
+void EventBufferBase<EventType, SetType> :: Restore(const typename EventType::MeasType& arVal, PointClass aClass, size_t aIndex, size_t aJournalId)
+{
+	EventType evt(arVal, aClass, aIndex);
+	evt.mJournalId = aJournalId;
+	this->Insert(evt);
+}
+
+template <class EventType, class SetType>
+void EventBufferBase<EventType, SetType> :: Insert(EventType& arEvent)
+{
+	this->Update(arEvent, true);
 
 	if(this->NumUnselected() > M_MAX_EVENTS) { //we've overflown and we've got to drop an event
 		mIsOverflown = true;
-		typename SetType::Type::iterator itr = mEventSet.begin();
+		++mNumDropped;
+		EventSet& set = mEventSets[this->OldestPartition()];
+		typename EventSet::iterator itr = set.begin();
 		this->mCounter.DecrCount(itr->mClass);
-		mEventSet.erase(itr);
+		this->Release(*itr);
+		set.erase(itr);
+	}
+}
+
+template <class EventType, class SetType>
+size_t EventBufferBase<EventType, SetType> :: PartitionIndex(PointClass aClass)
+{
+	switch(aClass) {
+	case(PC_CLASS_1):
+		return 0;
+	case(PC_CLASS_2):
+		return 1;
+	case(PC_CLASS_3):
+		return 2;
+	default:
+		return NUM_PARTITIONS - 1;
 	}
 }
 
+template <class EventType, class SetType>
+bool EventBufferBase<EventType, SetType> :: Before(const EventType& arLeft, const EventType& arRight) const
+{
+	typename EventSet::key_compare less = mEventSets[0].key_comp();
+	if(less(arLeft, arRight)) return true;
+	if(less(arRight, arLeft)) return false;
+	return arLeft.mSequence < arRight.mSequence;
+}
+
+template <class EventType, class SetType>
+size_t EventBufferBase<EventType, SetType> :: OldestPartition()
+{
+	size_t oldest = NUM_PARTITIONS;
+	for(size_t i = 0; i < NUM_PARTITIONS; ++i) {
+		if(mEventSets[i].empty()) continue;
+		if(oldest == NUM_PARTITIONS || this->Before(*mEventSets[i].begin(), *mEventSets[oldest].begin())) oldest = i;
+	}
+	return oldest;
+}
+
+template <class EventType, class SetType>
+typename EventBufferBase<EventType, SetType>::EventSet::iterator EventBufferBase<EventType, SetType> :: NextMatch(size_t aPartition, typename EventSet::iterator aItr, PointClass aClass)
+{
+	// only the shared partition mixes classes
+	if(aPartition == NUM_PARTITIONS - 1) {
+		while(aItr != mEventSets[aPartition].end() && (aItr->mClass & aClass) == 0) ++aItr;
+	}
+	return aItr;
+}
+
 template <class EventType, class SetType>
 void EventBufferBase<EventType, SetType> :: Update(EventType& arEvent, bool aNewValue)
 {
@@ -236,7 +373,7 @@ template <class EventType, class SetType>
 void EventBufferBase<EventType, SetType> :: _Update(const EventType& arEvent)
 {
 	this->mCounter.IncrCount(arEvent.mClass);
-	this->mEventSet.insert(arEvent);
+	this->PartitionOf(arEvent).insert(arEvent);
 }
 
 template <class EventType, class SetType>
@@ -268,6 +405,7 @@ size_t EventBufferBase<EventType, SetType> :: ClearWrittenEvents()
 
 	size_t num = 0;
 	while(itr != this->mSelectedEvents.end() && itr->mWritten) {
+		this->Release(*itr);
 		++itr;
 		++num;
 	}
@@ -285,19 +423,37 @@ typename EvtItr< EventType >::Type EventBufferBase<EventType, SetType> :: Begin(
 template <class EventType, class SetType>
 size_t EventBufferBase <EventType, SetType> :: Select(PointClass aClass, size_t aMaxEvent)
 {
-	typename SetType::Type::iterator i = mEventSet.begin();
+	const PointClass CLASSES[NUM_PARTITIONS - 1] = { PC_CLASS_1, PC_CLASS_2, PC_CLASS_3 };
+
+	// merge the partitions of the requested classes, only matching events are visited
+	typename EventSet::iterator next[NUM_PARTITIONS];
+	size_t partitions[NUM_PARTITIONS];
+	size_t num = 0;
+	for(size_t p = 0; p < NUM_PARTITIONS; ++p) {
+		if(p < NUM_PARTITIONS - 1 && (CLASSES[p] & aClass) == 0) continue;
+		next[p] = this->NextMatch(p, mEventSets[p].begin(), aClass);
+		if(next[p] != mEventSets[p].end()) partitions[num++] = p;
+	}
 
 	size_t count = 0;
 
-	while( i != mEventSet.end() && count < aMaxEvent) {
-		if( ( i->mClass & aClass) != 0 ) {
-			mCounter.DecrCount(i->mClass);
-			mSelectedEvents.push_back(*i);
-			mEventSet.erase(i++);
-			++count;
-			mSelectedEvents.back().mWritten = false;
+	while(num > 0 && count < aMaxEvent) {
+		size_t best = 0;
+		for(size_t k = 1; k < num; ++k) {
+			if(this->Before(*next[partitions[k]], *next[partitions[best]])) best = k;
 		}
-		else ++i;
+
+		size_t p = partitions[best];
+		typename EventSet::iterator i = next[p];
+		mCounter.DecrCount(i->mClass);
+		mSelectedEvents.push_back(*i);
+		mEventSets[p].erase(i++);
+		next[p] = this->NextMatch(p, i, aClass);
+		++count;
+		mSelectedEvents.back().mWritten = false;
+
+		// drop exhausted partitions so a single class is a plain walk of its store
+		if(next[p] == mEventSets[p].end()) partitions[best] = partitions[--num];
 	}
 
 	return count;
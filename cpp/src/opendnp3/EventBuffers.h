@@ -86,18 +86,28 @@ InsertionOrderedEventBuffer<EventType> :: InsertionOrderedEventBuffer(size_t aMa
 template <class EventType>
 void SingleEventBuffer<EventType> :: _Update(const EventType& arEvent)
 {
-	typename IndexSet< EventType >::Type::iterator i = this->mEventSet.find(arEvent);
+	typedef typename IndexSet< EventType >::Type SetType;
+
+	// the existing event for the index may be in another partition if the point changed class
+	for(size_t p = 0; p < this->NUM_PARTITIONS; ++p) {
+		SetType& set = this->mEventSets[p];
+		typename SetType::iterator i = set.find(arEvent);
+		if(i == set.end()) continue;
 
-	if(i != this->mEventSet.end() ) {
 		if(arEvent.mValue.GetTime() >= i->mValue.GetTime()) {
-			this->mEventSet.erase(i);
-			this->mEventSet.insert(arEvent); //new event
+			this->Release(*i);
+			this->mCounter.DecrCount(i->mClass);
+			set.erase(i);
+			this->PartitionOf(arEvent).insert(arEvent); //new event
+			this->mCounter.IncrCount(arEvent.mClass);
 		}
+		else this->Release(arEvent);
+
+		return;
 	}
-	else {
-		this->mEventSet.insert(arEvent); //new event
-		this->mCounter.IncrCount(arEvent.mClass);
-	}
+
+	this->PartitionOf(arEvent).insert(arEvent); //new event
+	this->mCounter.IncrCount(arEvent.mClass);
 }
 
 } //end NS
@@ -0,0 +1,314 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+
+#include "EventJournal.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Location.h>
+
+#include "DNPCrc.h"
+
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <stddef.h>
+#include <string.h>
+
+using namespace boost::interprocess;
+
+namespace opendnp3
+{
+
+const size_t EventJournal::NO_ID = std::numeric_limits<size_t>::max();
+
+const uint32_t JOURNAL_MAGIC = 0x4A504E44; // "DNPJ"
+const uint32_t JOURNAL_VERSION = 1;
+
+// the mapping needs a file of the correct size before it can be created
+const char* PrepareJournalFile(const EventJournalConfig& arConfig)
+{
+	if(arConfig.mPath.empty()) MACRO_THROW_EXCEPTION(ArgumentException, "Journal path is empty");
+	if(arConfig.mCapacity == 0) MACRO_THROW_EXCEPTION(ArgumentException, "Journal capacity must be greater than zero");
+
+	std::streamoff size = sizeof(JournalHeader) + arConfig.mCapacity * sizeof(JournalRecord);
+	std::ifstream existing(arConfig.mPath.c_str(), std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+	bool matches = existing.is_open() && existing.tellg() == size;
+	existing.close();
+
+	if(!matches) {
+		std::filebuf fbuf;
+		if(fbuf.open(arConfig.mPath.c_str(), std::ios_base::in | std::ios_base::out | std::ios_base::trunc | std::ios_base::binary) == NULL) {
+			MACRO_THROW_EXCEPTION(ArgumentException, "Unable to create journal: " + arConfig.mPath);
+		}
+		fbuf.pubseekoff(size - 1, std::ios_base::beg);
+		fbuf.sputc(0);
+	}
+
+	return arConfig.mPath.c_str();
+}
+
+EventJournal::EventJournal(const EventJournalConfig& arConfig) :
+	mCapacity(arConfig.mCapacity),
+	mSyncPolicy(arConfig.mSyncPolicy),
+	mSyncBatch(arConfig.mSyncBatch),
+	mMapping(PrepareJournalFile(arConfig), read_write),
+	mRegion(mMapping, read_write),
+	mpHeader(reinterpret_cast<JournalHeader*>(mRegion.get_address())),
+	mpRecords(reinterpret_cast<JournalRecord*>(reinterpret_cast<uint8_t*>(mRegion.get_address()) + sizeof(JournalHeader))),
+	mNumPending(0),
+	mNumLive(0),
+	mNumDropped(0)
+{
+	bool valid = mpHeader->mMagic == JOURNAL_MAGIC &&
+	             mpHeader->mVersion == JOURNAL_VERSION &&
+	             mpHeader->mRecordSize == sizeof(JournalRecord) &&
+	             mpHeader->mCapacity == mCapacity &&
+	             mpHeader->mTail <= mpHeader->mHead;
+
+	if(valid) this->Recover();
+	else this->Format();
+}
+
+EventJournal::~EventJournal()
+{
+	if(mSyncPolicy != JSP_NONE) this->Flush();
+}
+
+size_t EventJournal::Append(const Binary& arValue, PointClass aClass, size_t aIndex)
+{
+	return this->Append(DT_BINARY, arValue.GetValue() ? 1 : 0, arValue.GetQuality(), arValue.GetTime(), aClass, aIndex);
+}
+
+size_t EventJournal::Append(const Analog& arValue, PointClass aClass, size_t aIndex)
+{
+	double value = arValue.GetValue();
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return this->Append(DT_ANALOG, bits, arValue.GetQuality(), arValue.GetTime(), aClass, aIndex);
+}
+
+size_t EventJournal::Append(const Counter& arValue, PointClass aClass, size_t aIndex)
+{
+	return this->Append(DT_COUNTER, arValue.GetValue(), arValue.GetQuality(), arValue.GetTime(), aClass, aIndex);
+}
+
+void EventJournal::Read(const JournalRecord& arRecord, Binary& arValue)
+{
+	arValue.SetQualityValue(arRecord.mQuality);
+	arValue.SetTime(arRecord.mTime);
+}
+
+void EventJournal::Read(const JournalRecord& arRecord, Analog& arValue)
+{
+	double value;
+	memcpy(&value, &arRecord.mValue, sizeof(value));
+	arValue.SetValue(value);
+	arValue.SetQuality(arRecord.mQuality);
+	arValue.SetTime(arRecord.mTime);
+}
+
+void EventJournal::Read(const JournalRecord& arRecord, Counter& arValue)
+{
+	arValue.SetValue(static_cast<uint32_t>(arRecord.mValue));
+	arValue.SetQuality(arRecord.mQuality);
+	arValue.SetTime(arRecord.mTime);
+}
+
+size_t EventJournal::Append(DataTypes aType, uint64_t aValue, uint8_t aQuality, millis_t aTime, PointClass aClass, size_t aIndex)
+{
+	this->Reserve();
+
+	uint64_t seq = mpHeader->mHead;
+	size_t slot = static_cast<size_t>(seq % mCapacity);
+	JournalRecord& r = mpRecords[slot];
+
+	r.mId = seq;
+	r.mTime = aTime;
+	r.mValue = aValue;
+	r.mIndex = static_cast<uint32_t>(aIndex);
+	r.mType = static_cast<uint8_t>(aType);
+	r.mClass = static_cast<uint8_t>(aClass);
+	r.mQuality = aQuality;
+	r.mState = JRS_LIVE;
+	Stamp(r, seq);
+
+	// the record must be complete before the head covers it
+	std::atomic_thread_fence(std::memory_order_release);
+	mpHeader->mHead = seq + 1;
+
+	++mNumLive;
+	this->OnMutation(slot);
+	return static_cast<size_t>(seq);
+}
+
+void EventJournal::Release(size_t aId)
+{
+	if(aId == NO_ID) return;
+
+	size_t slot = aId % mCapacity;
+	JournalRecord& r = mpRecords[slot];
+	if(r.mState != JRS_LIVE || r.mId != aId) return;
+
+	r.mState = JRS_RELEASED;
+	--mNumLive;
+
+	if(slot == mpHeader->mTail % mCapacity) this->AdvanceTail();
+
+	this->OnMutation(slot);
+}
+
+void EventJournal::Reserve()
+{
+	size_t carried = 0;
+
+	while(mpHeader->mHead - mpHeader->mTail >= mCapacity) {
+		JournalRecord& r = mpRecords[mpHeader->mTail % mCapacity];
+
+		if(r.mState == JRS_LIVE) {
+			if(carried < mCapacity) {
+				// The head and the tail share this slot. Publish the new head
+				// first so the record is covered under both sequence numbers
+				// until the tail moves past the old one.
+				uint64_t seq = mpHeader->mHead;
+				mpHeader->mHead = seq + 1;
+				std::atomic_thread_fence(std::memory_order_release);
+				Stamp(r, seq);
+				std::atomic_thread_fence(std::memory_order_release);
+				++mpHeader->mTail;
+				++carried;
+				continue;
+			}
+
+			// every record is live, the oldest one has to go
+			r.mState = JRS_RELEASED;
+			--mNumLive;
+			++mNumDropped;
+		}
+
+		++mpHeader->mTail;
+	}
+}
+
+void EventJournal::AdvanceTail()
+{
+	while(mpHeader->mTail < mpHeader->mHead && mpRecords[mpHeader->mTail % mCapacity].mState != JRS_LIVE) {
+		++mpHeader->mTail;
+	}
+}
+
+void EventJournal::GetLiveIds(std::vector<size_t>& arIds) const
+{
+	for(uint64_t seq = mpHeader->mTail; seq < mpHeader->mHead; ++seq) {
+		const JournalRecord& r = mpRecords[seq % mCapacity];
+		if(r.mState == JRS_LIVE && r.mSequence == seq) arIds.push_back(static_cast<size_t>(r.mId));
+	}
+}
+
+void EventJournal::Flush()
+{
+	if(mNumPending > 0) {
+		mRegion.flush(0, mRegion.get_size(), false);
+		mNumPending = 0;
+	}
+}
+
+void EventJournal::Recover()
+{
+	// a carry forward was interrupted after the new head was published
+	if(mpHeader->mHead - mpHeader->mTail > mCapacity) {
+		JournalRecord& r = mpRecords[mpHeader->mTail % mCapacity];
+		if(r.mSequence == mpHeader->mTail && IsValid(r)) Stamp(r, mpHeader->mHead - 1);
+		mpHeader->mTail = mpHeader->mHead - mCapacity;
+	}
+
+	std::vector<bool> live(mCapacity, false);
+	for(uint64_t seq = mpHeader->mTail; seq < mpHeader->mHead; ++seq) {
+		size_t slot = static_cast<size_t>(seq % mCapacity);
+		const JournalRecord& r = mpRecords[slot];
+		if(r.mState == JRS_LIVE && r.mSequence == seq && IsValid(r)) live[slot] = true;
+	}
+
+	// anything that isn't a valid member of the current ring is discarded
+	for(size_t i = 0; i < mCapacity; ++i) {
+		if(live[i]) ++mNumLive;
+		else if(mpRecords[i].mState == JRS_LIVE) mpRecords[i].mState = JRS_RELEASED;
+	}
+
+	this->AdvanceTail();
+	mNumPending = 1;
+	if(mSyncPolicy != JSP_NONE) this->Flush();
+}
+
+void EventJournal::Format()
+{
+	memset(mRegion.get_address(), 0, mRegion.get_size());
+	mpHeader->mVersion = JOURNAL_VERSION;
+	mpHeader->mRecordSize = sizeof(JournalRecord);
+	mpHeader->mCapacity = mCapacity;
+	mpHeader->mHead = 0;
+	mpHeader->mTail = 0;
+
+	// the magic is written last so a partially formatted file is never trusted
+	std::atomic_thread_fence(std::memory_order_release);
+	mpHeader->mMagic = JOURNAL_MAGIC;
+
+	mNumPending = 1;
+	this->Flush();
+}
+
+void EventJournal::OnMutation(size_t aSlot)
+{
+	++mNumPending;
+
+	switch(mSyncPolicy) {
+	case(JSP_ALWAYS):
+		this->FlushRange(sizeof(JournalHeader) + aSlot * sizeof(JournalRecord), sizeof(JournalRecord));
+		this->FlushRange(0, sizeof(JournalHeader));
+		mNumPending = 0;
+		break;
+	case(JSP_BATCHED):
+		if(mNumPending >= mSyncBatch) this->Flush();
+		break;
+	default:
+		break;
+	}
+}
+
+void EventJournal::FlushRange(size_t aOffset, size_t aSize)
+{
+	mRegion.flush(aOffset, aSize, false);
+}
+
+void EventJournal::Stamp(JournalRecord& arRecord, uint64_t aSequence)
+{
+	arRecord.mSequence = aSequence;
+	arRecord.mCrc = static_cast<uint16_t>(DNPCrc::CalcCrc(reinterpret_cast<const uint8_t*>(&arRecord), offsetof(JournalRecord, mState)));
+}
+
+bool EventJournal::IsValid(const JournalRecord& arRecord)
+{
+	return arRecord.mCrc == static_cast<uint16_t>(DNPCrc::CalcCrc(reinterpret_cast<const uint8_t*>(&arRecord), offsetof(JournalRecord, mState)));
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,177 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+
+#ifndef __EVENT_JOURNAL_H_
+#define __EVENT_JOURNAL_H_
+
+#include <opendnp3/DataTypes.h>
+#include <opendnp3/PointClass.h>
+#include <opendnp3/SlaveConfig.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <vector>
+
+namespace opendnp3
+{
+
+/// Fixed size header at the start of the journal file
+struct DLL_LOCAL JournalHeader {
+	uint32_t mMagic;
+	uint32_t mVersion;
+	uint32_t mRecordSize;
+	uint32_t mReserved;
+	uint64_t mCapacity;
+	uint64_t mHead;			// sequence number of the next record to be written
+	uint64_t mTail;			// sequence number of the oldest record that may still be live
+	uint8_t mPadding[24];
+};
+
+/// Fixed size event record stored in the journal ring
+struct DLL_LOCAL JournalRecord {
+	uint64_t mSequence;		// the journal sequence number that currently covers this record
+	uint64_t mId;			// the sequence number the record was appended with, never changes
+	int64_t mTime;
+	uint64_t mValue;		// raw bits of the measurement value
+	uint32_t mIndex;
+	uint8_t mType;			// DataTypes of the measurement
+	uint8_t mClass;
+	uint8_t mQuality;
+	uint8_t mState;			// JournalRecordState, not covered by the crc so it can be changed in place
+	uint16_t mCrc;
+	uint8_t mPadding[6];
+};
+
+enum JournalRecordState {
+	JRS_FREE = 0,
+	JRS_LIVE = 1,
+	JRS_RELEASED = 2
+};
+
+/**
+ * Append-only ring of event records in a memory-mapped file.
+ *
+ * Records are appended at the head and released in place when the event is
+ * confirmed or discarded. The tail advances over contiguous released records.
+ * The head and tail are published in the header only after the records they
+ * cover have been written, so a reader that validates each record against
+ * its expected sequence number always sees a consistent ring.
+ *
+ * When the ring is full and the oldest record is still live, it is carried
+ * forward by re-stamping it with the head sequence number. Records never move
+ * and keep the id returned by Append(), so the id identifies the event for its
+ * lifetime even if the slot is later reused.
+ *
+ * Single-threaded, driven from the outstation's executor.
+ */
+class DLL_LOCAL EventJournal : private Uncopyable
+{
+public:
+
+	static const size_t NO_ID;
+
+	EventJournal(const EventJournalConfig& arConfig);
+	~EventJournal();
+
+	/**
+	 * Appends an event to the journal.
+	 *
+	 * @return		the id of the record, used to release it later
+	 */
+	size_t Append(const Binary& arValue, PointClass aClass, size_t aIndex);
+	size_t Append(const Analog& arValue, PointClass aClass, size_t aIndex);
+	size_t Append(const Counter& arValue, PointClass aClass, size_t aIndex);
+
+	/// Types without a record encoding, i.e. VTO stream data, are not journaled
+	template <class T>
+	size_t Append(const T&, PointClass, size_t) {
+		return NO_ID;
+	}
+
+	/// Releases a live record, NO_ID and ids of records that were dropped are ignored
+	void Release(size_t aId);
+
+	/// Forces any unsynchronized mutations to disk
+	void Flush();
+
+	/// Fills the vector with the ids of all live records in journal order
+	void GetLiveIds(std::vector<size_t>& arIds) const;
+
+	const JournalRecord& GetRecord(size_t aId) const {
+		return mpRecords[aId % mCapacity];
+	}
+
+	size_t Capacity() const {
+		return mCapacity;
+	}
+
+	size_t NumLive() const {
+		return mNumLive;
+	}
+
+	/// @return the number of live records that were overwritten because every slot was live
+	size_t NumDropped() const {
+		return mNumDropped;
+	}
+
+	static void Read(const JournalRecord& arRecord, Binary& arValue);
+	static void Read(const JournalRecord& arRecord, Analog& arValue);
+	static void Read(const JournalRecord& arRecord, Counter& arValue);
+
+private:
+
+	size_t Append(DataTypes aType, uint64_t aValue, uint8_t aQuality, millis_t aTime, PointClass aClass, size_t aIndex);
+
+	// makes room for a record at the head, carrying live records at the tail forward
+	void Reserve();
+	void AdvanceTail();
+	void Recover();
+	void Format();
+	void OnMutation(size_t aSlot);
+	void FlushRange(size_t aOffset, size_t aSize);
+
+	static void Stamp(JournalRecord& arRecord, uint64_t aSequence);
+	static bool IsValid(const JournalRecord& arRecord);
+
+	const size_t mCapacity;
+	const JournalSyncPolicy mSyncPolicy;
+	const size_t mSyncBatch;
+
+	boost::interprocess::file_mapping mMapping;
+	boost::interprocess::mapped_region mRegion;
+
+	JournalHeader* mpHeader;
+	JournalRecord* mpRecords;
+
+	size_t mNumPending;		// mutations since the last sync
+	size_t mNumLive;
+	size_t mNumDropped;
+};
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
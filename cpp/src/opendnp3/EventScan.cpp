@@ -0,0 +1,82 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "EventScan.h"
+
+#include <opendnp3/PointClass.h>
+#include <opendnp3/Util.h>
+
+#include "AppHeader.h"
+#include "AsyncTaskPeriodic.h"
+#include "BusScheduler.h"
+
+#include <chrono>
+
+namespace opendnp3
+{
+
+EventScan::EventScan(const ExceptionScan& arScan, BusScheduler* apBus) :
+	mClassMask(arScan.ClassMask),
+	mMinPeriod(arScan.ScanRate),
+	mMaxPeriod(arScan.IsAdaptive() ? arScan.MaxScanRate : arScan.ScanRate),
+	mIsAdaptive(arScan.IsAdaptive()),
+	mpBus(apBus),
+	mpTask(NULL),
+	mPeriod(arScan.ScanRate),
+	mNumScans(0)
+{}
+
+void EventScan::OnScan(const IINField& arIIN, size_t aNumFragments, size_t aNumObjects, size_t aNumBytes)
+{
+	++mNumScans;
+	if(!mIsAdaptive) return;
+
+	if(aNumFragments > 1 || this->HasMoreData(arIIN)) mPeriod = Max<millis_t>(mMinPeriod, mPeriod / 2);
+	else if(aNumObjects == 0) mPeriod = Min<millis_t>(mMaxPeriod, Max<millis_t>(1, mPeriod * 2));
+
+	// the bus share wins over the configured period
+	mPeriod = Max<millis_t>(mPeriod, this->BusShare(aNumBytes));
+
+	if(mpTask) mpTask->SetPeriod(mPeriod);
+}
+
+bool EventScan::HasMoreData(const IINField& arIIN) const
+{
+	if((mClassMask & PC_CLASS_1) && arIIN.GetClass1Events()) return true;
+	if((mClassMask & PC_CLASS_2) && arIIN.GetClass2Events()) return true;
+	if((mClassMask & PC_CLASS_3) && arIIN.GetClass3Events()) return true;
+
+	return false;
+}
+
+millis_t EventScan::BusShare(size_t aNumBytes) const
+{
+	if(mpBus == NULL) return 0;
+
+	timer_clock::duration occupied = mpBus->TransmitTime(aNumBytes) * static_cast<int64_t>(mpBus->NumDevices());
+	std::chrono::milliseconds share = std::chrono::duration_cast<std::chrono::milliseconds>(occupied);
+	if(share < occupied) share += std::chrono::milliseconds(1);
+	return share.count();
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,108 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __EVENT_SCAN_H_
+#define __EVENT_SCAN_H_
+
+#include <opendnp3/MasterConfigTypes.h>
+#include <opendnp3/Types.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include <stddef.h>
+
+namespace opendnp3
+{
+
+class AsyncTaskPeriodic;
+class BusScheduler;
+class IINField;
+
+/**
+ * An exception scan of the master and the period it currently runs at.
+ *
+ * The period of an adaptive scan halves toward ExceptionScan::ScanRate while
+ * the outstation reports more data for the scanned classes in its IIN bits or
+ * needs more than one fragment to answer, and doubles toward
+ * ExceptionScan::MaxScanRate while its responses are empty. On a shared bus
+ * the period is never shorter than the number of devices times the time the
+ * last response occupied the bus, so one busy outstation can't take more
+ * than its share.
+ */
+class DLL_LOCAL EventScan : private Uncopyable
+{
+public:
+
+	/**
+		@param arScan	The configured scan
+		@param apBus	The scheduler of a shared bus, NULL if the channel isn't shared
+	*/
+	EventScan(const ExceptionScan& arScan, BusScheduler* apBus = NULL);
+
+	// The task whose period follows the scan's
+	void SetTask(AsyncTaskPeriodic* apTask) {
+		mpTask = apTask;
+	}
+
+	int ClassMask() const {
+		return mClassMask;
+	}
+
+	millis_t Period() const {
+		return mPeriod;
+	}
+
+	size_t NumScans() const {
+		return mNumScans;
+	}
+
+	/**
+		Adjusts the period after the scan completes successfully
+
+		@param arIIN			IIN of the final response
+		@param aNumFragments	Number of response fragments
+		@param aNumObjects		Number of object headers in all of the fragments
+		@param aNumBytes		Size of all of the fragments
+	*/
+	void OnScan(const IINField& arIIN, size_t aNumFragments, size_t aNumObjects, size_t aNumBytes);
+
+private:
+
+	bool HasMoreData(const IINField& arIIN) const;
+
+	// shortest period that keeps the scan within its share of a shared bus
+	millis_t BusShare(size_t aNumBytes) const;
+
+	const int mClassMask;
+	const millis_t mMinPeriod;
+	const millis_t mMaxPeriod;
+	const bool mIsAdaptive;
+	BusScheduler* mpBus;
+	AsyncTaskPeriodic* mpTask;
+	millis_t mPeriod;
+	size_t mNumScans;
+};
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
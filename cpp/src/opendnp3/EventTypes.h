@@ -28,6 +28,8 @@
 
 #include <opendnp3/Visibility.h>
 
+#include <limits>
+
 namespace opendnp3
 {
 
@@ -40,13 +42,15 @@ struct DLL_LOCAL EventInfo : public PointInfoBase<T> {
 	EventInfo(const T& arValue, PointClass aClass, size_t aIndex) :
 		PointInfoBase<T>(arValue, aClass, aIndex),
 		mSequence(0),
-		mWritten(false)
+		mWritten(false),
+		mJournalId(std::numeric_limits<size_t>::max())
 	{}
 
-	EventInfo() : mSequence(0), mWritten(false) {}
+	EventInfo() : mSequence(0), mWritten(false), mJournalId(std::numeric_limits<size_t>::max()) {}
 
 	size_t mSequence;	// sequence number used by the event buffers to record insertion order
 	bool mWritten;		// true if the event has been written
+	size_t mJournalId;	// id of the persistent copy in the EventJournal, if any
 };
 
 typedef EventInfo<Binary>				BinaryEvent;
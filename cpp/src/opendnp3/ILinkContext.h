@@ -27,9 +27,13 @@
 
 #include <opendnp3/Visibility.h>
 
+#include <stddef.h>
+
 namespace opendnp3
 {
 
+class LatencyTrace;
+
 // @section DESCRIPTION Interface from the link router to the link layer
 class DLL_LOCAL ILinkContext : public IFrameSink
 {
@@ -39,6 +43,11 @@ public:
 
 	virtual void OnLowerLayerUp() = 0;
 	virtual void OnLowerLayerDown() = 0;
+
+	/// The trace the router stamps frames for this context into, if there is one
+	virtual LatencyTrace* GetLatencyTrace() {
+		return NULL;
+	}
 };
 
 }
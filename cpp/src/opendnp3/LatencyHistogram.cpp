@@ -0,0 +1,104 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "LatencyHistogram.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Location.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std::chrono;
+
+namespace opendnp3
+{
+
+const size_t LatencyHistogram::NUM_BUCKETS;
+
+LatencyHistogram::LatencyHistogram()
+{
+	this->Reset();
+}
+
+void LatencyHistogram::Record(const timer_clock::duration& arLatency)
+{
+	timer_clock::duration latency = std::max(arLatency, timer_clock::duration::zero());
+
+	++mBuckets[BucketFor(latency)];
+	++mNumSamples;
+	mTotal += latency;
+	mMax = std::max(mMax, latency);
+}
+
+void LatencyHistogram::Reset()
+{
+	std::fill(mBuckets, mBuckets + NUM_BUCKETS, 0);
+	mNumSamples = 0;
+	mTotal = mMax = timer_clock::duration::zero();
+}
+
+size_t LatencyHistogram::Count(size_t aBucket) const
+{
+	if(aBucket >= NUM_BUCKETS) MACRO_THROW_EXCEPTION(ArgumentException, "Bucket out of range");
+	return mBuckets[aBucket];
+}
+
+timer_clock::duration LatencyHistogram::Mean() const
+{
+	if(mNumSamples == 0) return timer_clock::duration::zero();
+	return mTotal / mNumSamples;
+}
+
+timer_clock::duration LatencyHistogram::Percentile(double aFraction) const
+{
+	if(aFraction < 0.0 || aFraction > 1.0) MACRO_THROW_EXCEPTION(ArgumentException, "Fraction must be between 0 and 1");
+	if(mNumSamples == 0) return timer_clock::duration::zero();
+
+	size_t target = std::max<size_t>(1, static_cast<size_t>(std::ceil(aFraction * mNumSamples)));
+	size_t count = 0;
+	for(size_t i = 0; i < NUM_BUCKETS; ++i) {
+		count += mBuckets[i];
+		if(count >= target) return std::min(UpperBound(i), mMax);
+	}
+
+	return mMax;
+}
+
+size_t LatencyHistogram::BucketFor(const timer_clock::duration& arLatency)
+{
+	int64_t us = duration_cast<microseconds>(arLatency).count();
+	size_t bucket = 0;
+	while(us > 0 && bucket < (NUM_BUCKETS - 1)) {
+		us >>= 1;
+		++bucket;
+	}
+	return bucket;
+}
+
+timer_clock::duration LatencyHistogram::UpperBound(size_t aBucket)
+{
+	return duration_cast<timer_clock::duration>(microseconds(static_cast<int64_t>(1) << aBucket));
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
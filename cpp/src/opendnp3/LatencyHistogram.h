@@ -0,0 +1,86 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __LATENCY_HISTOGRAM_H_
+#define __LATENCY_HISTOGRAM_H_
+
+#include <opendnp3/Clock.h>
+#include <opendnp3/Visibility.h>
+
+#include <chrono>
+#include <stddef.h>
+
+namespace opendnp3
+{
+
+/**
+ Histogram of latencies in power of two buckets of microseconds.
+
+ Bucket 0 counts latencies below 1 microsecond and bucket i counts latencies in
+ [2^(i-1), 2^i) microseconds. The last bucket also counts everything above it.
+*/
+class DLL_LOCAL LatencyHistogram
+{
+public:
+
+	static const size_t NUM_BUCKETS = 32;
+
+	LatencyHistogram();
+
+	void Record(const timer_clock::duration& arLatency);
+	void Reset();
+
+	size_t NumSamples() const {
+		return mNumSamples;
+	}
+
+	/// @return the number of samples in a bucket
+	size_t Count(size_t aBucket) const;
+
+	timer_clock::duration Max() const {
+		return mMax;
+	}
+
+	timer_clock::duration Mean() const;
+
+	/**
+		@param aFraction Fraction of the samples between 0 and 1, i.e. 0.99 for the 99th percentile
+		@return a bound that the given fraction of the samples do not exceed, at the resolution of the buckets
+	*/
+	timer_clock::duration Percentile(double aFraction) const;
+
+	/// @return the bucket a latency is counted in
+	static size_t BucketFor(const timer_clock::duration& arLatency);
+
+	/// @return the exclusive upper bound of a bucket
+	static timer_clock::duration UpperBound(size_t aBucket);
+
+private:
+
+	size_t mBuckets[NUM_BUCKETS];
+	size_t mNumSamples;
+	timer_clock::duration mTotal;
+	timer_clock::duration mMax;
+};
+
+}
+
+#endif
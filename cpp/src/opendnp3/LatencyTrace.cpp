@@ -0,0 +1,166 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "LatencyTrace.h"
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+
+using namespace std::chrono;
+
+namespace opendnp3
+{
+
+StageHistogram::StageHistogram() :
+	mNumSamples(0),
+	mTotalMicros(0),
+	mMaxMicros(0)
+{
+	for(size_t i = 0; i < StageLatency::NUM_BUCKETS; ++i) mBuckets[i].store(0, std::memory_order_relaxed);
+}
+
+void StageHistogram::Record(const timer_clock::duration& arLatency)
+{
+	timer_clock::duration latency = std::max(arLatency, timer_clock::duration::zero());
+	uint64_t us = static_cast<uint64_t>(duration_cast<microseconds>(latency).count());
+
+	Add(mBuckets[LatencyHistogram::BucketFor(latency)], 1);
+	Add(mNumSamples, 1);
+	Add(mTotalMicros, us);
+	if(us > mMaxMicros.load(std::memory_order_relaxed)) mMaxMicros.store(us, std::memory_order_relaxed);
+}
+
+void StageHistogram::Read(StageLatency& arLatency) const
+{
+	for(size_t i = 0; i < StageLatency::NUM_BUCKETS; ++i) arLatency.mBuckets[i] = mBuckets[i].load(std::memory_order_relaxed);
+	arLatency.mNumSamples = mNumSamples.load(std::memory_order_relaxed);
+	arLatency.mTotalMicros = mTotalMicros.load(std::memory_order_relaxed);
+	arLatency.mMaxMicros = mMaxMicros.load(std::memory_order_relaxed);
+}
+
+LatencyTrace::LatencyTrace() :
+	mAwaitingFinal(false),
+	mReceiving(false),
+	mPolling(false)
+{}
+
+void LatencyTrace::OnApduQueued(const timer_clock::time_point& arNow)
+{
+	mQueued.push_back(arNow);
+}
+
+void LatencyTrace::OnApduSent(const timer_clock::time_point& arNow)
+{
+	if(mQueued.empty()) return;
+
+	mApduQueued = mQueued.front();
+	mQueued.pop_front();
+	this->Record(LS_TX_QUEUE, arNow - mApduQueued);
+}
+
+void LatencyTrace::OnApduDispatched(const timer_clock::time_point& arNow)
+{
+	if(!mReceiving) return;
+
+	mReceiving = false;
+	this->Record(LS_RX_DISPATCH, arNow - mRxComplete);
+}
+
+void LatencyTrace::Reset()
+{
+	mQueued.clear();
+	mAwaitingFinal = false;
+	mReceiving = false;
+	mPolling = false;
+}
+
+void LatencyTrace::OnTransportSend(const timer_clock::time_point& arNow)
+{
+	mTransportStart = arNow;
+	mAwaitingFinal = false;
+}
+
+void LatencyTrace::OnFinalSegment()
+{
+	mAwaitingFinal = true;
+}
+
+void LatencyTrace::OnFirstSegment()
+{
+	mRxStart = mLastRead;
+}
+
+void LatencyTrace::OnApduReceived(const timer_clock::time_point& arNow)
+{
+	mRxComplete = arNow;
+	mReceiving = true;
+	this->Record(LS_RX_REASSEMBLY, arNow - mRxStart);
+}
+
+bool LatencyTrace::OnFrameQueued(bool aUserData, const timer_clock::time_point& arNow)
+{
+	// link layer frames such as a reset of the link states can go out between the last segment
+	// leaving the transport layer and reaching the router, but no other user data can
+	if(!(aUserData && mAwaitingFinal)) return false;
+
+	mAwaitingFinal = false;
+	this->Record(LS_TX_SEGMENT, arNow - mTransportStart);
+	return true;
+}
+
+void LatencyTrace::OnFrameWritten(bool aFinal, const timer_clock::time_point& arQueued, const timer_clock::time_point& arWriteStart, const timer_clock::time_point& arNow)
+{
+	this->Record(LS_TX_LINK_QUEUE, arWriteStart - arQueued);
+	this->Record(LS_TX_WIRE, arNow - arWriteStart);
+	if(aFinal) this->Record(LS_TX_TOTAL, arNow - mApduQueued);
+}
+
+void LatencyTrace::OnFrameRead(const timer_clock::time_point& arReadTime)
+{
+	mLastRead = arReadTime;
+}
+
+void LatencyTrace::OnPollStarted(const timer_clock::time_point& arNow)
+{
+	mPollStart = arNow;
+	mPolling = true;
+}
+
+void LatencyTrace::OnPollCompleted(const timer_clock::time_point& arNow)
+{
+	if(!mPolling) return;
+
+	mPolling = false;
+	this->Record(LS_POLL_ROUND_TRIP, arNow - mPollStart);
+}
+
+LatencyStatistics LatencyTrace::Snapshot() const
+{
+	LatencyStatistics stats;
+	stats.mEnabled = true;
+	for(size_t i = 0; i < LS_NUM_STAGES; ++i) mStages[i].Read(stats.mStages[i]);
+	return stats;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
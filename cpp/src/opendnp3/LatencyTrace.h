@@ -0,0 +1,170 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __LATENCY_TRACE_H_
+#define __LATENCY_TRACE_H_
+
+#include <opendnp3/Clock.h>
+#include <opendnp3/LatencyStatistics.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include <atomic>
+#include <deque>
+
+// Stamps a trace point when the library is built with OPENDNP3_LATENCY_TRACE, otherwise compiles to nothing
+#ifdef OPENDNP3_LATENCY_TRACE
+#define LATENCY_TRACE(trace, call) { if(trace != NULL) trace->call; }
+#else
+#define LATENCY_TRACE(trace, call) {}
+#endif
+
+namespace opendnp3
+{
+
+/**
+ Latency histogram for one stage, written from the stack's strand and read from any thread.
+
+ There is a single writer, so a record is relaxed loads and stores with no locked instructions.
+ A snapshot taken while a sample is being recorded may see some of its fields and not others.
+*/
+class DLL_LOCAL StageHistogram : private Uncopyable
+{
+public:
+
+	StageHistogram();
+
+	void Record(const timer_clock::duration& arLatency);
+
+	void Read(StageLatency& arLatency) const;
+
+private:
+
+	static void Add(std::atomic<uint64_t>& arValue, uint64_t aAmount) {
+		arValue.store(arValue.load(std::memory_order_relaxed) + aAmount, std::memory_order_relaxed);
+	}
+
+	std::atomic<uint64_t> mBuckets[StageLatency::NUM_BUCKETS];
+	std::atomic<uint64_t> mNumSamples;
+	std::atomic<uint64_t> mTotalMicros;
+	std::atomic<uint64_t> mMaxMicros;
+};
+
+/**
+ Follows the fragments of one stack through the layers and records the time spent in each
+ LatencyStage. The layers call it at their trace points through LATENCY_TRACE, all on the
+ stack's strand. Only one fragment is in the transport layer at a time in each direction, so
+ a single set of time points per direction is enough.
+*/
+class DLL_LOCAL LatencyTrace : private Uncopyable
+{
+public:
+
+	LatencyTrace();
+
+	// Application layer
+
+	/// A fragment was added to the send queue
+	void OnApduQueued(const timer_clock::time_point& arNow);
+
+	/// The fragment at the front of the send queue was handed to the transport layer
+	void OnApduSent(const timer_clock::time_point& arNow);
+
+	/// A received fragment has been handled
+	void OnApduDispatched(const timer_clock::time_point& arNow);
+
+	/// The layers below went down and the send queue was discarded
+	void Reset();
+
+	// Transport layer
+
+	void OnTransportSend(const timer_clock::time_point& arNow);
+
+	/// The segment being handed to the link layer completes the fragment
+	void OnFinalSegment();
+
+	/// A segment with FIR set was accepted
+	void OnFirstSegment();
+
+	/// The last segment of a fragment was accepted
+	void OnApduReceived(const timer_clock::time_point& arNow);
+
+	// Router
+
+	/**
+		A frame for this stack reached the router
+		@return true if the frame carries the last segment of a fragment
+	*/
+	bool OnFrameQueued(bool aUserData, const timer_clock::time_point& arNow);
+
+	/// A frame for this stack finished its physical write
+	void OnFrameWritten(bool aFinal, const timer_clock::time_point& arQueued, const timer_clock::time_point& arWriteStart, const timer_clock::time_point& arNow);
+
+	/// A user data frame for this stack was parsed from a read that completed at the given time
+	void OnFrameRead(const timer_clock::time_point& arReadTime);
+
+	// Master
+
+	/// A class poll sent its first request
+	void OnPollStarted(const timer_clock::time_point& arNow);
+
+	/// The final response to the poll was handled successfully
+	void OnPollCompleted(const timer_clock::time_point& arNow);
+
+	LatencyStatistics Snapshot() const;
+
+private:
+
+	void Record(LatencyStage aStage, const timer_clock::duration& arLatency) {
+		mStages[aStage].Record(arLatency);
+	}
+
+	std::deque<timer_clock::time_point> mQueued;	// queue times of the fragments waiting to be sent
+	timer_clock::time_point mApduQueued;			// queue time of the fragment in the transport layer
+	timer_clock::time_point mTransportStart;
+	bool mAwaitingFinal;							// the last segment has been sent but hasn't reached the router
+
+	timer_clock::time_point mLastRead;
+	timer_clock::time_point mRxStart;
+	timer_clock::time_point mRxComplete;
+	bool mReceiving;
+
+	timer_clock::time_point mPollStart;
+	bool mPolling;
+
+	StageHistogram mStages[LS_NUM_STAGES];
+};
+
+/// Trace stamps kept by the router alongside each queued frame
+struct FrameStamp {
+
+	FrameStamp(const timer_clock::time_point& arQueued, bool aFinal) :
+		mQueued(arQueued),
+		mFinal(aFinal)
+	{}
+
+	timer_clock::time_point mQueued;
+	bool mFinal;
+};
+
+}
+
+#endif
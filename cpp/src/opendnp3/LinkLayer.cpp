@@ -49,7 +49,9 @@ LinkLayer::LinkLayer(Logger* apLogger, IExecutor* apExecutor, const LinkConfig&
 	mIsOnline(false),
 	mpRouter(NULL),
 	mpPriState(PLLS_SecNotReset::Inst()),
-	mpSecState(SLLS_NotReset::Inst())
+	mpSecState(SLLS_NotReset::Inst()),
+	mpCounters(NULL),
+	mpTrace(NULL)
 {}
 
 void LinkLayer::SetRouter(ILinkRouter* apRouter)
@@ -176,6 +178,7 @@ bool LinkLayer::Retry()
 {
 	if(mRetryRemaining > 0) {
 		--mRetryRemaining;
+		if(mpCounters) mpCounters->Increment(SC_LINK_RETRIES);
 		return true;
 	}
 	else return false;
@@ -29,6 +29,8 @@
 #include "IExecutor.h"
 #include "ILinkContext.h"
 #include "LinkFrame.h"
+#include "StatisticsCounters.h"
+#include "LatencyTrace.h"
 
 #include <opendnp3/LinkConfig.h>
 #include <opendnp3/Visibility.h>
@@ -49,9 +51,22 @@ public:
 
 	void SetRouter(ILinkRouter*);
 
+	/// Optional counters for retries, owned by the stack
+	void SetCounters(StackCounters* apCounters) {
+		mpCounters = apCounters;
+	}
+
+	/// Optional latency trace, owned by the stack and stamped by the router
+	void SetLatencyTrace(LatencyTrace* apTrace) {
+		mpTrace = apTrace;
+	}
+
 	// ILinkContext interface
 	void OnLowerLayerUp();
 	void OnLowerLayerDown();
+	LatencyTrace* GetLatencyTrace() {
+		return mpTrace;
+	}
 
 	// IFrameSink interface
 	void Ack(bool aIsMaster, bool aIsRcvBuffFull, uint16_t aDest, uint16_t aSrc);
@@ -157,6 +172,8 @@ private:
 	ILinkRouter* mpRouter;
 	PriStateBase* mpPriState;
 	SecStateBase* mpSecState;
+	StackCounters* mpCounters;
+	LatencyTrace* mpTrace;
 };
 
 }
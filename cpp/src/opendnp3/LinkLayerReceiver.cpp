@@ -35,10 +35,11 @@ namespace opendnp3
 
 const uint8_t LinkLayerReceiver::M_SYNC_PATTERN[2] = {0x05, 0x64};
 
-LinkLayerReceiver::LinkLayerReceiver(Logger* apLogger, IFrameSink* apSink) :
+LinkLayerReceiver::LinkLayerReceiver(Logger* apLogger, IFrameSink* apSink, ChannelCounters* apCounters) :
 	Loggable(apLogger),
 	mFrameSize(0),
 	mpSink(apSink),
+	mpCounters(apCounters),
 	mpState(LRS_Sync::Inst()),
 	mBuffer(BUFFER_SIZE)
 {
@@ -69,6 +70,8 @@ void LinkLayerReceiver::OnRead(size_t aNumBytes)
 
 void LinkLayerReceiver::PushFrame()
 {
+	if(mpCounters) mpCounters->Increment(CC_FRAMES_RX);
+
 	switch(mHeader.GetFuncEnum()) {
 	case(FC_PRI_RESET_LINK_STATES):
 		mpSink->ResetLinkStates(mHeader.IsFromMaster(), mHeader.GetDest(), mHeader.GetSrc());
@@ -124,6 +127,7 @@ bool LinkLayerReceiver::ValidateBody()
 	size_t len = mHeader.GetLength() - LS_MIN_LENGTH;
 	if(LinkFrame::ValidateBodyCRC(mBuffer.ReadBuff() + LS_HEADER_SIZE, len)) return true;
 	else {
+		if(mpCounters) mpCounters->Increment(CC_CRC_ERRORS);
 		ERROR_BLOCK(LEV_ERROR, "CRC failure in body", DLERR_CRC);
 		return false;
 	}
@@ -133,6 +137,7 @@ bool LinkLayerReceiver::ValidateHeader()
 {
 	//first thing to do is check the CRC
 	if(!DNPCrc::IsCorrectCRC(mBuffer.ReadBuff(), LI_CRC)) {
+		if(mpCounters) mpCounters->Increment(CC_CRC_ERRORS);
 		ERROR_BLOCK(LEV_ERROR, "CRC failure in header", DLERR_CRC);
 		return false;
 	}
@@ -195,6 +200,7 @@ bool LinkLayerReceiver::ValidateHeader()
 void LinkLayerReceiver::FailFrame()
 {
 	// All you have to do is advance the reader by one, when the resync happens the data will disappear
+	if(mpCounters) mpCounters->Increment(CC_RESYNCS);
 	mBuffer.AdvanceRead(1);
 }
 
@@ -32,6 +32,7 @@
 #include "ShiftableBuffer.h"
 #include "LinkFrame.h"
 #include "LinkHeader.h"
+#include "StatisticsCounters.h"
 
 
 namespace opendnp3
@@ -50,8 +51,9 @@ public:
 	/**
 		@param apLogger Logger that the receiver is to use.
 		@param apSink Complete frames are sent to this interface.
+		@param apCounters Optional channel counters for received frames and parse errors
 	*/
-	LinkLayerReceiver(Logger* apLogger, IFrameSink* apSink);
+	LinkLayerReceiver(Logger* apLogger, IFrameSink* apSink, ChannelCounters* apCounters = NULL);
 
 	/**
 		Called when valid data has been written to the current buffer write position
@@ -101,6 +103,7 @@ private:
 	static const uint8_t M_SYNC_PATTERN[2];
 
 	IFrameSink* mpSink;  // pointer to interface to push complete frames
+	ChannelCounters* mpCounters;
 	LRS_Base* mpState;
 
 	// Buffer to which user data is extracted, this is necessary since CRC checks are interlaced
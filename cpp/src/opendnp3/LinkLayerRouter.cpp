@@ -38,10 +38,10 @@ using namespace std::chrono;
 namespace opendnp3
 {
 
-LinkLayerRouter::LinkLayerRouter(Logger* apLogger, IPhysicalLayerAsync* apPhys, millis_t aOpenRetry) :
+LinkLayerRouter::LinkLayerRouter(Logger* apLogger, IPhysicalLayerAsync* apPhys, const OpenRetryPolicy& arOpenRetry, OpenLimiter* apLimiter) :
 	Loggable(apLogger),
-	PhysicalLayerMonitor(apLogger, apPhys, milliseconds(aOpenRetry), milliseconds(aOpenRetry)),
-	mReceiver(apLogger, this),
+	PhysicalLayerMonitor(apLogger, apPhys, arOpenRetry, apLimiter),
+	mReceiver(apLogger, this, &mCounters),
 	mTransmitting(false)
 {}
 
@@ -104,6 +104,8 @@ ILinkContext* LinkLayerRouter::GetDestination(uint16_t aDest, uint16_t aSrc)
 
 	ILinkContext* pDest = GetContext(route);
 
+	if(pDest == NULL) mCounters.Increment(CC_UNKNOWN_ROUTE);
+
 	if(pDest == NULL && mpLogger->IsEnabled(LEV_WARNING)) {
 
 #ifndef OPENDNP3_STRIP_LOG_MESSAGES
@@ -163,16 +165,28 @@ void LinkLayerRouter::RequestLinkStatus(bool aIsMaster, uint16_t aDest, uint16_t
 void LinkLayerRouter::ConfirmedUserData(bool aIsMaster, bool aFcb, uint16_t aDest, uint16_t aSrc, const uint8_t* apData, size_t aDataLength)
 {
 	ILinkContext* pDest = GetDestination(aDest, aSrc);
-	if(pDest) pDest->ConfirmedUserData(aIsMaster, aFcb, aDest, aSrc, apData, aDataLength);
+	if(pDest) {
+		LATENCY_TRACE(pDest->GetLatencyTrace(), OnFrameRead(mReadTime));
+		pDest->ConfirmedUserData(aIsMaster, aFcb, aDest, aSrc, apData, aDataLength);
+	}
 }
 void LinkLayerRouter::UnconfirmedUserData(bool aIsMaster, uint16_t aDest, uint16_t aSrc, const uint8_t* apData, size_t aDataLength)
 {
 	ILinkContext* pDest = GetDestination(aDest, aSrc);
-	if(pDest) pDest->UnconfirmedUserData(aIsMaster, aDest, aSrc, apData, aDataLength);
+	if(pDest) {
+		LATENCY_TRACE(pDest->GetLatencyTrace(), OnFrameRead(mReadTime));
+		pDest->UnconfirmedUserData(aIsMaster, aDest, aSrc, apData, aDataLength);
+	}
 }
 
 void LinkLayerRouter::_OnReceive(const uint8_t*, size_t aNumBytes)
 {
+	if(mTrafficHandler) mTrafficHandler(aNumBytes);
+	mCounters.Increment(CC_BYTES_RX, aNumBytes);
+#ifdef OPENDNP3_LATENCY_TRACE
+	mReadTime = timer_clock::now();
+#endif
+
 	// The order is important here. You must let the receiver process the byte or another read could write
 	// over the buffer before it is processed
 	mReceiver.OnRead(aNumBytes); //this may trigger callbacks to the local ILinkContext interface
@@ -185,11 +199,17 @@ void LinkLayerRouter::Transmit(const LinkFrame& arFrame)
 {
 	LinkRoute lr(arFrame.GetDest(), arFrame.GetSrc());
 
-	if (this->GetContext(lr)) {
+	ILinkContext* pContext = this->GetContext(lr);
+
+	if (pContext) {
 		if (!this->IsLowerLayerUp()) {
 			MACRO_THROW_EXCEPTION(InvalidStateException, "LowerLayerDown");
 		}
 		this->mTransmitQueue.push_back(arFrame);
+#ifdef OPENDNP3_LATENCY_TRACE
+		this->StampQueued(pContext, arFrame);
+#endif
+		mCounters.Set(CC_TRANSMIT_QUEUE_DEPTH, mTransmitQueue.size());
 		this->CheckForSend();
 	}
 	else {
@@ -227,8 +247,15 @@ void LinkLayerRouter::_OnSendSuccess()
 	LinkRoute lr(f.GetDest(), f.GetSrc());
 	ILinkContext* pContext = this->GetContext(lr);
 	assert(pContext != NULL);
+	if(mTrafficHandler) mTrafficHandler(f.GetSize());
+	mCounters.Increment(CC_FRAMES_TX);
+	mCounters.Increment(CC_BYTES_TX, f.GetSize());
+#ifdef OPENDNP3_LATENCY_TRACE
+	this->StampWritten(pContext);
+#endif
 	mTransmitting = false;
 	mTransmitQueue.pop_front();
+	mCounters.Set(CC_TRANSMIT_QUEUE_DEPTH, mTransmitQueue.size());
 	this->CheckForSend();
 }
 
@@ -245,10 +272,33 @@ void LinkLayerRouter::CheckForSend()
 		mTransmitting = true;
 		const LinkFrame& f = mTransmitQueue.front();
 		LOG_BLOCK(LEV_INTERPRET, "~> " << f.ToString());
+#ifdef OPENDNP3_LATENCY_TRACE
+		mWriteStart = timer_clock::now();
+#endif
 		mpPhys->AsyncWrite(f.GetBuffer(), f.GetSize());
 	}
 }
 
+#ifdef OPENDNP3_LATENCY_TRACE
+void LinkLayerRouter::StampQueued(ILinkContext* apContext, const LinkFrame& arFrame)
+{
+	timer_clock::time_point now = timer_clock::now();
+	FuncCodes func = arFrame.GetFunc();
+	bool userData = (func == FC_PRI_CONFIRMED_USER_DATA) || (func == FC_PRI_UNCONFIRMED_USER_DATA);
+	LatencyTrace* pTrace = apContext->GetLatencyTrace();
+	bool final = (pTrace != NULL) && pTrace->OnFrameQueued(userData, now);
+	mTransmitStamps.push_back(FrameStamp(now, final));
+}
+
+void LinkLayerRouter::StampWritten(ILinkContext* apContext)
+{
+	const FrameStamp& stamp = mTransmitStamps.front();
+	LatencyTrace* pTrace = apContext->GetLatencyTrace();
+	if(pTrace != NULL) pTrace->OnFrameWritten(stamp.mFinal, stamp.mQueued, mWriteStart, timer_clock::now());
+	mTransmitStamps.pop_front();
+}
+#endif
+
 void LinkLayerRouter::OnPhysicalLayerOpenSuccessCallback()
 {
 	if(mpPhys->CanRead())
@@ -267,6 +317,10 @@ void LinkLayerRouter::OnPhysicalLayerCloseCallback()
 	// Drop frames queued for transmit and tell the contexts that the router has closed
 	mTransmitting = false;
 	mTransmitQueue.erase(mTransmitQueue.begin(), mTransmitQueue.end());
+	mCounters.Set(CC_TRANSMIT_QUEUE_DEPTH, 0);
+#ifdef OPENDNP3_LATENCY_TRACE
+	mTransmitStamps.clear();
+#endif
 	for(auto pair: mAddressMap) pair.second->OnLowerLayerDown();
 }
 
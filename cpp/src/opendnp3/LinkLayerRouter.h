@@ -33,6 +33,7 @@
 #include "IFrameSink.h"
 #include "ILinkRouter.h"
 #include "LinkRoute.h"
+#include "LatencyTrace.h"
 
 #include <opendnp3/Visibility.h>
 
@@ -50,7 +51,7 @@ class DLL_LOCAL LinkLayerRouter : public PhysicalLayerMonitor, public IFrameSink
 {
 public:
 
-	LinkLayerRouter(Logger*, IPhysicalLayerAsync*, millis_t aOpenRetry);
+	LinkLayerRouter(Logger*, IPhysicalLayerAsync*, const OpenRetryPolicy& arOpenRetry, OpenLimiter* apLimiter = NULL);
 
 	bool IsRouteInUse(const LinkRoute& arRoute);
 
@@ -77,6 +78,16 @@ public:
 	// Notify the listener when the state changes
 	void AddStateListener(std::function<void (ChannelState)> aListener);
 
+	/// Safe to call from any thread
+	ChannelStatistics GetStatistics() const {
+		return mCounters.Snapshot();
+	}
+
+	// Optional handler called with the number of bytes of every frame written and every read, used for bus accounting
+	void SetTrafficHandler(std::function<void (size_t)> aHandler) {
+		mTrafficHandler = aHandler;
+	}
+
 protected:
 
 	// override this function so that we can notify listeners
@@ -87,12 +98,17 @@ private:
 	void NotifyListener(std::function<void (ChannelState)> aListener, ChannelState state);
 
 	std::vector<std::function<void (ChannelState)>> mListeners;
+	std::function<void (size_t)> mTrafficHandler;
 
 	ILinkContext* GetDestination(uint16_t aDest, uint16_t aSrc);
 	ILinkContext* GetContext(const LinkRoute&);
 
 	void CheckForSend();
 
+#ifdef OPENDNP3_LATENCY_TRACE
+	void StampQueued(ILinkContext* apContext, const LinkFrame& arFrame);
+	void StampWritten(ILinkContext* apContext);
+#endif
 
 	typedef std::map<LinkRoute, ILinkContext*, LinkRoute::LessThan> AddressMap;
 	typedef std::deque<LinkFrame> TransmitQueue;
@@ -100,6 +116,14 @@ private:
 	AddressMap mAddressMap;
 	TransmitQueue mTransmitQueue;
 
+#ifdef OPENDNP3_LATENCY_TRACE
+	std::deque<FrameStamp> mTransmitStamps;	// one for each frame in mTransmitQueue
+	timer_clock::time_point mWriteStart;		// start of the write of the frame at the front of the queue
+	timer_clock::time_point mReadTime;			// completion of the read being parsed
+#endif
+
+	ChannelCounters mCounters;
+
 	// Handles the parsing of incoming frames
 	LinkLayerReceiver mReceiver;
 	bool mTransmitting;
@@ -23,6 +23,7 @@
 #include "Master.h"
 
 #include <opendnp3/Logger.h>
+#include <opendnp3/Util.h>
 #include <opendnp3/IDataObserver.h>
 
 #include "MasterStates.h"
@@ -47,19 +48,27 @@ namespace opendnp3
 Master::Master(Logger* apLogger, MasterConfig aCfg, IAppLayer* apAppLayer, IDataObserver* apPublisher, AsyncTaskGroup* apTaskGroup, IExecutor* apExecutor, ITimeSource* apTimeSrc) :
 	Loggable(apLogger),
 	StackBase(apExecutor),
+	mCommandQueue(apTaskGroup->GetTimeSource()),
 	mVtoReader(apLogger),
 	mVtoWriter(apLogger->GetSubLogger("VtoWriter"), aCfg.VtoWriterQueueSize),
 	mRequest(aCfg.FragSize),
 	mpAppLayer(apAppLayer),
-	mpPublisher(apPublisher),
+	mUseValueTable(aCfg.UseCurrentValueTable),
+	mValues(apPublisher),
+	mpFilter(aCfg.PublishChangesOnly ? &mFilter : NULL),
+	mpPublisher(mUseValueTable ? &mValues : apPublisher),
+	mOffloadDecode(aCfg.OffloadDecode),
+	mDecoder(apLogger, mpPublisher, &mVtoReader, mpFilter),
 	mpTaskGroup(apTaskGroup),
 	mpTimeSrc(apTimeSrc),
 	mpState(AMS_Closed::Inst()),
 	mpTask(NULL),
 	mpScheduledTask(NULL),
+	mpTrace(NULL),
+	mpCounters(NULL),
 	mState(SS_UNKNOWN),
 	mSchedule(apTaskGroup, this, aCfg),
-	mClassPoll(apLogger, apPublisher, &mVtoReader),
+	mClassPoll(apLogger, mpPublisher, &mVtoReader, mpFilter),
 	mClearRestart(apLogger),
 	mConfigureUnsol(apLogger),
 	mTimeSync(apLogger, apTimeSrc),
@@ -75,6 +84,9 @@ Master::Master(Logger* apLogger, MasterConfig aCfg, IAppLayer* apAppLayer, IData
 		this->mSchedule.mpCommandTask->Enable();
 	});
 
+	// command deadlines run from when the oldest queued command was requested
+	mSchedule.mpCommandTask->SetDemandTime(std::bind(&QueuedCommandProcessor::OldestRequestTime, &mCommandQueue));
+
 	/*
 	 * Establish a link between the mVtoWriter and the
 	 * mSchedule.mpVtoTransmitTask.  When new data is written to
@@ -90,6 +102,13 @@ Master::Master(Logger* apLogger, MasterConfig aCfg, IAppLayer* apAppLayer, IData
 	this->UpdateState(SS_COMMS_DOWN);
 }
 
+void Master::SetDecodePool(DecodePool* apPool)
+{
+	if(!mOffloadDecode || apPool == NULL) return;
+	mDecoder.SetPool(apPool);
+	mClassPoll.SetDecoder(&mDecoder);
+}
+
 void Master::UpdateState(StackState aState)
 {
 	if(mState != aState) {
@@ -210,9 +229,60 @@ void Master::DirectOperate(const AnalogOutputDouble64& arCommand, size_t aIndex,
 	this->mCommandTask.AddCommandCode(FC_DIRECT_OPERATE);
 }
 
+void Master::SelectAndOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback)
+{
+	this->ConfigureBatchCommandTask(arCommands, Group12Var1::Inst(), true, aCallback);
+}
+
+void Master::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback)
+{
+	this->ConfigureBatchCommandTask(arCommands, Group41Var2::Inst(), true, aCallback);
+}
+
+void Master::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback)
+{
+	this->ConfigureBatchCommandTask(arCommands, Group41Var1::Inst(), true, aCallback);
+}
+
+void Master::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback)
+{
+	this->ConfigureBatchCommandTask(arCommands, Group41Var3::Inst(), true, aCallback);
+}
+
+void Master::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback)
+{
+	this->ConfigureBatchCommandTask(arCommands, Group41Var4::Inst(), true, aCallback);
+}
+
+void Master::DirectOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback)
+{
+	this->ConfigureBatchCommandTask(arCommands, Group12Var1::Inst(), false, aCallback);
+}
+
+void Master::DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback)
+{
+	this->ConfigureBatchCommandTask(arCommands, Group41Var2::Inst(), false, aCallback);
+}
+
+void Master::DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback)
+{
+	this->ConfigureBatchCommandTask(arCommands, Group41Var1::Inst(), false, aCallback);
+}
+
+void Master::DirectOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback)
+{
+	this->ConfigureBatchCommandTask(arCommands, Group41Var3::Inst(), false, aCallback);
+}
+
+void Master::DirectOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback)
+{
+	this->ConfigureBatchCommandTask(arCommands, Group41Var4::Inst(), false, aCallback);
+}
+
 void Master::StartTask(MasterTaskBase* apMasterTask, bool aInit)
 {
 	if(aInit) apMasterTask->Init();
+	if(aInit && apMasterTask == &mClassPoll) LATENCY_TRACE(mpTrace, OnPollStarted(timer_clock::now()));
 	apMasterTask->ConfigureRequest(mRequest);
 	mpAppLayer->SendRequest(mRequest);
 }
@@ -241,12 +311,31 @@ void Master::IntegrityPoll(ITask* apTask)
 	mpState->StartTask(this, apTask, &mClassPoll);
 }
 
-void Master::EventPoll(ITask* apTask, int aClassMask)
+void Master::EventPoll(ITask* apTask, EventScan* apScan)
 {
-	mClassPoll.Set(aClassMask);
+	mClassPoll.Set(apScan->ClassMask(), apScan);
 	mpState->StartTask(this, apTask, &mClassPoll);
 }
 
+void Master::OnClassPollComplete()
+{
+	// the decoder filters after the poll and reports what it drops per poll through ReadDecodeStatistics()
+	if(mpCounters && mpFilter && !mDecoder.IsEnabled()) {
+		mpCounters->Set(SC_POLL_SUPPRESSED_POINTS, mClassPoll.NumSuppressed());
+		mpCounters->Increment(SC_SUPPRESSED_POINTS, mClassPoll.NumSuppressed());
+	}
+
+	EventScan* pScan = mClassPoll.GetScan();
+	if(pScan == NULL) return;
+
+	pScan->OnScan(mClassPoll.LastIIN(), mClassPoll.NumFragments(), mClassPoll.NumObjects(), mClassPoll.NumBytes());
+
+	if(mpCounters) {
+		mpCounters->Increment(SC_EVENT_SCANS);
+		mpCounters->Set(SC_EVENT_SCAN_PERIOD_MILLIS, Max<millis_t>(0, mSchedule.ShortestScanPeriod()));
+	}
+}
+
 void Master::ChangeUnsol(ITask* apTask, bool aEnable, int aClassMask)
 {
 	mConfigureUnsol.Set(aEnable, aClassMask);
@@ -336,11 +425,18 @@ void Master::OnUnsolResponse(const APDU& arAPDU)
 
 void Master::ProcessDataResponse(const APDU& arResponse)
 {
+	if(mDecoder.IsEnabled()) {
+		mDecoder.Submit(arResponse);
+		return;
+	}
+
 	try {
-		ResponseLoader loader(this->mpLogger, this->mpPublisher, this->GetVtoReader());
+		ResponseLoader loader(this->mpLogger, this->mpPublisher, this->GetVtoReader(), mpFilter);
 
 		for(HeaderReadIterator hdr = arResponse.BeginRead(); !hdr.IsEnd(); ++hdr)
 			loader.Process(hdr);
+
+		if(mpCounters && loader.NumSuppressed() > 0) mpCounters->Increment(SC_SUPPRESSED_POINTS, loader.NumSuppressed());
 	}
 	catch(const Exception& ex) {
 		EXCEPTION_BLOCK(LEV_WARNING, ex)
@@ -29,6 +29,7 @@
 #ifndef __MASTER_H_
 #define __MASTER_H_
 
+#include <opendnp3/CommandBatch.h>
 #include <opendnp3/MasterConfig.h>
 #include <opendnp3/ObjectInterfaces.h>
 #include <opendnp3/Visibility.h>
@@ -44,6 +45,7 @@
 #include "VtoWriter.h"
 #include "QueuedCommandProcessor.h"
 #include "CommandHelpers.h"
+#include "CommandBatchSequence.h"
 
 // includes for tasks
 #include "StartupTasks.h"
@@ -51,6 +53,14 @@
 #include "VtoTransmitTask.h"
 #include "CommandTask.h"
 #include "StackBase.h"
+#include "LatencyTrace.h"
+#include "StatisticsCounters.h"
+#include "CurrentValueTable.h"
+#include "ChangeFilter.h"
+#include "DecodePipeline.h"
+
+#include <memory>
+#include <vector>
 
 namespace opendnp3
 {
@@ -64,6 +74,7 @@ class AsyncTaskContinuous;
 class AsyncTaskBase;
 class CopyableBuffer;
 class AMS_Base;
+class DecodePool;
 
 /**
  * Represents a DNP3 Master endpoint. The tasks functions can perform all the
@@ -88,6 +99,31 @@ public:
 		return &mCommandQueue;
 	}
 
+	/// Copies the current value table, false if it isn't enabled. Safe to call from any thread.
+	bool ReadCurrentValues(CurrentValues& arValues) {
+		if(!mUseValueTable) return false;
+		mValues.Read(arValues);
+		return true;
+	}
+
+	/// Optional latency trace for poll round trips, owned by the stack
+	void SetLatencyTrace(LatencyTrace* apTrace) {
+		mpTrace = apTrace;
+	}
+
+	/// Optional counters for exception scan statistics, owned by the stack
+	void SetCounters(StackCounters* apCounters) {
+		mpCounters = apCounters;
+	}
+
+	/// Threads that decode data responses if the config asks for it, owned by the manager
+	void SetDecodePool(DecodePool* apPool);
+
+	/// Adds the decode pipeline's metrics, safe from any thread
+	void ReadDecodeStatistics(StackStatistics& arStats) const {
+		if(mDecoder.IsEnabled()) mDecoder.ReadStatistics(arStats);
+	}
+
 	/**
 	 * Returns a pointer to the VTO reader object.  This should only be
 	 * used by internal subsystems in the library.  External user
@@ -152,6 +188,21 @@ public:
 	void SelectAndOperate(const AnalogOutputDouble64& arCommand, size_t aIndex, std::function<void (CommandResponse)> aCallback);
 	void DirectOperate(const AnalogOutputDouble64& arCommand, size_t aIndex, std::function<void (CommandResponse)> aCallback);
 
+	void SelectAndOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback);
+
 private:
 
 	template <class T>
@@ -167,13 +218,39 @@ private:
 		mCommandTask.Configure(formatter, responder);
 	}
 
+	template <class T>
+	void ConfigureBatchCommandTask(const std::vector< IndexedCommand<T> >& arCommands, CommandObject<T>* apObj, bool aSelectBeforeOperate, BatchCallback aCallback) {
+		std::shared_ptr< CommandBatchSequence<T> > pBatch(new CommandBatchSequence<T>(arCommands, apObj, aSelectBeforeOperate));
+		auto formatter = [this, pBatch](APDU & arAPDU, FunctionCodes aCode) -> std::function<CommandStatus (const APDU&)> {
+			pBatch->Format(arAPDU, aCode);
+			return [this, pBatch, aCode](const APDU & arResponse) {
+				// the batch decides whether another request follows once it has seen the response
+				CommandStatus status = pBatch->Validate(arResponse, aCode);
+				FunctionCodes next;
+				if(status == CS_SUCCESS && pBatch->GetNextCode(next)) mCommandTask.AddCommandCode(next);
+				return status;
+			};
+		};
+		auto responder = [this, pBatch, aCallback](CommandStatus aStatus) {
+			if(aStatus != CS_SUCCESS) pBatch->Fail(aStatus);
+			std::vector<CommandResponse> responses = pBatch->GetResponses();
+			mpExecutor->Post([ = ]() {
+				aCallback(responses);
+			});
+		};
+		mCommandTask.Configure(formatter, responder);
+
+		FunctionCodes first;
+		if(pBatch->GetNextCode(first)) mCommandTask.AddCommandCode(first);
+	}
+
 	void UpdateState(StackState aState);
 
 	/* Task functions used for scheduling */
 
 	void WriteIIN(ITask* apTask);
 	void IntegrityPoll(ITask* apTask);
-	void EventPoll(ITask* apTask, int aClassMask);
+	void EventPoll(ITask* apTask, EventScan* apScan);
 	void ChangeUnsol(ITask* apTask, bool aEnable, int aClassMask);
 	void SyncTime(ITask* apTask);
 	void ProcessCommand(ITask* apTask);
@@ -184,6 +261,7 @@ private:
 	void ProcessIIN(const IINField& arIIN);	// Analyze IIN bits and react accordingly
 	void ProcessDataResponse(const APDU&);	// Read data output of solicited or unsolicited response and publish
 	void StartTask(MasterTaskBase*, bool aInit);	// Starts a task running
+	void OnClassPollComplete();				// Adapts the exception scan that just completed
 
 	QueuedCommandProcessor mCommandQueue;				// Threadsafe queue for buffering command requests
 
@@ -205,13 +283,21 @@ private:
 	APDU mRequest;							// APDU that gets reused for requests
 
 	IAppLayer* mpAppLayer;					// lower application layer
+	bool mUseValueTable;					// if true, measurements go through mValues on the way to the observer
+	CurrentValueTable mValues;				// latest value of every point, readable from any thread
+	ChangeFilter mFilter;					// last published value of every point
+	ChangeFilter* mpFilter;					// &mFilter if only changes are published, otherwise NULL
 	IDataObserver* mpPublisher;				// where the data measurements are pushed
+	bool mOffloadDecode;					// if true, data responses go through mDecoder once there's a pool
+	DecodePipeline mDecoder;				// decodes and publishes data responses off the strand
 	AsyncTaskGroup* mpTaskGroup;			// How task execution is controlled
 	ITimeSource* mpTimeSrc;					// Access to UTC, normally system time but can be a mock for testing
 
 	AMS_Base* mpState;						// Pointer to active state, start in TLS_Closed
 	MasterTaskBase* mpTask;					// The current master task
 	ITask* mpScheduledTask;					// The current scheduled task
+	LatencyTrace* mpTrace;					// Records poll round trips when tracing is built in
+	StackCounters* mpCounters;				// Exception scan statistics, owned by the stack
 	StackState mState;						// Current state of the master
 
 	StackState GetState() {
@@ -26,6 +26,7 @@
 #include "AsyncTaskBase.h"
 #include "AsyncTaskContinuous.h"
 #include "AsyncTaskGroup.h"
+#include "AsyncTaskPeriodic.h"
 
 #include <functional>
 
@@ -36,7 +37,7 @@ namespace opendnp3
 
 MasterSchedule::MasterSchedule(AsyncTaskGroup* apGroup, Master* apMaster, const MasterConfig& arCfg) :
 	mpGroup(apGroup),
-	mTracking(apGroup)
+	mTracking(apGroup, arCfg.TaskRetryRate)
 {
 	this->Init(arCfg, apMaster);
 }
@@ -56,6 +57,15 @@ void MasterSchedule::ResetStartupTasks()
 	mTracking.ResetTasks(START_UP_TASKS);
 }
 
+millis_t MasterSchedule::ShortestScanPeriod() const
+{
+	millis_t shortest = -1;
+for(const EventScan & s: mScans) {
+		if(s.Period() >= 0 && (shortest < 0 || s.Period() < shortest)) shortest = s.Period();
+	}
+	return shortest;
+}
+
 void MasterSchedule::Init(const MasterConfig& arCfg, Master* apMaster)
 {
 	AsyncTaskBase* pIntegrity = mTracking.Add(
@@ -66,6 +76,7 @@ void MasterSchedule::Init(const MasterConfig& arCfg, Master* apMaster)
 	                                    "Integrity Poll");
 
 	pIntegrity->SetFlags(ONLINE_ONLY_TASKS | START_UP_TASKS);
+	pIntegrity->SetAging(arCfg.PollAgingRate);
 
 	if (arCfg.DoUnsolOnStartup) {
 		/*
@@ -110,17 +121,24 @@ void MasterSchedule::Init(const MasterConfig& arCfg, Master* apMaster)
 
 	/*
 	 * Load any exception scans and make them dependent on the
-	 * integrity poll.
+	 * integrity poll. The period of an adaptive scan's task is
+	 * changed by the scan as it completes.
 	 */
 for(ExceptionScan e: arCfg.mScans) {
-		AsyncTaskBase* pEventScan = mTracking.Add(
-		                                    e.ScanRate,
-		                                    arCfg.TaskRetryRate,
-		                                    AMP_POLL,
-		                                    bind(&Master::EventPoll, apMaster, _1, e.ClassMask),
-		                                    "Event Scan");
+		mScans.emplace_back(e, mpGroup->GetScheduler());
+		EventScan* pScan = &mScans.back();
+		TaskHandler handler = bind(&Master::EventPoll, apMaster, _1, pScan);
+
+		AsyncTaskBase* pEventScan;
+		if(e.IsAdaptive()) {
+			AsyncTaskPeriodic* pPeriodic = mTracking.AddPeriodic(e.ScanRate, arCfg.TaskRetryRate, AMP_POLL, handler, "Event Scan");
+			pScan->SetTask(pPeriodic);
+			pEventScan = pPeriodic;
+		}
+		else pEventScan = mTracking.Add(e.ScanRate, arCfg.TaskRetryRate, AMP_POLL, handler, "Event Scan");
 
 		pEventScan->SetFlags(ONLINE_ONLY_TASKS);
+		pEventScan->SetAging(arCfg.PollAgingRate);
 		pEventScan->AddDependency(pIntegrity);
 	}
 
@@ -130,6 +148,8 @@ for(ExceptionScan e: arCfg.mScans) {
 	                        std::bind(&Master::ProcessCommand, apMaster, _1),
 	                        "Command");
 
+	mpCommandTask->SetDeadline(arCfg.CommandDeadline);
+
 	mpTimeTask = mTracking.AddContinuous(
 	                     AMP_TIME_SYNC,
 	                     std::bind(&Master::SyncTime, apMaster, _1),
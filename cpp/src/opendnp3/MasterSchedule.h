@@ -32,8 +32,11 @@
 #include <opendnp3/MasterConfig.h>
 #include <opendnp3/Visibility.h>
 
+#include "EventScan.h"
 #include "TrackingTaskGroup.h"
 
+#include <deque>
+
 namespace opendnp3
 {
 
@@ -79,6 +82,9 @@ public:
 	// Resets all of the tasks that run on startup. This is typically done after a failure
 	void ResetStartupTasks();
 
+	// @return the current period of the most frequent exception scan, -1 if there are none
+	millis_t ShortestScanPeriod() const;
+
 private:
 
 	void Init(const MasterConfig& arCfg, Master* mpMaster);
@@ -87,6 +93,9 @@ private:
 	AsyncTaskGroup* mpGroup;
 	TrackingTaskGroup mTracking;
 
+	// a deque so the tasks can keep pointers to the scans
+	std::deque<EventScan> mScans;
+
 	enum MasterPriority {
 		AMP_VTO_TRANSMIT,
 		AMP_POLL,
@@ -35,15 +35,24 @@ MasterStackImpl::MasterStackImpl(	Logger* apLogger,
                                         IDataObserver* apPublisher,
                                         AsyncTaskGroup* apTaskGroup,
                                         const MasterStackConfig& arCfg,
-                                        std::function<void (IMaster*)> aOnShutdown) :
+                                        std::function<void (IMaster*)> aOnShutdown,
+                                        DeliveryPool* apDeliveryPool,
+                                        DecodePool* apDecodePool) :
 
 	IMaster(apLogger, apService),
 	mpExecutor(apExecutor),
 	mAppStack(apLogger, apExecutor, arCfg.app, arCfg.link),
-	mMaster(apLogger->GetSubLogger("master"), arCfg.master, &mAppStack.mApplication, apPublisher, apTaskGroup, apExecutor),
+	mDelivery(apPublisher, arCfg.delivery, apDeliveryPool),
+	mMaster(apLogger->GetSubLogger("master"), arCfg.master, &mAppStack.mApplication, (arCfg.delivery.mCapacity > 0) ? &mDelivery : apPublisher, apTaskGroup, apExecutor),
 	mOnShutdown(aOnShutdown)
 {
 	mAppStack.mApplication.SetUser(&mMaster);
+	mMaster.SetCounters(&mAppStack.mCounters);
+	mMaster.SetDecodePool(apDecodePool);
+
+#ifdef OPENDNP3_LATENCY_TRACE
+	mMaster.SetLatencyTrace(&mAppStack.mTrace);
+#endif
 }
 
 ICommandProcessor* MasterStackImpl::GetCommandProcessor()
@@ -51,6 +60,11 @@ ICommandProcessor* MasterStackImpl::GetCommandProcessor()
 	return mMaster.GetCommandProcessor();
 }
 
+bool MasterStackImpl::ReadCurrentValues(CurrentValues& arValues)
+{
+	return mMaster.ReadCurrentValues(arValues);
+}
+
 ILinkContext* MasterStackImpl::GetLinkContext()
 {
 	return &mAppStack.mLink;
@@ -61,6 +75,19 @@ void MasterStackImpl::SetLinkRouter(ILinkRouter* apRouter)
 	mAppStack.mLink.SetRouter(apRouter);
 }
 
+StackStatistics MasterStackImpl::GetStatistics()
+{
+	StackStatistics stats = mAppStack.mCounters.Snapshot();
+	mDelivery.ReadStatistics(stats);
+	mMaster.ReadDecodeStatistics(stats);
+	return stats;
+}
+
+LatencyStatistics MasterStackImpl::GetLatencyStatistics()
+{
+	return mAppStack.GetLatencyStatistics();
+}
+
 void MasterStackImpl::Shutdown()
 {
 	this->CleanupVto();
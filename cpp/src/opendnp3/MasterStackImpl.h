@@ -35,12 +35,15 @@
 
 #include "Master.h"
 #include "ApplicationStack.h"
+#include "DeliveryQueue.h"
 
 
 namespace opendnp3
 {
 
 class ILinkContext;
+class DeliveryPool;
+class DecodePool;
 
 /** @section desc A stack object for a master */
 class DLL_LOCAL MasterStackImpl : public IMaster
@@ -54,16 +57,24 @@ public:
 	        IDataObserver* apPublisher,
 	        AsyncTaskGroup* apTaskGroup,
 	        const MasterStackConfig& arCfg,
-	        std::function<void (IMaster*)> aOnShutdown);
+	        std::function<void (IMaster*)> aOnShutdown,
+	        DeliveryPool* apDeliveryPool = NULL,
+	        DecodePool* apDecodePool = NULL);
 
 	ICommandProcessor* GetCommandProcessor();
 
+	bool ReadCurrentValues(CurrentValues& arValues);
+
 	ILinkContext* GetLinkContext();
 
 	void SetLinkRouter(ILinkRouter* apRouter);
 
 	void AddStateListener(std::function<void (StackState)> aListener);
 
+	StackStatistics GetStatistics();
+
+	LatencyStatistics GetLatencyStatistics();
+
 	void Shutdown();
 
 protected:
@@ -74,6 +85,7 @@ protected:
 private:
 	IExecutor* mpExecutor;
 	ApplicationStack mAppStack;
+	DeliveryQueue mDelivery;	// between the master and the observer if arCfg.delivery has a capacity
 	Master mMaster;
 	std::function<void (IMaster*)> mOnShutdown;
 
@@ -161,6 +161,10 @@ void AMS_Waiting::OnFinalResponse(Master* c, const APDU& arAPDU)
 		c->StartTask(c->mpTask, false);
 		break;
 	case(TR_SUCCESS):
+		if(c->mpTask == &c->mClassPoll) {
+			LATENCY_TRACE(c->mpTrace, OnPollCompleted(timer_clock::now()));
+			c->OnClassPollComplete();
+		}
 		this->ChangeState(c, AMS_Idle::Inst());
 		c->mpScheduledTask->OnComplete(true);
 	}
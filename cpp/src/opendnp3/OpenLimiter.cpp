@@ -0,0 +1,100 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "OpenLimiter.h"
+
+#include "PhysicalLayerMonitor.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace opendnp3
+{
+
+OpenLimiter::OpenLimiter(size_t aMaxInFlight) :
+	mMaxInFlight(aMaxInFlight),
+	mNumInFlight(0)
+{
+
+}
+
+void OpenLimiter::SetMaxInFlight(size_t aMaxInFlight)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mMaxInFlight = aMaxInFlight;
+	this->GrantWaiting();
+}
+
+bool OpenLimiter::Acquire(PhysicalLayerMonitor* apMonitor)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if(mMaxInFlight == 0 || mNumInFlight < mMaxInFlight) {
+		++mNumInFlight;
+		return true;
+	}
+	else {
+		mWaiting.push_back(apMonitor);
+		return false;
+	}
+}
+
+bool OpenLimiter::Cancel(PhysicalLayerMonitor* apMonitor)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	auto iter = std::remove(mWaiting.begin(), mWaiting.end(), apMonitor);
+	if(iter == mWaiting.end()) return false;
+	mWaiting.erase(iter, mWaiting.end());
+	return true;
+}
+
+void OpenLimiter::Release()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	assert(mNumInFlight > 0);
+	--mNumInFlight;
+	this->GrantWaiting();
+}
+
+size_t OpenLimiter::GetNumInFlight()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	return mNumInFlight;
+}
+
+size_t OpenLimiter::GetNumWaiting()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	return mWaiting.size();
+}
+
+void OpenLimiter::GrantWaiting()
+{
+	while(!mWaiting.empty() && (mMaxInFlight == 0 || mNumInFlight < mMaxInFlight)) {
+		PhysicalLayerMonitor* pMonitor = mWaiting.front();
+		mWaiting.pop_front();
+		++mNumInFlight;
+		pMonitor->OnOpenGranted(); // only posts to the monitor's executor
+	}
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
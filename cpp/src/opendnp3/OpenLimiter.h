@@ -0,0 +1,83 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __OPEN_LIMITER_H_
+#define __OPEN_LIMITER_H_
+
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include <deque>
+#include <mutex>
+#include <stddef.h>
+
+namespace opendnp3
+{
+
+class PhysicalLayerMonitor;
+
+/**
+* Limits how many physical layers can be opening at the same time. Each open holds one token
+* until it succeeds or fails. Monitors that ask while every token is taken are queued and are
+* granted a token, in order, as others are released. Shared by all the channels of a manager,
+* so it's safe to call from any thread.
+*/
+class DLL_LOCAL OpenLimiter : private Uncopyable
+{
+public:
+
+	/// @param aMaxInFlight Maximum number of concurrent opens, 0 means unlimited
+	OpenLimiter(size_t aMaxInFlight = 0);
+
+	/// Changing the limit immediately grants tokens to waiting monitors if it was raised
+	void SetMaxInFlight(size_t aMaxInFlight);
+
+	/**
+	* Take a token or queue for one
+	* @return true if the token was taken, otherwise the monitor's OnOpenGranted() is called later
+	*/
+	bool Acquire(PhysicalLayerMonitor* apMonitor);
+
+	/**
+	* Withdraw every queued request of the monitor. Once this returns, no further grant is posted to it.
+	* @return false if the monitor wasn't queued, i.e. a grant is already on its way
+	*/
+	bool Cancel(PhysicalLayerMonitor* apMonitor);
+
+	/// Return a token taken by Acquire() or granted by OnOpenGranted()
+	void Release();
+
+	size_t GetNumInFlight();
+	size_t GetNumWaiting();
+
+private:
+
+	void GrantWaiting();
+
+	std::mutex mMutex;
+	size_t mMaxInFlight;
+	size_t mNumInFlight;
+	std::deque<PhysicalLayerMonitor*> mWaiting;
+};
+
+}
+
+#endif
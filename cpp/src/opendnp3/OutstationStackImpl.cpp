@@ -40,7 +40,9 @@ OutstationStackImpl::OutstationStackImpl(
 	mOnShutdown(aOnShutdown)
 {
 	mAppStack.mApplication.SetUser(&mSlave);
+	mSlave.SetCounters(&mAppStack.mCounters);
 	mDB.Configure(arCfg.device);
+	if(!arCfg.slave.mSnapshot.mPath.empty()) mDB.LoadSnapshot(arCfg.slave.mSnapshot.mPath);
 }
 
 IDataObserver* OutstationStackImpl::GetDataObserver()
@@ -63,6 +65,16 @@ void OutstationStackImpl::AddStateListener(std::function<void (StackState)> aLis
 	mSlave.AddStateListener(aListener);
 }
 
+StackStatistics OutstationStackImpl::GetStatistics()
+{
+	return mAppStack.mCounters.Snapshot();
+}
+
+LatencyStatistics OutstationStackImpl::GetLatencyStatistics()
+{
+	return mAppStack.GetLatencyStatistics();
+}
+
 void OutstationStackImpl::Shutdown()
 {
 	this->CleanupVto();
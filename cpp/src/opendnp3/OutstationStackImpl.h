@@ -63,6 +63,10 @@ public:
 
 	void AddStateListener(std::function<void (StackState)> aListener);
 
+	StackStatistics GetStatistics();
+
+	LatencyStatistics GetLatencyStatistics();
+
 	void Shutdown();
 
 protected:
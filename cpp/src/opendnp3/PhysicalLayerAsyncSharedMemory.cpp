@@ -0,0 +1,194 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "PhysicalLayerAsyncSharedMemory.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Logger.h>
+
+#include "LoggableMacros.h"
+
+#include <boost/asio.hpp>
+
+#include <functional>
+
+using namespace boost;
+using namespace boost::system;
+
+namespace opendnp3
+{
+
+// how often a sleeping layer wakes to check that the peer process is still alive
+const millis_t PEER_CHECK_MS = 1000;
+
+PhysicalLayerAsyncSharedMemory::PhysicalLayerAsyncSharedMemory(Logger* apLogger, boost::asio::io_service* apIOService, const std::string& arName) :
+	PhysicalLayerAsyncASIO(apLogger, apIOService),
+	mName(arName),
+	mpSelf(new PhysicalLayerAsyncSharedMemory*(this)),
+	mStopWaiting(false),
+	mCheckPending(false),
+	mpReadBuffer(NULL),
+	mMaxRead(0),
+	mpWriteBuffer(NULL),
+	mNumToWrite(0),
+	mNumWritten(0)
+{
+
+}
+
+PhysicalLayerAsyncSharedMemory::~PhysicalLayerAsyncSharedMemory()
+{
+	this->Detach();
+}
+
+/* Implement the actions */
+
+void PhysicalLayerAsyncSharedMemory::DoClose()
+{
+	this->Detach();
+
+	// complete any outstanding operations the way a cancelled socket would
+	if(mpReadBuffer != NULL) {
+		mStrand.post(std::bind(&PhysicalLayerAsyncSharedMemory::CompleteRead, this, error_code(boost::asio::error::operation_aborted), 0));
+	}
+	if(mpWriteBuffer != NULL) {
+		mStrand.post(std::bind(&PhysicalLayerAsyncSharedMemory::CompleteWrite, this, error_code(boost::asio::error::operation_aborted)));
+	}
+}
+
+void PhysicalLayerAsyncSharedMemory::DoAsyncRead(uint8_t* apBuffer, size_t aMaxBytes)
+{
+	mpReadBuffer = apBuffer;
+	mMaxRead = aMaxBytes;
+	this->PostCheck();
+}
+
+void PhysicalLayerAsyncSharedMemory::DoAsyncWrite(const uint8_t* apBuffer, size_t aNumBytes)
+{
+	mpWriteBuffer = apBuffer;
+	mNumToWrite = aNumBytes;
+	mNumWritten = mpSegment->Write(apBuffer, aNumBytes);
+
+	// the completion is always asynchronous, even when the whole buffer fit
+	if(mNumWritten == mNumToWrite) {
+		mpWriteBuffer = NULL;
+		mStrand.post(std::bind(&PhysicalLayerAsyncSharedMemory::CompleteWrite, this, error_code()));
+	}
+	else this->PostCheck();
+}
+
+void PhysicalLayerAsyncSharedMemory::DoOpenFailure()
+{
+	this->Detach();
+}
+
+void PhysicalLayerAsyncSharedMemory::PostOpenCallback(const error_code& arError)
+{
+	mStrand.post(std::bind(&PhysicalLayerAsyncSharedMemory::OnOpenCallback, this, arError));
+}
+
+void PhysicalLayerAsyncSharedMemory::Attach(SharedMemorySegment* apSegment)
+{
+	mpSegment.reset(apSegment);
+	mStopWaiting = false;
+	mWaiter = std::thread(std::bind(&PhysicalLayerAsyncSharedMemory::WaitForDoorbell, this, apSegment));
+}
+
+void PhysicalLayerAsyncSharedMemory::Detach()
+{
+	if(mpSegment.get() == NULL) return;
+
+	mStopWaiting = true;
+	mpSegment->RingLocal();
+	mWaiter.join();
+
+	mpSegment->Disconnect();
+	mpSegment.reset();
+}
+
+void PhysicalLayerAsyncSharedMemory::WaitForDoorbell(SharedMemorySegment* apSegment)
+{
+	uint32_t seen = apSegment->GetDoorbell();
+	while(!mStopWaiting) {
+		if(!mCheckPending.exchange(true)) {
+			mStrand.post(std::bind(&PhysicalLayerAsyncSharedMemory::PostedCheck, std::weak_ptr<PhysicalLayerAsyncSharedMemory*>(mpSelf)));
+		}
+		apSegment->WaitForDoorbell(seen, PEER_CHECK_MS);
+		seen = apSegment->GetDoorbell();
+	}
+}
+
+void PhysicalLayerAsyncSharedMemory::PostCheck()
+{
+	mStrand.post(std::bind(&PhysicalLayerAsyncSharedMemory::PostedCheck, std::weak_ptr<PhysicalLayerAsyncSharedMemory*>(mpSelf)));
+}
+
+void PhysicalLayerAsyncSharedMemory::PostedCheck(std::weak_ptr<PhysicalLayerAsyncSharedMemory*> aSelf)
+{
+	std::shared_ptr<PhysicalLayerAsyncSharedMemory*> pSelf = aSelf.lock();
+	if(pSelf) (*pSelf)->Check();
+}
+
+void PhysicalLayerAsyncSharedMemory::Check()
+{
+	// cleared first so a doorbell that rings from here on posts another check
+	mCheckPending = false;
+
+	// each step can close the layer and detach the segment
+	if(mpSegment.get() != NULL && mState.IsOpening()) this->OnOpeningCheck();
+	if(mpSegment.get() != NULL && mpReadBuffer != NULL) this->TryRead();
+	if(mpSegment.get() != NULL && mpWriteBuffer != NULL) this->TryWrite();
+}
+
+void PhysicalLayerAsyncSharedMemory::TryRead()
+{
+	size_t num = mpSegment->Read(mpReadBuffer, mMaxRead);
+	if(num > 0) this->CompleteRead(error_code(), num);
+	else if(!mpSegment->IsPeerConnected()) this->CompleteRead(boost::asio::error::eof, 0);
+}
+
+void PhysicalLayerAsyncSharedMemory::TryWrite()
+{
+	if(!mpSegment->IsPeerConnected()) {
+		this->CompleteWrite(boost::asio::error::broken_pipe);
+	}
+	else {
+		mNumWritten += mpSegment->Write(mpWriteBuffer + mNumWritten, mNumToWrite - mNumWritten);
+		if(mNumWritten == mNumToWrite) this->CompleteWrite(error_code());
+	}
+}
+
+void PhysicalLayerAsyncSharedMemory::CompleteRead(const error_code& arError, size_t aNumBytes)
+{
+	uint8_t* pBuffer = mpReadBuffer;
+	mpReadBuffer = NULL;
+	this->OnReadCallback(arError, pBuffer, aNumBytes);
+}
+
+void PhysicalLayerAsyncSharedMemory::CompleteWrite(const error_code& arError)
+{
+	mpWriteBuffer = NULL;
+	this->OnWriteCallback(arError, mNumWritten);
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,106 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __PHYSICAL_LAYER_ASYNC_SHARED_MEMORY_H_
+#define __PHYSICAL_LAYER_ASYNC_SHARED_MEMORY_H_
+
+#include "PhysicalLayerAsyncASIO.h"
+#include "SharedMemorySegment.h"
+
+#include <opendnp3/Location.h>
+
+#include <boost/system/error_code.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace opendnp3
+{
+
+/**
+Shared handling for the shared memory client and server. Writes are copied
+straight into the peer's ring. Reads drain everything that is waiting in this
+end's ring, so a burst of frames reaches the link layer in a single callback.
+
+A helper thread sleeps on the segment's doorbell while the layer is attached
+and posts a check to the strand whenever the peer writes, frees space or
+changes state. It also wakes periodically to notice a peer process that died.
+*/
+class DLL_LOCAL PhysicalLayerAsyncSharedMemory : public PhysicalLayerAsyncASIO
+{
+public:
+	PhysicalLayerAsyncSharedMemory(Logger*, boost::asio::io_service* apIOService, const std::string& arName);
+
+	virtual ~PhysicalLayerAsyncSharedMemory();
+
+	/* Implement the shared client/server actions */
+	void DoClose();
+	void DoAsyncRead(uint8_t*, size_t);
+	void DoAsyncWrite(const uint8_t*, size_t);
+	void DoOpenFailure();
+
+protected:
+
+	// takes ownership of a mapped segment and starts waiting on its doorbell
+	void Attach(SharedMemorySegment* apSegment);
+
+	// stops waiting, marks this end closed and unmaps the segment
+	void Detach();
+
+	// called on the strand for every check while the layer is opening
+	virtual void OnOpeningCheck() {}
+
+	void PostOpenCallback(const boost::system::error_code& arError);
+
+	const std::string mName;
+	std::auto_ptr<SharedMemorySegment> mpSegment;
+
+private:
+
+	static void PostedCheck(std::weak_ptr<PhysicalLayerAsyncSharedMemory*> aSelf);
+
+	void PostCheck();
+	void Check();
+	void WaitForDoorbell(SharedMemorySegment* apSegment);
+
+	void TryRead();
+	void TryWrite();
+	void CompleteRead(const boost::system::error_code& arError, size_t aNumBytes);
+	void CompleteWrite(const boost::system::error_code& arError);
+
+	// posted checks hold a weak reference so they are harmless after destruction
+	std::shared_ptr<PhysicalLayerAsyncSharedMemory*> mpSelf;
+
+	std::thread mWaiter;
+	std::atomic<bool> mStopWaiting;
+	std::atomic<bool> mCheckPending;
+
+	uint8_t* mpReadBuffer;
+	size_t mMaxRead;
+	const uint8_t* mpWriteBuffer;
+	size_t mNumToWrite;
+	size_t mNumWritten;
+};
+}
+
+#endif
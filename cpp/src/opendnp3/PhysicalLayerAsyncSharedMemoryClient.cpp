@@ -0,0 +1,73 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "PhysicalLayerAsyncSharedMemoryClient.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Logger.h>
+
+#include "LoggableMacros.h"
+
+#include <boost/asio.hpp>
+
+using namespace boost;
+using namespace boost::system;
+
+namespace opendnp3
+{
+
+PhysicalLayerAsyncSharedMemoryClient::PhysicalLayerAsyncSharedMemoryClient(Logger* apLogger, boost::asio::io_service* apIOService, const std::string& arName) :
+	PhysicalLayerAsyncSharedMemory(apLogger, apIOService, arName)
+{
+
+}
+
+/* Implement the actions */
+
+void PhysicalLayerAsyncSharedMemoryClient::DoOpen()
+{
+	std::auto_ptr<SharedMemorySegment> pSegment;
+
+	try {
+		pSegment.reset(new SharedMemorySegment(mName, SMR_CLIENT));
+	}
+	catch(const std::exception& ex) {
+		LOG_BLOCK(LEV_DEBUG, "Unable to open segment " << mName << ": " << ex.what());
+	}
+
+	// reported like a refused connect so the channel retries
+	if(pSegment.get() == NULL || !pSegment->Connect()) {
+		this->PostOpenCallback(boost::asio::error::connection_refused);
+	}
+	else {
+		this->Attach(pSegment.release());
+		this->PostOpenCallback(error_code());
+	}
+}
+
+void PhysicalLayerAsyncSharedMemoryClient::DoOpenSuccess()
+{
+	LOG_BLOCK(LEV_INFO, "Attached to: " << mName);
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,48 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __PHYSICAL_LAYER_ASYNC_SHARED_MEMORY_CLIENT_H_
+#define __PHYSICAL_LAYER_ASYNC_SHARED_MEMORY_CLIENT_H_
+
+#include "PhysicalLayerAsyncSharedMemory.h"
+
+#include <opendnp3/Location.h>
+
+namespace opendnp3
+{
+
+/**
+Attaches to a segment created by a listening server. The open fails, and is
+retried by the channel, if the segment doesn't exist or already has a client.
+*/
+class DLL_LOCAL PhysicalLayerAsyncSharedMemoryClient : public PhysicalLayerAsyncSharedMemory
+{
+public:
+	PhysicalLayerAsyncSharedMemoryClient(Logger* apLogger, boost::asio::io_service* apIOService, const std::string& arName);
+
+	/* Implement the remaining actions */
+	void DoOpen();
+	void DoOpenSuccess();
+};
+
+}
+
+#endif
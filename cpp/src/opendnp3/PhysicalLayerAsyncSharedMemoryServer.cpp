@@ -0,0 +1,84 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "PhysicalLayerAsyncSharedMemoryServer.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Logger.h>
+
+#include "LoggableMacros.h"
+
+#include <boost/asio.hpp>
+
+using namespace boost;
+using namespace boost::system;
+
+namespace opendnp3
+{
+
+PhysicalLayerAsyncSharedMemoryServer::PhysicalLayerAsyncSharedMemoryServer(Logger* apLogger, boost::asio::io_service* apIOService, const std::string& arName, size_t aCapacity) :
+	PhysicalLayerAsyncSharedMemory(apLogger, apIOService, arName),
+	mCapacity(aCapacity)
+{
+
+}
+
+PhysicalLayerAsyncSharedMemoryServer::~PhysicalLayerAsyncSharedMemoryServer()
+{
+	this->Detach();
+	SharedMemorySegment::Remove(mName);
+}
+
+/* Implement the actions */
+
+void PhysicalLayerAsyncSharedMemoryServer::DoOpen()
+{
+	try {
+		this->Attach(new SharedMemorySegment(mName, SMR_SERVER, mCapacity));
+
+		// start listening now, like binding an acceptor, unless an old client is still attached
+		mpSegment->Accept();
+	}
+	catch(const std::exception& ex) {
+		LOG_BLOCK(LEV_WARNING, "Unable to create segment " << mName << ": " << ex.what());
+		this->PostOpenCallback(boost::asio::error::access_denied);
+	}
+}
+
+void PhysicalLayerAsyncSharedMemoryServer::DoOpeningClose()
+{
+	this->Detach();
+	this->PostOpenCallback(boost::asio::error::operation_aborted);
+}
+
+void PhysicalLayerAsyncSharedMemoryServer::DoOpenSuccess()
+{
+	LOG_BLOCK(LEV_INFO, "Client attached to: " << mName);
+}
+
+void PhysicalLayerAsyncSharedMemoryServer::OnOpeningCheck()
+{
+	if(mpSegment->Accept()) this->OnOpenCallback(error_code());
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,56 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __PHYSICAL_LAYER_ASYNC_SHARED_MEMORY_SERVER_H_
+#define __PHYSICAL_LAYER_ASYNC_SHARED_MEMORY_SERVER_H_
+
+#include "PhysicalLayerAsyncSharedMemory.h"
+
+#include <opendnp3/Location.h>
+
+namespace opendnp3
+{
+
+/**
+Creates the named segment and completes the open once a client attaches.
+The segment is removed when the layer is destroyed.
+*/
+class DLL_LOCAL PhysicalLayerAsyncSharedMemoryServer : public PhysicalLayerAsyncSharedMemory
+{
+public:
+	PhysicalLayerAsyncSharedMemoryServer(Logger* apLogger, boost::asio::io_service* apIOService, const std::string& arName, size_t aCapacity);
+
+	~PhysicalLayerAsyncSharedMemoryServer();
+
+	/* Implement the remaining actions */
+	void DoOpen();
+	void DoOpeningClose();
+	void DoOpenSuccess();
+
+private:
+	void OnOpeningCheck();
+
+	size_t mCapacity;
+};
+
+}
+
+#endif
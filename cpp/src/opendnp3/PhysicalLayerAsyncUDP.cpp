@@ -0,0 +1,171 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "PhysicalLayerAsyncUDP.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Logger.h>
+
+#include "LoggableMacros.h"
+#include "UDPSocketService.h"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <string.h>
+
+using namespace boost;
+using namespace boost::asio;
+using namespace boost::system;
+
+namespace opendnp3
+{
+
+const size_t PhysicalLayerAsyncUDP::MAX_QUEUED_DATAGRAMS;
+
+PhysicalLayerAsyncUDP::PhysicalLayerAsyncUDP(Logger* apLogger, boost::asio::io_service* apIOService, UDPSocketService* apService, const std::string& arRemoteAddress, uint16_t aRemotePort, int32_t aLinkAddress) :
+	PhysicalLayerAsyncASIO(apLogger, apIOService),
+	mpService(apService),
+	mRemoteEndpoint(ip::address::from_string(arRemoteAddress), aRemotePort),
+	mLinkAddress(aLinkAddress),
+	mIsRegistered(false),
+	mpSelf(new PhysicalLayerAsyncUDP*(this)),
+	mOffset(0),
+	mDrainPending(false),
+	mpReadBuffer(NULL),
+	mMaxRead(0)
+{
+
+}
+
+PhysicalLayerAsyncUDP::~PhysicalLayerAsyncUDP()
+{
+	if(mIsRegistered) mpService->Unregister(mRemoteEndpoint, mLinkAddress);
+}
+
+/* Implement the actions */
+
+void PhysicalLayerAsyncUDP::DoOpen()
+{
+	error_code ec = mpService->Register(this, mRemoteEndpoint, mLinkAddress);
+	mIsRegistered = !ec;
+	mStrand.post(std::bind(&PhysicalLayerAsyncUDP::OnOpenCallback, this, ec));
+}
+
+void PhysicalLayerAsyncUDP::DoClose()
+{
+	if(mIsRegistered) {
+		mpService->Unregister(mRemoteEndpoint, mLinkAddress);
+		mIsRegistered = false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mReceived.clear();
+		mOffset = 0;
+	}
+
+	if(mpReadBuffer != NULL) {
+		mStrand.post(std::bind(&PhysicalLayerAsyncUDP::CompleteRead, this, error_code(error::operation_aborted), 0));
+	}
+}
+
+void PhysicalLayerAsyncUDP::DoOpenSuccess()
+{
+	LOG_BLOCK(LEV_INFO, "Routing datagrams from: " << mRemoteEndpoint);
+}
+
+void PhysicalLayerAsyncUDP::DoAsyncRead(uint8_t* apBuffer, size_t aMaxBytes)
+{
+	mpReadBuffer = apBuffer;
+	mMaxRead = aMaxBytes;
+	mStrand.post(std::bind(&PhysicalLayerAsyncUDP::PostedDrain, std::weak_ptr<PhysicalLayerAsyncUDP*>(mpSelf)));
+}
+
+void PhysicalLayerAsyncUDP::DoAsyncWrite(const uint8_t* apBuffer, size_t aNumBytes)
+{
+	mpService->Send(apBuffer, aNumBytes, mRemoteEndpoint, mStrand.wrap(std::bind(&PhysicalLayerAsyncUDP::OnWriteComplete, this, std::placeholders::_1, aNumBytes)));
+}
+
+void PhysicalLayerAsyncUDP::OnDatagram(const uint8_t* apData, size_t aSize)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	// like a full socket buffer, the oldest datagram is lost
+	if(mReceived.size() >= MAX_QUEUED_DATAGRAMS) {
+		mReceived.pop_front();
+		mOffset = 0;
+	}
+
+	mReceived.push_back(std::vector<uint8_t>(apData, apData + aSize));
+
+	if(!mDrainPending) {
+		mDrainPending = true;
+		mStrand.post(std::bind(&PhysicalLayerAsyncUDP::PostedDrain, std::weak_ptr<PhysicalLayerAsyncUDP*>(mpSelf)));
+	}
+}
+
+void PhysicalLayerAsyncUDP::PostedDrain(std::weak_ptr<PhysicalLayerAsyncUDP*> aSelf)
+{
+	std::shared_ptr<PhysicalLayerAsyncUDP*> pSelf = aSelf.lock();
+	if(pSelf) (*pSelf)->Drain();
+}
+
+void PhysicalLayerAsyncUDP::Drain()
+{
+	size_t num = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mDrainPending = false;
+
+		if(mpReadBuffer == NULL || mReceived.empty()) return;
+
+		// a datagram bigger than the read is handed over in pieces
+		const std::vector<uint8_t>& datagram = mReceived.front();
+		num = std::min(mMaxRead, datagram.size() - mOffset);
+		memcpy(mpReadBuffer, &datagram[mOffset], num);
+		mOffset += num;
+		if(mOffset == datagram.size()) {
+			mReceived.pop_front();
+			mOffset = 0;
+		}
+	}
+
+	this->CompleteRead(error_code(), num);
+}
+
+void PhysicalLayerAsyncUDP::OnWriteComplete(const error_code& arError, size_t aNumBytes)
+{
+	this->OnWriteCallback(arError, arError ? 0 : aNumBytes);
+}
+
+void PhysicalLayerAsyncUDP::CompleteRead(const error_code& arError, size_t aNumBytes)
+{
+	uint8_t* pBuffer = mpReadBuffer;
+	mpReadBuffer = NULL;
+	this->OnReadCallback(arError, pBuffer, aNumBytes);
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,95 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __PHYSICAL_LAYER_ASYNC_UDP_H_
+#define __PHYSICAL_LAYER_ASYNC_UDP_H_
+
+#include "PhysicalLayerAsyncASIO.h"
+
+#include <opendnp3/Location.h>
+
+#include <boost/asio/ip/udp.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace opendnp3
+{
+
+class UDPSocketService;
+
+/**
+A connectionless channel to one remote endpoint over a socket shared through a
+UDPSocketService. Opening only registers the route, so there is no connection
+setup and nothing for the monitor to reconnect. Each write is sent as one
+datagram and datagrams are handed to the reader in arrival order.
+*/
+class DLL_LOCAL PhysicalLayerAsyncUDP : public PhysicalLayerAsyncASIO
+{
+public:
+	PhysicalLayerAsyncUDP(Logger*, boost::asio::io_service* apIOService, UDPSocketService* apService, const std::string& arRemoteAddress, uint16_t aRemotePort, int32_t aLinkAddress);
+
+	virtual ~PhysicalLayerAsyncUDP();
+
+	/* Implement the actions */
+	void DoOpen();
+	void DoClose();
+	void DoOpenSuccess();
+	void DoAsyncRead(uint8_t*, size_t);
+	void DoAsyncWrite(const uint8_t*, size_t);
+
+	// Called by the service with its routes locked, queues the datagram for the next read
+	void OnDatagram(const uint8_t* apData, size_t aSize);
+
+	// datagrams held while no read is outstanding before the oldest is dropped
+	static const size_t MAX_QUEUED_DATAGRAMS = 64;
+
+private:
+
+	static void PostedDrain(std::weak_ptr<PhysicalLayerAsyncUDP*> aSelf);
+
+	void Drain();
+	void OnWriteComplete(const boost::system::error_code& arError, size_t aNumBytes);
+	void CompleteRead(const boost::system::error_code& arError, size_t aNumBytes);
+
+	UDPSocketService* mpService;
+	boost::asio::ip::udp::endpoint mRemoteEndpoint;
+	int32_t mLinkAddress;
+	bool mIsRegistered;
+
+	// posted drains hold a weak reference so they are harmless after destruction
+	std::shared_ptr<PhysicalLayerAsyncUDP*> mpSelf;
+
+	// guards the received datagrams, which are queued from the service's strand
+	std::mutex mMutex;
+	std::deque< std::vector<uint8_t> > mReceived;
+	size_t mOffset;
+	bool mDrainPending;
+
+	uint8_t* mpReadBuffer;
+	size_t mMaxRead;
+};
+}
+
+#endif
@@ -0,0 +1,174 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "PhysicalLayerAsyncUringTCP.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Logger.h>
+
+#include "LoggableMacros.h"
+
+#include <boost/asio.hpp>
+
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace boost;
+using namespace boost::system;
+
+namespace opendnp3
+{
+
+PhysicalLayerAsyncUringTCP::PhysicalLayerAsyncUringTCP(Logger* apLogger, boost::asio::io_service* apIOService, UringService* apUring) :
+	PhysicalLayerAsyncASIO(apLogger, apIOService),
+	mpUring(apUring),
+	mSocket(-1),
+	mReadOp(mStrand.wrap(std::bind(&PhysicalLayerAsyncUringTCP::OnReadComplete, this, std::placeholders::_1))),
+	mWriteOp(mStrand.wrap(std::bind(&PhysicalLayerAsyncUringTCP::OnWriteComplete, this, std::placeholders::_1))),
+	mBufferIndex(apUring->AcquireBuffer()),
+	mpRegistered(NULL),
+	mNumRegistered(0),
+	mpReadBuffer(NULL),
+	mpWriteBuffer(NULL),
+	mNumToWrite(0),
+	mNumWritten(0)
+{
+	if(mBufferIndex == UringService::NO_BUFFER) LOG_BLOCK(LEV_INFO, "No registered buffer slot available, using plain receives");
+}
+
+PhysicalLayerAsyncUringTCP::~PhysicalLayerAsyncUringTCP()
+{
+	if(mSocket >= 0) close(mSocket);
+	mpUring->ReleaseBuffer(mBufferIndex);
+}
+
+error_code PhysicalLayerAsyncUringTCP::ToErrorCode(int aResult)
+{
+	return (aResult < 0) ? error_code(-aResult, system_category()) : error_code();
+}
+
+/* Implement the actions */
+
+void PhysicalLayerAsyncUringTCP::DoClose()
+{
+	this->ShutdownSocket();
+	this->CloseSocket();
+}
+
+void PhysicalLayerAsyncUringTCP::DoAsyncRead(uint8_t* apBuffer, size_t aMaxBytes)
+{
+	mpReadBuffer = apBuffer;
+	if(this->IsRegistered(apBuffer, aMaxBytes)) mpUring->ReadFixed(mSocket, mBufferIndex, apBuffer, aMaxBytes, &mReadOp);
+	else mpUring->Receive(mSocket, apBuffer, aMaxBytes, &mReadOp);
+}
+
+bool PhysicalLayerAsyncUringTCP::IsRegistered(uint8_t* apBuffer, size_t aMaxBytes)
+{
+	if(mBufferIndex == UringService::NO_BUFFER) return false;
+	if(apBuffer >= mpRegistered && apBuffer + aMaxBytes <= mpRegistered + mNumRegistered) return true;
+
+	// The receiver always reads up to the end of its buffer and the first read
+	// after an open starts at the beginning, so one registration covers the
+	// whole read area for the life of the connection.
+	if(!mpUring->RegisterBuffer(mBufferIndex, apBuffer, aMaxBytes)) {
+		mpUring->ReleaseBuffer(mBufferIndex);
+		mBufferIndex = UringService::NO_BUFFER;
+		return false;
+	}
+	mpRegistered = apBuffer;
+	mNumRegistered = aMaxBytes;
+	return true;
+}
+
+void PhysicalLayerAsyncUringTCP::DoAsyncWrite(const uint8_t* apBuffer, size_t aNumBytes)
+{
+	mpWriteBuffer = apBuffer;
+	mNumToWrite = aNumBytes;
+	mNumWritten = 0;
+	mpUring->Send(mSocket, apBuffer, aNumBytes, &mWriteOp);
+}
+
+void PhysicalLayerAsyncUringTCP::DoOpenFailure()
+{
+	LOG_BLOCK(LEV_DEBUG, "Failed socket open, closing socket");
+	this->CloseSocket();
+}
+
+void PhysicalLayerAsyncUringTCP::OnReadComplete(int aResult)
+{
+	if(aResult == 0) {
+		this->OnReadCallback(boost::asio::error::eof, mpReadBuffer, 0);
+	}
+	else if(aResult < 0) {
+		this->OnReadCallback(ToErrorCode(aResult), mpReadBuffer, 0);
+	}
+	else {
+		this->OnReadCallback(error_code(), mpReadBuffer, aResult);
+	}
+}
+
+void PhysicalLayerAsyncUringTCP::OnWriteComplete(int aResult)
+{
+	if(aResult > 0) {
+		mNumWritten += aResult;
+		if(mNumWritten < mNumToWrite) {
+			// short send, keep going until the whole buffer is written like asio::async_write
+			mpUring->Send(mSocket, mpWriteBuffer + mNumWritten, mNumToWrite - mNumWritten, &mWriteOp);
+			return;
+		}
+	}
+
+	error_code ec = (aResult == 0) ? boost::asio::error::broken_pipe : ToErrorCode(aResult);
+	this->OnWriteCallback(ec, mNumWritten);
+}
+
+void PhysicalLayerAsyncUringTCP::CloseSocket()
+{
+	if(mSocket < 0) return;
+
+	// queued entries refer to the descriptor by number, so they have to reach
+	// the kernel before it can be closed and reused
+	mpUring->Cancel(&mReadOp);
+	mpUring->Cancel(&mWriteOp);
+	mpUring->Flush();
+
+	if(close(mSocket) < 0) LOG_BLOCK(LEV_WARNING, "Error while closing socket: " << strerror(errno));
+	mSocket = -1;
+
+	// the read area may be freed once the layer is closed, so stop pinning it
+	if(mpRegistered != NULL) {
+		mpUring->UnregisterBuffer(mBufferIndex);
+		mpRegistered = NULL;
+		mNumRegistered = 0;
+	}
+}
+
+void PhysicalLayerAsyncUringTCP::ShutdownSocket()
+{
+	if(mSocket >= 0 && shutdown(mSocket, SHUT_RDWR) < 0) {
+		LOG_BLOCK(LEV_WARNING, "Error while shutting down socket: " << strerror(errno));
+	}
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,84 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __PHYSICAL_LAYER_ASYNC_URING_TCP_H_
+#define __PHYSICAL_LAYER_ASYNC_URING_TCP_H_
+
+#include "PhysicalLayerAsyncASIO.h"
+#include "UringService.h"
+
+#include <opendnp3/Location.h>
+
+#include <boost/system/error_code.hpp>
+
+namespace opendnp3
+{
+
+/**
+Shared socket handling for the io_uring client and server. Reads and writes are
+submitted to a UringService instead of the asio reactor, while timers and the
+executor still come from the io_service strand.
+*/
+class DLL_LOCAL PhysicalLayerAsyncUringTCP : public PhysicalLayerAsyncASIO
+{
+public:
+	PhysicalLayerAsyncUringTCP(Logger*, boost::asio::io_service* apIOService, UringService* apUring);
+
+	virtual ~PhysicalLayerAsyncUringTCP();
+
+	/* Implement the shared client/server actions */
+	void DoClose();
+	void DoAsyncRead(uint8_t*, size_t);
+	void DoAsyncWrite(const uint8_t*, size_t);
+	void DoOpenFailure();
+
+protected:
+	// converts the result of a completion to an error code
+	static boost::system::error_code ToErrorCode(int aResult);
+
+	void CloseSocket();
+
+	UringService* mpUring;
+	int mSocket;
+
+private:
+	void ShutdownSocket();
+
+	// registers the read area with the layer's buffer slot if it is not already
+	bool IsRegistered(uint8_t* apBuffer, size_t aMaxBytes);
+
+	void OnReadComplete(int aResult);
+	void OnWriteComplete(int aResult);
+
+	UringOperation mReadOp;
+	UringOperation mWriteOp;
+
+	size_t mBufferIndex;
+	uint8_t* mpRegistered;
+	size_t mNumRegistered;
+	uint8_t* mpReadBuffer;
+	const uint8_t* mpWriteBuffer;
+	size_t mNumToWrite;
+	size_t mNumWritten;
+};
+}
+
+#endif
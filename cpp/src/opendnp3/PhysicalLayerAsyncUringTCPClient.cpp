@@ -0,0 +1,80 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "PhysicalLayerAsyncUringTCPClient.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Logger.h>
+
+#include "LoggableMacros.h"
+
+#include <boost/asio.hpp>
+
+#include <errno.h>
+#include <sys/socket.h>
+
+using namespace boost;
+using namespace boost::asio;
+using namespace boost::system;
+
+namespace opendnp3
+{
+
+PhysicalLayerAsyncUringTCPClient::PhysicalLayerAsyncUringTCPClient(Logger* apLogger, boost::asio::io_service* apIOService, UringService* apUring, const std::string& arAddress, uint16_t aPort) :
+	PhysicalLayerAsyncUringTCP(apLogger, apIOService, apUring),
+	mRemoteEndpoint(ip::tcp::v4(), aPort),
+	mConnectOp(mStrand.wrap(std::bind(&PhysicalLayerAsyncUringTCPClient::OnConnectComplete, this, std::placeholders::_1)))
+{
+	mRemoteEndpoint.address( boost::asio::ip::address::from_string(arAddress) );
+}
+
+/* Implement the actions */
+void PhysicalLayerAsyncUringTCPClient::DoOpen()
+{
+	mSocket = socket(mRemoteEndpoint.data()->sa_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(mSocket < 0) {
+		// report the failure asynchronously like any other failed connect
+		mStrand.post(std::bind(&PhysicalLayerAsyncUringTCPClient::OnConnectComplete, this, -errno));
+	}
+	else {
+		mpUring->Connect(mSocket, mRemoteEndpoint.data(), static_cast<socklen_t>(mRemoteEndpoint.size()), &mConnectOp);
+	}
+}
+
+void PhysicalLayerAsyncUringTCPClient::DoOpeningClose()
+{
+	mpUring->Cancel(&mConnectOp);
+	mpUring->Flush();
+}
+
+void PhysicalLayerAsyncUringTCPClient::DoOpenSuccess()
+{
+	LOG_BLOCK(LEV_INFO, "Connected to: " << mRemoteEndpoint);
+}
+
+void PhysicalLayerAsyncUringTCPClient::OnConnectComplete(int aResult)
+{
+	this->OnOpenCallback(ToErrorCode(aResult));
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
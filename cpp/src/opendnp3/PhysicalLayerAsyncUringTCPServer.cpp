@@ -0,0 +1,114 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "PhysicalLayerAsyncUringTCPServer.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Logger.h>
+
+#include "LoggableMacros.h"
+
+#include <boost/asio.hpp>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace boost;
+using namespace boost::asio;
+using namespace boost::system;
+
+namespace opendnp3
+{
+
+PhysicalLayerAsyncUringTCPServer::PhysicalLayerAsyncUringTCPServer(Logger* apLogger, boost::asio::io_service* apIOService, UringService* apUring, const std::string& arEndpoint, uint16_t aPort) :
+	PhysicalLayerAsyncUringTCP(apLogger, apIOService, apUring),
+	mLocalEndpoint(ip::tcp::v4(), aPort),
+	mRemoteLength(0),
+	mAcceptor(-1),
+	mAcceptOp(mStrand.wrap(std::bind(&PhysicalLayerAsyncUringTCPServer::OnAcceptComplete, this, std::placeholders::_1)))
+{
+	mLocalEndpoint.address( boost::asio::ip::address::from_string(arEndpoint) );
+}
+
+PhysicalLayerAsyncUringTCPServer::~PhysicalLayerAsyncUringTCPServer()
+{
+	if(mAcceptor >= 0) close(mAcceptor);
+}
+
+/* Implement the actions */
+void PhysicalLayerAsyncUringTCPServer::DoOpen()
+{
+	if(mAcceptor < 0) {
+		mAcceptor = socket(mLocalEndpoint.data()->sa_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if(mAcceptor < 0) {
+			MACRO_THROW_EXCEPTION(Exception, strerror(errno));
+		}
+
+		int reuse = 1;
+		setsockopt(mAcceptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+		if(bind(mAcceptor, mLocalEndpoint.data(), static_cast<socklen_t>(mLocalEndpoint.size())) < 0 || listen(mAcceptor, SOMAXCONN) < 0) {
+			int error = errno;
+			this->CloseAcceptor();
+			MACRO_THROW_EXCEPTION(Exception, strerror(error));
+		}
+	}
+
+	mRemoteLength = static_cast<socklen_t>(mRemoteEndpoint.capacity());
+	mpUring->Accept(mAcceptor, mRemoteEndpoint.data(), &mRemoteLength, &mAcceptOp);
+}
+
+void PhysicalLayerAsyncUringTCPServer::CloseAcceptor()
+{
+	if(mAcceptor >= 0) {
+		if(close(mAcceptor) < 0) LOG_BLOCK(LEV_WARNING, "Error while closing tcp acceptor: " << strerror(errno));
+		mAcceptor = -1;
+	}
+}
+
+void PhysicalLayerAsyncUringTCPServer::DoOpenCallback()
+{
+	this->CloseAcceptor();
+}
+
+void PhysicalLayerAsyncUringTCPServer::DoOpeningClose()
+{
+	mpUring->Cancel(&mAcceptOp);
+	mpUring->Flush();
+	this->CloseAcceptor();
+}
+
+void PhysicalLayerAsyncUringTCPServer::DoOpenSuccess()
+{
+	mRemoteEndpoint.resize(mRemoteLength);
+	LOG_BLOCK(LEV_INFO, "Accepted connection from: " << mRemoteEndpoint);
+}
+
+void PhysicalLayerAsyncUringTCPServer::OnAcceptComplete(int aResult)
+{
+	if(aResult >= 0) mSocket = aResult;
+	this->OnOpenCallback(ToErrorCode(aResult));
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,62 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __PHYSICAL_LAYER_ASYNC_URING_TCP_SERVER_H_
+#define __PHYSICAL_LAYER_ASYNC_URING_TCP_SERVER_H_
+
+#include "PhysicalLayerAsyncUringTCP.h"
+
+#include <boost/asio/ip/tcp.hpp>
+
+#include <opendnp3/Location.h>
+
+#include <sys/socket.h>
+
+namespace opendnp3
+{
+
+class DLL_LOCAL PhysicalLayerAsyncUringTCPServer : public PhysicalLayerAsyncUringTCP
+{
+public:
+	PhysicalLayerAsyncUringTCPServer(Logger* apLogger, boost::asio::io_service* apIOService, UringService* apUring, const std::string& arEndpoint, uint16_t aPort);
+
+	~PhysicalLayerAsyncUringTCPServer();
+
+	/* Implement the remaining actions */
+	void DoOpen();
+	void DoOpeningClose();
+	void DoOpenSuccess();
+	void DoOpenCallback();
+
+private:
+	void OnAcceptComplete(int aResult);
+	void CloseAcceptor();
+
+	boost::asio::ip::tcp::endpoint mLocalEndpoint;
+	boost::asio::ip::tcp::endpoint mRemoteEndpoint;
+	socklen_t mRemoteLength;
+	int mAcceptor;
+	UringOperation mAcceptOp;
+};
+
+}
+
+#endif
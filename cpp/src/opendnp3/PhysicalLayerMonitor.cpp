@@ -25,7 +25,9 @@
 #include "IPhysicalLayerAsync.h"
 #include "PhysicalLayerMonitorStates.h"
 #include "LoggableMacros.h"
+#include "OpenLimiter.h"
 
+#include <algorithm>
 #include <functional>
 
 #include <assert.h>
@@ -37,6 +39,14 @@ using namespace std::chrono;
 namespace opendnp3
 {
 
+struct PhysicalLayerMonitor::PostedHandle {
+	PostedHandle(PhysicalLayerMonitor* apMonitor) : mpMonitor(apMonitor), mNumGrants(0) {}
+
+	std::mutex mMutex;
+	PhysicalLayerMonitor* mpMonitor;	// NULL once the monitor is destroyed
+	std::atomic<size_t> mNumGrants;		// tokens granted but not yet delivered
+};
+
 PhysicalLayerMonitor::PhysicalLayerMonitor(Logger* apLogger, IPhysicalLayerAsync* apPhys, timer_clock::duration aMinOpenRetry, timer_clock::duration aMaxOpenRetry) :
 	Loggable(apLogger),
 	IHandlerAsync(apLogger),
@@ -46,20 +56,83 @@ PhysicalLayerMonitor::PhysicalLayerMonitor(Logger* apLogger, IPhysicalLayerAsync
 	mFinalShutdown(false),
 	mMinOpenRetry(aMinOpenRetry),
 	mMaxOpenRetry(aMaxOpenRetry),
-	mCurrentRetry(aMinOpenRetry)
+	mBackoffFactor(2.0),
+	mJitter(0.0),
+	mCurrentRetry(aMinOpenRetry),
+	mpLimiter(NULL),
+	mOpenDeferred(false),
+	mHoldsOpenToken(false),
+	mpPosted(new PostedHandle(this)),
+	mNumOpenAttempts(0),
+	mNumOpenSuccess(0),
+	mNumOpenFailure(0),
+	mNumOpenDeferred(0),
+	mCurrentRetryMs(duration_cast<milliseconds>(aMinOpenRetry).count())
+{
+	assert(apPhys != NULL);
+	mpPhys->SetHandler(this);
+}
+
+PhysicalLayerMonitor::PhysicalLayerMonitor(Logger* apLogger, IPhysicalLayerAsync* apPhys, const OpenRetryPolicy& arPolicy, OpenLimiter* apLimiter) :
+	Loggable(apLogger),
+	IHandlerAsync(apLogger),
+	mpPhys(apPhys),
+	mpOpenTimer(NULL),
+	mpState(MonitorStateInit::Inst()),
+	mFinalShutdown(false),
+	mMinOpenRetry(milliseconds(arPolicy.mMinRetry)),
+	mMaxOpenRetry(milliseconds(std::max(arPolicy.mMinRetry, arPolicy.mMaxRetry))),
+	mBackoffFactor(std::max(1.0, arPolicy.mBackoffFactor)),
+	mJitter(std::min(1.0, std::max(0.0, arPolicy.mJitter))),
+	mCurrentRetry(mMinOpenRetry),
+	// channels created together must not share a seed or their jitter is identical
+	mRandom(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(this) ^ timer_clock::now().time_since_epoch().count())),
+	mpLimiter(apLimiter),
+	mOpenDeferred(false),
+	mHoldsOpenToken(false),
+	mpPosted(new PostedHandle(this)),
+	mNumOpenAttempts(0),
+	mNumOpenSuccess(0),
+	mNumOpenFailure(0),
+	mNumOpenDeferred(0),
+	mCurrentRetryMs(arPolicy.mMinRetry)
 {
 	assert(apPhys != NULL);
 	mpPhys->SetHandler(this);
 }
 
 PhysicalLayerMonitor::~PhysicalLayerMonitor()
-{}
+{
+	// no grant can be posted once the monitor leaves the queue
+	if(mpLimiter != NULL) mpLimiter->Cancel(this);
+
+	size_t numGrants = 0;
+	{
+		// waits out a posted handler that's already running on another thread
+		std::unique_lock<std::mutex> lock(mpPosted->mMutex);
+		mpPosted->mpMonitor = NULL;
+		numGrants = mpPosted->mNumGrants.exchange(0);
+	}
+	for(size_t i = 0; i < numGrants; ++i) mpLimiter->Release();
+	this->ReleaseOpenToken();
+}
 
 ChannelState PhysicalLayerMonitor::GetState()
 {
 	return mpState->GetState();
 }
 
+OpenStatistics PhysicalLayerMonitor::GetOpenStatistics()
+{
+	OpenStatistics stats;
+	stats.mNumAttempts = mNumOpenAttempts.load(std::memory_order_relaxed);
+	stats.mNumSuccess = mNumOpenSuccess.load(std::memory_order_relaxed);
+	stats.mNumFailure = mNumOpenFailure.load(std::memory_order_relaxed);
+	stats.mNumDeferred = mNumOpenDeferred.load(std::memory_order_relaxed);
+	stats.mCurrentRetry = mCurrentRetryMs.load(std::memory_order_relaxed);
+	return stats;
+}
+
 bool PhysicalLayerMonitor::WaitForShutdown(millis_t aTimeout)
 {
 	std::unique_lock<std::mutex> lock(mMutex);
@@ -142,15 +215,21 @@ void PhysicalLayerMonitor::OnOpenTimerExpiration()
 void PhysicalLayerMonitor::_OnOpenFailure()
 {
 	LOG_BLOCK(LEV_DEBUG, "_OnOpenFailure()");
+	this->ReleaseOpenToken();
+	mNumOpenFailure.fetch_add(1, std::memory_order_relaxed);
 	mpState->OnOpenFailure(this);
 	this->OnPhysicalLayerOpenFailureCallback();
-	this->mCurrentRetry = std::min(2 * mCurrentRetry, mMaxOpenRetry);
+	this->mCurrentRetry = std::min(duration_cast<timer_clock::duration>(mCurrentRetry * mBackoffFactor), mMaxOpenRetry);
+	mCurrentRetryMs.store(duration_cast<milliseconds>(mCurrentRetry).count(), std::memory_order_relaxed);
 }
 
 void PhysicalLayerMonitor::_OnLowerLayerUp()
 {
 	LOG_BLOCK(LEV_DEBUG, "_OnLowerLayerUp");
+	this->ReleaseOpenToken();
+	mNumOpenSuccess.fetch_add(1, std::memory_order_relaxed);
 	this->mCurrentRetry = mMinOpenRetry;
+	mCurrentRetryMs.store(duration_cast<milliseconds>(mCurrentRetry).count(), std::memory_order_relaxed);
 	mpState->OnLayerOpen(this);
 	this->OnPhysicalLayerOpenSuccessCallback();
 }
@@ -167,7 +246,7 @@ void PhysicalLayerMonitor::_OnLowerLayerDown()
 void PhysicalLayerMonitor::StartOpenTimer()
 {
 	assert(mpOpenTimer == NULL);
-	mpOpenTimer = mpPhys->GetExecutor()->Start(mCurrentRetry, std::bind(&PhysicalLayerMonitor::OnOpenTimerExpiration, this));
+	mpOpenTimer = mpPhys->GetExecutor()->Start(this->NextRetryDelay(), std::bind(&PhysicalLayerMonitor::OnOpenTimerExpiration, this));
 }
 
 void PhysicalLayerMonitor::CancelOpenTimer()
@@ -177,8 +256,90 @@ void PhysicalLayerMonitor::CancelOpenTimer()
 	mpOpenTimer = NULL;
 }
 
+void PhysicalLayerMonitor::BeginOpen()
+{
+	if(mpLimiter == NULL) this->DoAsyncOpen();
+	else if(mpLimiter->Acquire(this)) {
+		mHoldsOpenToken = true;
+		this->DoAsyncOpen();
+	}
+	else {
+		LOG_BLOCK(LEV_DEBUG, "Open deferred until another channel finishes opening");
+		mOpenDeferred = true;
+		mNumOpenDeferred.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void PhysicalLayerMonitor::BeginClose()
+{
+	if(mOpenDeferred) {
+		// The physical layer was never asked to open, so fake the failure it would report.
+		// If the grant is already posted, it runs first and hands the token back.
+		mOpenDeferred = false;
+		mpLimiter->Cancel(this);
+		mpPhys->GetExecutor()->Post(std::bind(&PhysicalLayerMonitor::RunPosted, mpPosted, false));
+	}
+	else mpPhys->AsyncClose();
+}
+
 /* ------- Internal helper functions ------- */
 
+void PhysicalLayerMonitor::DoAsyncOpen()
+{
+	mNumOpenAttempts.fetch_add(1, std::memory_order_relaxed);
+	mpPhys->AsyncOpen();
+}
+
+void PhysicalLayerMonitor::OnOpenGranted()
+{
+	// the limiter holds its lock, so the destructor can't be past Cancel() yet
+	mpPosted->mNumGrants.fetch_add(1);
+	mpPhys->GetExecutor()->Post(std::bind(&PhysicalLayerMonitor::RunPosted, mpPosted, true));
+}
+
+void PhysicalLayerMonitor::RunPosted(std::shared_ptr<PostedHandle> apHandle, bool aIsGrant)
+{
+	// the destructor already returned the token of a grant that finds no monitor
+	std::unique_lock<std::mutex> lock(apHandle->mMutex);
+	PhysicalLayerMonitor* pMonitor = apHandle->mpMonitor;
+	if(pMonitor == NULL) return;
+	if(aIsGrant) {
+		apHandle->mNumGrants.fetch_sub(1);
+		pMonitor->OnDeferredOpenGranted();
+	}
+	else pMonitor->OnDeferredOpenAborted();
+}
+
+void PhysicalLayerMonitor::OnDeferredOpenGranted()
+{
+	mHoldsOpenToken = true;
+	if(mOpenDeferred) {
+		mOpenDeferred = false;
+		this->DoAsyncOpen();
+	}
+	else this->ReleaseOpenToken();
+}
+
+void PhysicalLayerMonitor::OnDeferredOpenAborted()
+{
+	LOG_BLOCK(LEV_DEBUG, "Deferred open abandoned");
+	mpState->OnOpenFailure(this);
+	this->OnPhysicalLayerOpenFailureCallback();
+}
 
+void PhysicalLayerMonitor::ReleaseOpenToken()
+{
+	if(mHoldsOpenToken) {
+		mHoldsOpenToken = false;
+		mpLimiter->Release();
+	}
+}
+
+timer_clock::duration PhysicalLayerMonitor::NextRetryDelay()
+{
+	if(mJitter <= 0.0) return mCurrentRetry;
+	double fraction = mJitter * std::uniform_real_distribution<double>(0.0, 1.0)(mRandom);
+	return mCurrentRetry - duration_cast<timer_clock::duration>(mCurrentRetry * fraction);
+}
 
 }
@@ -34,23 +34,29 @@
 
 #include <opendnp3/ChannelStates.h>
 #include <opendnp3/Location.h>
+#include <opendnp3/OpenRetryPolicy.h>
 
 #include <set>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <atomic>
+#include <random>
+#include <memory>
 
 namespace opendnp3
 {
 
 class IPhysicalLayerAsync;
 class IMonitorState;
+class OpenLimiter;
 
 /** Manages the lifecycle of a physical layer
   */
 class DLL_LOCAL PhysicalLayerMonitor : public IHandlerAsync
 {
 	friend class MonitorStateActions;
+	friend class OpenLimiter;
 
 public:
 	PhysicalLayerMonitor(	Logger*,
@@ -58,6 +64,15 @@ public:
 	                        timer_clock::duration aMinOpenRetry,
 	                        timer_clock::duration aMaxOpenRetry);
 
+	/**
+	* @param arPolicy Backoff and jitter applied to the open retry timer
+	* @param apLimiter Optional limit on concurrent opens shared with other monitors
+	*/
+	PhysicalLayerMonitor(	Logger*,
+	                        IPhysicalLayerAsync*,
+	                        const OpenRetryPolicy& arPolicy,
+	                        OpenLimiter* apLimiter = NULL);
+
 	~PhysicalLayerMonitor();
 
 	/** Begin monitor execution, retry indefinitely on failure - Idempotent*/
@@ -86,6 +101,9 @@ public:
 		return mpLogger;
 	}
 
+	/// Safe to call from any thread
+	OpenStatistics GetOpenStatistics();
+
 protected:
 
 
@@ -116,17 +134,53 @@ private:
 	/// Cancels the open timer
 	void CancelOpenTimer();
 
+	/// Opens the physical layer once the limiter hands out a token
+	void BeginOpen();
+
+	/// Closes the physical layer, or abandons an open that is still waiting for a token
+	void BeginClose();
+
 	/* --- Internal helper functions --- */
 
 	void DoFinalShutdown();
 
+	void DoAsyncOpen();
+
+	/// Called by the limiter from any thread
+	void OnOpenGranted();
+
+	void OnDeferredOpenGranted();
+	void OnDeferredOpenAborted();
+	void ReleaseOpenToken();
+
+	/// Shared with the grants and aborts posted to the executor, which may outlive the monitor
+	struct PostedHandle;
+
+	static void RunPosted(std::shared_ptr<PostedHandle> apHandle, bool aIsGrant);
+
+	timer_clock::duration NextRetryDelay();
+
 	std::mutex mMutex;
 	std::condition_variable mCondition;
 
 	const timer_clock::duration mMinOpenRetry;
 	const timer_clock::duration mMaxOpenRetry;
+	const double mBackoffFactor;
+	const double mJitter;
 
 	timer_clock::duration mCurrentRetry;
+	std::minstd_rand mRandom;
+
+	OpenLimiter* mpLimiter;
+	bool mOpenDeferred;		// waiting on the limiter for a token
+	bool mHoldsOpenToken;
+	std::shared_ptr<PostedHandle> mpPosted;
+
+	std::atomic<uint64_t> mNumOpenAttempts;
+	std::atomic<uint64_t> mNumOpenSuccess;
+	std::atomic<uint64_t> mNumOpenFailure;
+	std::atomic<uint64_t> mNumOpenDeferred;
+	std::atomic<int64_t> mCurrentRetryMs;
 
 	// Implement from IHandlerAsync - Try to reconnect using a timer
 	void _OnOpenFailure();
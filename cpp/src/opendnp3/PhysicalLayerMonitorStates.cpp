@@ -53,12 +53,12 @@ void MonitorStateActions::CancelOpenTimer(PhysicalLayerMonitor* apContext)
 
 void MonitorStateActions::AsyncClose(PhysicalLayerMonitor* apContext)
 {
-	apContext->mpPhys->AsyncClose();
+	apContext->BeginClose();
 }
 
 void MonitorStateActions::AsyncOpen(PhysicalLayerMonitor* apContext)
 {
-	apContext->mpPhys->AsyncOpen();
+	apContext->BeginOpen();
 }
 
 /* --- IMonitorState --- */
@@ -25,8 +25,9 @@
 namespace opendnp3
 {
 
-QueuedCommandProcessor::QueuedCommandProcessor() :
-	SubjectBase()
+QueuedCommandProcessor::QueuedCommandProcessor(ITimeSource* apTimeSrc) :
+	SubjectBase(),
+	mpTimeSrc(apTimeSrc)
 {
 
 }
@@ -81,16 +82,72 @@ void QueuedCommandProcessor::DirectOperate(const AnalogOutputDouble64& arCommand
 	this->DirectOperateT(arCommand, aIndex, aCallback);
 }
 
+void QueuedCommandProcessor::SelectAndOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback)
+{
+	this->SelectAndOperateBatchT(arCommands, aCallback);
+}
+
+void QueuedCommandProcessor::DirectOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback)
+{
+	this->DirectOperateBatchT(arCommands, aCallback);
+}
+
+void QueuedCommandProcessor::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback)
+{
+	this->SelectAndOperateBatchT(arCommands, aCallback);
+}
+
+void QueuedCommandProcessor::DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback)
+{
+	this->DirectOperateBatchT(arCommands, aCallback);
+}
+
+void QueuedCommandProcessor::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback)
+{
+	this->SelectAndOperateBatchT(arCommands, aCallback);
+}
+
+void QueuedCommandProcessor::DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback)
+{
+	this->DirectOperateBatchT(arCommands, aCallback);
+}
+
+void QueuedCommandProcessor::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback)
+{
+	this->SelectAndOperateBatchT(arCommands, aCallback);
+}
+
+void QueuedCommandProcessor::DirectOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback)
+{
+	this->DirectOperateBatchT(arCommands, aCallback);
+}
+
+void QueuedCommandProcessor::SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback)
+{
+	this->SelectAndOperateBatchT(arCommands, aCallback);
+}
+
+void QueuedCommandProcessor::DirectOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback)
+{
+	this->DirectOperateBatchT(arCommands, aCallback);
+}
+
 bool QueuedCommandProcessor::Dispatch(ICommandProcessor* apProcessor)
 {
 	std::lock_guard<std::mutex> lock(mMutex);
 	if(mRequestQueue.empty()) return false;
 	else {
-		mRequestQueue.front()(apProcessor);
+		mRequestQueue.front().mRequest(apProcessor);
 		mRequestQueue.pop();
 		return true;
 	}
 }
 
+timer_clock::time_point QueuedCommandProcessor::OldestRequestTime()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mRequestQueue.empty() ? timer_clock::time_point::max() : mRequestQueue.front().mTime;
+}
+
 }
 
@@ -29,10 +29,14 @@
 #ifndef __QUEUED_COMMAND_PROCESSOR_H_
 #define __QUEUED_COMMAND_PROCESSOR_H_
 
+#include <opendnp3/Exception.h>
 #include <opendnp3/ICommandProcessor.h>
+#include <opendnp3/Location.h>
 #include <opendnp3/SubjectBase.h>
 #include <opendnp3/Visibility.h>
 
+#include "TimeSource.h"
+
 #include <queue>
 #include <mutex>
 
@@ -43,7 +47,7 @@ class DLL_LOCAL QueuedCommandProcessor : public ICommandProcessor, public Subjec
 {
 public:
 
-	QueuedCommandProcessor();
+	QueuedCommandProcessor(ITimeSource* apTimeSrc = TimeSource::Inst());
 
 	// Implement the ICommandProcessor interface
 
@@ -62,34 +66,79 @@ public:
 	void SelectAndOperate(const AnalogOutputDouble64& arCommand, size_t aIndex, std::function<void (CommandResponse)> aCallback);
 	void DirectOperate(const AnalogOutputDouble64& arCommand, size_t aIndex, std::function<void (CommandResponse)> aCallback);
 
+	void SelectAndOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<ControlRelayOutputBlock> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt16> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputInt32> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputFloat32> >& arCommands, BatchCallback aCallback);
+
+	void SelectAndOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback);
+	void DirectOperate(const std::vector< IndexedCommand<AnalogOutputDouble64> >& arCommands, BatchCallback aCallback);
+
 	// Function used to marshall calls another ICommandProcessor
 
 	bool Dispatch(ICommandProcessor* apProcessor);
 
+	// @return when the oldest queued request was made, time_point::max() if the queue is empty
+	timer_clock::time_point OldestRequestTime();
+
 private:
-	std::mutex mMutex;
-	std::queue<std::function<void (ICommandProcessor*)>> mRequestQueue;
 
-	template <class T>
-	void SelectAndOperateT(const T& arCommand, size_t aIndex, std::function<void (CommandResponse)> aCallback) {
+	struct Request {
+		Request(const timer_clock::time_point& arTime, const std::function<void (ICommandProcessor*)>& arRequest) :
+			mTime(arTime), mRequest(arRequest)
+		{}
+
+		timer_clock::time_point mTime;
+		std::function<void (ICommandProcessor*)> mRequest;
+	};
+
+	void Push(const std::function<void (ICommandProcessor*)>& arRequest) {
 		{
 			std::lock_guard<std::mutex> lock(mMutex);
-			mRequestQueue.push([arCommand, aIndex, aCallback](ICommandProcessor * pProcessor) {
-				pProcessor->SelectAndOperate(arCommand, aIndex, aCallback);
-			});
+			mRequestQueue.push(Request(mpTimeSrc->GetUTC(), arRequest));
 		}
 		this->NotifyObservers();
 	}
 
+	ITimeSource* mpTimeSrc;
+	std::mutex mMutex;
+	std::queue<Request> mRequestQueue;
+
+	template <class T>
+	void SelectAndOperateT(const T& arCommand, size_t aIndex, std::function<void (CommandResponse)> aCallback) {
+		this->Push([arCommand, aIndex, aCallback](ICommandProcessor * pProcessor) {
+			pProcessor->SelectAndOperate(arCommand, aIndex, aCallback);
+		});
+	}
+
 	template <class T>
 	void DirectOperateT(const T& arCommand, size_t aIndex, std::function<void (CommandResponse)> aCallback) {
-		{
-			std::lock_guard<std::mutex> lock(mMutex);
-			mRequestQueue.push([arCommand, aIndex, aCallback](ICommandProcessor * pProcessor) {
-				pProcessor->DirectOperate(arCommand, aIndex, aCallback);
-			});
-		}
-		this->NotifyObservers();
+		this->Push([arCommand, aIndex, aCallback](ICommandProcessor * pProcessor) {
+			pProcessor->DirectOperate(arCommand, aIndex, aCallback);
+		});
+	}
+
+	template <class T>
+	void SelectAndOperateBatchT(const std::vector< IndexedCommand<T> >& arCommands, BatchCallback aCallback) {
+		if(arCommands.empty()) MACRO_THROW_EXCEPTION(ArgumentException, "Batch is empty");
+		this->Push([arCommands, aCallback](ICommandProcessor * pProcessor) {
+			pProcessor->SelectAndOperate(arCommands, aCallback);
+		});
+	}
+
+	template <class T>
+	void DirectOperateBatchT(const std::vector< IndexedCommand<T> >& arCommands, BatchCallback aCallback) {
+		if(arCommands.empty()) MACRO_THROW_EXCEPTION(ArgumentException, "Batch is empty");
+		this->Push([arCommands, aCallback](ICommandProcessor * pProcessor) {
+			pProcessor->DirectOperate(arCommands, aCallback);
+		});
 	}
 };
 
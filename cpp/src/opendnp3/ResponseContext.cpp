@@ -29,6 +29,7 @@
 #include "LoggableMacros.h"
 #include "Objects.h"
 #include "SlaveResponseTypes.h"
+#include "VtoStreamWriter.h"
 
 using namespace boost;
 
@@ -52,21 +53,28 @@ bool ResponseContext::ResponseKey::operator()(const ResponseContext::ResponseKey
 }
 
 
-ResponseContext::ResponseContext(Logger* apLogger, Database* apDB, SlaveResponseTypes* apRspTypes, const EventMaxConfig& arEventMaxConfig) :
+ResponseContext::ResponseContext(Logger* apLogger, Database* apDB, SlaveResponseTypes* apRspTypes, const EventMaxConfig& arEventMaxConfig, const EventJournalConfig& arJournalConfig) :
 	Loggable(apLogger),
-	mBuffer(arEventMaxConfig),
+	mBuffer(arEventMaxConfig, arJournalConfig),
+	mpVtoStream(NULL),
 	mMode(UNDEFINED),
 	mpDB(apDB),
 	mFIR(true),
 	mFIN(false),
 	mpRspTypes(apRspTypes),
-	mLoadedEventData(false)
-{}
+	mLoadedEventData(false),
+	mNumLoadedEvents(0)
+{
+	if(mBuffer.GetJournal() != NULL) {
+		LOG_BLOCK(LEV_INFO, "Recovered " << mBuffer.NumRecovered() << " events from journal: " << arJournalConfig.mPath);
+	}
+}
 
 void ResponseContext::Reset()
 {
 	mFIR = true;
 	mLoadedEventData = false;
+	mNumLoadedEvents = 0;
 	mMode = UNDEFINED;
 	mTempIIN.Zero();
 
@@ -78,6 +86,7 @@ void ResponseContext::Reset()
 	this->mVtoEvents.clear();
 
 	mBuffer.Deselect();
+	if(mpVtoStream) mpVtoStream->Deselect();
 }
 
 void ResponseContext::ClearWritten()
@@ -87,6 +96,12 @@ void ResponseContext::ClearWritten()
 	size_t deselected = mBuffer.Deselect();
 
 	LOG_BLOCK(LEV_DEBUG, "Clearing written events: " << written << " deselected: " << deselected);
+
+	if(mpVtoStream) {
+		// the rest of the stream's selection goes in the next fragment
+		size_t streamed = mpVtoStream->ClearWritten();
+		LOG_BLOCK(LEV_DEBUG, "Clearing written vto bytes: " << streamed);
+	}
 }
 
 void ResponseContext::ClearAndReset()
@@ -126,6 +141,7 @@ IINField ResponseContext::Configure(const APDU& arRequest)
 			/* Virtual Terminal Objects */
 		case 113:
 			this->SelectVtoEvents(PC_ALL_EVENTS, Group113Var0::Inst(), GetEventCount(hdr.info()));
+			this->SelectVtoStream();
 			continue;
 		default:
 			/*
@@ -275,6 +291,9 @@ void ResponseContext::SelectEvents(PointClass aClass, size_t aNum)
 	remain -= this->SelectEvents(aClass, mpRspTypes->mpEventAnalog, mAnalogEvents, remain);
 	remain -= this->SelectEvents(aClass, mpRspTypes->mpEventCounter, mCounterEvents, remain);
 	remain -= this->SelectVtoEvents(aClass, mpRspTypes->mpEventVto, remain);
+
+	// streamed vto data is class 1 like the vto events
+	if(aClass & PC_CLASS_1) this->SelectVtoStream();
 }
 
 size_t ResponseContext::SelectVtoEvents(PointClass aClass, const SizeByVariationObject* apObj, size_t aNum)
@@ -296,6 +315,17 @@ size_t ResponseContext::SelectVtoEvents(PointClass aClass, const SizeByVariation
 	return num;
 }
 
+size_t ResponseContext::SelectVtoStream()
+{
+	if(mpVtoStream == NULL) return 0;
+
+	size_t num = mpVtoStream->Select();
+
+	LOG_BLOCK(LEV_INTERPRET, "Selected: " << num << " vto stream bytes");
+
+	return num;
+}
+
 void ResponseContext::LoadResponse(APDU& arAPDU)
 {
 	//delay the setting of FIR/FIN until we know if it will be multifragmented or not
@@ -314,10 +344,18 @@ bool ResponseContext::SelectUnsol(ClassMask m)
 	if(m.class2) this->SelectEvents(PC_CLASS_2);
 	if(m.class3) this->SelectEvents(PC_CLASS_3);
 
-	return mBuffer.NumSelected() > 0;
+	return !this->IsEventEmpty();
 }
 
 bool ResponseContext::HasEvents(ClassMask m)
+{
+	if(this->HasBufferedEvents(m)) return true;
+	if(m.class1 && mpVtoStream && mpVtoStream->HasData()) return true;
+
+	return false;
+}
+
+bool ResponseContext::HasBufferedEvents(ClassMask m)
 {
 	if(m.class1 && mBuffer.HasClassData(PC_CLASS_1)) return true;
 	if(m.class2 && mBuffer.HasClassData(PC_CLASS_2)) return true;
@@ -329,6 +367,7 @@ bool ResponseContext::HasEvents(ClassMask m)
 void ResponseContext::LoadUnsol(APDU& arAPDU, const IINField& arIIN, ClassMask m)
 {
 	this->SelectUnsol(m);
+	mNumLoadedEvents = 0;
 
 	arAPDU.Set(FC_UNSOLICITED_RESPONSE, true, true, true, true);
 	this->LoadEventData(arAPDU);
@@ -340,6 +379,7 @@ bool ResponseContext::LoadEventData(APDU& arAPDU)
 	if (!this->LoadEvents<Analog>(arAPDU, mAnalogEvents)) return false;
 	if (!this->LoadEvents<Counter>(arAPDU, mCounterEvents)) return false;
 	if (!this->LoadVtoEvents(arAPDU)) return false;
+	if (!this->LoadVtoStream(arAPDU)) return false;
 
 	return true;
 }
@@ -380,6 +420,18 @@ bool ResponseContext::LoadVtoEvents(APDU& arAPDU)
 	return true;	// the queue has been exhausted on this iteration
 }
 
+bool ResponseContext::LoadVtoStream(APDU& arAPDU)
+{
+	if (mpVtoStream == NULL) return true;
+
+	if (mpVtoStream->Load(arAPDU, mpRspTypes->mpEventVto) > 0) {
+		/* At least one object was loaded */
+		this->mLoadedEventData = true;
+	}
+
+	return mpVtoStream->NumSelected() == 0;
+}
+
 size_t ResponseContext::IterateIndexed(VtoEventRequest& arRequest, VtoDataEventIter& arIter, APDU& arAPDU)
 {
 	for (size_t i = 0; i < arRequest.count; ++i) {
@@ -430,8 +482,8 @@ bool ResponseContext::IsStaticEmpty()
 
 bool ResponseContext::IsEventEmpty()
 {
-	// are there unwritten events in the selection buffer?
-	return mBuffer.NumSelected() == 0;
+	// are there unwritten events in the selection buffer or unloaded vto stream data?
+	return mBuffer.NumSelected() == 0 && (mpVtoStream == NULL || mpVtoStream->NumSelected() == 0);
 }
 
 void ResponseContext::FinalizeResponse(APDU& arAPDU, bool aFIN)
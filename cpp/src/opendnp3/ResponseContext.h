@@ -50,6 +50,7 @@ class Database;
 class SlaveEventBuffer;
 class ObjectBase;
 class SlaveResponseTypes;
+class VtoStreamWriter;
 
 
 /**
@@ -94,7 +95,7 @@ class DLL_LOCAL ResponseContext : public Loggable
 	typedef std::function<bool (APDU&)> WriteFunction;
 
 public:
-	ResponseContext(Logger*, Database*, SlaveResponseTypes* apRspTypes, const EventMaxConfig& arEventMaxConfig);
+	ResponseContext(Logger*, Database*, SlaveResponseTypes* apRspTypes, const EventMaxConfig& arEventMaxConfig, const EventJournalConfig& arJournalConfig = EventJournalConfig());
 
 	Mode GetMode() {
 		return mMode;
@@ -104,6 +105,19 @@ public:
 		return &mBuffer;
 	}
 
+	// Vto data is cut from the stream's rings after the vto events
+	void SetVtoStream(VtoStreamWriter* apStream) {
+		mpVtoStream = apStream;
+	}
+
+	size_t NumBufferedEvents() {
+		return mBuffer.Size();
+	}
+
+	size_t NumDroppedEvents() {
+		return mBuffer.NumDropped();
+	}
+
 	// Setup the response context with a new read request
 	IINField Configure(const APDU& arRequest);
 
@@ -112,11 +126,19 @@ public:
 
 	bool HasEvents(ClassMask aMask);
 
+	// true if there are buffered events of the masked classes, ignoring the vto stream
+	bool HasBufferedEvents(ClassMask aMask);
+
 	/** Configure the APDU with a FIR/FIN unsol packet based on
 		current state of the event buffer
 	*/
 	void LoadUnsol(APDU&, const IINField& arIIN, ClassMask aMask);
 
+	// the number of measurement events loaded into the current response
+	size_t NumLoadedEvents() {
+		return mNumLoadedEvents;
+	}
+
 	// @return TRUE is all of the response data has already been written
 	bool IsComplete() {
 		return IsEmpty();
@@ -138,6 +160,8 @@ private:
 
 	SlaveEventBuffer mBuffer;
 
+	VtoStreamWriter* mpVtoStream;
+
 	Mode mMode;
 
 	// @return TRUE if all of the data has been written
@@ -167,6 +191,7 @@ private:
 
 	IINField mTempIIN;
 	bool mLoadedEventData;
+	size_t mNumLoadedEvents;
 
 	template<class T>
 	struct EventRequest {
@@ -210,6 +235,8 @@ private:
 
 	bool LoadVtoEvents(APDU& arAPDU);
 
+	bool LoadVtoStream(APDU& arAPDU);
+
 	//wrappers that select the event buffer and add to the event queues
 	void SelectEvents(PointClass aClass, size_t aNum = std::numeric_limits<size_t>::max());
 
@@ -218,6 +245,8 @@ private:
 
 	size_t SelectVtoEvents(PointClass aClass, const SizeByVariationObject* apObj, size_t aNum);
 
+	size_t SelectVtoStream();
+
 
 	// T is the event type
 	template <class T>
@@ -360,6 +389,7 @@ bool ResponseContext::LoadEvents(APDU& arAPDU, std::deque< EventRequest<T> >& ar
 		if (written > 0) {
 			/* At least one event was loaded */
 			this->mLoadedEventData = true;
+			this->mNumLoadedEvents += written;
 		}
 
 		if (written == r.count) {
@@ -31,10 +31,12 @@
 namespace opendnp3
 {
 
-ResponseLoader::ResponseLoader(Logger* apLogger, IDataObserver* apPublisher, VtoReader* apVtoReader) :
+ResponseLoader::ResponseLoader(Logger* apLogger, IDataObserver* apPublisher, VtoReader* apVtoReader, ChangeFilter* apFilter) :
 	Loggable(apLogger),
 	mpPublisher(apPublisher),
 	mpVtoReader(apVtoReader),
+	mpFilter(apFilter),
+	mNumSuppressed(0),
 	mTransaction(apPublisher)
 {}
 
@@ -38,6 +38,7 @@
 #include "Loggable.h"
 #include "LoggableMacros.h"
 #include "CTOHistory.h"
+#include "ChangeFilter.h"
 #include "ObjectReadIterator.h"
 #include "VtoReader.h"
 
@@ -59,12 +60,14 @@ public:
 	 * 						message reporting
 	 * @param apPublisher	the IDataObserver for any responses that match
 	 * @param apVtoReader	the VtoReader for any responses that match
+	 * @param apFilter		optional filter that drops unchanged static values
 	 *
 	 * @return				a new ResponseLoader instance
 	 */
 	ResponseLoader(Logger* log,
 	               IDataObserver* apPublisher,
-	               VtoReader* apVtoReader);
+	               VtoReader* apVtoReader,
+	               ChangeFilter* apFilter = NULL);
 
 	/**
 	 * Processes a DNP3 object received by the Master.  The real heavy
@@ -75,6 +78,11 @@ public:
 	 */
 	void Process(HeaderReadIterator& itr);
 
+	/// Number of static values the filter dropped
+	size_t NumSuppressed() const {
+		return mNumSuppressed;
+	}
+
 private:
 
 	/**
@@ -129,6 +137,9 @@ private:
 	 */
 	VtoReader* mpVtoReader;
 
+	ChangeFilter* mpFilter;
+	size_t mNumSuppressed;
+
 	Transaction mTransaction;
 
 	CTOHistory mCTO;
@@ -178,7 +189,8 @@ void ResponseLoader::Read(HeaderReadIterator& arIter, StreamObject<T>* apObj)
 			value.SetQuality(T::ONLINE);
 		}
 
-		mpPublisher->Update(value, index);
+		if(mpFilter == NULL || mpFilter->Publish(value, index, !apObj->IsEvent())) mpPublisher->Update(value, index);
+		else ++mNumSuppressed;
 	}
 }
 
@@ -195,7 +207,8 @@ void ResponseLoader::ReadBitfield(HeaderReadIterator& arIter)
 	for (; !obj.IsEnd(); ++obj) {
 		bool val = BitfieldObject::StaticRead(*obj, obj->Start(), obj->Index());
 		b.SetValue(val);
-		mpPublisher->Update(b, obj->Index());
+		if(mpFilter == NULL || mpFilter->Publish(b, obj->Index(), true)) mpPublisher->Update(b, obj->Index());
+		else ++mNumSuppressed;
 	}
 }
 
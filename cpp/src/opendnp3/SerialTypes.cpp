@@ -44,7 +44,10 @@ FlowType GetFlowTypeFromInt(int flowControl)
 	}
 }
 
+int GetBitsPerCharacter(const SerialSettings& arSettings)
+{
+	int parity = (arSettings.mParity == PAR_NONE) ? 0 : 1;
+	return 1 + arSettings.mDataBits + parity + arSettings.mStopBits;
 }
 
-
-
+}
@@ -0,0 +1,275 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "SharedMemorySegment.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Location.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace boost::interprocess;
+
+namespace opendnp3
+{
+
+const uint32_t SHARED_MEMORY_MAGIC = 0x4D534E44; // "DNSM"
+const uint32_t SHARED_MEMORY_VERSION = 1;
+const size_t MIN_SHARED_MEMORY_CAPACITY = 4096;
+
+SharedMemorySegment::SharedMemorySegment(const std::string& arName, SharedMemoryRole aRole, size_t aCapacity) :
+	mName(arName),
+	mRole(aRole),
+	mCapacity(0),
+	mpHeader(NULL)
+{
+	if(arName.empty()) MACRO_THROW_EXCEPTION(ArgumentException, "Segment name is empty");
+
+	if(aRole == SMR_SERVER) {
+		mCapacity = ToCapacity(aCapacity);
+		offset_t size = sizeof(SharedMemoryHeader) + 2 * mCapacity;
+
+		shared_memory_object object(open_or_create, arName.c_str(), read_write);
+		offset_t existing = 0;
+		if(!object.get_size(existing) || existing != size) object.truncate(size);
+		mObject.swap(object);
+	}
+	else {
+		shared_memory_object object(open_only, arName.c_str(), read_write);
+		mObject.swap(object);
+	}
+
+	mapped_region region(mObject, read_write);
+	mRegion.swap(region);
+	mpHeader = reinterpret_cast<SharedMemoryHeader*>(mRegion.get_address());
+
+	if(aRole == SMR_SERVER) {
+		bool valid = mpHeader->mMagic == SHARED_MEMORY_MAGIC &&
+		             mpHeader->mVersion == SHARED_MEMORY_VERSION &&
+		             mpHeader->mCapacity == mCapacity;
+
+		if(valid) Local().mState.store(SMS_CLOSED);	// take over from a previous server
+		else this->Format();
+	}
+	else {
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(mpHeader->mMagic != SHARED_MEMORY_MAGIC || mpHeader->mVersion != SHARED_MEMORY_VERSION) {
+			MACRO_THROW_EXCEPTION(Exception, "Segment has not been initialized by a server: " + arName);
+		}
+		mCapacity = mpHeader->mCapacity;
+		if(mRegion.get_size() < sizeof(SharedMemoryHeader) + 2 * mCapacity) {
+			MACRO_THROW_EXCEPTION(Exception, "Segment is smaller than its header claims: " + arName);
+		}
+	}
+
+	uint8_t* pData = reinterpret_cast<uint8_t*>(mRegion.get_address()) + sizeof(SharedMemoryHeader);
+	mpData[SMR_SERVER] = pData;
+	mpData[SMR_CLIENT] = pData + mCapacity;
+}
+
+SharedMemorySegment::~SharedMemorySegment()
+{
+
+}
+
+void SharedMemorySegment::Remove(const std::string& arName)
+{
+	shared_memory_object::remove(arName.c_str());
+}
+
+size_t SharedMemorySegment::ToCapacity(size_t aRequested)
+{
+	if(aRequested > std::numeric_limits<uint32_t>::max() / 2) MACRO_THROW_EXCEPTION(ArgumentException, "Ring capacity is too large");
+
+	size_t capacity = MIN_SHARED_MEMORY_CAPACITY;
+	while(capacity < aRequested) capacity <<= 1;
+	return capacity;
+}
+
+bool SharedMemorySegment::Accept()
+{
+	SharedMemoryEnd& client = Remote();
+
+	switch(Local().mState.load()) {
+	case(SMS_CLOSED):
+		// a client from the last session may still be using the rings
+		if(client.mState.load() == SMS_CLOSED || !IsAlive(client)) {
+			this->Reset();
+			Local().mPid.store(getpid());
+			Local().mState.store(SMS_LISTENING);
+		}
+		return false;
+	case(SMS_CONNECTED):
+		// claimed by a client, attached once it has published its state
+		return client.mState.load() == SMS_CONNECTED;
+	default:
+		return false;
+	}
+}
+
+bool SharedMemorySegment::Connect()
+{
+	SharedMemoryEnd& server = Remote();
+
+	uint32_t expected = SMS_LISTENING;
+	if(!IsAlive(server) || !server.mState.compare_exchange_strong(expected, SMS_CONNECTED)) return false;
+
+	Local().mPid.store(getpid());
+	Local().mState.store(SMS_CONNECTED);
+	Ring(server);
+	return true;
+}
+
+void SharedMemorySegment::Disconnect()
+{
+	Local().mState.store(SMS_CLOSED);
+	Local().mBlocked.store(0);
+	Ring(Remote());
+}
+
+bool SharedMemorySegment::IsPeerConnected() const
+{
+	return Remote().mState.load() == SMS_CONNECTED && IsAlive(Remote());
+}
+
+bool SharedMemorySegment::IsAlive(const SharedMemoryEnd& arEnd)
+{
+	pid_t pid = arEnd.mPid.load();
+	if(pid <= 0) return false;
+	return pid == getpid() || kill(pid, 0) == 0 || errno == EPERM;
+}
+
+size_t SharedMemorySegment::Write(const uint8_t* apData, size_t aSize)
+{
+	size_t num = this->Push(apData, aSize);
+	if(num < aSize) {
+		// ask the reader to ring when it frees space, then look again in case it already has
+		Local().mBlocked.store(1);
+		num += this->Push(apData + num, aSize - num);
+	}
+	return num;
+}
+
+size_t SharedMemorySegment::Push(const uint8_t* apData, size_t aSize)
+{
+	SharedMemoryRing& ring = Remote().mRx;
+	uint8_t* pData = mpData[1 - mRole];
+
+	uint64_t head = ring.mHead.load(std::memory_order_relaxed);
+	uint64_t tail = ring.mTail.load();
+	size_t num = std::min(aSize, mCapacity - static_cast<size_t>(head - tail));
+	if(num == 0) return 0;
+
+	size_t offset = static_cast<size_t>(head & (mCapacity - 1));
+	size_t first = std::min(num, mCapacity - offset);
+	memcpy(pData + offset, apData, first);
+	memcpy(pData, apData + first, num - first);
+
+	ring.mHead.store(head + num, std::memory_order_release);
+	Ring(Remote());
+	return num;
+}
+
+size_t SharedMemorySegment::Read(uint8_t* apData, size_t aSize)
+{
+	SharedMemoryRing& ring = Local().mRx;
+	uint8_t* pData = mpData[mRole];
+
+	uint64_t tail = ring.mTail.load(std::memory_order_relaxed);
+	uint64_t head = ring.mHead.load(std::memory_order_acquire);
+	size_t num = std::min(aSize, static_cast<size_t>(head - tail));
+	if(num == 0) return 0;
+
+	size_t offset = static_cast<size_t>(tail & (mCapacity - 1));
+	size_t first = std::min(num, mCapacity - offset);
+	memcpy(apData, pData + offset, first);
+	memcpy(apData + first, pData, num - first);
+
+	ring.mTail.store(tail + num);
+	if(Remote().mBlocked.load() && Remote().mBlocked.exchange(0)) Ring(Remote());
+	return num;
+}
+
+uint32_t SharedMemorySegment::GetDoorbell() const
+{
+	return mpHeader->mEnds[mRole].mDoorbell.load();
+}
+
+void SharedMemorySegment::WaitForDoorbell(uint32_t aSeen, millis_t aTimeout)
+{
+	SharedMemoryEnd& local = Local();
+	timespec timeout = { static_cast<time_t>(aTimeout / 1000), static_cast<long>((aTimeout % 1000) * 1000000) };
+
+	// The sleeping flag is published before the kernel compares the doorbell,
+	// so a writer either sees the flag and wakes us or bumped the doorbell first
+	local.mSleeping.store(1);
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&local.mDoorbell), FUTEX_WAIT, aSeen, &timeout, NULL, 0);
+	local.mSleeping.store(0);
+}
+
+void SharedMemorySegment::RingLocal()
+{
+	Ring(Local());
+}
+
+void SharedMemorySegment::Ring(SharedMemoryEnd& arEnd)
+{
+	arEnd.mDoorbell.fetch_add(1);
+
+	// only pay for the syscall when the other end is actually asleep
+	if(arEnd.mSleeping.load()) {
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&arEnd.mDoorbell), FUTEX_WAKE, std::numeric_limits<int>::max(), NULL, NULL, 0);
+	}
+}
+
+void SharedMemorySegment::Format()
+{
+	memset(mRegion.get_address(), 0, sizeof(SharedMemoryHeader));
+	mpHeader->mVersion = SHARED_MEMORY_VERSION;
+	mpHeader->mCapacity = static_cast<uint32_t>(mCapacity);
+
+	// the magic is written last so a client never attaches to a partial header
+	std::atomic_thread_fence(std::memory_order_release);
+	mpHeader->mMagic = SHARED_MEMORY_MAGIC;
+}
+
+void SharedMemorySegment::Reset()
+{
+	for(size_t i = 0; i < 2; ++i) {
+		SharedMemoryEnd& end = mpHeader->mEnds[i];
+		end.mRx.mHead.store(0);
+		end.mRx.mTail.store(0);
+		end.mBlocked.store(0);
+	}
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,173 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __SHARED_MEMORY_SEGMENT_H_
+#define __SHARED_MEMORY_SEGMENT_H_
+
+#include <opendnp3/Types.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <atomic>
+#include <string>
+
+namespace opendnp3
+{
+
+enum SharedMemoryRole {
+	SMR_SERVER = 0,
+	SMR_CLIENT = 1
+};
+
+enum SharedMemoryState {
+	SMS_CLOSED = 0,
+	SMS_LISTENING = 1,
+	SMS_CONNECTED = 2
+};
+
+/**
+Byte counters of a single producer, single consumer ring. They only ever grow,
+so the fill level is mHead - mTail and the offset is the counter modulo the
+capacity. Each one lives on its own cache line.
+*/
+struct SharedMemoryRing {
+	std::atomic<uint64_t> mHead;	// bytes written, only stored by the producer
+	uint8_t mPad0[56];
+	std::atomic<uint64_t> mTail;	// bytes consumed, only stored by the consumer
+	uint8_t mPad1[56];
+};
+
+/**
+Everything one end of the connection publishes to the other. The doorbell is a
+futex word, the peer bumps it whenever there is something new to look at.
+*/
+struct SharedMemoryEnd {
+	std::atomic<uint32_t> mState;
+	std::atomic<uint32_t> mDoorbell;
+	std::atomic<uint32_t> mSleeping;	// set while the end is blocked on its doorbell
+	std::atomic<uint32_t> mBlocked;		// set while the end waits for space to write
+	std::atomic<int32_t> mPid;
+	uint8_t mPad[44];
+	SharedMemoryRing mRx;				// the ring this end consumes
+};
+
+struct SharedMemoryHeader {
+	uint32_t mMagic;
+	uint32_t mVersion;
+	uint32_t mCapacity;
+	uint8_t mPad[52];
+	SharedMemoryEnd mEnds[2];
+};
+
+/**
+A named shared memory segment holding a ring per direction between a server
+and a single client. Works between threads of one process and between
+processes, since every field lives in the mapping and wakeups use non-private
+futexes.
+
+The server creates the segment and resets the rings whenever it starts to
+listen with no client attached. A client attaches by claiming a listening
+server. Either end detaches by marking itself closed, and an end whose process
+has died is treated as closed.
+
+Each end must be driven by a single thread at a time, only the doorbell
+functions may be called concurrently with the rest.
+*/
+class DLL_LOCAL SharedMemorySegment : private Uncopyable
+{
+public:
+
+	/**
+	* @param arName name of the segment, shared by both ends
+	* @param aRole the end of the connection this object drives
+	* @param aCapacity bytes per ring, rounded up to a power of two. Only used by the server.
+	*/
+	SharedMemorySegment(const std::string& arName, SharedMemoryRole aRole, size_t aCapacity = 0);
+	~SharedMemorySegment();
+
+	static void Remove(const std::string& arName);
+
+	size_t GetCapacity() const {
+		return mCapacity;
+	}
+
+	// Server: advances the handshake, returns true once a client has attached
+	bool Accept();
+
+	// Client: claims a listening server, returns false if there isn't one
+	bool Connect();
+
+	// Marks this end closed and notifies the peer
+	void Disconnect();
+
+	bool IsPeerConnected() const;
+
+	// Copies up to aSize bytes into the peer's ring, returns the number copied
+	size_t Write(const uint8_t* apData, size_t aSize);
+
+	// Copies up to aSize bytes out of this end's ring, returns the number copied
+	size_t Read(uint8_t* apData, size_t aSize);
+
+	uint32_t GetDoorbell() const;
+
+	// Blocks until the doorbell differs from aSeen or the timeout expires
+	void WaitForDoorbell(uint32_t aSeen, millis_t aTimeout);
+
+	// Wakes a thread blocked in WaitForDoorbell on this end
+	void RingLocal();
+
+private:
+
+	SharedMemoryEnd& Local() {
+		return mpHeader->mEnds[mRole];
+	}
+
+	SharedMemoryEnd& Remote() {
+		return mpHeader->mEnds[1 - mRole];
+	}
+
+	const SharedMemoryEnd& Remote() const {
+		return mpHeader->mEnds[1 - mRole];
+	}
+
+	static size_t ToCapacity(size_t aRequested);
+	static bool IsAlive(const SharedMemoryEnd& arEnd);
+	static void Ring(SharedMemoryEnd& arEnd);
+
+	void Format();
+	void Reset();
+	size_t Push(const uint8_t* apData, size_t aSize);
+
+	std::string mName;
+	SharedMemoryRole mRole;
+	size_t mCapacity;
+	boost::interprocess::shared_memory_object mObject;
+	boost::interprocess::mapped_region mRegion;
+	SharedMemoryHeader* mpHeader;
+	uint8_t* mpData[2];
+};
+
+}
+
+#endif
@@ -50,11 +50,12 @@ Slave::Slave(Logger* apLogger, IAppLayer* apAppLayer, IExecutor* apExecutor, ITi
 	mpUnsolTimer(NULL),
 	mResponse(arCfg.mMaxFragSize),
 	mUnsol(arCfg.mMaxFragSize),
-	mRspContext(apLogger, apDatabase, &mRspTypes, arCfg.mEventMaxConfig),
+	mRspContext(apLogger, apDatabase, &mRspTypes, arCfg.mEventMaxConfig, arCfg.mEventJournal),
 	mSBOHandler(arCfg.mSelectTimeout, apCmdHandler, apTimeSource),
 	mHaveLastRequest(false),
 	mLastRequest(arCfg.mMaxFragSize),
 	mpTime(apTime),
+	mpTimeSource(apTimeSource),
 	mDeferredUpdate(false),
 	mDeferredRequest(false),
 	mDeferredUnsol(false),
@@ -62,8 +63,13 @@ Slave::Slave(Logger* apLogger, IAppLayer* apAppLayer, IExecutor* apExecutor, ITi
 	mStartupNullUnsol(false),
 	mState(SS_UNKNOWN),
 	mpTimeTimer(NULL),
+	mpSnapshotTimer(NULL),
+	mpCounters(NULL),
 	mVtoReader(apLogger),
-	mVtoWriter(apLogger->GetSubLogger("VtoWriter"), arCfg.mVtoWriterQueueSize)
+	mVtoWriter(apLogger->GetSubLogger("VtoWriter"), arCfg.mVtoWriterQueueSize),
+	mVtoStreamWriter(apLogger->GetSubLogger("VtoStreamWriter"), arCfg.mVtoStreamBufferSize),
+	mVtoWindow(VtoStreamWriter::FragmentCapacity(arCfg.mMaxFragSize), arCfg.mVtoStreamBufferSize, arCfg.mVtoWindowDelay),
+	mUnsolPack(arCfg.mMaxFragSize, arCfg.mUnsolMaxPackDelay)
 {
 	/* Link the event buffer to the database */
 	mpDatabase->SetEventBuffer(mRspContext.GetBuffer());
@@ -82,15 +88,27 @@ Slave::Slave(Logger* apLogger, IAppLayer* apAppLayer, IExecutor* apExecutor, ITi
 	 * Incoming vto data will trigger a POST on the timer source to call
 	 * Slave::OnVtoUpdate().
 	 */
-	mVtoWriter.AddObserver(mpExecutor, [this]() {
-		this->OnVtoUpdate();
-	});
+	if (mConfig.mVtoStreamBufferSize > 0) {
+		mRspContext.SetVtoStream(&mVtoStreamWriter);
+		mVtoStreamWriter.AddObserver(mpExecutor, [this]() {
+			this->OnVtoUpdate();
+		});
+	}
+	else {
+		mVtoWriter.AddObserver(mpExecutor, [this]() {
+			this->OnVtoUpdate();
+		});
+	}
 
 	/* Cause the slave to go through the null-unsol startup sequence */
 	if (!mConfig.mDisableUnsol) {
 		mDeferredUnsol = true;
 	}
 
+	if (!mConfig.mSnapshot.mPath.empty() && mConfig.mSnapshot.mPeriod > 0) {
+		mpSnapshotTimer = mpExecutor->Start(std::chrono::milliseconds(mConfig.mSnapshot.mPeriod), std::bind(&Slave::OnSnapshotTimerExpiration, this));
+	}
+
 	this->UpdateState(SS_COMMS_DOWN);
 }
 
@@ -98,7 +116,10 @@ Slave::~Slave()
 {
 	if(mpUnsolTimer) mpUnsolTimer->Cancel();
 	if(mpTimeTimer) mpTimeTimer->Cancel();
+	if(mpSnapshotTimer) mpSnapshotTimer->Cancel();
 
+	/* Leave the last known values behind for the next warm start */
+	if(!mConfig.mSnapshot.mPath.empty()) this->SaveSnapshot();
 }
 
 void Slave::UpdateState(StackState aState)
@@ -127,13 +148,16 @@ void Slave::OnLowerLayerDown()
 
 void Slave::OnSolSendSuccess()
 {
+	this->OnVtoStreamConfirmed();
 	mpState->OnSolSendSuccess(this);
 	this->FlushDeferredEvents();
+	this->UpdateEventCounters();
 	this->UpdateState(SS_COMMS_UP);
 }
 
 void Slave::OnSolFailure()
 {
+	mVtoWindow.OnFailure();
 	mpState->OnSolFailure(this);
 	this->FlushDeferredEvents();
 	LOG_BLOCK(LEV_WARNING, "Response failure");
@@ -141,13 +165,18 @@ void Slave::OnSolFailure()
 
 void Slave::OnUnsolSendSuccess()
 {
+	this->OnVtoStreamConfirmed();
+	mUnsolPack.OnConfirmed(mpTimeSource->GetUTC());
 	mpState->OnUnsolSendSuccess(this);
 	this->FlushDeferredEvents();
+	this->UpdateEventCounters();
 	this->UpdateState(SS_COMMS_UP);
 }
 
 void Slave::OnUnsolFailure()
 {
+	mVtoWindow.OnFailure();
+	mUnsolPack.OnFailure();
 	mpState->OnUnsolFailure(this);
 	LOG_BLOCK(LEV_WARNING, "Unsol response failure");
 	this->FlushDeferredEvents();
@@ -245,6 +274,7 @@ size_t Slave::FlushVtoUpdates()
 size_t Slave::FlushUpdates()
 {
 	size_t num = 0;
+	size_t buffered = mRspContext.NumBufferedEvents();
 	try {
 		Transaction t(&mChangeBuffer);
 		num = mChangeBuffer.FlushUpdates(mpDatabase);
@@ -256,12 +286,66 @@ size_t Slave::FlushUpdates()
 		return 0;
 	}
 
+	if(mConfig.mAdaptiveUnsolPack && mRspContext.NumBufferedEvents() > buffered) {
+		mUnsolPack.OnEvents(mRspContext.NumBufferedEvents() - buffered, mpTimeSource->GetUTC());
+	}
+
 	num += this->FlushVtoUpdates();
 
 	LOG_BLOCK(LEV_DEBUG, "Processed " << num << " updates");
+	this->UpdateEventCounters();
 	return num;
 }
 
+void Slave::UpdateEventCounters()
+{
+	if(mpCounters == NULL) return;
+
+	mpCounters->Set(SC_EVENT_BUFFER_DEPTH, mRspContext.NumBufferedEvents());
+	mpCounters->Set(SC_EVENT_OVERFLOWS, mRspContext.NumDroppedEvents());
+	mpCounters->Set(SC_UNSOL_FILL_PERCENT, mUnsolPack.FillPercent());
+	mpCounters->Set(SC_UNSOL_PACK_DELAY_MILLIS, Max<millis_t>(0, mConfig.mAdaptiveUnsolPack ? mUnsolPack.LastDelay() : mConfig.mUnsolPackDelay));
+
+	if(mConfig.mVtoStreamBufferSize > 0) {
+		mpCounters->Set(SC_VTO_BYTES_PER_SECOND, mVtoWindow.BytesPerSecond());
+		mpCounters->Set(SC_VTO_WINDOW_BYTES, mVtoWindow.NumBytes());
+		mpCounters->Set(SC_VTO_ROUND_TRIP_MICROS, mVtoWindow.RoundTripMicros());
+	}
+}
+
+millis_t Slave::UnsolPackDelay()
+{
+	if(mConfig.mVtoStreamBufferSize == 0 || mRspContext.HasBufferedEvents(mConfig.mUnsolMask)) return this->EventPackDelay();
+
+	// vto data on its own goes as soon as it fills a fragment, and otherwise never waits longer than events would
+	if(mVtoStreamWriter.NumBytesQueued() >= mVtoWindow.FragmentCapacity()) return 0;
+	millis_t ceiling = mConfig.mAdaptiveUnsolPack ? mConfig.mUnsolMaxPackDelay : mConfig.mUnsolPackDelay;
+	if(ceiling > 0) return Min<millis_t>(mConfig.mVtoPackDelay, ceiling);
+	return mConfig.mVtoPackDelay;
+}
+
+millis_t Slave::EventPackDelay()
+{
+	if(!mConfig.mAdaptiveUnsolPack) return mConfig.mUnsolPackDelay;
+	return mUnsolPack.PackDelay(mRspContext.NumBufferedEvents(), mpTimeSource->GetUTC());
+}
+
+void Slave::OnVtoStreamSent()
+{
+	if(mConfig.mVtoStreamBufferSize > 0 && mVtoStreamWriter.NumBytesLoaded() > 0) mVtoWindow.OnSent(mpTimeSource->GetUTC());
+}
+
+void Slave::OnVtoStreamConfirmed()
+{
+	if(mConfig.mVtoStreamBufferSize == 0) return;
+
+	size_t loaded = mVtoStreamWriter.NumBytesLoaded();
+	if(loaded == 0) return;
+
+	mVtoWindow.OnConfirmed(loaded, mpTimeSource->GetUTC());
+	mVtoStreamWriter.SetWindow(mVtoWindow.NumBytes());
+}
+
 
 void Slave::ConfigureAndSendSimpleResponse()
 {
@@ -276,6 +360,7 @@ void Slave::Send(APDU& arAPDU, const IINField& arIIN)
 	mRspIIN.BitwiseOR(mIIN);
 	mRspIIN.BitwiseOR(arIIN);
 	arAPDU.SetIIN(mRspIIN);
+	this->OnVtoStreamSent();
 	mpAppLayer->SendResponse(arAPDU);
 }
 
@@ -283,6 +368,7 @@ void Slave::Send(APDU& arAPDU)
 {
 	mRspIIN.BitwiseOR(mIIN);
 	arAPDU.SetIIN(mRspIIN);
+	this->OnVtoStreamSent();
 	mpAppLayer->SendResponse(arAPDU);
 }
 
@@ -290,6 +376,8 @@ void Slave::SendUnsolicited(APDU& arAPDU)
 {
 	mRspIIN.BitwiseOR(mIIN);
 	arAPDU.SetIIN(mRspIIN);
+	this->OnVtoStreamSent();
+	if(mRspContext.NumLoadedEvents() > 0) mUnsolPack.OnSent(arAPDU.Size(), mRspContext.NumLoadedEvents(), mpTimeSource->GetUTC());
 	mpAppLayer->SendUnsolicited(arAPDU);
 }
 
@@ -618,6 +706,14 @@ void Slave::StartUnsolTimer(millis_t aTimeout)
 	mpUnsolTimer = mpExecutor->Start(std::chrono::milliseconds(aTimeout), std::bind(&Slave::OnUnsolTimerExpiration, this));
 }
 
+void Slave::CancelUnsolTimer()
+{
+	if(mpUnsolTimer) {
+		mpUnsolTimer->Cancel();
+		mpUnsolTimer = NULL;
+	}
+}
+
 void Slave::ResetTimeIIN()
 {
 	mpTimeTimer = NULL;
@@ -625,6 +721,23 @@ void Slave::ResetTimeIIN()
 	mpTimeTimer = mpExecutor->Start(std::chrono::milliseconds(mConfig.mTimeSyncPeriod), std::bind(&Slave::ResetTimeIIN, this));
 }
 
+void Slave::OnSnapshotTimerExpiration()
+{
+	mpSnapshotTimer = NULL;
+	this->SaveSnapshot();
+	mpSnapshotTimer = mpExecutor->Start(std::chrono::milliseconds(mConfig.mSnapshot.mPeriod), std::bind(&Slave::OnSnapshotTimerExpiration, this));
+}
+
+void Slave::SaveSnapshot()
+{
+	try {
+		mpDatabase->SaveSnapshot(mConfig.mSnapshot.mPath);
+	}
+	catch (Exception& ex) {
+		LOG_BLOCK(LEV_ERROR, "Unable to save database snapshot: " << ex.Message());
+	}
+}
+
 } //end ns
 
 /* vim: set ts=4 sw=4: */
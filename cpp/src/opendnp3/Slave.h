@@ -47,8 +47,12 @@
 #include "ResponseContext.h"
 #include "SlaveEventBuffer.h"
 #include "SlaveResponseTypes.h"
+#include "StatisticsCounters.h"
 #include "VtoReader.h"
 #include "VtoWriter.h"
+#include "VtoStreamWriter.h"
+#include "VtoWindow.h"
+#include "UnsolPackController.h"
 #include "OutstationSBOHandler.h"
 
 
@@ -152,7 +156,16 @@ public:
 	 * @return			a pointer to the VtoWriter instance for this stack
 	 */
 	IVtoWriter* GetVtoWriter() {
-		return &mVtoWriter;
+		if(mConfig.mVtoStreamBufferSize > 0) return &mVtoStreamWriter;
+		else return &mVtoWriter;
+	}
+
+	/**
+	 * Publishes the event buffer depth and overflow count to the stack
+	 * counters. Must be set before the lower layer comes up.
+	 */
+	void SetCounters(StackCounters* apCounters) {
+		mpCounters = apCounters;
 	}
 
 private:
@@ -183,6 +196,7 @@ private:
 	APDU mLastRequest;						// APDU used to form responses
 
 	ITimeManager* mpTime;
+	ITimeSource* mpTimeSource;				// Clock for the pack delay and vto window measurements
 
 	// Flags that tell us that some action has been Deferred
 	// until the slave is in a state capable of handling it.
@@ -230,13 +244,25 @@ private:
 	size_t FlushVtoUpdates();
 	size_t FlushUpdates();
 	void FlushDeferredEvents();
+	void UpdateEventCounters();
 	void StartUnsolTimer(millis_t aTimeout);
+	void CancelUnsolTimer();
+	millis_t UnsolPackDelay();				// how long the current unsolicited data may wait before it is sent
+	millis_t EventPackDelay();				// how long buffered events may wait before they are sent
+	void OnVtoStreamSent();
+	void OnVtoStreamConfirmed();
 
 	// Task handlers
 
 	void ResetTimeIIN();
 	ITimer* mpTimeTimer;
 
+	void OnSnapshotTimerExpiration();
+	void SaveSnapshot();
+	ITimer* mpSnapshotTimer;
+
+	StackCounters* mpCounters;
+
 	/**
 	 * The VtoReader instance for this stack which will direct received
 	 * VTO data to the user application.  The user application should
@@ -252,6 +278,24 @@ private:
 	 */
 	VtoWriter mVtoWriter;
 
+	/**
+	 * Replaces mVtoWriter when SlaveConfig::mVtoStreamBufferSize is set. The
+	 * ResponseContext pulls data straight out of its rings.
+	 */
+	VtoStreamWriter mVtoStreamWriter;
+
+	/**
+	 * Sizes how much unconfirmed data mVtoStreamWriter accepts from the
+	 * user application, from the measured confirm round trip time.
+	 */
+	VtoWindow mVtoWindow;
+
+	/**
+	 * Chooses the unsolicited pack delay when SlaveConfig::mAdaptiveUnsolPack
+	 * is set, and measures how full unsolicited fragments are either way.
+	 */
+	UnsolPackController mUnsolPack;
+
 	/**
 	 * A structure to provide the C++ equivalent of templated typedefs.
 	 */
@@ -41,6 +41,28 @@ EventMaxConfig::EventMaxConfig(size_t aMaxBinaryEvents, size_t aMaxAnalogEvents,
 	mMaxVtoEvents(aMaxVtoEvents)
 {}
 
+EventJournalConfig::EventJournalConfig() :
+	mCapacity(0),
+	mSyncPolicy(JSP_BATCHED),
+	mSyncBatch(64)
+{}
+
+EventJournalConfig::EventJournalConfig(const std::string& arPath, size_t aCapacity, JournalSyncPolicy aSyncPolicy, size_t aSyncBatch) :
+	mPath(arPath),
+	mCapacity(aCapacity),
+	mSyncPolicy(aSyncPolicy),
+	mSyncBatch(aSyncBatch)
+{}
+
+DatabaseSnapshotConfig::DatabaseSnapshotConfig() :
+	mPeriod(0)
+{}
+
+DatabaseSnapshotConfig::DatabaseSnapshotConfig(const std::string& arPath, millis_t aPeriod) :
+	mPath(arPath),
+	mPeriod(aPeriod)
+{}
+
 SlaveConfig::SlaveConfig() :
 	mMaxControls(1),
 	mDisableUnsol(false),
@@ -48,11 +70,18 @@ SlaveConfig::SlaveConfig() :
 	mAllowTimeSync(false),
 	mTimeSyncPeriod(10 * 60 * 1000), //every 10 min
 	mUnsolPackDelay(200),
+	mAdaptiveUnsolPack(false),
+	mUnsolMaxPackDelay(200),
 	mUnsolRetryDelay(2000),
 	mSelectTimeout(5000),
 	mMaxFragSize(DEFAULT_FRAG_SIZE),
 	mVtoWriterQueueSize(DEFAULT_VTO_WRITER_QUEUE_SIZE),
+	mVtoStreamBufferSize(0),
+	mVtoPackDelay(20),
+	mVtoWindowDelay(1000),
 	mEventMaxConfig(),
+	mEventJournal(),
+	mSnapshot(),
 	mStaticBinary(SBR_GROUP1_VAR2),
 	mStaticAnalog(SAR_GROUP30_VAR1),
 	mStaticCounter(SCR_GROUP20_VAR1),
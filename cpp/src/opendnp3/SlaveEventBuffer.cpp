@@ -28,12 +28,56 @@
 namespace opendnp3
 {
 
-SlaveEventBuffer::SlaveEventBuffer(const EventMaxConfig& arEventMaxConfig) :
+SlaveEventBuffer::SlaveEventBuffer(const EventMaxConfig& arEventMaxConfig, const EventJournalConfig& arJournalConfig) :
 	mBinaryEvents(arEventMaxConfig.mMaxBinaryEvents),
 	mAnalogEvents(arEventMaxConfig.mMaxAnalogEvents),
 	mCounterEvents(arEventMaxConfig.mMaxCounterEvents),
-	mVtoEvents(arEventMaxConfig.mMaxVtoEvents)
-{}
+	mVtoEvents(arEventMaxConfig.mMaxVtoEvents),
+	mNumRecovered(0)
+{
+	if(!arJournalConfig.mPath.empty()) {
+		mpJournal.reset(new EventJournal(arJournalConfig));
+		mBinaryEvents.SetJournal(mpJournal.get());
+		mAnalogEvents.SetJournal(mpJournal.get());
+		mCounterEvents.SetJournal(mpJournal.get());
+		mNumRecovered = this->Recover();
+	}
+}
+
+size_t SlaveEventBuffer::Recover()
+{
+	// restored events keep their records, any that overflow the buffers are released
+	std::vector<size_t> ids;
+	mpJournal->GetLiveIds(ids);
+
+	for(size_t i = 0; i < ids.size(); ++i) {
+		const JournalRecord& r = mpJournal->GetRecord(ids[i]);
+		switch(r.mType) {
+		case(DT_BINARY):
+			this->Restore<Binary>(mBinaryEvents, r);
+			break;
+		case(DT_ANALOG):
+			this->Restore<Analog>(mAnalogEvents, r);
+			break;
+		case(DT_COUNTER):
+			this->Restore<Counter>(mCounterEvents, r);
+			break;
+		default:
+			mpJournal->Release(ids[i]);
+			break;
+		}
+	}
+
+	return ids.size();
+}
+
+template <class T, class BufferType>
+void SlaveEventBuffer::Restore(BufferType& arBuffer, const JournalRecord& arRecord)
+{
+	T value;
+	EventJournal::Read(arRecord, value);
+	arBuffer.Restore(value, static_cast<PointClass>(arRecord.mClass), arRecord.mIndex, static_cast<size_t>(arRecord.mId));
+}
 
 void SlaveEventBuffer::Update(const Binary& arEvent, PointClass aClass, size_t aIndex)
 {
@@ -112,6 +156,22 @@ bool SlaveEventBuffer::IsOverflow()
 	        || mVtoEvents.IsOverflown();
 }
 
+size_t SlaveEventBuffer::Size()
+{
+	return mBinaryEvents.Size()
+	       + mAnalogEvents.Size()
+	       + mCounterEvents.Size()
+	       + mVtoEvents.Size();
+}
+
+size_t SlaveEventBuffer::NumDropped()
+{
+	return mBinaryEvents.NumDropped()
+	       + mAnalogEvents.NumDropped()
+	       + mCounterEvents.NumDropped()
+	       + mVtoEvents.NumDropped();
+}
+
 bool SlaveEventBuffer::HasEventData()
 {
 	return mBinaryEvents.NumUnselected() > 0
@@ -37,6 +37,9 @@
 #include "BufferTypes.h"
 #include "DatabaseInterfaces.h"
 #include "EventBuffers.h"
+#include "EventJournal.h"
+
+#include <memory>
 
 
 namespace opendnp3
@@ -49,6 +52,10 @@ namespace opendnp3
  * transactional such that failed deliveries put events back into the buffer.
  *
  * All selections can be limited by a desired event count.
+ *
+ * If a journal is configured, binary, analog and counter events are also kept
+ * in a memory-mapped EventJournal until they are cleared. Events left in the
+ * journal by a previous instance are restored on construction.
  */
 class DLL_LOCAL SlaveEventBuffer : public IEventBuffer
 {
@@ -62,10 +69,11 @@ public:
 	 *
 	 * @param arEventMaxConfig		the configuration parameters for the
 	 * 								SlaveEventBuffer instance
+	 * @param arJournalConfig		the optional persistent journal
 	 *
 	 * @return						a new SlaveEventBuffer instance
 	 */
-	SlaveEventBuffer(const EventMaxConfig& arEventMaxConfig);
+	SlaveEventBuffer(const EventMaxConfig& arEventMaxConfig, const EventJournalConfig& arJournalConfig = EventJournalConfig());
 
 	/**
 	 * Adds an event to the buffer.
@@ -172,6 +180,17 @@ public:
 	 */
 	bool IsOverflow();
 
+	/**
+	 * @return the total number of events held across all of the buffers
+	 */
+	size_t Size();
+
+	/**
+	 * @return the total number of events dropped on overflow across all of
+	 * the buffers
+	 */
+	size_t NumDropped();
+
 	/**
 	 * Returns true if the buffer contains any data matching the given
 	 * PointClass.
@@ -237,6 +256,23 @@ public:
 	 */
 	bool IsFull(BufferTypes aType);
 
+	/**
+	 * Returns the number of events restored from the journal when the
+	 * buffer was constructed.
+	 *
+	 * @return				the number of recovered events
+	 */
+	size_t NumRecovered() {
+		return mNumRecovered;
+	}
+
+	/**
+	 * Returns the journal, or NULL if journaling is disabled.
+	 */
+	EventJournal* GetJournal() {
+		return mpJournal.get();
+	}
+
 protected:
 
 	/**
@@ -252,6 +288,14 @@ protected:
 
 private:
 
+	/**
+	 * Loads all live journal records into the event buffers.
+	 */
+	size_t Recover();
+
+	template <class T, class BufferType>
+	void Restore(BufferType& arBuffer, const JournalRecord& arRecord);
+
 	/**
 	 * A buffer for binary events that require ordering based on the
 	 * time of occurrence.
@@ -276,6 +320,10 @@ private:
 	 */
 	InsertionOrderedEventBuffer<VtoEvent> mVtoEvents;
 
+	std::auto_ptr<EventJournal> mpJournal;
+
+	size_t mNumRecovered;
+
 };
 
 }
@@ -231,13 +231,15 @@ void AS_Idle::OnDataUpdate(Slave* c)
 
 	// start the unsol timer or act immediately if there's no pack timer
 	if (!c->mConfig.mDisableUnsol && c->mStartupNullUnsol && c->mRspContext.HasEvents(c->mConfig.mUnsolMask)) {
-		if (c->mConfig.mUnsolPackDelay == 0) {
+		millis_t delay = c->UnsolPackDelay();
+		if (delay <= 0) {
+			c->CancelUnsolTimer();	// anything the timer was waiting for goes out now
 			ChangeState(c, AS_WaitForUnsolSuccess::Inst());
 			c->mRspContext.LoadUnsol(c->mUnsol, c->mIIN, c->mConfig.mUnsolMask);
 			c->SendUnsolicited(c->mUnsol);
 		}
 		else if (c->mpUnsolTimer == NULL) {
-			c->StartUnsolTimer(c->mConfig.mUnsolPackDelay);
+			c->StartUnsolTimer(delay);
 		}
 	}
 }
@@ -0,0 +1,71 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "StatisticsCounters.h"
+
+namespace opendnp3
+{
+
+ChannelStatistics ChannelCounters::Snapshot() const
+{
+	uint64_t values[CC_NUM_COUNTERS];
+	this->Read(values);
+
+	ChannelStatistics stats;
+	stats.mNumFramesRx = values[CC_FRAMES_RX];
+	stats.mNumFramesTx = values[CC_FRAMES_TX];
+	stats.mNumBytesRx = values[CC_BYTES_RX];
+	stats.mNumBytesTx = values[CC_BYTES_TX];
+	stats.mNumCrcErrors = values[CC_CRC_ERRORS];
+	stats.mNumResyncs = values[CC_RESYNCS];
+	stats.mNumUnknownRoute = values[CC_UNKNOWN_ROUTE];
+	stats.mTransmitQueueDepth = values[CC_TRANSMIT_QUEUE_DEPTH];
+	return stats;
+}
+
+StackStatistics StackCounters::Snapshot() const
+{
+	uint64_t values[SC_NUM_COUNTERS];
+	this->Read(values);
+
+	StackStatistics stats;
+	stats.mNumLinkRetries = values[SC_LINK_RETRIES];
+	stats.mNumTransportDrops = values[SC_TRANSPORT_DROPS];
+	stats.mNumAppTimeouts = values[SC_APP_TIMEOUTS];
+	stats.mNumUnsolConfirms = values[SC_UNSOL_CONFIRMS];
+	stats.mNumEventOverflows = values[SC_EVENT_OVERFLOWS];
+	stats.mSendQueueDepth = values[SC_SEND_QUEUE_DEPTH];
+	stats.mEventBufferDepth = values[SC_EVENT_BUFFER_DEPTH];
+	stats.mVtoBytesPerSecond = values[SC_VTO_BYTES_PER_SECOND];
+	stats.mVtoWindowBytes = values[SC_VTO_WINDOW_BYTES];
+	stats.mVtoRoundTripMicros = values[SC_VTO_ROUND_TRIP_MICROS];
+	stats.mUnsolFillPercent = values[SC_UNSOL_FILL_PERCENT];
+	stats.mUnsolPackDelayMillis = values[SC_UNSOL_PACK_DELAY_MILLIS];
+	stats.mNumEventScans = values[SC_EVENT_SCANS];
+	stats.mEventScanPeriodMillis = values[SC_EVENT_SCAN_PERIOD_MILLIS];
+	stats.mNumSuppressedPoints = values[SC_SUPPRESSED_POINTS];
+	stats.mPollSuppressedPoints = values[SC_POLL_SUPPRESSED_POINTS];
+	return stats;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
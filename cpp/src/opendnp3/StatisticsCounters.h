@@ -0,0 +1,144 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __STATISTICS_COUNTERS_H_
+#define __STATISTICS_COUNTERS_H_
+
+#include <opendnp3/Statistics.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include <atomic>
+#include <thread>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace opendnp3
+{
+
+/**
+ A block of counters written from one strand and read from any thread.
+
+ A write is a relaxed load and store of the counter bracketed by an odd/even sequence number,
+ which costs no locked instructions on the hot path. Readers retry until they see the same even
+ sequence before and after copying the counters, so every snapshot is consistent. The block is
+ padded by a cache line on each side so the writer never shares a line with neighbouring data,
+ however the enclosing object happens to be aligned.
+*/
+template <size_t N>
+class CounterBlock : private Uncopyable
+{
+public:
+
+	static const size_t CACHE_LINE_SIZE = 64;
+
+	CounterBlock() : mSequence(0) {
+		for(size_t i = 0; i < N; ++i) mValues[i].store(0, std::memory_order_relaxed);
+	}
+
+	/// Only the strand that owns the block may write to it
+	void Increment(size_t aIndex, uint64_t aAmount = 1) {
+		this->Write(aIndex, mValues[aIndex].load(std::memory_order_relaxed) + aAmount);
+	}
+
+	/// Records a gauge such as a queue depth
+	void Set(size_t aIndex, uint64_t aValue) {
+		this->Write(aIndex, aValue);
+	}
+
+	/// Copies all of the counters as they were between two writes, safe from any thread
+	void Read(uint64_t* apValues) const {
+		for(;;) {
+			uint32_t before = mSequence.load(std::memory_order_acquire);
+			if((before & 1) == 0) {
+				for(size_t i = 0; i < N; ++i) apValues[i] = mValues[i].load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if(mSequence.load(std::memory_order_relaxed) == before) return;
+			}
+			std::this_thread::yield();
+		}
+	}
+
+private:
+
+	void Write(size_t aIndex, uint64_t aValue) {
+		uint32_t seq = mSequence.load(std::memory_order_relaxed);
+		mSequence.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		mValues[aIndex].store(aValue, std::memory_order_relaxed);
+		mSequence.store(seq + 2, std::memory_order_release);
+	}
+
+	char mPadBefore[CACHE_LINE_SIZE];
+	std::atomic<uint32_t> mSequence;
+	std::atomic<uint64_t> mValues[N];
+	char mPadAfter[CACHE_LINE_SIZE];
+};
+
+enum ChannelCounter {
+	CC_FRAMES_RX,
+	CC_FRAMES_TX,
+	CC_BYTES_RX,
+	CC_BYTES_TX,
+	CC_CRC_ERRORS,
+	CC_RESYNCS,
+	CC_UNKNOWN_ROUTE,
+	CC_TRANSMIT_QUEUE_DEPTH,
+	CC_NUM_COUNTERS
+};
+
+/// Counters shared by the router and the frame parser of a channel
+class DLL_LOCAL ChannelCounters : public CounterBlock<CC_NUM_COUNTERS>
+{
+public:
+	ChannelStatistics Snapshot() const;
+};
+
+enum StackCounter {
+	SC_LINK_RETRIES,
+	SC_TRANSPORT_DROPS,
+	SC_APP_TIMEOUTS,
+	SC_UNSOL_CONFIRMS,
+	SC_EVENT_OVERFLOWS,
+	SC_SEND_QUEUE_DEPTH,
+	SC_EVENT_BUFFER_DEPTH,
+	SC_VTO_BYTES_PER_SECOND,
+	SC_VTO_WINDOW_BYTES,
+	SC_VTO_ROUND_TRIP_MICROS,
+	SC_UNSOL_FILL_PERCENT,
+	SC_UNSOL_PACK_DELAY_MILLIS,
+	SC_EVENT_SCANS,
+	SC_EVENT_SCAN_PERIOD_MILLIS,
+	SC_SUPPRESSED_POINTS,
+	SC_POLL_SUPPRESSED_POINTS,
+	SC_NUM_COUNTERS
+};
+
+/// Counters shared by the layers of a master or outstation
+class DLL_LOCAL StackCounters : public CounterBlock<SC_NUM_COUNTERS>
+{
+public:
+	StackStatistics Snapshot() const;
+};
+
+}
+
+#endif
@@ -24,12 +24,18 @@
 
 #include "AsyncTaskGroup.h"
 #include "AsyncTaskContinuous.h"
+#include "AsyncTaskPeriodic.h"
+#include "BusScheduler.h"
 
 namespace opendnp3
 {
 
-TrackingTaskGroup::TrackingTaskGroup(AsyncTaskGroup* apGroup) : mpGroup(apGroup)
-{}
+TrackingTaskGroup::TrackingTaskGroup(AsyncTaskGroup* apGroup, millis_t aBackoff) :
+	mpGroup(apGroup),
+	mpDevice(NULL)
+{
+	if(apGroup->GetScheduler()) mpDevice = apGroup->GetScheduler()->AddDevice(aBackoff);
+}
 
 void TrackingTaskGroup::ResetTasks(int aMask)
 {
@@ -42,11 +48,21 @@ TrackingTaskGroup::~TrackingTaskGroup()
 {
 	//remove all the tasks that were created
 	for(auto pTask: mTaskVec) mpGroup->Remove(pTask);
+	if(mpDevice) mpGroup->GetScheduler()->RemoveDevice(mpDevice);
 }
 
 AsyncTaskBase* TrackingTaskGroup::Add(millis_t aPeriod, millis_t aRetryDelay, int aPriority, const TaskHandler& arCallback, const std::string& arName)
 {
 	AsyncTaskBase* pTask = mpGroup->Add(aPeriod, aRetryDelay, aPriority, arCallback, arName);
+	pTask->SetDevice(mpDevice);
+	mTaskVec.push_back(pTask);
+	return pTask;
+}
+
+AsyncTaskPeriodic* TrackingTaskGroup::AddPeriodic(millis_t aPeriod, millis_t aRetryDelay, int aPriority, const TaskHandler& arCallback, const std::string& arName)
+{
+	AsyncTaskPeriodic* pTask = mpGroup->AddPeriodic(aPeriod, aRetryDelay, aPriority, arCallback, arName);
+	pTask->SetDevice(mpDevice);
 	mTaskVec.push_back(pTask);
 	return pTask;
 }
@@ -54,6 +70,7 @@ AsyncTaskBase* TrackingTaskGroup::Add(millis_t aPeriod, millis_t aRetryDelay, in
 AsyncTaskContinuous* TrackingTaskGroup::AddContinuous(int aPriority, const TaskHandler& arCallback, const std::string& arName)
 {
 	AsyncTaskContinuous* pTask = mpGroup->AddContinuous(aPriority, arCallback, arName);
+	pTask->SetDevice(mpDevice);
 	mTaskVec.push_back(pTask);
 	return pTask;
 }
@@ -44,7 +44,9 @@ namespace opendnp3
 
 class AsyncTaskGroup;
 class AsyncTaskContinuous;
+class AsyncTaskPeriodic;
 class AsyncTaskBase;
+class BusDevice;
 
 /**
  Tracks all tasks that are created and releases them on destruction
@@ -54,18 +56,24 @@ class DLL_LOCAL TrackingTaskGroup
 
 public:
 
-	TrackingTaskGroup(AsyncTaskGroup* apGroup);
+	/**
+		@param apGroup Group the tasks are created in
+		@param aBackoff If the group has a bus scheduler, the tasks are registered as a device with this initial backoff in milliseconds
+	*/
+	TrackingTaskGroup(AsyncTaskGroup* apGroup, millis_t aBackoff = 0);
 	~TrackingTaskGroup();
 
 	void ResetTasks(int aMask);
 
 	AsyncTaskBase* Add(millis_t aPeriod, millis_t aRetryDelay, int aPriority, const TaskHandler& arCallback, const std::string& arName = "");
+	AsyncTaskPeriodic* AddPeriodic(millis_t aPeriod, millis_t aRetryDelay, int aPriority, const TaskHandler& arCallback, const std::string& arName = "");
 	AsyncTaskContinuous* AddContinuous(int aPriority, const TaskHandler& arCallback, const std::string& arName = "");
 
 
 private:
 
 	AsyncTaskGroup* mpGroup;
+	BusDevice* mpDevice;
 
 	typedef std::vector<AsyncTaskBase*> TaskVec;
 	TaskVec mTaskVec;
@@ -51,6 +51,17 @@ public:
 	TransportLayer(Logger* apLogger, size_t aFragSize = DEFAULT_FRAG_SIZE);
 	virtual ~TransportLayer() {}
 
+	/// Optional counters for dropped segments, owned by the stack
+	void SetCounters(StackCounters* apCounters) {
+		mReceiver.SetCounters(apCounters);
+	}
+
+	/// Optional latency trace, owned by the stack
+	void SetLatencyTrace(LatencyTrace* apTrace) {
+		mReceiver.SetLatencyTrace(apTrace);
+		mTransmitter.SetLatencyTrace(apTrace);
+	}
+
 	/* Actions - Taken by the states/transmitter/receiver in response to events */
 
 	void ThisLayerUp();
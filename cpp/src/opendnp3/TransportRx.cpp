@@ -41,6 +41,8 @@ namespace opendnp3
 TransportRx::TransportRx(Logger* apLogger, TransportLayer* apContext, size_t aFragSize) :
 	Loggable(apLogger),
 	mpContext(apContext),
+	mpCounters(NULL),
+	mpTrace(NULL),
 	mBuffer(aFragSize),
 	mNumBytesRead(0),
 	mSeq(0)
@@ -58,6 +60,7 @@ void TransportRx::HandleReceive(const uint8_t* apData, size_t aNumBytes)
 {
 	switch(aNumBytes) {
 	case(1):
+		this->CountDrop();
 		ERROR_BLOCK(LEV_WARNING, "Received tpdu with no payload", TLERR_NO_PAYLOAD);
 		return;
 	case(0):
@@ -77,10 +80,12 @@ void TransportRx::HandleReceive(const uint8_t* apData, size_t aNumBytes)
 
 	if(this->ValidateHeader(first, last, seq, payload_len)) {
 		if(BufferRemaining() < payload_len) {
+			this->CountDrop();
 			ERROR_BLOCK(LEV_WARNING, "Exceeded the buffer size before a complete fragment was read", TLERR_BUFFER_FULL);
 			mNumBytesRead = 0;
 		}
 		else { //passed all validation
+			if(first) LATENCY_TRACE(mpTrace, OnFirstSegment());
 			memcpy(mBuffer + mNumBytesRead, apData + 1, payload_len);
 			mNumBytesRead += payload_len;
 			mSeq = (mSeq + 1) % 64;
@@ -88,6 +93,7 @@ void TransportRx::HandleReceive(const uint8_t* apData, size_t aNumBytes)
 			if(last) {
 				size_t tmp = mNumBytesRead;
 				mNumBytesRead = 0;
+				LATENCY_TRACE(mpTrace, OnApduReceived(timer_clock::now()));
 				mpContext->ReceiveAPDU(mBuffer, tmp);
 			}
 		}
@@ -104,22 +110,26 @@ bool TransportRx::ValidateHeader(bool aFir, bool aFin, int aSeq, size_t aPayload
 			/*  2004-03-29_DNP3_Doc_Library.pdf: 2-2 Page 64.
 				When a secondary station receives a frame with the FIR bit set,
 				all previously received unterminated frame sequences are discarded. */
+			this->CountDrop();
 			ERROR_BLOCK(LEV_WARNING, "FIR received mid-fragment, discarding: " << mNumBytesRead << "bytes", TLERR_NEW_FIR);
 			mNumBytesRead = 0;
 		}
 	}
 	else if(mNumBytesRead == 0) { //non-first packet with 0 prior bytes
+		this->CountDrop();
 		ERROR_BLOCK(LEV_WARNING, "non-FIR packet with 0 prior bytes", TLERR_MESSAGE_WITHOUT_FIR);
 		return false;
 	}
 
 	if(!aFin && aPayloadSize != TL_MAX_TPDU_PAYLOAD) {
 		//if it's not a FIN packet it should have a length of
+		this->CountDrop();
 		ERROR_BLOCK(LEV_WARNING, "Partial non-FIN frame, payload= " << aPayloadSize, TLERR_BAD_LENGTH);
 		return false;
 	}
 
 	if(aSeq != mSeq) {
+		this->CountDrop();
 		ERROR_BLOCK(LEV_WARNING, "Ignoring bad sequence, got: " << aSeq << " expected: " << mSeq, TLERR_BAD_SEQUENCE);
 		return false;
 	}
@@ -35,6 +35,8 @@
 
 #include "Loggable.h"
 #include "CopyableBuffer.h"
+#include "StatisticsCounters.h"
+#include "LatencyTrace.h"
 
 namespace opendnp3
 {
@@ -53,11 +55,25 @@ public:
 
 	void Reset();
 
+	void SetCounters(StackCounters* apCounters) {
+		mpCounters = apCounters;
+	}
+
+	void SetLatencyTrace(LatencyTrace* apTrace) {
+		mpTrace = apTrace;
+	}
+
 private:
 
 	bool ValidateHeader(bool aFir, bool aFin, int aSeq, size_t aPayloadSize);
 
+	void CountDrop() {
+		if(mpCounters) mpCounters->Increment(SC_TRANSPORT_DROPS);
+	}
+
 	TransportLayer* mpContext;
+	StackCounters* mpCounters;
+	LatencyTrace* mpTrace;
 
 	CopyableBuffer mBuffer;
 	size_t mNumBytesRead;
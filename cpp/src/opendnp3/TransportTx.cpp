@@ -40,6 +40,7 @@ namespace opendnp3
 TransportTx::TransportTx(Logger* apLogger, TransportLayer* apContext, size_t aFragSize) :
 	Loggable(apLogger),
 	mpContext(apContext),
+	mpTrace(NULL),
 	mBufferAPDU(aFragSize),
 	mBufferTPDU(TL_MAX_TPDU_LENGTH),
 	mNumBytesSent(0),
@@ -56,6 +57,7 @@ void TransportTx::Send(const uint8_t* apData, size_t aNumBytes)
 	mNumBytesToSend = aNumBytes;
 	mNumBytesSent = 0;
 
+	LATENCY_TRACE(mpTrace, OnTransportSend(timer_clock::now()));
 	this->CheckForSend();
 }
 
@@ -73,6 +75,7 @@ bool TransportTx::CheckForSend()
 
 		mBufferTPDU[0] = GetHeader(fir, fin, mSeq);
 		LOG_BLOCK(LEV_INTERPRET, "-> " << TransportLayer::ToString(mBufferTPDU[0]));
+		if(fin) LATENCY_TRACE(mpTrace, OnFinalSegment());
 		mpContext->TransmitTPDU(mBufferTPDU, num_to_send + 1);
 		return false;
 	}
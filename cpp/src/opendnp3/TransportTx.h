@@ -35,6 +35,7 @@
 
 #include "Loggable.h"
 #include "CopyableBuffer.h"
+#include "LatencyTrace.h"
 
 namespace opendnp3
 {
@@ -53,6 +54,9 @@ public:
 	void Send(const uint8_t*, size_t); // A fresh call to Send() will reset the state
 	bool SendSuccess();
 
+	void SetLatencyTrace(LatencyTrace* apTrace) {
+		mpTrace = apTrace;
+	}
 
 	static uint8_t GetHeader(bool aFir, bool aFin, int aSeq);
 
@@ -61,6 +65,7 @@ private:
 	bool CheckForSend();
 
 	TransportLayer* mpContext;
+	LatencyTrace* mpTrace;
 
 	CopyableBuffer mBufferAPDU;
 	CopyableBuffer mBufferTPDU;
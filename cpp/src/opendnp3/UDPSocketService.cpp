@@ -0,0 +1,328 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "UDPSocketService.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Logger.h>
+
+#include "LoggableMacros.h"
+#include "PhysicalLayerAsyncUDP.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <errno.h>
+#include <string.h>
+#endif
+
+using namespace boost;
+using namespace boost::asio;
+using namespace boost::system;
+
+namespace opendnp3
+{
+
+const int32_t UDPSocketService::ANY_LINK_ADDRESS;
+const size_t UDPSocketService::BATCH_SIZE;
+const size_t UDPSocketService::MAX_DATAGRAM;
+
+// bounds how long one wakeup keeps the strand when datagrams keep arriving
+const size_t MAX_BATCHES_PER_WAKEUP = 16;
+
+UDPSocketService::UDPSocketService(Logger* apLogger, boost::asio::io_service* apService, const ip::udp::endpoint& arLocal, size_t aReceiveBufferSize) :
+	Loggable(apLogger),
+	mLocal(arLocal),
+	mReceiveBufferSize(aReceiveBufferSize),
+	mStrand(*apService),
+	mSocket(*apService),
+	mFlushPending(false),
+	mIsShutdown(false),
+	mNumDropped(0),
+	mBuffers(BATCH_SIZE * MAX_DATAGRAM),
+	mSizes(BATCH_SIZE),
+	mSenders(BATCH_SIZE)
+{
+#ifdef __linux__
+	mReceiveHeaders.resize(BATCH_SIZE);
+	mReceiveVectors.resize(BATCH_SIZE);
+	mSendHeaders.resize(BATCH_SIZE);
+	mSendVectors.resize(BATCH_SIZE);
+
+	// the receive side always points at the same buffers, only the lengths are reset
+	memset(&mReceiveHeaders[0], 0, BATCH_SIZE * sizeof(mmsghdr));
+	for(size_t i = 0; i < BATCH_SIZE; ++i) {
+		mReceiveVectors[i].iov_base = &mBuffers[i * MAX_DATAGRAM];
+		mReceiveVectors[i].iov_len = MAX_DATAGRAM;
+		mReceiveHeaders[i].msg_hdr.msg_name = mSenders[i].data();
+		mReceiveHeaders[i].msg_hdr.msg_iov = &mReceiveVectors[i];
+		mReceiveHeaders[i].msg_hdr.msg_iovlen = 1;
+	}
+#endif
+}
+
+UDPSocketService::~UDPSocketService()
+{
+	this->Shutdown();
+}
+
+error_code UDPSocketService::Register(PhysicalLayerAsyncUDP* apLayer, const ip::udp::endpoint& arRemote, int32_t aLinkAddress)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	if(mIsShutdown) return error::operation_aborted;
+
+	if(!mSocket.is_open()) {
+		error_code ec = this->Bind();
+		if(ec) return ec;
+	}
+
+	Route route(arRemote, aLinkAddress);
+	if(mRoutes.find(route) != mRoutes.end()) return error::address_in_use;
+
+	mRoutes[route] = apLayer;
+	return error_code();
+}
+
+void UDPSocketService::Unregister(const ip::udp::endpoint& arRemote, int32_t aLinkAddress)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mRoutes.erase(Route(arRemote, aLinkAddress));
+}
+
+void UDPSocketService::Send(const uint8_t* apData, size_t aSize, const ip::udp::endpoint& arDest, const SendHandler& arHandler)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	if(mIsShutdown) {
+		mStrand.post(std::bind(arHandler, error_code(error::operation_aborted)));
+		return;
+	}
+
+	Outgoing datagram = { apData, aSize, arDest, arHandler };
+	mSendQueue.push_back(datagram);
+
+	// everything queued before the flush runs goes out together
+	if(!mFlushPending) {
+		mFlushPending = true;
+		mStrand.post(std::bind(&UDPSocketService::Flush, this));
+	}
+}
+
+void UDPSocketService::Shutdown()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	if(mIsShutdown) return;
+	mIsShutdown = true;
+
+	error_code ec;
+	mSocket.close(ec);
+
+	for(auto& datagram : mSendQueue) mStrand.post(std::bind(datagram.mHandler, error_code(error::operation_aborted)));
+	mSendQueue.clear();
+}
+
+error_code UDPSocketService::Bind()
+{
+	error_code ec;
+	mSocket.open(mLocal.protocol(), ec);
+	if(ec) return ec;
+
+	mSocket.bind(mLocal, ec);
+	if(!ec) mSocket.non_blocking(true, ec);
+	if(ec) {
+		error_code ignored;
+		mSocket.close(ignored);
+		return ec;
+	}
+
+	// a burst of replies from many outstations arrives at once, the kernel caps this at its own maximum
+	error_code ignored;
+	mSocket.set_option(socket_base::receive_buffer_size(static_cast<int>(mReceiveBufferSize)), ignored);
+
+	LOG_BLOCK(LEV_INFO, "Bound UDP socket to: " << mLocal);
+
+	mStrand.post([this]() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		if(!mIsShutdown) this->BeginReceive();
+	});
+
+	return error_code();
+}
+
+void UDPSocketService::BeginReceive()
+{
+	mSocket.async_receive(null_buffers(), mStrand.wrap(std::bind(&UDPSocketService::OnReadable, this, std::placeholders::_1)));
+}
+
+void UDPSocketService::OnReadable(const error_code& arError)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	if(mIsShutdown) return;
+	if(arError) LOG_BLOCK(LEV_WARNING, "Error waiting on UDP socket: " << arError.message());
+
+	for(size_t i = 0; i < MAX_BATCHES_PER_WAKEUP; ++i) {
+		size_t num = this->ReceiveBatch();
+		for(size_t j = 0; j < num; ++j) this->Deliver(&mBuffers[j * MAX_DATAGRAM], mSizes[j], mSenders[j]);
+		if(num < BATCH_SIZE) break;
+	}
+
+	this->BeginReceive();
+}
+
+size_t UDPSocketService::ReceiveBatch()
+{
+#ifdef __linux__
+	for(size_t i = 0; i < BATCH_SIZE; ++i) {
+		mReceiveHeaders[i].msg_hdr.msg_namelen = static_cast<socklen_t>(mSenders[i].capacity());
+		mReceiveHeaders[i].msg_hdr.msg_flags = 0;
+	}
+
+	int num = recvmmsg(mSocket.native_handle(), &mReceiveHeaders[0], BATCH_SIZE, MSG_DONTWAIT, NULL);
+	if(num < 0) {
+		if(errno != EAGAIN && errno != EWOULDBLOCK) LOG_BLOCK(LEV_WARNING, "Error receiving datagrams: " << strerror(errno));
+		return 0;
+	}
+
+	for(int i = 0; i < num; ++i) {
+		mSenders[i].resize(mReceiveHeaders[i].msg_hdr.msg_namelen);
+		// a datagram that didn't fit can't hold a valid frame
+		mSizes[i] = (mReceiveHeaders[i].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : mReceiveHeaders[i].msg_len;
+	}
+
+	return static_cast<size_t>(num);
+#else
+	size_t num = 0;
+	while(num < BATCH_SIZE) {
+		error_code ec;
+		size_t size = mSocket.receive_from(buffer(&mBuffers[num * MAX_DATAGRAM], MAX_DATAGRAM), mSenders[num], 0, ec);
+		if(ec) {
+			if(ec != error::would_block) LOG_BLOCK(LEV_WARNING, "Error receiving datagrams: " << ec.message());
+			break;
+		}
+		mSizes[num++] = size;
+	}
+	return num;
+#endif
+}
+
+void UDPSocketService::Deliver(const uint8_t* apData, size_t aSize, const ip::udp::endpoint& arSender)
+{
+	if(aSize == 0) {
+		++mNumDropped;
+		return;
+	}
+
+	auto iter = mRoutes.end();
+
+	// the addresses sit at fixed offsets after the 0x05 0x64 start bytes
+	if(aSize >= 10 && apData[0] == 0x05 && apData[1] == 0x64) {
+		int32_t dest = apData[4] | (apData[5] << 8);
+		int32_t src = apData[6] | (apData[7] << 8);
+		iter = mRoutes.find(Route(arSender, src));
+		if(iter == mRoutes.end()) iter = mRoutes.find(Route(arSender, dest));
+	}
+
+	if(iter == mRoutes.end()) iter = mRoutes.find(Route(arSender, ANY_LINK_ADDRESS));
+
+	if(iter == mRoutes.end()) {
+		++mNumDropped;
+		LOG_BLOCK(LEV_DEBUG, "Dropping datagram from unknown sender: " << arSender);
+	}
+	else {
+		iter->second->OnDatagram(apData, aSize);
+	}
+}
+
+void UDPSocketService::Flush()
+{
+	std::vector< std::pair<SendHandler, error_code> > completed;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFlushPending = false;
+
+		while(!mSendQueue.empty() && !mIsShutdown) {
+			error_code ec;
+			size_t num = this->SendBatch(std::min(mSendQueue.size(), BATCH_SIZE), ec);
+
+			for(size_t i = 0; i < num; ++i) {
+				completed.push_back(std::make_pair(mSendQueue.front().mHandler, error_code()));
+				mSendQueue.pop_front();
+			}
+
+			if(ec == error::would_block || ec == error::try_again) {
+				// finish the queue once the kernel has room, sends keep queueing behind it
+				mFlushPending = true;
+				mSocket.async_send(null_buffers(), mStrand.wrap(std::bind(&UDPSocketService::OnWritable, this, std::placeholders::_1)));
+				break;
+			}
+			else if(ec) {
+				completed.push_back(std::make_pair(mSendQueue.front().mHandler, ec));
+				mSendQueue.pop_front();
+			}
+		}
+	}
+
+	for(auto& pair : completed) pair.first(pair.second);
+}
+
+size_t UDPSocketService::SendBatch(size_t aNum, error_code& arError)
+{
+#ifdef __linux__
+	for(size_t i = 0; i < aNum; ++i) {
+		Outgoing& datagram = mSendQueue[i];
+		mSendVectors[i].iov_base = const_cast<uint8_t*>(datagram.mpData);
+		mSendVectors[i].iov_len = datagram.mSize;
+		memset(&mSendHeaders[i], 0, sizeof(mmsghdr));
+		mSendHeaders[i].msg_hdr.msg_name = datagram.mDest.data();
+		mSendHeaders[i].msg_hdr.msg_namelen = static_cast<socklen_t>(datagram.mDest.size());
+		mSendHeaders[i].msg_hdr.msg_iov = &mSendVectors[i];
+		mSendHeaders[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	int num = sendmmsg(mSocket.native_handle(), &mSendHeaders[0], static_cast<unsigned>(aNum), MSG_DONTWAIT | MSG_NOSIGNAL);
+	if(num < 0) {
+		arError = error_code(errno, system_category());
+		return 0;
+	}
+	return static_cast<size_t>(num);
+#else
+	for(size_t i = 0; i < aNum; ++i) {
+		Outgoing& datagram = mSendQueue[i];
+		mSocket.send_to(buffer(datagram.mpData, datagram.mSize), datagram.mDest, 0, arError);
+		if(arError) return i;
+	}
+	return aNum;
+#endif
+}
+
+void UDPSocketService::OnWritable(const error_code& arError)
+{
+	if(arError && arError != error::operation_aborted) LOG_BLOCK(LEV_WARNING, "Error waiting on UDP socket: " << arError.message());
+	this->Flush();
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,139 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __UDP_SOCKET_SERVICE_H_
+#define __UDP_SOCKET_SERVICE_H_
+
+#include <boost/asio.hpp>
+
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Location.h>
+
+#include "Loggable.h"
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
+namespace opendnp3
+{
+
+class PhysicalLayerAsyncUDP;
+
+/**
+A UDP socket bound to one local endpoint and shared by every channel that uses
+that endpoint, so a master polling thousands of outstations holds one socket
+instead of one per outstation.
+
+Received datagrams are routed to the layer registered for the sender's
+endpoint. Several layers can share a remote endpoint, e.g. outstations behind
+one gateway, by registering the outstation's link address. A frame is routed
+by its source address, then its destination address, then to a layer that
+registered without an address.
+
+On Linux datagrams are read with recvmmsg and written with sendmmsg, so a
+burst from many channels costs one system call per batch.
+*/
+class DLL_LOCAL UDPSocketService : public Loggable, private Uncopyable
+{
+public:
+
+	typedef std::function<void (const boost::system::error_code&)> SendHandler;
+
+	// Registered address that matches any frame from the remote endpoint
+	static const int32_t ANY_LINK_ADDRESS = -1;
+
+	UDPSocketService(Logger* apLogger, boost::asio::io_service* apService, const boost::asio::ip::udp::endpoint& arLocal, size_t aReceiveBufferSize = 1 << 22);
+	~UDPSocketService();
+
+	// Binds the socket on first use. Fails if the bind fails or the route is already taken.
+	boost::system::error_code Register(PhysicalLayerAsyncUDP* apLayer, const boost::asio::ip::udp::endpoint& arRemote, int32_t aLinkAddress);
+	void Unregister(const boost::asio::ip::udp::endpoint& arRemote, int32_t aLinkAddress);
+
+	// Queues a datagram. The buffer must stay valid until the handler is called.
+	void Send(const uint8_t* apData, size_t aSize, const boost::asio::ip::udp::endpoint& arDest, const SendHandler& arHandler);
+
+	// Close the socket so the io_service can run out of work
+	void Shutdown();
+
+	size_t GetNumDropped() const {
+		return mNumDropped;
+	}
+
+	static const size_t BATCH_SIZE = 64;
+	static const size_t MAX_DATAGRAM = 2048;
+
+private:
+
+	typedef std::pair<boost::asio::ip::udp::endpoint, int32_t> Route;
+
+	struct Outgoing {
+		const uint8_t* mpData;
+		size_t mSize;
+		boost::asio::ip::udp::endpoint mDest;
+		SendHandler mHandler;
+	};
+
+	boost::system::error_code Bind();
+
+	void BeginReceive();
+	void OnReadable(const boost::system::error_code& arError);
+	size_t ReceiveBatch();
+	void Deliver(const uint8_t* apData, size_t aSize, const boost::asio::ip::udp::endpoint& arSender);
+
+	void Flush();
+	size_t SendBatch(size_t aNum, boost::system::error_code& arError);
+	void OnWritable(const boost::system::error_code& arError);
+
+	boost::asio::ip::udp::endpoint mLocal;
+	size_t mReceiveBufferSize;
+	boost::asio::strand mStrand;
+	boost::asio::ip::udp::socket mSocket;
+
+	// guards the socket, the routes and the send queue
+	std::mutex mMutex;
+	std::map<Route, PhysicalLayerAsyncUDP*> mRoutes;
+	std::deque<Outgoing> mSendQueue;
+	bool mFlushPending;
+	bool mIsShutdown;
+	size_t mNumDropped;
+
+	std::vector<uint8_t> mBuffers;
+	std::vector<size_t> mSizes;
+	std::vector<boost::asio::ip::udp::endpoint> mSenders;
+
+#ifdef __linux__
+	std::vector<mmsghdr> mReceiveHeaders;
+	std::vector<iovec> mReceiveVectors;
+	std::vector<mmsghdr> mSendHeaders;
+	std::vector<iovec> mSendVectors;
+#endif
+};
+
+}
+
+#endif
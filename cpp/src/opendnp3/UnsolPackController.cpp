@@ -0,0 +1,127 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "UnsolPackController.h"
+
+#include <opendnp3/Util.h>
+
+#include <cmath>
+
+namespace opendnp3
+{
+
+const millis_t UnsolPackController::RATE_TIME_CONSTANT;
+const size_t UnsolPackController::DEFAULT_BYTES_PER_EVENT;
+
+// control, function code, and IIN of a response
+const size_t UNSOL_HEADER_SIZE = 4;
+
+UnsolPackController::UnsolPackController(size_t aFragmentSize, millis_t aMaxLatency) :
+	mFragmentSize(aFragmentSize),
+	mMaxLatency(aMaxLatency),
+	mHaveRate(false),
+	mRate(0),
+	mBytesPerEvent(static_cast<double>(DEFAULT_BYTES_PER_EVENT)),
+	mFillRatio(0),
+	mHaveFill(false),
+	mSent(false),
+	mRoundTripMicros(0),
+	mLastDelay(0)
+{}
+
+void UnsolPackController::OnEvents(size_t aNum, timer_clock::time_point aTime)
+{
+	this->Decay(aTime);
+	mRate += static_cast<double>(aNum) / RATE_TIME_CONSTANT;
+}
+
+void UnsolPackController::OnSent(size_t aNumBytes, size_t aNumEvents, timer_clock::time_point aTime)
+{
+	mSent = true;
+	mSentTime = aTime;
+
+	double fill = static_cast<double>(aNumBytes) / static_cast<double>(mFragmentSize);
+	mFillRatio = mHaveFill ? (7 * mFillRatio + fill) / 8 : fill;
+	mHaveFill = true;
+
+	// object headers are shared out over the events, which is what filling a fragment costs
+	if(aNumEvents > 0 && aNumBytes > UNSOL_HEADER_SIZE) {
+		double perEvent = static_cast<double>(aNumBytes - UNSOL_HEADER_SIZE) / static_cast<double>(aNumEvents);
+		mBytesPerEvent = (7 * mBytesPerEvent + perEvent) / 8;
+	}
+}
+
+void UnsolPackController::OnConfirmed(timer_clock::time_point aTime)
+{
+	if(!mSent) return;
+	mSent = false;
+
+	uint64_t sample = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(aTime - mSentTime).count());
+	mRoundTripMicros = (mRoundTripMicros == 0) ? sample : (7 * mRoundTripMicros + sample) / 8;
+}
+
+void UnsolPackController::OnFailure()
+{
+	mSent = false;
+}
+
+millis_t UnsolPackController::PackDelay(size_t aNumPending, timer_clock::time_point aTime)
+{
+	this->Decay(aTime);
+	mLastDelay = 0;
+
+	double capacity = static_cast<double>(mFragmentSize - Min<size_t>(mFragmentSize, UNSOL_HEADER_SIZE));
+	double needed = capacity / mBytesPerEvent - static_cast<double>(aNumPending);
+	millis_t budget = mMaxLatency - static_cast<millis_t>(mRoundTripMicros / 2000);
+
+	if(needed > 0 && mRate > 0 && budget > 0) {
+		double wait = Min<double>(needed / mRate, static_cast<double>(budget));
+		if(mRate * wait >= 1) mLastDelay = static_cast<millis_t>(std::ceil(wait));
+	}
+
+	return mLastDelay;
+}
+
+uint64_t UnsolPackController::FillPercent() const
+{
+	return static_cast<uint64_t>(mFillRatio * 100 + 0.5);
+}
+
+double UnsolPackController::EventsPerSecond(timer_clock::time_point aTime)
+{
+	this->Decay(aTime);
+	return mRate * 1000;
+}
+
+void UnsolPackController::Decay(timer_clock::time_point aTime)
+{
+	if(mHaveRate && aTime > mRateTime) {
+		double elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(aTime - mRateTime).count()) / 1000;
+		mRate *= std::exp(-elapsed / RATE_TIME_CONSTANT);
+	}
+
+	if(!mHaveRate || aTime > mRateTime) mRateTime = aTime;
+	mHaveRate = true;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,127 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __UNSOL_PACK_CONTROLLER_H_
+#define __UNSOL_PACK_CONTROLLER_H_
+
+#include <opendnp3/Clock.h>
+#include <opendnp3/Types.h>
+#include <opendnp3/Visibility.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace opendnp3
+{
+
+/**
+ * Chooses the unsolicited pack delay from the recent event arrival rate
+ * instead of using a fixed SlaveConfig::mUnsolPackDelay.
+ *
+ * The delay is the time needed for the arrival rate to fill the rest of a
+ * fragment, at the average size of the events already reported. It is
+ * capped so that an event reaches the master within the latency ceiling,
+ * allowing half of the smoothed confirm round trip for the trip to the
+ * master. If not even one more event is expected within that time, waiting
+ * can't improve the fragment and the delay is zero, so a lightly loaded
+ * outstation reports immediately.
+ */
+class DLL_LOCAL UnsolPackController
+{
+public:
+
+	/**
+	 * @param aFragmentSize		the maximum size of an unsolicited fragment
+	 * @param aMaxLatency		the latency ceiling for an event
+	 */
+	UnsolPackController(size_t aFragmentSize, millis_t aMaxLatency);
+
+	/// aNum events were buffered at aTime
+	void OnEvents(size_t aNum, timer_clock::time_point aTime);
+
+	/// An unsolicited fragment of aNumBytes carrying aNumEvents events was sent at aTime
+	void OnSent(size_t aNumBytes, size_t aNumEvents, timer_clock::time_point aTime);
+
+	/// The master confirmed the last unsolicited fragment
+	void OnConfirmed(timer_clock::time_point aTime);
+
+	/// The last unsolicited fragment was not confirmed
+	void OnFailure();
+
+	/**
+	 * Chooses how long to wait before the next unsolicited response
+	 *
+	 * @param aNumPending	the number of events already buffered
+	 * @param aTime			the current time
+	 * @return				the delay in milliseconds, 0 to send immediately
+	 */
+	millis_t PackDelay(size_t aNumPending, timer_clock::time_point aTime);
+
+	/// @return the delay chosen by the last call to PackDelay()
+	millis_t LastDelay() const {
+		return mLastDelay;
+	}
+
+	/// @return the smoothed fraction of each unsolicited fragment that was used, in percent
+	uint64_t FillPercent() const;
+
+	/// @return the smoothed confirm round trip time, 0 until it has been measured
+	uint64_t RoundTripMicros() const {
+		return mRoundTripMicros;
+	}
+
+	/// @return the recent arrival rate in events per second
+	double EventsPerSecond(timer_clock::time_point aTime);
+
+	/// The arrival rate decays with this time constant
+	static const millis_t RATE_TIME_CONSTANT = 1000;
+
+	/// Assumed bytes per event until the first fragment has been sent
+	static const size_t DEFAULT_BYTES_PER_EVENT = 8;
+
+private:
+
+	// decays the arrival rate to aTime
+	void Decay(timer_clock::time_point aTime);
+
+	const size_t mFragmentSize;
+	const millis_t mMaxLatency;
+
+	bool mHaveRate;
+	timer_clock::time_point mRateTime;
+	double mRate;				// events per millisecond
+
+	double mBytesPerEvent;
+	double mFillRatio;
+	bool mHaveFill;
+
+	bool mSent;
+	timer_clock::time_point mSentTime;
+	uint64_t mRoundTripMicros;
+
+	millis_t mLastDelay;
+};
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
@@ -0,0 +1,412 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "UringService.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/Location.h>
+#include <opendnp3/Logger.h>
+
+#include "LoggableMacros.h"
+
+#include <algorithm>
+#include <string.h>
+#include <errno.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+using namespace boost;
+using namespace boost::asio;
+
+namespace opendnp3
+{
+
+const size_t UringService::NO_BUFFER = static_cast<size_t>(-1);
+
+UringService::UringService(Logger* apLogger, boost::asio::io_service* apService, size_t aNumEntries, size_t aNumBuffers) :
+	Loggable(apLogger),
+	mpService(apService),
+	mRingFd(-1),
+	mEventFd(-1),
+	mpSqRing(MAP_FAILED),
+	mSqRingSize(0),
+	mpCqRing(MAP_FAILED),
+	mCqRingSize(0),
+	mpEntries(static_cast<io_uring_sqe*>(MAP_FAILED)),
+	mEntriesSize(0),
+	mNumQueued(0),
+	mFlushPending(false),
+	mStrand(*apService),
+	mEventDescriptor(*apService),
+	mEventCount(0),
+	mIsShutdown(false)
+{
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+
+	mRingFd = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(aNumEntries), &params));
+	if(mRingFd < 0) MACRO_THROW_EXCEPTION(Exception, std::string("io_uring_setup failed: ") + strerror(errno));
+
+	mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	mCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	if(params.features & IORING_FEAT_SINGLE_MMAP) mSqRingSize = mCqRingSize = std::max(mSqRingSize, mCqRingSize);
+
+	mpSqRing = mmap(NULL, mSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_SQ_RING);
+	if(mpSqRing != MAP_FAILED) {
+		mpCqRing = (params.features & IORING_FEAT_SINGLE_MMAP) ? mpSqRing :
+		           mmap(NULL, mCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_CQ_RING);
+	}
+	if(mpCqRing != MAP_FAILED) {
+		mEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+		mpEntries = static_cast<io_uring_sqe*>(mmap(NULL, mEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_SQES));
+	}
+	if(mpEntries == MAP_FAILED) {
+		int error = errno;
+		this->Release();
+		MACRO_THROW_EXCEPTION(Exception, std::string("Unable to map io_uring: ") + strerror(error));
+	}
+
+	uint8_t* pSq = static_cast<uint8_t*>(mpSqRing);
+	mpSqHead = reinterpret_cast<unsigned*>(pSq + params.sq_off.head);
+	mpSqTail = reinterpret_cast<unsigned*>(pSq + params.sq_off.tail);
+	mSqMask = *reinterpret_cast<unsigned*>(pSq + params.sq_off.ring_mask);
+	mSqCapacity = *reinterpret_cast<unsigned*>(pSq + params.sq_off.ring_entries);
+	mpSqArray = reinterpret_cast<unsigned*>(pSq + params.sq_off.array);
+	mpSqFlags = reinterpret_cast<unsigned*>(pSq + params.sq_off.flags);
+
+	uint8_t* pCq = static_cast<uint8_t*>(mpCqRing);
+	mpCqHead = reinterpret_cast<unsigned*>(pCq + params.cq_off.head);
+	mpCqTail = reinterpret_cast<unsigned*>(pCq + params.cq_off.tail);
+	mCqMask = *reinterpret_cast<unsigned*>(pCq + params.cq_off.ring_mask);
+	mpCompletions = reinterpret_cast<io_uring_cqe*>(pCq + params.cq_off.cqes);
+
+	mEventFd = eventfd(0, EFD_CLOEXEC);
+	if(mEventFd < 0 || syscall(__NR_io_uring_register, mRingFd, IORING_REGISTER_EVENTFD, &mEventFd, 1) < 0) {
+		int error = errno;
+		this->Release();
+		MACRO_THROW_EXCEPTION(Exception, std::string("Unable to register io_uring eventfd: ") + strerror(error));
+	}
+
+	// Sparse tables need Linux 5.19, the layers fall back to plain receives on
+	// older kernels or once every slot is reserved
+	if(aNumBuffers > 0) {
+		io_uring_rsrc_register table;
+		memset(&table, 0, sizeof(table));
+		table.nr = static_cast<uint32_t>(aNumBuffers);
+		table.flags = IORING_RSRC_REGISTER_SPARSE;
+		if(syscall(__NR_io_uring_register, mRingFd, IORING_REGISTER_BUFFERS2, &table, sizeof(table)) < 0) {
+			LOG_BLOCK(LEV_WARNING, "Unable to register io_uring buffer table: " << strerror(errno));
+		}
+		else {
+			for(size_t i = aNumBuffers; i > 0; --i) mFreeBuffers.push_back(i - 1);
+		}
+	}
+
+	mEventDescriptor.assign(mEventFd);
+	this->BeginWait();
+}
+
+UringService::~UringService()
+{
+	boost::system::error_code ec;
+	mEventDescriptor.close(ec);
+	mEventFd = -1;
+	this->Release();
+}
+
+void UringService::Release()
+{
+	if(mpEntries != MAP_FAILED) munmap(mpEntries, mEntriesSize);
+	if(mpCqRing != MAP_FAILED && mpCqRing != mpSqRing) munmap(mpCqRing, mCqRingSize);
+	if(mpSqRing != MAP_FAILED) munmap(mpSqRing, mSqRingSize);
+	if(mEventFd >= 0) close(mEventFd);
+	if(mRingFd >= 0) close(mRingFd);
+}
+
+size_t UringService::AcquireBuffer()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if(mFreeBuffers.empty()) return NO_BUFFER;
+	size_t index = mFreeBuffers.back();
+	mFreeBuffers.pop_back();
+	return index;
+}
+
+void UringService::ReleaseBuffer(size_t aIndex)
+{
+	if(aIndex == NO_BUFFER) return;
+	this->UnregisterBuffer(aIndex);
+	std::lock_guard<std::mutex> lock(mMutex);
+	mFreeBuffers.push_back(aIndex);
+}
+
+bool UringService::RegisterBuffer(size_t aIndex, uint8_t* apBuffer, size_t aSize)
+{
+	iovec vec;
+	vec.iov_base = apBuffer;
+	vec.iov_len = aSize;
+
+	// reads already in flight keep a reference to the memory the slot had before
+	io_uring_rsrc_update2 update;
+	memset(&update, 0, sizeof(update));
+	update.offset = static_cast<uint32_t>(aIndex);
+	update.data = reinterpret_cast<uint64_t>(&vec);
+	update.nr = 1;
+	if(syscall(__NR_io_uring_register, mRingFd, IORING_REGISTER_BUFFERS_UPDATE, &update, sizeof(update)) < 0) {
+		LOG_BLOCK(LEV_WARNING, "Unable to register io_uring buffer: " << strerror(errno));
+		return false;
+	}
+	return true;
+}
+
+void UringService::UnregisterBuffer(size_t aIndex)
+{
+	this->RegisterBuffer(aIndex, NULL, 0);
+}
+
+void UringService::Connect(int aFd, const sockaddr* apAddr, socklen_t aLength, UringOperation* apOp)
+{
+	io_uring_sqe entry;
+	memset(&entry, 0, sizeof(entry));
+	entry.opcode = IORING_OP_CONNECT;
+	entry.fd = aFd;
+	entry.addr = reinterpret_cast<uint64_t>(apAddr);
+	entry.off = aLength;
+	entry.user_data = reinterpret_cast<uint64_t>(apOp);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	this->Queue(entry);
+}
+
+void UringService::Accept(int aFd, sockaddr* apAddr, socklen_t* apLength, UringOperation* apOp)
+{
+	io_uring_sqe entry;
+	memset(&entry, 0, sizeof(entry));
+	entry.opcode = IORING_OP_ACCEPT;
+	entry.fd = aFd;
+	entry.addr = reinterpret_cast<uint64_t>(apAddr);
+	entry.addr2 = reinterpret_cast<uint64_t>(apLength);
+	entry.accept_flags = SOCK_CLOEXEC;
+	entry.user_data = reinterpret_cast<uint64_t>(apOp);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	this->Queue(entry);
+}
+
+void UringService::Receive(int aFd, uint8_t* apBuffer, size_t aMaxBytes, UringOperation* apOp)
+{
+	io_uring_sqe entry;
+	memset(&entry, 0, sizeof(entry));
+	entry.opcode = IORING_OP_RECV;
+	entry.fd = aFd;
+	entry.addr = reinterpret_cast<uint64_t>(apBuffer);
+	entry.len = static_cast<uint32_t>(aMaxBytes);
+	entry.user_data = reinterpret_cast<uint64_t>(apOp);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	this->Queue(entry);
+}
+
+void UringService::ReadFixed(int aFd, size_t aBufferIndex, uint8_t* apBuffer, size_t aMaxBytes, UringOperation* apOp)
+{
+	io_uring_sqe entry;
+	memset(&entry, 0, sizeof(entry));
+	entry.opcode = IORING_OP_READ_FIXED;
+	entry.fd = aFd;
+	entry.off = static_cast<uint64_t>(-1);
+	entry.addr = reinterpret_cast<uint64_t>(apBuffer);
+	entry.len = static_cast<uint32_t>(aMaxBytes);
+	entry.buf_index = static_cast<uint16_t>(aBufferIndex);
+	entry.user_data = reinterpret_cast<uint64_t>(apOp);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	this->Queue(entry);
+}
+
+void UringService::Send(int aFd, const uint8_t* apBuffer, size_t aNumBytes, UringOperation* apOp)
+{
+	io_uring_sqe entry;
+	memset(&entry, 0, sizeof(entry));
+	entry.opcode = IORING_OP_SEND;
+	entry.fd = aFd;
+	entry.addr = reinterpret_cast<uint64_t>(apBuffer);
+	entry.len = static_cast<uint32_t>(aNumBytes);
+	entry.msg_flags = MSG_NOSIGNAL;
+	entry.user_data = reinterpret_cast<uint64_t>(apOp);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	this->Queue(entry);
+}
+
+void UringService::Cancel(UringOperation* apOp)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	// an operation still waiting for a slot never reached the kernel, so it is
+	// completed here instead. The handler is posted since the caller holds its strand.
+	uint64_t userData = reinterpret_cast<uint64_t>(apOp);
+	size_t numWaiting = mBacklog.size();
+	mBacklog.erase(std::remove_if(mBacklog.begin(), mBacklog.end(), [userData](const io_uring_sqe & arEntry) {
+		return arEntry.user_data == userData;
+	}), mBacklog.end());
+	if(mBacklog.size() < numWaiting) {
+		mpService->post([apOp]() {
+			apOp->mHandler(-ECANCELED);
+		});
+		return;
+	}
+
+	io_uring_sqe entry;
+	memset(&entry, 0, sizeof(entry));
+	entry.opcode = IORING_OP_ASYNC_CANCEL;
+	entry.fd = -1;
+	entry.addr = userData;
+	entry.user_data = 0; // the result of the cancellation itself is ignored
+	this->Queue(entry);
+}
+
+void UringService::Flush()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mFlushPending = false;
+	this->Submit();
+}
+
+void UringService::Shutdown()
+{
+	mStrand.post([this]() {
+		mIsShutdown = true;
+		boost::system::error_code ec;
+		mEventDescriptor.cancel(ec);
+	});
+}
+
+void UringService::Queue(const io_uring_sqe& arEntry)
+{
+	// entries keep their order, so nothing goes into the ring while others wait for a slot
+	if(mBacklog.empty() && !this->HasSpace()) this->Submit();
+	if(mBacklog.empty() && this->HasSpace()) this->Push(arEntry);
+	else mBacklog.push_back(arEntry);
+
+	// every entry queued before the flush runs goes to the kernel in one call
+	if(!mFlushPending) {
+		mFlushPending = true;
+		mpService->post(std::bind(&UringService::Flush, this));
+	}
+}
+
+bool UringService::HasSpace()
+{
+	return (*mpSqTail - __atomic_load_n(mpSqHead, __ATOMIC_ACQUIRE)) < mSqCapacity;
+}
+
+void UringService::Push(const io_uring_sqe& arEntry)
+{
+	unsigned tail = *mpSqTail;
+	unsigned index = tail & mSqMask;
+	mpEntries[index] = arEntry;
+	mpSqArray[index] = index;
+	__atomic_store_n(mpSqTail, tail + 1, __ATOMIC_RELEASE);
+	++mNumQueued;
+}
+
+void UringService::Submit()
+{
+	for(;;) {
+		while(!mBacklog.empty() && this->HasSpace()) {
+			this->Push(mBacklog.front());
+			mBacklog.pop_front();
+		}
+		if(mNumQueued == 0) return;
+
+		int ret = this->Enter(mNumQueued);
+		if(ret < 0) {
+			if(ret == -EINTR) continue;
+			// EAGAIN and EBUSY are transient, the entries are retried once completions are reaped
+			if(ret != -EAGAIN && ret != -EBUSY) LOG_BLOCK(LEV_ERROR, "io_uring_enter failed: " << strerror(-ret));
+			return;
+		}
+		if(ret == 0) return;
+		mNumQueued -= std::min(mNumQueued, static_cast<unsigned>(ret));
+	}
+}
+
+int UringService::Enter(unsigned aNumEntries)
+{
+	int ret = static_cast<int>(syscall(__NR_io_uring_enter, mRingFd, aNumEntries, 0, 0, NULL, 0));
+	return (ret < 0) ? -errno : ret;
+}
+
+void UringService::BeginWait()
+{
+	mEventDescriptor.async_read_some(buffer(&mEventCount, sizeof(mEventCount)),
+	                                 mStrand.wrap(
+	                                         std::bind(&UringService::OnCompletions,
+	                                                   this,
+	                                                   std::placeholders::_1)
+	                                 ));
+}
+
+void UringService::OnCompletions(const boost::system::error_code& arError)
+{
+	if(mIsShutdown) return;
+	if(arError) {
+		LOG_BLOCK(LEV_ERROR, "Error waiting for io_uring completions: " << arError.message());
+		return;
+	}
+
+	for(;;) {
+		unsigned head = *mpCqHead;
+		unsigned tail = __atomic_load_n(mpCqTail, __ATOMIC_ACQUIRE);
+		while(head != tail) {
+			io_uring_cqe* pCompletion = &mpCompletions[head & mCqMask];
+			UringOperation* pOp = reinterpret_cast<UringOperation*>(pCompletion->user_data);
+			int result = pCompletion->res;
+
+			__atomic_store_n(mpCqHead, ++head, __ATOMIC_RELEASE);
+			if(pOp != NULL) pOp->mHandler(result);
+
+			if(head == tail) tail = __atomic_load_n(mpCqTail, __ATOMIC_ACQUIRE);
+		}
+
+		// completions that did not fit in the ring are held by the kernel until
+		// an enter call asks for events, the eventfd is not signalled for them
+		if((__atomic_load_n(mpSqFlags, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW) == 0) break;
+		if(syscall(__NR_io_uring_enter, mRingFd, 0, 0, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR) {
+			LOG_BLOCK(LEV_ERROR, "Unable to flush io_uring completions: " << strerror(errno));
+			break;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if((mNumQueued > 0 || !mBacklog.empty()) && !mFlushPending) this->Submit();
+	}
+
+	this->BeginWait();
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
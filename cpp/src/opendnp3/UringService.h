@@ -0,0 +1,160 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __URING_SERVICE_H_
+#define __URING_SERVICE_H_
+
+#include <boost/asio.hpp>
+
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Location.h>
+
+#include "Loggable.h"
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+
+namespace opendnp3
+{
+
+/**
+An operation that can be submitted to the ring. The handler receives the result
+field of the completion, i.e. a byte count, a file descriptor or a negated errno.
+Physical layers own one of these per outstanding operation type and reuse it.
+*/
+class DLL_LOCAL UringOperation
+{
+public:
+	UringOperation(std::function<void (int)> aHandler) : mHandler(aHandler)
+	{}
+
+	std::function<void (int)> mHandler;
+};
+
+/**
+A single io_uring instance shared by every channel that runs on an io_service.
+
+Submissions from all channels are queued and handed to the kernel with one
+io_uring_enter call the next time the io_service runs a handler. Completions
+are signalled through an eventfd that the io_service watches, so they are
+reaped on the pool threads and dispatched to each operation's handler.
+
+A sparse table of buffer slots is registered with the kernel at construction.
+Physical layers reserve a slot and point it at the area the link layer reads
+into, so fixed buffer reads land directly in the receiver without a copy.
+*/
+class DLL_LOCAL UringService : public Loggable, private Uncopyable
+{
+public:
+
+	UringService(Logger* apLogger, boost::asio::io_service* apService, size_t aNumEntries = 4096, size_t aNumBuffers = 1024);
+	virtual ~UringService();
+
+	static const size_t NO_BUFFER;
+
+	// Reserve a buffer slot, returns NO_BUFFER if they are all in use
+	size_t AcquireBuffer();
+	void ReleaseBuffer(size_t aIndex);
+
+	// Point a reserved slot at caller owned memory, which stays pinned until the
+	// slot is unregistered. Returns false if the kernel refuses the update.
+	bool RegisterBuffer(size_t aIndex, uint8_t* apBuffer, size_t aSize);
+	void UnregisterBuffer(size_t aIndex);
+
+	void Connect(int aFd, const sockaddr* apAddr, socklen_t aLength, UringOperation* apOp);
+	void Accept(int aFd, sockaddr* apAddr, socklen_t* apLength, UringOperation* apOp);
+	void Receive(int aFd, uint8_t* apBuffer, size_t aMaxBytes, UringOperation* apOp);
+	// apBuffer must lie within the memory registered to the slot
+	void ReadFixed(int aFd, size_t aBufferIndex, uint8_t* apBuffer, size_t aMaxBytes, UringOperation* apOp);
+	void Send(int aFd, const uint8_t* apBuffer, size_t aNumBytes, UringOperation* apOp);
+
+	// Request that an outstanding operation complete early with -ECANCELED
+	void Cancel(UringOperation* apOp);
+
+	// Hand queued submissions to the kernel. Callers must cancel and flush before
+	// closing a descriptor that queued operations refer to.
+	void Flush();
+
+	// Stop watching for completions so the io_service can run out of work
+	void Shutdown();
+
+protected:
+
+	// Hand entries to the kernel, returns the number consumed or a negated errno
+	virtual int Enter(unsigned aNumEntries);
+
+private:
+
+	void Release();
+
+	void Queue(const io_uring_sqe& arEntry);
+	bool HasSpace();
+	void Push(const io_uring_sqe& arEntry);
+	void Submit();
+
+	void BeginWait();
+	void OnCompletions(const boost::system::error_code& arError);
+
+	boost::asio::io_service* mpService;
+
+	int mRingFd;
+	int mEventFd;
+
+	void* mpSqRing;
+	size_t mSqRingSize;
+	void* mpCqRing;
+	size_t mCqRingSize;
+	io_uring_sqe* mpEntries;
+	size_t mEntriesSize;
+
+	unsigned* mpSqTail;
+	unsigned* mpSqHead;
+	unsigned mSqMask;
+	unsigned mSqCapacity;
+	unsigned* mpSqArray;
+	unsigned* mpSqFlags;
+
+	unsigned* mpCqHead;
+	unsigned* mpCqTail;
+	unsigned mCqMask;
+	io_uring_cqe* mpCompletions;
+
+	std::mutex mMutex;
+	unsigned mNumQueued;
+	std::deque<io_uring_sqe> mBacklog;
+	bool mFlushPending;
+
+	std::vector<size_t> mFreeBuffers;
+
+	boost::asio::strand mStrand;
+	boost::asio::posix::stream_descriptor mEventDescriptor;
+	uint64_t mEventCount;
+	bool mIsShutdown;
+};
+
+}
+
+#endif
@@ -78,9 +78,15 @@ void VtoRouter::_OnReceive(const uint8_t* apData, size_t aLength)
 {
 	LOG_BLOCK(LEV_COMM, "GotLocalData: " << aLength);
 
-	// turn the incoming data into a VtoMessage object and enque it
-	VtoMessage msg(VTODT_DATA, apData, aLength);
-	this->mVtoTxBuffer.push_back(msg);
+	// when nothing is queued ahead of it the data goes straight to the vto writer
+	size_t numWritten = 0;
+	if(mVtoTxBuffer.empty()) numWritten = mpVtoWriter->Write(apData, aLength, this->GetChannelId());
+
+	// turn whatever the writer couldn't take into a VtoMessage object and enque it
+	if(numWritten < aLength) {
+		VtoMessage msg(VTODT_DATA, apData + numWritten, aLength - numWritten);
+		this->mVtoTxBuffer.push_back(msg);
+	}
 
 	this->CheckForVtoWrite();
 	this->CheckForPhysRead();
@@ -0,0 +1,311 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "VtoStreamWriter.h"
+
+#include <opendnp3/Logger.h>
+#include <opendnp3/Util.h>
+
+#include "APDU.h"
+#include "EnhancedVto.h"
+#include "LoggableMacros.h"
+#include "VtoData.h"
+
+#include <string.h>
+
+namespace opendnp3
+{
+
+// group, variation, qualifier, 1 byte count and 1 byte index ahead of each object
+const size_t VTO_OBJECT_OVERHEAD = 5;
+
+// VtoWriter::SetLocalVtoState uses the same index for state changes
+const size_t VTO_STATE_INDEX = 255;
+
+// control, function code, and IIN of a response
+const size_t RESPONSE_HEADER_SIZE = 4;
+
+VtoStreamWriter::Stream::Stream(uint8_t aChannelId, size_t aBufferSize) :
+	mChannelId(aChannelId),
+	mBuffer(aBufferSize),
+	mTail(0),
+	mLoaded(0),
+	mSelected(0),
+	mHead(0),
+	mStatesLoaded(0),
+	mStatesSelected(0)
+{}
+
+VtoStreamWriter::VtoStreamWriter(Logger* apLogger, size_t aBufferSize) :
+	Loggable(apLogger),
+	mBufferSize(aBufferSize),
+	mWindow(aBufferSize)
+{}
+
+VtoStreamWriter::~VtoStreamWriter()
+{
+	for(auto pStream: mStreams) {
+		if(pStream->mHead > pStream->mTail) {
+			LOG_BLOCK(LEV_WARNING, "On destruction, channel " << static_cast<int>(pStream->mChannelId) << " had " << (pStream->mHead - pStream->mTail) << " bytes that went unsent");
+		}
+		delete pStream;
+	}
+}
+
+size_t VtoStreamWriter::Write(const uint8_t* apData, size_t aLength, uint8_t aChannelId)
+{
+	size_t num = 0;
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+
+		Stream* pStream = this->GetStream(aChannelId);
+		num = Min<size_t>(this->NumFree(*pStream), aLength);
+
+		if(num > 0) {
+			// the copy wraps at most once
+			size_t pos = static_cast<size_t>(pStream->mHead % mBufferSize);
+			size_t first = Min<size_t>(num, mBufferSize - pos);
+			memcpy(&pStream->mBuffer[pos], apData, first);
+			if(num > first) memcpy(&pStream->mBuffer[0], apData + first, num - first);
+			pStream->mHead += num;
+		}
+	}
+
+	if (num > 0) this->NotifyObservers();
+
+	return num;
+}
+
+void VtoStreamWriter::SetLocalVtoState(bool aLocalVtoConnectionOpened, uint8_t aChannelId)
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		Stream* pStream = this->GetStream(aChannelId);
+		pStream->mStates.push_back(StateChange(pStream->mHead, aLocalVtoConnectionOpened));
+	}
+
+	this->NotifyObservers();
+}
+
+size_t VtoStreamWriter::NumBytesAvailable()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	size_t available = mBufferSize;
+	if(mWindow < available) available = mWindow;
+	for(auto pStream: mStreams) available = Min<size_t>(available, this->NumFree(*pStream));
+	return available;
+}
+
+void VtoStreamWriter::AddVtoCallback(IVtoBufferHandler* apHandler)
+{
+	assert(apHandler != NULL);
+	std::unique_lock<std::mutex> lock(mMutex);
+	this->mCallbacks.insert(apHandler);
+}
+
+void VtoStreamWriter::RemoveVtoCallback(IVtoBufferHandler* apHandler)
+{
+	assert(apHandler != NULL);
+	std::unique_lock<std::mutex> lock(mMutex);
+	this->mCallbacks.erase(apHandler);
+}
+
+bool VtoStreamWriter::HasData()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	for(auto pStream: mStreams) {
+		if(pStream->mHead > pStream->mLoaded || pStream->mStates.size() > pStream->mStatesLoaded) return true;
+	}
+	return false;
+}
+
+size_t VtoStreamWriter::Select()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	size_t num = 0;
+	for(auto pStream: mStreams) {
+		num += static_cast<size_t>(pStream->mHead - pStream->mSelected);
+		num += pStream->mStates.size() - pStream->mStatesSelected;
+		pStream->mSelected = pStream->mHead;
+		pStream->mStatesSelected = pStream->mStates.size();
+	}
+	return num;
+}
+
+size_t VtoStreamWriter::Load(APDU& arAPDU, const SizeByVariationObject* apObj)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	size_t count = 0;
+	for(auto pStream: mStreams) {
+		if(!this->LoadStream(*pStream, arAPDU, apObj, count)) break;
+	}
+	LOG_BLOCK(LEV_INTERPRET, "Loaded " << count << " vto objects");
+	return count;
+}
+
+bool VtoStreamWriter::LoadStream(Stream& arStream, APDU& arAPDU, const SizeByVariationObject* apObj, size_t& arCount)
+{
+	for(;;) {
+		bool stateDue = arStream.mStatesLoaded < arStream.mStatesSelected && arStream.mStates[arStream.mStatesLoaded].mOffset <= arStream.mLoaded;
+
+		if(stateDue) {
+			// a state change goes out once all of the data written before it has been loaded
+			const StateChange& change = arStream.mStates[arStream.mStatesLoaded];
+			VtoData vto = EnhancedVto::CreateVtoData(change.mOpened, arStream.mChannelId);
+			IndexedWriteIterator itr = arAPDU.WriteIndexed(apObj, vto.GetSize(), VTO_STATE_INDEX);
+			if(itr.IsEnd()) return false;
+			itr.SetIndex(VTO_STATE_INDEX);
+			apObj->Write(*itr, vto.GetSize(), vto.mpData);
+			++arStream.mStatesLoaded;
+			++arCount;
+			continue;
+		}
+
+		uint64_t limit = arStream.mSelected;
+		if(arStream.mStatesLoaded < arStream.mStatesSelected) limit = Min<uint64_t>(limit, arStream.mStates[arStream.mStatesLoaded].mOffset);
+		if(arStream.mLoaded == limit) return true;
+
+		// cut the object to whatever space is left so every fragment goes out full
+		size_t space = arAPDU.MaxSize() - arAPDU.Size();
+		if(space <= VTO_OBJECT_OVERHEAD) return false;
+		size_t size = Min<size_t>(Min<size_t>(static_cast<size_t>(limit - arStream.mLoaded), VtoData::MAX_SIZE), space - VTO_OBJECT_OVERHEAD);
+
+		IndexedWriteIterator itr = arAPDU.WriteIndexed(apObj, size, arStream.mChannelId);
+		if(itr.IsEnd()) return false;
+		itr.SetIndex(arStream.mChannelId);
+
+		size_t pos = static_cast<size_t>(arStream.mLoaded % mBufferSize);
+		size_t first = Min<size_t>(size, mBufferSize - pos);
+		memcpy(*itr, &arStream.mBuffer[pos], first);
+		if(size > first) memcpy(*itr + first, &arStream.mBuffer[0], size - first);
+
+		arStream.mLoaded += size;
+		++arCount;
+	}
+}
+
+size_t VtoStreamWriter::NumSelected()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	size_t num = 0;
+	for(auto pStream: mStreams) {
+		num += static_cast<size_t>(pStream->mSelected - pStream->mLoaded);
+		num += pStream->mStatesSelected - pStream->mStatesLoaded;
+	}
+	return num;
+}
+
+size_t VtoStreamWriter::NumBytesQueued()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	size_t num = 0;
+	for(auto pStream: mStreams) num += static_cast<size_t>(pStream->mHead - pStream->mLoaded);
+	return num;
+}
+
+size_t VtoStreamWriter::NumBytesLoaded()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	size_t num = 0;
+	for(auto pStream: mStreams) num += static_cast<size_t>(pStream->mLoaded - pStream->mTail);
+	return num;
+}
+
+void VtoStreamWriter::SetWindow(size_t aNumBytes)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mWindow = Min<size_t>(aNumBytes, mBufferSize);
+}
+
+size_t VtoStreamWriter::FragmentCapacity(size_t aFragSize)
+{
+	size_t capacity = 0;
+	size_t space = aFragSize > RESPONSE_HEADER_SIZE ? aFragSize - RESPONSE_HEADER_SIZE : 0;
+	while(space > VTO_OBJECT_OVERHEAD) {
+		size_t size = Min<size_t>(VtoData::MAX_SIZE, space - VTO_OBJECT_OVERHEAD);
+		capacity += size;
+		space -= size + VTO_OBJECT_OVERHEAD;
+	}
+	return capacity;
+}
+
+size_t VtoStreamWriter::ClearWritten()
+{
+	size_t released = 0;
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		for(auto pStream: mStreams) {
+			released += static_cast<size_t>(pStream->mLoaded - pStream->mTail);
+			pStream->mTail = pStream->mLoaded;
+			pStream->mStates.erase(pStream->mStates.begin(), pStream->mStates.begin() + pStream->mStatesLoaded);
+			pStream->mStatesSelected -= pStream->mStatesLoaded;
+			pStream->mStatesLoaded = 0;
+		}
+	}
+
+	// the confirmed bytes are the writer's credit
+	if(released > 0) this->NotifyAllCallbacks();
+
+	return released;
+}
+
+void VtoStreamWriter::Deselect()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	for(auto pStream: mStreams) {
+		pStream->mLoaded = pStream->mTail;
+		pStream->mSelected = pStream->mTail;
+		pStream->mStatesLoaded = 0;
+		pStream->mStatesSelected = 0;
+	}
+}
+
+VtoStreamWriter::Stream* VtoStreamWriter::GetStream(uint8_t aChannelId)
+{
+	for(auto pStream: mStreams) {
+		if(pStream->mChannelId == aChannelId) return pStream;
+	}
+
+	Stream* pStream = new Stream(aChannelId, mBufferSize);
+	mStreams.push_back(pStream);
+	return pStream;
+}
+
+size_t VtoStreamWriter::NumFree(const Stream& arStream) const
+{
+	size_t used = static_cast<size_t>(arStream.mHead - arStream.mTail);
+	return used < mWindow ? mWindow - used : 0;
+}
+
+void VtoStreamWriter::NotifyAllCallbacks()
+{
+	CallbackSet set; //create a copy of the set outside the critical section
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		set = mCallbacks;
+	}
+
+	for(auto pCallback: set) pCallback->OnBufferAvailable();
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,173 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __VTO_STREAM_WRITER_H_
+#define __VTO_STREAM_WRITER_H_
+
+#include <deque>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <opendnp3/SubjectBase.h>
+#include <opendnp3/Uncopyable.h>
+#include <opendnp3/Visibility.h>
+
+#include "Loggable.h"
+#include "VtoDataInterface.h"
+
+namespace opendnp3
+{
+
+class APDU;
+class SizeByVariationObject;
+
+/**
+ * Implements the IVtoWriter interface with a byte ring for each virtual
+ * channel instead of a queue of 255-byte VtoEvent chunks.
+ *
+ * Written data stays in the ring until the ResponseContext cuts group 113
+ * objects directly out of it while it builds a fragment. The stack side
+ * follows the same select / load / clear written / deselect cycle as the
+ * SlaveEventBuffer. Ring space is only handed back to the writer, and
+ * OnBufferAvailable() called, once the master has confirmed the fragment
+ * that carried the data.
+ */
+class DLL_LOCAL VtoStreamWriter : public IVtoWriter, public SubjectBase, private Loggable, private Uncopyable
+{
+public:
+
+	/**
+	 * @param apLogger		logger for the writer
+	 * @param aBufferSize	size in bytes of the ring for each channel
+	 */
+	VtoStreamWriter(Logger* apLogger, size_t aBufferSize);
+
+	~VtoStreamWriter();
+
+	/* Implement IVtoWriter, called from user threads */
+
+	size_t Write(const uint8_t* apData, size_t aLength, uint8_t aChannelId);
+
+	void SetLocalVtoState(bool aLocalVtoConnectionOpened, uint8_t aChannelId);
+
+	/// The free space of the fullest channel, channels share no space
+	size_t NumBytesAvailable();
+
+	void AddVtoCallback(IVtoBufferHandler* apHandler);
+
+	void RemoveVtoCallback(IVtoBufferHandler* apHandler);
+
+	/* Stack side, called from the slave's executor */
+
+	/// @return true if any data or state changes are waiting to be sent
+	bool HasData();
+
+	/// Selects everything written so far for the next response
+	/// @return the number of bytes and state changes selected
+	size_t Select();
+
+	/**
+	 * Cuts objects of up to VtoData::MAX_SIZE bytes from the selected data
+	 * until the fragment is full or the selection is exhausted.
+	 *
+	 * @return the number of objects written to the fragment
+	 */
+	size_t Load(APDU& arAPDU, const SizeByVariationObject* apObj);
+
+	/// @return the number of selected bytes and state changes not yet loaded
+	size_t NumSelected();
+
+	/// @return the number of written bytes that have not been loaded into a fragment
+	size_t NumBytesQueued();
+
+	/// @return the number of bytes loaded into fragments that have not been confirmed
+	size_t NumBytesLoaded();
+
+	/// Limits how many unconfirmed bytes each channel may hold, at most the buffer size
+	void SetWindow(size_t aNumBytes);
+
+	/// @return the number of vto bytes a fragment of aFragSize holds when it carries nothing else
+	static size_t FragmentCapacity(size_t aFragSize);
+
+	/// Releases the loaded data back to the writer, the fragment was confirmed
+	/// @return the number of bytes released
+	size_t ClearWritten();
+
+	/// Clears the selection, loaded but unconfirmed data will be sent again
+	void Deselect();
+
+private:
+
+	// a local connection state change that is sent once the stream reaches mOffset
+	struct StateChange {
+		StateChange(uint64_t aOffset, bool aOpened) : mOffset(aOffset), mOpened(aOpened)
+		{}
+
+		uint64_t mOffset;
+		bool mOpened;
+	};
+
+	/*
+	 * The offsets count bytes since the stream was created and the ring
+	 * position is the offset modulo the buffer size, so
+	 * mTail <= mLoaded <= mSelected <= mHead.
+	 */
+	struct Stream {
+		Stream(uint8_t aChannelId, size_t aBufferSize);
+
+		uint8_t mChannelId;
+		std::vector<uint8_t> mBuffer;
+		uint64_t mTail;				// oldest byte that has not been confirmed
+		uint64_t mLoaded;			// end of the bytes loaded into unconfirmed fragments
+		uint64_t mSelected;			// end of the bytes selected for the current response
+		uint64_t mHead;				// end of the bytes written by the user
+		std::deque<StateChange> mStates;
+		size_t mStatesLoaded;
+		size_t mStatesSelected;
+	};
+
+	Stream* GetStream(uint8_t aChannelId);
+
+	// space the writer may use, the window can shrink below what is already written
+	size_t NumFree(const Stream& arStream) const;
+
+	bool LoadStream(Stream& arStream, APDU& arAPDU, const SizeByVariationObject* apObj, size_t& arCount);
+
+	void NotifyAllCallbacks();
+
+	const size_t mBufferSize;
+	size_t mWindow;
+
+	std::mutex mMutex;
+
+	// streams are created on the first write to a channel and live as long as the writer
+	std::vector<Stream*> mStreams;
+
+	typedef std::set<IVtoBufferHandler*> CallbackSet;
+	CallbackSet mCallbacks;
+};
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
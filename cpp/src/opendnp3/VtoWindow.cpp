@@ -0,0 +1,97 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "VtoWindow.h"
+
+#include <opendnp3/Util.h>
+
+namespace opendnp3
+{
+
+const uint64_t VtoWindow::THROUGHPUT_INTERVAL_MICROS;
+
+// the window must hold the fragment waiting for a confirm and the next one
+const size_t MIN_WINDOW_FRAGMENTS = 2;
+
+VtoWindow::VtoWindow(size_t aFragmentCapacity, size_t aMaxBytes, millis_t aTargetDelay) :
+	mFragmentCapacity(aFragmentCapacity),
+	mMaxBytes(aMaxBytes),
+	mTargetMicros(aTargetDelay > 0 ? static_cast<uint64_t>(aTargetDelay) * 1000 : 0),
+	mSent(false),
+	mRoundTripMicros(0),
+	mNumBytes(aMaxBytes),
+	mIntervalStarted(false),
+	mIntervalBytes(0),
+	mBytesPerSecond(0)
+{}
+
+void VtoWindow::OnSent(timer_clock::time_point aTime)
+{
+	mSent = true;
+	mSentTime = aTime;
+
+	if(!mIntervalStarted) {
+		mIntervalStarted = true;
+		mIntervalStart = aTime;
+	}
+}
+
+void VtoWindow::OnConfirmed(size_t aNumBytes, timer_clock::time_point aTime)
+{
+	if(!mSent) return;
+	mSent = false;
+
+	uint64_t sample = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(aTime - mSentTime).count());
+
+	// the same smoothing as the TCP retransmission timer
+	if(mRoundTripMicros == 0) mRoundTripMicros = Max<uint64_t>(sample, 1);
+	else mRoundTripMicros = Max<uint64_t>((7 * mRoundTripMicros + sample) / 8, 1);
+
+	this->Resize();
+
+	mIntervalBytes += aNumBytes;
+	uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(aTime - mIntervalStart).count());
+	if(elapsed >= THROUGHPUT_INTERVAL_MICROS) {
+		mBytesPerSecond = mIntervalBytes * 1000000 / elapsed;
+		mIntervalBytes = 0;
+		mIntervalStart = aTime;
+	}
+}
+
+void VtoWindow::OnFailure()
+{
+	// a retry says nothing about the round trip time
+	mSent = false;
+}
+
+void VtoWindow::Resize()
+{
+	size_t fragments = static_cast<size_t>((mTargetMicros + mRoundTripMicros - 1) / mRoundTripMicros);
+	if(fragments < MIN_WINDOW_FRAGMENTS) fragments = MIN_WINDOW_FRAGMENTS;
+
+	// avoid overflowing the product when the target is huge compared to the round trip
+	if(fragments > mMaxBytes / Max<size_t>(mFragmentCapacity, 1)) mNumBytes = mMaxBytes;
+	else mNumBytes = Min<size_t>(fragments * mFragmentCapacity, mMaxBytes);
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,111 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __VTO_WINDOW_H_
+#define __VTO_WINDOW_H_
+
+#include <opendnp3/Clock.h>
+#include <opendnp3/Types.h>
+#include <opendnp3/Visibility.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace opendnp3
+{
+
+/**
+ * Sizes the window of streamed vto data that an outstation lets its writers
+ * queue ahead of the master's confirms.
+ *
+ * An outstation may only have one fragment waiting for a confirm, so the
+ * window is the writers' credit rather than a count of fragments in flight.
+ * It holds as many full fragments as can be sent within the target delay at
+ * the smoothed confirm round trip time, and never fewer than two so the next
+ * full fragment is ready when a confirm arrives. Until the first round trip
+ * has been measured the window is as large as the stream buffers.
+ */
+class DLL_LOCAL VtoWindow
+{
+public:
+
+	/**
+	 * @param aFragmentCapacity	vto bytes in a full fragment
+	 * @param aMaxBytes			the size of the stream buffers
+	 * @param aTargetDelay		how long the window may take to drain
+	 */
+	VtoWindow(size_t aFragmentCapacity, size_t aMaxBytes, millis_t aTargetDelay);
+
+	/// A fragment carrying vto data was sent
+	void OnSent(timer_clock::time_point aTime);
+
+	/// The master confirmed the last fragment that was sent, which carried aNumBytes of vto data
+	void OnConfirmed(size_t aNumBytes, timer_clock::time_point aTime);
+
+	/// The fragment was not confirmed and will be sent again
+	void OnFailure();
+
+	/// @return the vto bytes in a full fragment
+	size_t FragmentCapacity() const {
+		return mFragmentCapacity;
+	}
+
+	/// @return the window in bytes
+	size_t NumBytes() const {
+		return mNumBytes;
+	}
+
+	/// @return the smoothed confirm round trip time, 0 until it has been measured
+	uint64_t RoundTripMicros() const {
+		return mRoundTripMicros;
+	}
+
+	/// @return the bytes confirmed per second over the last completed interval
+	uint64_t BytesPerSecond() const {
+		return mBytesPerSecond;
+	}
+
+	static const uint64_t THROUGHPUT_INTERVAL_MICROS = 1000000;
+
+private:
+
+	void Resize();
+
+	const size_t mFragmentCapacity;
+	const size_t mMaxBytes;
+	const uint64_t mTargetMicros;
+
+	bool mSent;
+	timer_clock::time_point mSentTime;
+	uint64_t mRoundTripMicros;
+	size_t mNumBytes;
+
+	bool mIntervalStarted;
+	timer_clock::time_point mIntervalStart;
+	uint64_t mIntervalBytes;
+	uint64_t mBytesPerSecond;
+};
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
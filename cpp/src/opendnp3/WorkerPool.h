@@ -0,0 +1,178 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __WORKER_POOL_H_
+#define __WORKER_POOL_H_
+
+#include <opendnp3/Uncopyable.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace opendnp3
+{
+
+/**
+* Threads that run jobs in the order they were submitted. A job is a pointer to an object the
+* pool doesn't own, which can be submitted again while it runs, so the same object may be run
+* by several threads at once. Threads are started when the first job is submitted. Safe to
+* call from any thread.
+*/
+template <class T>
+class WorkerPool : private Uncopyable
+{
+public:
+
+	/**
+	* @param aRun Called by a pool thread, without the pool's lock, for every job
+	* @param aConcurrency Number of threads, at least one
+	*/
+	WorkerPool(std::function<void (T*)> aRun, size_t aConcurrency, std::function<void()> aOnThreadStart, std::function<void()> aOnThreadExit);
+
+	/// Jobs still queued are dropped, the ones running finish before the threads are joined
+	~WorkerPool();
+
+	/// Raising the number of threads takes effect immediately, they aren't stopped if it's lowered
+	void SetConcurrency(size_t aConcurrency);
+
+	/// Queues one job for the object
+	void Submit(T* apJob);
+
+	/// Withdraws the object's queued jobs and waits for the ones in progress, and any they submit meanwhile, to finish
+	void Remove(T* apJob);
+
+private:
+
+	void StartThreads();
+	void Run();
+
+	std::function<void (T*)> mRun;
+	std::function<void()> mOnThreadStart;
+	std::function<void()> mOnThreadExit;
+
+	std::mutex mMutex;
+	std::condition_variable mReady;
+	std::condition_variable mIdle;
+	std::deque<T*> mJobs;			// in order of submission
+	std::multiset<T*> mActive;		// being run by a thread
+	std::vector<std::thread> mThreads;
+	size_t mConcurrency;
+	bool mStopped;
+};
+
+template <class T>
+WorkerPool<T> :: WorkerPool(std::function<void (T*)> aRun, size_t aConcurrency, std::function<void()> aOnThreadStart, std::function<void()> aOnThreadExit) :
+	mRun(aRun),
+	mOnThreadStart(aOnThreadStart),
+	mOnThreadExit(aOnThreadExit),
+	mConcurrency(std::max<size_t>(aConcurrency, 1)),
+	mStopped(false)
+{
+
+}
+
+template <class T>
+WorkerPool<T> :: ~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopped = true;
+	}
+	mReady.notify_all();
+for(auto& thread: mThreads) thread.join();
+}
+
+template <class T>
+void WorkerPool<T> :: SetConcurrency(size_t aConcurrency)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mConcurrency = std::max<size_t>(aConcurrency, 1);
+	if(!mThreads.empty()) this->StartThreads();
+}
+
+template <class T>
+void WorkerPool<T> :: Submit(T* apJob)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mJobs.push_back(apJob);
+		this->StartThreads();
+	}
+	mReady.notify_one();
+}
+
+template <class T>
+void WorkerPool<T> :: Remove(T* apJob)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while(true) {
+		// a running job can submit its object again before it finishes
+		mJobs.erase(std::remove(mJobs.begin(), mJobs.end(), apJob), mJobs.end());
+		if(mActive.count(apJob) == 0) return;
+		mIdle.wait(lock);
+	}
+}
+
+template <class T>
+void WorkerPool<T> :: StartThreads()
+{
+	while(mThreads.size() < mConcurrency) mThreads.push_back(std::thread([this]() {
+		this->Run();
+	}));
+}
+
+template <class T>
+void WorkerPool<T> :: Run()
+{
+	mOnThreadStart();
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	while(true) {
+		while(!mStopped && mJobs.empty()) mReady.wait(lock);
+		if(mStopped) break;
+
+		T* pJob = mJobs.front();
+		mJobs.pop_front();
+		auto active = mActive.insert(pJob);
+
+		lock.unlock();
+		mRun(pJob);
+		lock.lock();
+
+		mActive.erase(active);
+		mIdle.notify_all();
+	}
+
+	lock.unlock();
+	mOnThreadExit();
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
+
+#endif
@@ -0,0 +1,147 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "AllocationCounter.h"
+
+#include <new>
+#include <stdlib.h>
+
+#ifdef _MSC_VER
+#define ALLOCATION_THREAD_LOCAL __declspec(thread)
+#else
+#define ALLOCATION_THREAD_LOCAL __thread
+#endif
+
+namespace
+{
+
+// plain integers so they can live in thread local storage on every compiler we support
+ALLOCATION_THREAD_LOCAL uint64_t gNumAllocations = 0;
+ALLOCATION_THREAD_LOCAL uint64_t gNumDeallocations = 0;
+ALLOCATION_THREAD_LOCAL uint64_t gNumBytes = 0;
+
+void* CountedAlloc(size_t aSize)
+{
+	++gNumAllocations;
+	gNumBytes += aSize;
+	return malloc(aSize == 0 ? 1 : aSize);
+}
+
+void CountedFree(void* apMem)
+{
+	if(apMem == NULL) return;
+	++gNumDeallocations;
+	free(apMem);
+}
+
+}
+
+void* operator new(size_t aSize)
+{
+	void* p = CountedAlloc(aSize);
+	if(p == NULL) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t aSize)
+{
+	void* p = CountedAlloc(aSize);
+	if(p == NULL) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new(size_t aSize, const std::nothrow_t&) throw()
+{
+	return CountedAlloc(aSize);
+}
+
+void* operator new[](size_t aSize, const std::nothrow_t&) throw()
+{
+	return CountedAlloc(aSize);
+}
+
+void operator delete(void* apMem) throw()
+{
+	CountedFree(apMem);
+}
+
+void operator delete[](void* apMem) throw()
+{
+	CountedFree(apMem);
+}
+
+void operator delete(void* apMem, const std::nothrow_t&) throw()
+{
+	CountedFree(apMem);
+}
+
+void operator delete[](void* apMem, const std::nothrow_t&) throw()
+{
+	CountedFree(apMem);
+}
+
+namespace opendnp3
+{
+
+AllocationCounter::AllocationCounter()
+{
+	this->Restart();
+}
+
+void AllocationCounter::Restart()
+{
+	mStopped = false;
+	mAllocations = gNumAllocations;
+	mDeallocations = gNumDeallocations;
+	mBytes = gNumBytes;
+}
+
+void AllocationCounter::Stop()
+{
+	mStopped = true;
+	mStopAllocations = gNumAllocations;
+	mStopDeallocations = gNumDeallocations;
+	mStopBytes = gNumBytes;
+}
+
+uint64_t AllocationCounter::Allocations() const
+{
+	return (mStopped ? mStopAllocations : gNumAllocations) - mAllocations;
+}
+
+uint64_t AllocationCounter::Deallocations() const
+{
+	return (mStopped ? mStopDeallocations : gNumDeallocations) - mDeallocations;
+}
+
+uint64_t AllocationCounter::Bytes() const
+{
+	return (mStopped ? mStopBytes : gNumBytes) - mBytes;
+}
+
+double AllocationCounter::PerOp(size_t aNumOps) const
+{
+	return static_cast<double>(this->Allocations()) / aNumOps;
+}
+
+}
+
+/* vim: set ts=4 sw=4: */
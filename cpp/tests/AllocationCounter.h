@@ -0,0 +1,80 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __ALLOCATION_COUNTER_H_
+#define __ALLOCATION_COUNTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace opendnp3
+{
+
+/**
+	Counts the heap allocations made by the calling thread.
+
+	The test executable replaces the global operator new/delete (see
+	AllocationCounter.cpp) and keeps a set of counters for each thread, so a
+	counter only sees the work done on the thread that created it. Allocations
+	made by the library while a counter is running are included since the
+	library is linked into the same image.
+*/
+class AllocationCounter
+{
+public:
+
+	/// Starts counting from the current totals of the calling thread
+	AllocationCounter();
+
+	void Restart();
+
+	/// Freezes the counts so the results can be reported without counting the reporting
+	void Stop();
+
+	/// Number of calls to operator new since the counter was (re)started
+	uint64_t Allocations() const;
+
+	/// Number of calls to operator delete since the counter was (re)started
+	uint64_t Deallocations() const;
+
+	/// Number of bytes requested since the counter was (re)started
+	uint64_t Bytes() const;
+
+	/// Allocations per operation after running aNumOps operations
+	double PerOp(size_t aNumOps) const;
+
+private:
+
+	bool mStopped;
+
+	uint64_t mAllocations;
+	uint64_t mDeallocations;
+	uint64_t mBytes;
+
+	uint64_t mStopAllocations;
+	uint64_t mStopDeallocations;
+	uint64_t mStopBytes;
+};
+
+}
+
+#endif
+
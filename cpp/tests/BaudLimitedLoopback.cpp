@@ -0,0 +1,118 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include "BaudLimitedLoopback.h"
+
+#include <opendnp3/IExecutor.h>
+
+#include <algorithm>
+
+using namespace boost::system;
+using namespace std::chrono;
+
+namespace opendnp3
+{
+
+BaudLimitedLoopback::BaudLimitedLoopback(Logger* apLogger, IExecutor* apExecutor, MockTimeSource* apTime, int aBaud, int aBitsPerChar) :
+	PhysicalLayerAsyncBase(apLogger),
+	mpExecutor(apExecutor),
+	mpTime(apTime),
+	mCharTime((static_cast<int64_t>(aBitsPerChar) * 1000000000) / aBaud),
+	mBusyUntil(apTime->GetUTC()),
+	mBusyTime(timer_clock::duration::zero()),
+	mpReadBuff(NULL),
+	mReadSize(0)
+{
+
+}
+
+void BaudLimitedLoopback::DoOpen()
+{
+	error_code ec(errc::success, get_generic_category());
+	mpExecutor->Post(std::bind(&BaudLimitedLoopback::OnOpenCallback, this, ec));
+}
+
+void BaudLimitedLoopback::DoClose()
+{
+	mReceived.clear();
+	if(mReadSize > 0) {
+		mReadSize = 0;
+		error_code ec(errc::permission_denied, get_generic_category());
+		mpExecutor->Post(std::bind(&BaudLimitedLoopback::OnReadCallback, this, ec, mpReadBuff, 0));
+	}
+}
+
+void BaudLimitedLoopback::DoAsyncRead(uint8_t* apBuff, size_t aNumBytes)
+{
+	mpReadBuff = apBuff;
+	mReadSize = aNumBytes;
+	this->CheckForRead();
+}
+
+void BaudLimitedLoopback::DoAsyncWrite(const uint8_t* apData, size_t aNumBytes)
+{
+	timer_clock::time_point written = this->Occupy(aNumBytes);
+	mpExecutor->Start(written, std::bind(&BaudLimitedLoopback::OnWriteComplete, this, written, aNumBytes));
+
+	// the responder echoes the bytes once it has received the whole write
+	std::deque<uint8_t> echo(apData, apData + aNumBytes);
+	timer_clock::time_point echoed = this->Occupy(aNumBytes);
+	mpExecutor->Start(echoed, std::bind(&BaudLimitedLoopback::OnEchoComplete, this, echoed, echo));
+}
+
+timer_clock::time_point BaudLimitedLoopback::Occupy(size_t aNumBytes)
+{
+	timer_clock::duration time = duration_cast<timer_clock::duration>(mCharTime * aNumBytes);
+	mBusyUntil = std::max(mBusyUntil, mpTime->GetUTC()) + time;
+	mBusyTime += time;
+	return mBusyUntil;
+}
+
+void BaudLimitedLoopback::OnWriteComplete(const timer_clock::time_point& arTime, size_t aNumBytes)
+{
+	mpTime->SetTime(arTime);
+	error_code ec(errc::success, get_generic_category());
+	this->OnWriteCallback(ec, aNumBytes);
+}
+
+void BaudLimitedLoopback::OnEchoComplete(const timer_clock::time_point& arTime, std::deque<uint8_t> aEcho)
+{
+	mpTime->SetTime(arTime);
+	if(this->IsOpen()) {
+		mReceived.insert(mReceived.end(), aEcho.begin(), aEcho.end());
+		this->CheckForRead();
+	}
+}
+
+void BaudLimitedLoopback::CheckForRead()
+{
+	if(mReadSize > 0 && mReceived.size() > 0) {
+		size_t num = std::min(mReadSize, mReceived.size());
+		std::copy(mReceived.begin(), mReceived.begin() + num, mpReadBuff);
+		mReceived.erase(mReceived.begin(), mReceived.begin() + num);
+		mReadSize = 0;
+
+		error_code ec(errc::success, get_generic_category());
+		mpExecutor->Post(std::bind(&BaudLimitedLoopback::OnReadCallback, this, ec, mpReadBuff, num));
+	}
+}
+
+}
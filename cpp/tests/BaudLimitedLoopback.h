@@ -0,0 +1,84 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#ifndef __BAUD_LIMITED_LOOPBACK_H_
+#define __BAUD_LIMITED_LOOPBACK_H_
+
+#include <opendnp3/PhysicalLayerAsyncBase.h>
+
+#include "MockTimeSource.h"
+
+#include <chrono>
+#include <deque>
+
+namespace opendnp3
+{
+
+class IExecutor;
+
+/**
+ Simulates a half-duplex serial bus with a responder that echoes every write.
+
+ A write occupies the bus for its transmission time at the configured baud rate, then
+ the echo occupies it again before it can be read. Completions are scheduled as timers
+ on the executor and advance the mock time source to their expiration, so driving the
+ executor runs the bus in simulated time.
+*/
+class BaudLimitedLoopback : public PhysicalLayerAsyncBase
+{
+public:
+	BaudLimitedLoopback(Logger*, IExecutor*, MockTimeSource*, int aBaud, int aBitsPerChar);
+
+	IExecutor* GetExecutor() {
+		return mpExecutor;
+	}
+
+	/// @return the time the bus has spent transmitting
+	timer_clock::duration BusyTime() const {
+		return mBusyTime;
+	}
+
+private:
+
+	void DoOpen();
+	void DoClose();
+	void DoAsyncRead(uint8_t* apBuff, size_t aNumBytes);
+	void DoAsyncWrite(const uint8_t* apData, size_t aNumBytes);
+
+	timer_clock::time_point Occupy(size_t aNumBytes);
+	void OnWriteComplete(const timer_clock::time_point& arTime, size_t aNumBytes);
+	void OnEchoComplete(const timer_clock::time_point& arTime, std::deque<uint8_t> aEcho);
+	void CheckForRead();
+
+	IExecutor* mpExecutor;
+	MockTimeSource* mpTime;
+	std::chrono::nanoseconds mCharTime;
+	timer_clock::time_point mBusyUntil;
+	timer_clock::duration mBusyTime;
+
+	std::deque<uint8_t> mReceived;
+	uint8_t* mpReadBuff;
+	size_t mReadSize;
+};
+
+}
+
+#endif
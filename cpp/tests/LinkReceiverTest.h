@@ -24,6 +24,7 @@
 #define __LINK_RECEIVER_TEST_H_
 
 #include <opendnp3/LinkLayerReceiver.h>
+#include <opendnp3/StatisticsCounters.h>
 
 #include "LogTester.h"
 #include "BufferHelpers.h"
@@ -38,7 +39,7 @@ public:
 	LinkReceiverTest(FilterLevel aLevel = LEV_WARNING, bool aImmediate = false) :
 		LogTester(aImmediate),
 		mSink(),
-		mRx(mLog.GetLogger(aLevel, "ReceiverTest"), &mSink)
+		mRx(mLog.GetLogger(aLevel, "ReceiverTest"), &mSink, &mCounters)
 	{}
 
 	void WriteData(const LinkFrame& arFrame) {
@@ -55,6 +56,7 @@ public:
 	}
 
 	MockFrameSink mSink;
+	ChannelCounters mCounters;
 	LinkLayerReceiver mRx;
 };
 
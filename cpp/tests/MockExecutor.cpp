@@ -47,6 +47,12 @@ timer_clock::duration MockExecutor::NextDurationTimer()
 	else return timer_clock::duration::min();
 }
 
+timer_clock::time_point MockExecutor::NextTimerTime()
+{
+	if(mTimerMap.empty()) return timer_clock::time_point::max();
+	return mTimerMap.begin()->first;
+}
+
 bool MockExecutor::DispatchOne()
 {
 	if(mPostQueue.size() > 0) {
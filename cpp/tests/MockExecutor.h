@@ -71,6 +71,9 @@ public:
 
 	timer_clock::duration NextDurationTimer();
 
+	/** @returns The expiration time of the next timer, timer_clock::time_point::max() if there are none */
+	timer_clock::time_point NextTimerTime();
+
 
 private:
 
@@ -38,7 +38,9 @@ ResponseLoaderTestObject::ResponseLoaderTestObject() :
 	log(),
 	fdo(),
 	mpLogger(log.GetLogger(LEV_INFO, "rsp")),
-	vto(mpLogger)
+	vto(mpLogger),
+	pFilter(NULL),
+	numSuppressed(0)
 {}
 
 void ResponseLoaderTestObject::Load(const std::string& arAPDU)
@@ -49,10 +51,11 @@ void ResponseLoaderTestObject::Load(const std::string& arAPDU)
 	f.Write(hs, hs.Size());
 	f.Interpret();
 
-	ResponseLoader rl(mpLogger, &fdo, &vto);
+	ResponseLoader rl(mpLogger, &fdo, &vto, pFilter);
 	for(HeaderReadIterator hdr = f.BeginRead(); !hdr.IsEnd(); ++hdr) {
 		rl.Process(hdr);
 	}
+	numSuppressed = rl.NumSuppressed();
 }
 
 void ResponseLoaderTestObject::CheckBinaries(const std::string& arAPDU)
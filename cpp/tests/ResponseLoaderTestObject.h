@@ -25,6 +25,7 @@
 
 #include <opendnp3/Log.h>
 #include <opendnp3/VtoReader.h>
+#include <opendnp3/ChangeFilter.h>
 
 #include "FlexibleDataObserver.h"
 
@@ -50,6 +51,8 @@ private: EventLog log;
 public: FlexibleDataObserver fdo;
 private: Logger* mpLogger;
 public: VtoReader vto;
+public: ChangeFilter* pFilter;			// NULL unless a test sets it
+public: size_t numSuppressed;		// by the filter in the last Load()
 
 };
 
@@ -37,7 +37,7 @@ SlaveTestObject::SlaveTestObject(const SlaveConfig& arCfg, FilterLevel aLevel, b
 	mts(),
 	app(mLog.GetLogger(aLevel, "app")),
 	db(mLog.GetLogger(aLevel, "db")),
-	slave(mLog.GetLogger(aLevel, "slave"), &app, &mts, &fakeTime, &db, &cmdHandler, arCfg),
+	slave(mLog.GetLogger(aLevel, "slave"), &app, &mts, &fakeTime, &db, &cmdHandler, arCfg, &timeSource),
 	mpLogger(mLog.GetLogger(aLevel, "test"))
 {
 	app.SetUser(&slave);
@@ -32,6 +32,7 @@
 #include "MockCommandHandler.h"
 #include "MockAppLayer.h"
 #include "MockTimeManager.h"
+#include "MockTimeSource.h"
 
 namespace opendnp3
 {
@@ -52,7 +53,7 @@ public:
 	}
 
 
-	//MockTimeSource fake_time;
+	MockTimeSource timeSource;
 	MockTimeManager fakeTime;
 	MockExecutor mts;
 	MockAppLayer app;
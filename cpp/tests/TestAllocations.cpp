@@ -0,0 +1,324 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include "TestHelpers.h"
+#include "AllocationCounter.h"
+#include "FlexibleDataObserver.h"
+#include "LinkReceiverTest.h"
+#include "MockExecutor.h"
+#include "MockFrameSink.h"
+#include "MockPhysicalLayerAsync.h"
+
+#include <opendnp3/ChangeBuffer.h>
+#include <opendnp3/Database.h>
+#include <opendnp3/ITransactable.h>
+#include <opendnp3/LinkLayerRouter.h>
+#include <opendnp3/LinkRoute.h>
+#include <opendnp3/ResponseContext.h>
+#include <opendnp3/ResponseLoader.h>
+#include <opendnp3/SlaveConfig.h>
+#include <opendnp3/SlaveEventBuffer.h>
+#include <opendnp3/SlaveResponseTypes.h>
+#include <opendnp3/VtoReader.h>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+using namespace opendnp3;
+using namespace std;
+
+#define OUTPUT_PERF_NUMBERS (0)
+
+/*
+	Each case runs a steady-state scenario, discards the warm-up iterations and
+	then reports the allocations per frame, event or poll. The limits are the
+	levels measured when these tests were written. Lower them as allocations
+	are removed from the hot paths, never raise them to make a test pass.
+*/
+
+const size_t NUM_WARMUP = 50;
+const size_t NUM_OPS = 500;
+const size_t NUM_POINTS = 100;
+
+void Report(const std::string& arName, const AllocationCounter& arCounter, size_t aNumOps, const std::string& arUnit)
+{
+	if (OUTPUT_PERF_NUMBERS) {
+		cout << arName << ": " << arCounter.PerOp(aNumOps) << " allocations and "
+		     << static_cast<double>(arCounter.Bytes()) / aNumOps << " bytes per " << arUnit << endl;
+	}
+}
+
+/// The outstation's response path without the slave state machine or the application layer
+class PollFixture
+{
+public:
+
+	PollFixture() :
+		mpLogger(mLog.GetLogger(LEV_WARNING, "test")),
+		mDatabase(mpLogger),
+		mRspTypes(mConfig),
+		mContext(mpLogger, &mDatabase, &mRspTypes, EventMaxConfig(NUM_POINTS, NUM_POINTS, NUM_POINTS, 0)) {
+		mDatabase.Configure(DT_BINARY, NUM_POINTS, true);
+		mDatabase.Configure(DT_ANALOG, NUM_POINTS, true);
+		mDatabase.Configure(DT_COUNTER, NUM_POINTS, true);
+		mDatabase.SetClass(DT_BINARY, PC_CLASS_0);
+		mDatabase.SetClass(DT_ANALOG, PC_CLASS_1);
+		mDatabase.SetClass(DT_COUNTER, PC_CLASS_0);
+		mDatabase.SetEventBuffer(mContext.GetBuffer());
+	}
+
+	// group 60 var 1 reads class 0, var 2 reads class 1
+	void Poll(uint8_t aClassVar) {
+		const uint8_t request[] = { 0xC0, 0x01, 0x3C, aClassVar, 0x06 };
+		mRequest.Write(request, sizeof(request));
+		mRequest.Interpret();
+
+		mContext.Reset();
+		mContext.Configure(mRequest);
+		mContext.LoadResponse(mResponse);
+		for(mContext.ClearWritten(); !mContext.IsComplete(); mContext.ClearWritten()) {
+			mContext.LoadResponse(mResponse);
+		}
+		mContext.Reset();
+	}
+
+	void ChangeAnalogs(double aValue) {
+		Transaction t(&mDatabase);
+		for(size_t i = 0; i < NUM_POINTS; ++i) mDatabase.Update(Analog(aValue, AQ_ONLINE), i);
+	}
+
+	EventLog mLog;
+	Logger* mpLogger;
+	SlaveConfig mConfig;
+	Database mDatabase;
+	SlaveResponseTypes mRspTypes;
+	ResponseContext mContext;
+	APDU mRequest;
+	APDU mResponse;
+};
+
+/// A router with one context on a mock physical layer that is already open
+class RouterFixture
+{
+public:
+
+	RouterFixture() :
+		mpLogger(mLog.GetLogger(LEV_WARNING, "test")),
+		mPhys(mpLogger, &mExecutor),
+		mRouter(mpLogger, &mPhys, 100) {
+		mRouter.AddContext(&mSink, LinkRoute(1, 1024));
+		mPhys.SignalOpenSuccess();
+	}
+
+	// no one subscribes to the log, so only the cost of producing entries is counted
+	EventLog mLog;
+	Logger* mpLogger;
+	MockExecutor mExecutor;
+	MockPhysicalLayerAsync mPhys;
+	LinkLayerRouter mRouter;
+	MockFrameSink mSink;
+};
+
+BOOST_AUTO_TEST_SUITE(AllocationSuite)
+
+BOOST_AUTO_TEST_CASE(CountsTheCallingThread)
+{
+	AllocationCounter counter;
+	int* pValue = new int(7);
+	delete pValue;
+	BOOST_REQUIRE_EQUAL(counter.Allocations(), 1);
+	BOOST_REQUIRE_EQUAL(counter.Deallocations(), 1);
+	BOOST_REQUIRE_EQUAL(counter.Bytes(), sizeof(int));
+
+	std::atomic<bool> go(false);
+	std::thread other([&go]() {
+		while(!go) std::this_thread::yield();
+		for(size_t i = 0; i < 10; ++i) delete new int(0);
+	});
+	counter.Restart();
+	go = true;
+	other.join();
+	BOOST_REQUIRE_EQUAL(counter.Allocations(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(LinkReceiverPerFrame)
+{
+	LinkReceiverTest t;
+	uint8_t data[250];
+	for(size_t i = 0; i < sizeof(data); ++i) data[i] = static_cast<uint8_t>(i);
+	LinkFrame f;
+	f.FormatUnconfirmedUserData(true, 1, 1024, data, sizeof(data));
+
+	AllocationCounter counter;
+	for(size_t i = 0; i < NUM_WARMUP + NUM_OPS; ++i) {
+		if(i == NUM_WARMUP) counter.Restart();
+		t.WriteData(f);
+		t.mSink.Reset();
+	}
+
+	counter.Stop();
+	Report("LinkLayerReceiver", counter, NUM_OPS, "frame");
+	BOOST_REQUIRE_EQUAL(t.mCounters.Snapshot().mNumFramesRx, NUM_WARMUP + NUM_OPS);
+	BOOST_REQUIRE_EQUAL(counter.Allocations(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(RouterTransmitPerFrame)
+{
+	RouterFixture t;
+	LinkFrame f;
+	f.FormatAck(true, false, 1, 1024);
+
+	AllocationCounter counter;
+	for(size_t i = 0; i < NUM_WARMUP + NUM_OPS; ++i) {
+		if(i == NUM_WARMUP) counter.Restart();
+		t.mRouter.Transmit(f);
+		t.mPhys.SignalSendSuccess();
+	}
+
+	counter.Stop();
+	Report("LinkLayerRouter transmit", counter, NUM_OPS, "frame");
+	BOOST_REQUIRE_EQUAL(t.mPhys.NumWrites(), NUM_WARMUP + NUM_OPS);
+	BOOST_REQUIRE(counter.PerOp(NUM_OPS) <= 1.1); // the transmit queue is a deque of whole frames
+}
+
+BOOST_AUTO_TEST_CASE(RouterUnknownRoutePerFrame)
+{
+	RouterFixture t;
+
+	AllocationCounter counter;
+	for(size_t i = 0; i < NUM_WARMUP + NUM_OPS; ++i) {
+		if(i == NUM_WARMUP) counter.Restart();
+		t.mRouter.Ack(true, false, 1, 2048);
+	}
+
+	counter.Stop();
+	Report("LinkLayerRouter unknown route", counter, NUM_OPS, "frame");
+	BOOST_REQUIRE_EQUAL(t.mRouter.GetStatistics().mNumUnknownRoute, NUM_WARMUP + NUM_OPS);
+	BOOST_REQUIRE(counter.PerOp(NUM_OPS) <= 7.0); // the ostringstream in GetDestination and the strings in the LogEntry
+}
+
+BOOST_AUTO_TEST_CASE(ChangeBufferPerEvent)
+{
+	ChangeBuffer buffer;
+	FlexibleDataObserver fdo;
+
+	// warm up every point so the observer's map stops growing before counting starts
+	AllocationCounter counter;
+	for(size_t i = 0; i < NUM_POINTS + NUM_OPS; ++i) {
+		if(i == NUM_POINTS) counter.Restart();
+		Transaction t(&buffer);
+		buffer.Update(Analog(static_cast<double>(i), AQ_ONLINE), i % NUM_POINTS);
+		buffer.FlushUpdates(&fdo);
+	}
+
+	counter.Stop();
+	Report("ChangeBuffer", counter, NUM_OPS, "event");
+	BOOST_REQUIRE_EQUAL(fdo.mAnalogMap.size(), NUM_POINTS);
+	BOOST_REQUIRE_EQUAL(counter.Allocations(), 0); // the per-type vectors and mOrder keep their capacity across flushes
+}
+
+BOOST_AUTO_TEST_CASE(SlaveEventBufferPerEvent)
+{
+	SlaveEventBuffer buffer(EventMaxConfig(0, NUM_POINTS, 0, 0));
+
+	AllocationCounter counter;
+	for(size_t i = 0; i < NUM_WARMUP + NUM_OPS; ++i) {
+		if(i == NUM_WARMUP) counter.Restart();
+		for(size_t j = 0; j < NUM_POINTS; ++j) buffer.Update(Analog(static_cast<double>(i)), PC_CLASS_1, j);
+		BOOST_REQUIRE_EQUAL(buffer.Select(PC_CLASS_1), NUM_POINTS);
+		AnalogEventIter itr;
+		buffer.Begin(itr);
+		for(size_t j = 0; j < NUM_POINTS; ++j, ++itr) itr->mWritten = true;
+		buffer.ClearWritten();
+		buffer.Deselect();
+	}
+
+	counter.Stop();
+	Report("SlaveEventBuffer", counter, NUM_OPS * NUM_POINTS, "event");
+	BOOST_REQUIRE_EQUAL(buffer.Size(), 0);
+	BOOST_REQUIRE(counter.PerOp(NUM_OPS * NUM_POINTS) <= 1.0); // one set node per event
+}
+
+BOOST_AUTO_TEST_CASE(Class0PerPoll)
+{
+	PollFixture t;
+
+	AllocationCounter counter;
+	for(size_t i = 0; i < NUM_WARMUP + NUM_OPS; ++i) {
+		if(i == NUM_WARMUP) counter.Restart();
+		t.Poll(1);
+	}
+
+	counter.Stop();
+	Report("ResponseContext class 0", counter, NUM_OPS, "poll");
+	BOOST_REQUIRE(t.mResponse.Size() > 0);
+	BOOST_REQUIRE(counter.PerOp(NUM_OPS) <= 9.0); // the closures and request queues built for every static header
+}
+
+BOOST_AUTO_TEST_CASE(Class1PerPoll)
+{
+	PollFixture t;
+
+	AllocationCounter counter;
+	for(size_t i = 0; i < NUM_WARMUP + NUM_OPS; ++i) {
+		if(i == NUM_WARMUP) counter.Restart();
+		t.ChangeAnalogs(static_cast<double>(i));
+		t.Poll(2);
+	}
+
+	counter.Stop();
+	Report("Database and ResponseContext class 1", counter, NUM_OPS, "poll");
+	Report("Database and ResponseContext class 1", counter, NUM_OPS * NUM_POINTS, "event");
+	BOOST_REQUIRE(t.mResponse.Size() > 0);
+	BOOST_REQUIRE(counter.PerOp(NUM_OPS) <= 101.0); // an event buffer set node for each of the events
+}
+
+BOOST_AUTO_TEST_CASE(ResponseLoaderPerPoll)
+{
+	PollFixture os;
+	os.Poll(1);
+	APDU response(os.mResponse);
+	response.Interpret();
+
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "test");
+	FlexibleDataObserver fdo;
+	VtoReader vto(pLogger);
+
+	AllocationCounter counter;
+	for(size_t i = 0; i < NUM_WARMUP + NUM_OPS; ++i) {
+		if(i == NUM_WARMUP) counter.Restart();
+		ResponseLoader loader(pLogger, &fdo, &vto);
+		for(HeaderReadIterator hdr = response.BeginRead(); !hdr.IsEnd(); ++hdr) loader.Process(hdr);
+	}
+
+	counter.Stop();
+	Report("ResponseLoader class 0", counter, NUM_OPS, "poll");
+	BOOST_REQUIRE_EQUAL(fdo.mAnalogMap.size(), NUM_POINTS);
+	BOOST_REQUIRE_EQUAL(counter.Allocations(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -33,8 +33,10 @@
 #include "MockTimeSource.h"
 
 #include <boost/bind.hpp>
+#include <algorithm>
 #include <queue>
 #include <chrono>
+#include <vector>
 
 using namespace opendnp3;
 using namespace boost;
@@ -260,4 +262,190 @@ BOOST_AUTO_TEST_CASE(TimerUsage)
 	BOOST_REQUIRE_EQUAL(mth.Front(), pT2); mth.Complete(true);
 }
 
+BOOST_AUTO_TEST_CASE(DeadlineRunsAheadOfPriority)
+{
+	MockTaskHandler mth;
+	MockTimeSource fakeTime;
+	MockExecutor exe;
+
+	fakeTime.SetToNow();
+
+	AsyncTaskGroup group(&exe, &fakeTime);
+	AsyncTaskBase* pPoll = group.Add(1000, 1000, 5, mth.GetHandler());
+	AsyncTaskContinuous* pCommand = group.AddContinuous(0, mth.GetHandler());
+	pCommand->SetDeadline(50);
+
+	group.Enable();
+
+	BOOST_REQUIRE_EQUAL(mth.Front(), pCommand);
+	mth.Pop();
+	pCommand->Disable();
+	BOOST_REQUIRE_EQUAL(mth.Front(), pPoll);
+}
+
+BOOST_AUTO_TEST_CASE(EarliestDeadlineFirst)
+{
+	MockTaskHandler mth;
+	MockTimeSource fakeTime;
+	MockExecutor exe;
+
+	fakeTime.SetToNow();
+
+	AsyncTaskGroup group(&exe, &fakeTime);
+	AsyncTaskContinuous* pBusy = group.AddContinuous(0, mth.GetHandler());
+	AsyncTaskContinuous* pT1 = group.AddContinuous(0, mth.GetHandler());
+	AsyncTaskContinuous* pT2 = group.AddContinuous(0, mth.GetHandler());
+	pT1->SetDeadline(100);
+	pT2->SetDeadline(50);
+
+	pBusy->Enable();
+	BOOST_REQUIRE_EQUAL(mth.Front(), pBusy);
+
+	pT1->Enable();
+	fakeTime.Advance(milliseconds(80));
+	pT2->Enable();
+
+	// T1 is due 20ms from now, T2 in 50ms
+	mth.Complete(true);
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT1);
+	mth.Pop();
+	pT1->Disable();
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT2);
+
+	BOOST_REQUIRE_EQUAL(pT1->NumDeadlineMisses(), 0);
+	BOOST_REQUIRE_EQUAL(pT2->NumDeadlineMisses(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(LatencyAndDeadlineMisses)
+{
+	MockTaskHandler mth;
+	MockTimeSource fakeTime;
+	MockExecutor exe;
+
+	fakeTime.SetToNow();
+
+	AsyncTaskGroup group(&exe, &fakeTime);
+	AsyncTaskContinuous* pBusy = group.AddContinuous(1, mth.GetHandler());
+	AsyncTaskContinuous* pT1 = group.AddContinuous(0, mth.GetHandler());
+	pT1->SetDeadline(20);
+
+	pBusy->Enable();
+	pT1->Enable();
+	fakeTime.Advance(milliseconds(30));
+	mth.Complete(true);
+
+	BOOST_REQUIRE_EQUAL(mth.Front(), pT1);
+	BOOST_REQUIRE_EQUAL(pT1->GetLatency().NumSamples(), 1);
+	BOOST_REQUIRE(pT1->GetLatency().Max() == milliseconds(30));
+	BOOST_REQUIRE_EQUAL(pT1->NumDeadlineMisses(), 1);
+
+	BOOST_REQUIRE_EQUAL(pBusy->GetLatency().NumSamples(), 1);
+	BOOST_REQUIRE(pBusy->GetLatency().Max() == milliseconds(0));
+}
+
+BOOST_AUTO_TEST_CASE(AgingPreventsStarvation)
+{
+	MockTaskHandler mth;
+	MockTimeSource fakeTime;
+	MockExecutor exe;
+
+	fakeTime.SetToNow();
+
+	AsyncTaskGroup group(&exe, &fakeTime);
+	AsyncTaskContinuous* pHigh = group.AddContinuous(5, mth.GetHandler());
+	AsyncTaskBase* pPoll = group.Add(1000, 1000, 0, mth.GetHandler());
+	pPoll->SetAging(1000);
+
+	group.Enable();
+
+	// the poll gains a level every second, it wins once it has passed the other task
+	for(size_t i = 0; i < 6; ++i) {
+		BOOST_REQUIRE_EQUAL(mth.Front(), pHigh);
+		fakeTime.Advance(milliseconds(1000));
+		mth.Complete(true);
+	}
+
+	BOOST_REQUIRE_EQUAL(mth.Front(), pPoll);
+	BOOST_REQUIRE(pPoll->GetLatency().Max() == milliseconds(6000));
+}
+
+BOOST_AUTO_TEST_CASE(DeadlineRunsFromDemandTime)
+{
+	MockTaskHandler mth;
+	MockTimeSource fakeTime;
+	MockExecutor exe;
+
+	fakeTime.SetToNow();
+	timer_clock::time_point requested = fakeTime.GetUTC();
+
+	AsyncTaskGroup group(&exe, &fakeTime);
+	AsyncTaskContinuous* pBusy = group.AddContinuous(0, mth.GetHandler());
+	AsyncTaskContinuous* pCommand = group.AddContinuous(0, mth.GetHandler());
+	AsyncTaskContinuous* pOther = group.AddContinuous(0, mth.GetHandler());
+	pCommand->SetDeadline(50);
+	pCommand->SetDemandTime([requested]() {
+		return requested;
+	});
+	pOther->SetDeadline(30);
+
+	pBusy->Enable();
+	fakeTime.Advance(milliseconds(40));
+	pCommand->Enable();
+	pOther->Enable();
+
+	// the command is due 50ms after it was requested, not 50ms after the task was enabled
+	fakeTime.Advance(milliseconds(20));
+	mth.Pop();
+	pBusy->Disable();
+	BOOST_REQUIRE_EQUAL(mth.Front(), pCommand);
+	BOOST_REQUIRE_EQUAL(pCommand->NumDeadlineMisses(), 1);
+	mth.Pop();
+	pCommand->Disable();
+	BOOST_REQUIRE_EQUAL(mth.Front(), pOther);
+	BOOST_REQUIRE_EQUAL(pOther->NumDeadlineMisses(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ManyTasksInOneGroup)
+{
+	MockTaskHandler mth;
+	MockTimeSource fakeTime;
+	MockExecutor exe;
+
+	fakeTime.SetToNow();
+
+	AsyncTaskGroup group(&exe, &fakeTime);
+	AsyncTaskContinuous* pBusy = group.AddContinuous(0, mth.GetHandler());
+	pBusy->Enable();
+
+	// a mix of deadlines and priorities like a multidrop channel with many masters
+	const size_t NUM_TASKS = 2000;
+	std::vector<AsyncTaskContinuous*> tasks;
+	for(size_t i = 0; i < NUM_TASKS; ++i) {
+		AsyncTaskContinuous* pTask = group.AddContinuous(static_cast<int>(i % 7), mth.GetHandler());
+		if(i % 3 == 0) pTask->SetDeadline(static_cast<millis_t>((i % 5 + 1) * 10));
+		pTask->Enable();
+		tasks.push_back(pTask);
+	}
+
+	std::vector<size_t> expected;
+	for(size_t i = 0; i < NUM_TASKS; ++i) expected.push_back(i);
+	std::sort(expected.begin(), expected.end(), [](size_t l, size_t r) {
+		millis_t dl = (l % 3 == 0) ? static_cast<millis_t>(l % 5) : 100;
+		millis_t dr = (r % 3 == 0) ? static_cast<millis_t>(r % 5) : 100;
+		if(dl != dr) return dl < dr;
+		if(l % 7 != r % 7) return l % 7 > r % 7;
+		return l < r;
+	});
+
+	mth.Pop();
+	pBusy->Disable();
+	for(size_t i: expected) {
+		BOOST_REQUIRE_EQUAL(mth.Size(), 1);
+		BOOST_REQUIRE_EQUAL(mth.Front(), tasks[i]);
+		mth.Pop();
+		tasks[i]->Disable();
+	}
+	BOOST_REQUIRE_EQUAL(mth.Size(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,261 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/AsyncTaskContinuous.h>
+#include <opendnp3/AsyncTaskGroup.h>
+#include <opendnp3/BusScheduler.h>
+#include <opendnp3/Exception.h>
+#include <opendnp3/LinkFrame.h>
+#include <opendnp3/LinkLayerRouter.h>
+#include <opendnp3/SerialTypes.h>
+#include <opendnp3/TrackingTaskGroup.h>
+
+#include "BaudLimitedLoopback.h"
+#include "LogTester.h"
+#include "MockExecutor.h"
+#include "MockFrameSink.h"
+#include "MockTimeSource.h"
+#include "TestHelpers.h"
+
+#include <deque>
+#include <string>
+
+using namespace opendnp3;
+using namespace std::chrono;
+
+class BusTaskRecorder
+{
+public:
+
+	TaskHandler GetHandler(const std::string& arName) {
+		return std::bind(&BusTaskRecorder::OnTask, this, arName, std::placeholders::_1);
+	}
+
+	size_t Size() {
+		return mTasks.size();
+	}
+
+	std::string Front() {
+		return mTasks.empty() ? "" : mTasks.front().first;
+	}
+
+	void Complete(bool aSuccess) {
+		ITask* p = mTasks.front().second;
+		mTasks.pop_front();
+		p->OnComplete(aSuccess);
+	}
+
+private:
+
+	typedef std::pair<std::string, ITask*> Record;
+	std::deque<Record> mTasks;
+
+	void OnTask(const std::string& arName, ITask* apTask) {
+		mTasks.push_back(Record(arName, apTask));
+	}
+};
+
+class BusTaskTest
+{
+public:
+
+	BusTaskTest() :
+		scheduler(&time, 9600, 10, 8000),
+		group(&exe, &time),
+		a(NULL),
+		b(NULL)
+	{
+		group.SetScheduler(&scheduler);
+	}
+
+	void AddTasks(TrackingTaskGroup& arA, TrackingTaskGroup& arB) {
+		a = arA.AddContinuous(0, rec.GetHandler("a"), "a");
+		b = arB.AddContinuous(0, rec.GetHandler("b"), "b");
+		a->SilentEnable();
+		b->SilentEnable();
+		group.Enable();
+	}
+
+	MockTimeSource time;
+	MockExecutor exe;
+	BusScheduler scheduler;
+	AsyncTaskGroup group;
+	BusTaskRecorder rec;
+	AsyncTaskContinuous* a;
+	AsyncTaskContinuous* b;
+};
+
+BOOST_AUTO_TEST_SUITE(BusSchedulerSuite)
+
+BOOST_AUTO_TEST_CASE(TransmitTimeFromBaud)
+{
+	MockTimeSource time;
+	BusScheduler scheduler(&time, 9600, 10);
+
+	// 10 bits per character at 9600 baud is ~1.04 milliseconds a byte
+	BOOST_REQUIRE_EQUAL(duration_cast<microseconds>(scheduler.TransmitTime(1)).count(), 1041);
+	BOOST_REQUIRE_EQUAL(duration_cast<milliseconds>(scheduler.TransmitTime(292)).count(), 304);
+
+	SerialSettings s;
+	BOOST_REQUIRE_EQUAL(GetBitsPerCharacter(s), 10);
+	s.mParity = PAR_EVEN;
+	s.mStopBits = 2;
+	BOOST_REQUIRE_EQUAL(GetBitsPerCharacter(s), 12);
+
+	BOOST_REQUIRE_THROW(BusScheduler(&time, 0, 10), ArgumentException);
+	BOOST_REQUIRE_THROW(BusScheduler(&time, 9600, 0), ArgumentException);
+}
+
+BOOST_AUTO_TEST_CASE(BackoffDoublesAndCaps)
+{
+	MockTimeSource time;
+	BusScheduler scheduler(&time, 9600, 10, 8000);
+	BusDevice* pDevice = scheduler.AddDevice(1000);
+
+	BOOST_REQUIRE_FALSE(pDevice->IsInBackoff(time.GetUTC()));
+
+	millis_t expected[] = { 1000, 2000, 4000, 8000, 8000 };
+	for(millis_t backoff: expected) {
+		scheduler.OnComplete(pDevice, false);
+		BOOST_REQUIRE(pDevice->BackoffUntil() == time.GetUTC() + milliseconds(backoff));
+		BOOST_REQUIRE(pDevice->IsInBackoff(time.GetUTC() + milliseconds(backoff - 1)));
+		BOOST_REQUIRE_FALSE(pDevice->IsInBackoff(time.GetUTC() + milliseconds(backoff)));
+	}
+
+	BOOST_REQUIRE_EQUAL(pDevice->NumFailures(), 5);
+	BOOST_REQUIRE_EQUAL(pDevice->NumConsecutiveFailures(), 5);
+
+	scheduler.OnComplete(pDevice, true);
+	BOOST_REQUIRE_FALSE(pDevice->IsInBackoff(time.GetUTC()));
+	BOOST_REQUIRE_EQUAL(pDevice->NumConsecutiveFailures(), 0);
+	BOOST_REQUIRE_EQUAL(pDevice->NumTransactions(), 6);
+
+	scheduler.OnComplete(pDevice, false);
+	BOOST_REQUIRE(pDevice->BackoffUntil() == time.GetUTC() + milliseconds(1000));
+
+	scheduler.RemoveDevice(pDevice);
+	BOOST_REQUIRE_THROW(scheduler.RemoveDevice(pDevice), ArgumentException);
+}
+
+BOOST_AUTO_TEST_CASE(TasksAlternateBetweenDevices)
+{
+	BusTaskTest t;
+	TrackingTaskGroup da(&t.group, 1000);
+	TrackingTaskGroup db(&t.group, 1000);
+	t.AddTasks(da, db);
+
+	BOOST_REQUIRE_EQUAL(t.rec.Size(), 1);
+	std::string first = t.rec.Front();
+	std::string second = (first == "a") ? "b" : "a";
+
+	for(size_t i = 0; i < 5; ++i) {
+		BOOST_REQUIRE_EQUAL(t.rec.Front(), first);
+		t.rec.Complete(true);
+		BOOST_REQUIRE_EQUAL(t.rec.Front(), second);
+		t.rec.Complete(true);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(FailingDeviceIsSkipped)
+{
+	BusTaskTest t;
+	TrackingTaskGroup da(&t.group, 1000);
+	TrackingTaskGroup db(&t.group, 1000);
+	t.AddTasks(da, db);
+
+	if(t.rec.Front() == "b") t.rec.Complete(true);
+	BOOST_REQUIRE_EQUAL(t.rec.Front(), "a");
+	t.rec.Complete(false);
+
+	// a is backing off, so b gets the bus to itself
+	for(size_t i = 0; i < 3; ++i) {
+		BOOST_REQUIRE_EQUAL(t.rec.Front(), "b");
+		t.rec.Complete(true);
+	}
+
+	t.time.Advance(milliseconds(1000));
+	BOOST_REQUIRE_EQUAL(t.rec.Front(), "b");
+	t.rec.Complete(true);
+	BOOST_REQUIRE_EQUAL(t.rec.Front(), "a");
+}
+
+BOOST_AUTO_TEST_CASE(TimerWaitsForBackoff)
+{
+	BusTaskTest t;
+	TrackingTaskGroup da(&t.group, 1000);
+	AsyncTaskContinuous* pTask = da.AddContinuous(0, t.rec.GetHandler("a"), "a");
+	pTask->Enable();
+
+	BOOST_REQUIRE_EQUAL(t.rec.Front(), "a");
+	t.rec.Complete(false);
+	BOOST_REQUIRE_EQUAL(t.rec.Size(), 0);
+	BOOST_REQUIRE_EQUAL(t.exe.NumActive(), 1);
+
+	t.time.Advance(milliseconds(1000));
+	BOOST_REQUIRE(t.exe.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.rec.Front(), "a");
+}
+
+BOOST_AUTO_TEST_CASE(UtilizationOnBaudLimitedLoopback)
+{
+	LogTester log;
+	MockTimeSource time;
+	MockExecutor exe;
+	BusScheduler scheduler(&time, 9600, 10);
+	BaudLimitedLoopback phys(log.mLog.GetLogger(LEV_WARNING, "Physical"), &exe, &time, 9600, 10);
+	LinkLayerRouter router(log.mLog.GetLogger(LEV_WARNING, "Router"), &phys, 1000);
+	router.SetTrafficHandler(std::bind(&BusScheduler::OnTraffic, &scheduler, std::placeholders::_1));
+
+	MockFrameSink master, echo;
+	router.AddContext(&master, LinkRoute(1, 1024));
+	router.AddContext(&echo, LinkRoute(1024, 1));
+	exe.Dispatch();
+	BOOST_REQUIRE(master.mLowerOnline);
+
+	const size_t NUM_FRAMES = 20;
+	LinkFrame f;
+	f.FormatAck(true, false, 1, 1024);
+
+	// frames sent back to back keep the bus busy
+	for(size_t i = 0; i < NUM_FRAMES; ++i) router.Transmit(f);
+	exe.Dispatch();
+	BOOST_REQUIRE_EQUAL(echo.mNumFrames, NUM_FRAMES);
+	BOOST_REQUIRE_EQUAL(scheduler.NumBytes(), 2 * NUM_FRAMES * f.GetSize());
+	BOOST_REQUIRE_CLOSE(scheduler.SampleUtilization(), 1.0, 0.1);
+
+	time.Advance(seconds(1));
+	BOOST_REQUIRE_EQUAL(scheduler.SampleUtilization(), 0.0);
+
+	// idle for as long as the bus was busy
+	for(size_t i = 0; i < NUM_FRAMES; ++i) router.Transmit(f);
+	exe.Dispatch();
+	time.Advance(phys.BusyTime() / 2);
+	BOOST_REQUIRE_CLOSE(scheduler.SampleUtilization(), 0.5, 0.1);
+
+	BOOST_REQUIRE(log.IsLogErrorFree());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,164 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/CurrentValueTable.h>
+
+#include "FlexibleDataObserver.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace opendnp3;
+
+BOOST_AUTO_TEST_SUITE(CurrentValueTableSuite)
+
+BOOST_AUTO_TEST_CASE(EmptyUntilUpdated)
+{
+	FlexibleDataObserver fdo;
+	CurrentValueTable table(&fdo);
+
+	CurrentValues values;
+	table.Read(values);
+	BOOST_REQUIRE_EQUAL(values.mVersion, 0);
+	BOOST_REQUIRE(values.mBinary.empty());
+	BOOST_REQUIRE(values.mAnalog.empty());
+	BOOST_REQUIRE(values.mCounter.empty());
+	BOOST_REQUIRE(values.mControlStatus.empty());
+	BOOST_REQUIRE(values.mSetpointStatus.empty());
+}
+
+BOOST_AUTO_TEST_CASE(KeepsLatestValueAndForwards)
+{
+	FlexibleDataObserver fdo;
+	CurrentValueTable table(&fdo);
+
+	{
+		Transaction t(&table);
+		Analog analog(12.5, AQ_ONLINE);
+		analog.SetTime(1000);
+		table.Update(analog, 3);
+		table.Update(Binary(true, BQ_ONLINE), 1);
+		table.Update(Counter(7, CQ_ONLINE), 0);
+		table.Update(ControlStatus(true, TQ_ONLINE), 0);
+		table.Update(SetpointStatus(4.0, PQ_ONLINE), 1);
+	}
+	{
+		Transaction t(&table);
+		table.Update(Analog(13.5, AQ_COMM_LOST), 3);
+	}
+
+	CurrentValues values;
+	table.Read(values);
+	BOOST_REQUIRE_EQUAL(values.mVersion, 2);
+
+	// indices that weren't reported keep their restart quality
+	BOOST_REQUIRE_EQUAL(values.mAnalog.size(), 4);
+	BOOST_REQUIRE_EQUAL(values.mAnalog[0].GetQuality(), AQ_RESTART);
+	BOOST_REQUIRE_EQUAL(values.mAnalog[3].GetValue(), 13.5);
+	BOOST_REQUIRE_EQUAL(values.mAnalog[3].GetQuality(), AQ_COMM_LOST);
+	BOOST_REQUIRE_EQUAL(values.mAnalog[3].GetTime(), 0);
+
+	BOOST_REQUIRE_EQUAL(values.mBinary.size(), 2);
+	BOOST_REQUIRE(values.mBinary[1].GetValue());
+	BOOST_REQUIRE_EQUAL(values.mCounter[0].GetValue(), 7);
+	BOOST_REQUIRE(values.mControlStatus[0].GetValue());
+	BOOST_REQUIRE_EQUAL(values.mSetpointStatus[1].GetValue(), 4.0);
+
+	BOOST_REQUIRE(fdo.Check(true, BQ_ONLINE, 1));
+	BOOST_REQUIRE(fdo.Check(13.5, AQ_COMM_LOST, 3));
+	BOOST_REQUIRE_EQUAL(table.Version(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(GrowsPastInitialStorage)
+{
+	FlexibleDataObserver fdo;
+	CurrentValueTable table(&fdo);
+
+	for(size_t i = 0; i < 1000; ++i) {
+		Transaction t(&table);
+		table.Update(Counter(static_cast<uint32_t>(i), CQ_ONLINE), i);
+	}
+
+	CurrentValues values;
+	table.Read(values);
+	BOOST_REQUIRE_EQUAL(values.mCounter.size(), 1000);
+	for(size_t i = 0; i < 1000; ++i) BOOST_REQUIRE_EQUAL(values.mCounter[i].GetValue(), i);
+}
+
+BOOST_AUTO_TEST_CASE(IgnoresIndicesPastTheLimit)
+{
+	FlexibleDataObserver fdo;
+	CurrentValueTable table(&fdo);
+
+	{
+		Transaction t(&table);
+		table.Update(Counter(1, CQ_ONLINE), 0xFFFFFFFF);
+	}
+
+	CurrentValues values;
+	table.Read(values);
+	BOOST_REQUIRE(values.mCounter.empty());
+	BOOST_REQUIRE(fdo.Check(1, CQ_ONLINE, 0xFFFFFFFF));
+}
+
+// every transaction writes the same value to all of the points, so a torn snapshot would show two values
+BOOST_AUTO_TEST_CASE(SnapshotsAreConsistentWhileWriting)
+{
+	const size_t NUM_POINTS = 500;
+	const uint32_t NUM_TRANSACTIONS = 2000;
+
+	FlexibleDataObserver fdo;
+	CurrentValueTable table(&fdo);
+	std::atomic<bool> done(false);
+
+	std::thread writer([&]() {
+		for(uint32_t value = 1; value <= NUM_TRANSACTIONS; ++value) {
+			Transaction t(&table);
+			// the table grows while readers are copying it
+			size_t count = std::min<size_t>(NUM_POINTS, value);
+			for(size_t i = 0; i < count; ++i) table.Update(Counter(value, CQ_ONLINE), i);
+		}
+		done = true;
+	});
+
+	CurrentValues values;
+	uint64_t lastVersion = 0;
+	do {
+		table.Read(values);
+		BOOST_REQUIRE(values.mVersion >= lastVersion);
+		lastVersion = values.mVersion;
+for(auto& counter: values.mCounter) {
+			if(counter.GetValue() != values.mVersion) BOOST_FAIL("Snapshot mixes transactions");
+		}
+	}
+	while(!done);
+
+	writer.join();
+	table.Read(values);
+	BOOST_REQUIRE_EQUAL(values.mVersion, NUM_TRANSACTIONS);
+	BOOST_REQUIRE_EQUAL(values.mCounter.size(), NUM_POINTS);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
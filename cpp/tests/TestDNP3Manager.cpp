@@ -32,7 +32,10 @@
 #include <opendnp3/IVtoEndpoint.h>
 #include <opendnp3/LogToStdio.h>
 #include <opendnp3/SimpleDataObserver.h>
+#include <opendnp3/Exception.h>
 
+#include <atomic>
+#include <chrono>
 #include <thread>
 
 using namespace opendnp3;
@@ -131,7 +134,101 @@ BOOST_AUTO_TEST_CASE(ConstructionDestructionWithVtoRoutersManualVtoShutdown)
 	}
 }
 
+#ifdef OPENDNP3_IO_URING
+BOOST_AUTO_TEST_CASE(ConstructionDestructionIoUring)
+{
+	for(int i = 0; i < ITERATIONS; ++i) {
+
+		DNP3Manager mgr(std::thread::hardware_concurrency());
+
+		auto pClient = mgr.AddTCPClient("client", LEV_INFO, 5000, "127.0.0.1", 20000, TB_IO_URING);
+		auto pServer = mgr.AddTCPServer("server", LEV_INFO, 5000, "127.0.0.1", 20000, TB_IO_URING);
+		pClient->AddMaster("master", LEV_INFO, NullDataObserver::Inst(), MasterStackConfig());
+		pServer->AddOutstation("outstation", LEV_INFO, SuccessCommandHandler::Inst(), SlaveStackConfig());
+
+		if(i % 2) pClient->Shutdown();
+	}
+}
+#else
+BOOST_AUTO_TEST_CASE(IoUringNotCompiledIn)
+{
+	DNP3Manager mgr(1);
+	BOOST_REQUIRE_THROW(mgr.AddTCPClient("client", LEV_INFO, 5000, "127.0.0.1", 20000, TB_IO_URING), ArgumentException);
+}
+#endif
+
+#ifdef OPENDNP3_SHARED_MEMORY
+BOOST_AUTO_TEST_CASE(ConstructionDestructionSharedMemory)
+{
+	for(int i = 0; i < ITERATIONS; ++i) {
+
+		DNP3Manager mgr(std::thread::hardware_concurrency());
 
+		auto pClient = mgr.AddSharedMemoryClient("client", LEV_INFO, 5000, "dnp3test_manager");
+		auto pServer = mgr.AddSharedMemoryServer("server", LEV_INFO, 5000, "dnp3test_manager");
+		pClient->AddMaster("master", LEV_INFO, NullDataObserver::Inst(), MasterStackConfig());
+		pServer->AddOutstation("outstation", LEV_INFO, SuccessCommandHandler::Inst(), SlaveStackConfig());
+
+		if(i % 2) pServer->Shutdown();
+	}
+}
+#else
+BOOST_AUTO_TEST_CASE(SharedMemoryNotCompiledIn)
+{
+	DNP3Manager mgr(1);
+	BOOST_REQUIRE_THROW(mgr.AddSharedMemoryServer("server", LEV_INFO, 5000, "dnp3test_manager"), ArgumentException);
+}
+#endif
+
+/// Records which thread ends the transactions of a master's observer
+class DeliveryThreadObserver : public NullDataObserver
+{
+public:
+	DeliveryThreadObserver() : mNumTransactions(0) {}
+
+	std::atomic<size_t> mNumTransactions;
+	std::thread::id mThread;
+
+private:
+	void _End() {
+		mThread = std::this_thread::get_id();
+		++mNumTransactions;
+	}
+};
+
+BOOST_AUTO_TEST_CASE(MasterWithDeliveryQueue)
+{
+	DeliveryThreadObserver observer;
+	std::atomic<size_t> numThreads(0);
+	{
+		DNP3Manager mgr(1, [&numThreads]() {
+			++numThreads;
+		});
+		mgr.SetDeliveryConcurrency(2);
+
+		MasterStackConfig masterCfg;
+		masterCfg.delivery = DeliveryConfig(100, DP_CONFLATE);
+		SlaveStackConfig slaveCfg;
+		slaveCfg.device = DeviceTemplate(5, 5);
+
+		auto pClient = mgr.AddTCPClient("client", LEV_INFO, 500, "127.0.0.1", 20000);
+		auto pServer = mgr.AddTCPServer("server", LEV_INFO, 500, "127.0.0.1", 20000);
+		auto pMaster = pClient->AddMaster("master", LEV_INFO, &observer, masterCfg);
+		pServer->AddOutstation("outstation", LEV_INFO, SuccessCommandHandler::Inst(), slaveCfg);
+
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while(observer.mNumTransactions == 0 && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		BOOST_REQUIRE(observer.mNumTransactions > 0);
+		BOOST_REQUIRE(pMaster->GetStatistics().mDeliveryQueueMaxDepth >= 10);
+	}
+
+	// the io thread and both delivery threads
+	BOOST_REQUIRE_EQUAL(numThreads, 3);
+	BOOST_REQUIRE(observer.mThread != std::this_thread::get_id());
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,253 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include "TestHelpers.h"
+#include "StopWatch.h"
+#include "DatabaseTestObject.h"
+
+#include <stdio.h>
+#include <fstream>
+#include <iostream>
+
+#define OUTPUT_PERF_NUMBERS	(0)
+
+using namespace std;
+using namespace std::chrono;
+using namespace opendnp3;
+
+const char* SNAPSHOT_PATH = "TestDatabaseSnapshot.dat";
+
+class SnapshotFile
+{
+public:
+	SnapshotFile() {
+		remove(SNAPSHOT_PATH);
+	}
+	~SnapshotFile() {
+		remove(SNAPSHOT_PATH);
+	}
+};
+
+void ConfigureAll(Database& arDB, size_t aNum)
+{
+	arDB.Configure(DT_BINARY, aNum);
+	arDB.Configure(DT_ANALOG, aNum);
+	arDB.Configure(DT_COUNTER, aNum);
+	arDB.Configure(DT_CONTROL_STATUS, aNum);
+	arDB.Configure(DT_SETPOINT_STATUS, aNum);
+	arDB.SetClass(DT_BINARY, PC_CLASS_1);
+	arDB.SetClass(DT_ANALOG, PC_CLASS_1);
+	arDB.SetClass(DT_COUNTER, PC_CLASS_1);
+}
+
+void LoadAll(Database& arDB, size_t aNum)
+{
+	Transaction tr(&arDB);
+	for(size_t i = 0; i < aNum; ++i) {
+		arDB.Update(Binary(i % 2 == 0, BQ_ONLINE), i);
+		arDB.Update(Analog(i * 1.5, AQ_ONLINE), i);
+		arDB.Update(Counter(static_cast<uint32_t>(i * 3), CQ_ONLINE), i);
+		arDB.Update(ControlStatus(i % 3 == 0, TQ_ONLINE), i);
+		arDB.Update(SetpointStatus(i * 2.5, PQ_ONLINE), i);
+	}
+}
+
+void SaveSnapshotOf(size_t aNum)
+{
+	DatabaseTestObject t;
+	ConfigureAll(t.db, aNum);
+	LoadAll(t.db, aNum);
+	t.db.SaveSnapshot(SNAPSHOT_PATH);
+}
+
+BOOST_AUTO_TEST_SUITE(DatabaseSnapshotSuite)
+
+BOOST_AUTO_TEST_CASE(RestoresValuesQualityAndTime)
+{
+	SnapshotFile file;
+	{
+		DatabaseTestObject t;
+		ConfigureAll(t.db, 3);
+		Transaction tr(&t.db);
+		Analog a(42.5, AQ_ONLINE | AQ_LOCAL_FORCED_DATA);
+		a.SetTime(123456);
+		t.db.Update(a, 1);
+		t.db.Update(Binary(true, BQ_ONLINE), 2);
+		t.db.Update(Counter(700000, CQ_ONLINE), 0);
+		t.db.Update(SetpointStatus(-3.25, PQ_ONLINE), 2);
+		t.db.Update(ControlStatus(true, TQ_ONLINE), 1);
+		t.db.SaveSnapshot(SNAPSHOT_PATH);
+	}
+
+	DatabaseTestObject t;
+	ConfigureAll(t.db, 3);
+	BOOST_REQUIRE_EQUAL(t.db.LoadSnapshot(SNAPSHOT_PATH), 15);
+
+	AnalogIterator ai;
+	t.db.Begin(ai);
+	BOOST_REQUIRE_EQUAL(ai[1].mValue.GetValue(), 42.5);
+	BOOST_REQUIRE_EQUAL(ai[1].mValue.GetQuality(), AQ_ONLINE | AQ_LOCAL_FORCED_DATA);
+	BOOST_REQUIRE_EQUAL(ai[1].mValue.GetTime(), 123456);
+	BOOST_REQUIRE_EQUAL(ai[0].mValue.GetQuality(), AQ_RESTART);
+
+	BinaryIterator bi;
+	t.db.Begin(bi);
+	BOOST_REQUIRE(bi[2].mValue.GetValue());
+	BOOST_REQUIRE(bi[2].mValue.CheckQualityBit(BQ_ONLINE));
+	BOOST_REQUIRE_FALSE(bi[1].mValue.GetValue());
+
+	CounterIterator ci;
+	t.db.Begin(ci);
+	BOOST_REQUIRE_EQUAL(ci[0].mValue.GetValue(), 700000);
+
+	ControlIterator ti;
+	t.db.Begin(ti);
+	BOOST_REQUIRE(ti[1].mValue.GetValue());
+
+	SetpointIterator si;
+	t.db.Begin(si);
+	BOOST_REQUIRE_EQUAL(si[2].mValue.GetValue(), -3.25);
+}
+
+BOOST_AUTO_TEST_CASE(LoadDoesNotGenerateEvents)
+{
+	SnapshotFile file;
+	SaveSnapshotOf(10);
+
+	DatabaseTestObject t;
+	ConfigureAll(t.db, 10);
+	t.db.SetDeadband(DT_ANALOG, 4, 2.0);
+	BOOST_REQUIRE_EQUAL(t.db.LoadSnapshot(SNAPSHOT_PATH), 50);
+	BOOST_REQUIRE(t.buffer.mBinaryEvents.empty());
+	BOOST_REQUIRE(t.buffer.mAnalogEvents.empty());
+	BOOST_REQUIRE(t.buffer.mCounterEvents.empty());
+
+	// change detection resumes from the restored values
+	Transaction tr(&t.db);
+	t.db.Update(Binary(true, BQ_ONLINE), 4);
+	t.db.Update(Analog(7.0, AQ_ONLINE), 4);
+	BOOST_REQUIRE(t.buffer.mBinaryEvents.empty());
+	BOOST_REQUIRE(t.buffer.mAnalogEvents.empty());
+
+	t.db.Update(Analog(8.5, AQ_ONLINE), 4);
+	BOOST_REQUIRE_EQUAL(t.buffer.mAnalogEvents.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(MissingSnapshotRestoresNothing)
+{
+	SnapshotFile file;
+	DatabaseTestObject t;
+	ConfigureAll(t.db, 10);
+	BOOST_REQUIRE_EQUAL(t.db.LoadSnapshot(SNAPSHOT_PATH), 0);
+}
+
+BOOST_AUTO_TEST_CASE(CorruptSnapshotIsIgnored)
+{
+	SnapshotFile file;
+	{
+		ofstream out(SNAPSHOT_PATH, ios_base::binary);
+		for(size_t i = 0; i < 1000; ++i) out.put(static_cast<char>(i));
+	}
+
+	DatabaseTestObject t;
+	ConfigureAll(t.db, 10);
+	BOOST_REQUIRE_EQUAL(t.db.LoadSnapshot(SNAPSHOT_PATH), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TruncatedSnapshotIsIgnored)
+{
+	SnapshotFile file;
+	SaveSnapshotOf(100);
+
+	string contents;
+	{
+		ifstream in(SNAPSHOT_PATH, ios_base::binary);
+		contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+	}
+	{
+		ofstream out(SNAPSHOT_PATH, ios_base::binary | ios_base::trunc);
+		out.write(contents.data(), contents.size() / 2);
+	}
+
+	DatabaseTestObject t;
+	ConfigureAll(t.db, 100);
+	BOOST_REQUIRE_EQUAL(t.db.LoadSnapshot(SNAPSHOT_PATH), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TemplateChangesRestoreCommonPoints)
+{
+	SnapshotFile file;
+	SaveSnapshotOf(10);
+
+	{
+		DatabaseTestObject t;
+		ConfigureAll(t.db, 20);
+		BOOST_REQUIRE_EQUAL(t.db.LoadSnapshot(SNAPSHOT_PATH), 50);
+
+		AnalogIterator ai;
+		t.db.Begin(ai);
+		BOOST_REQUIRE_EQUAL(ai[9].mValue.GetValue(), 13.5);
+		BOOST_REQUIRE_EQUAL(ai[10].mValue.GetQuality(), AQ_RESTART);
+	}
+
+	DatabaseTestObject t;
+	ConfigureAll(t.db, 5);
+	BOOST_REQUIRE_EQUAL(t.db.LoadSnapshot(SNAPSHOT_PATH), 25);
+}
+
+BOOST_AUTO_TEST_CASE(SaveReplacesPreviousSnapshot)
+{
+	SnapshotFile file;
+	SaveSnapshotOf(10);
+	SaveSnapshotOf(4);
+
+	DatabaseTestObject t;
+	ConfigureAll(t.db, 10);
+	BOOST_REQUIRE_EQUAL(t.db.LoadSnapshot(SNAPSHOT_PATH), 20);
+}
+
+BOOST_AUTO_TEST_CASE(LoadOneMillionPoints)
+{
+	SnapshotFile file;
+	const size_t NUM = 200000; // per type, 1M points in total
+
+	StopWatch sw;
+	SaveSnapshotOf(NUM);
+	double save_sec = duration_cast<microseconds>(sw.Elapsed()).count() / 1000000.0;
+
+	DatabaseTestObject t;
+	ConfigureAll(t.db, NUM);
+
+	sw.Restart();
+	BOOST_REQUIRE_EQUAL(t.db.LoadSnapshot(SNAPSHOT_PATH), 5 * NUM);
+	double load_sec = duration_cast<microseconds>(sw.Elapsed()).count() / 1000000.0;
+
+	if (OUTPUT_PERF_NUMBERS) {
+		cout << "Snapshot save (with updates) sec: " << save_sec << endl;
+		cout << "Snapshot load sec: " << load_sec << " points/sec: " << (5 * NUM) / load_sec << endl;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,221 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/APDU.h>
+#include <opendnp3/ChangeFilter.h>
+#include <opendnp3/DecodePipeline.h>
+#include <opendnp3/DecodePool.h>
+#include <opendnp3/HeaderReadIterator.h>
+#include <opendnp3/Log.h>
+#include <opendnp3/ResponseLoader.h>
+#include <opendnp3/VtoReader.h>
+
+#include "BufferHelpers.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+using namespace opendnp3;
+using namespace std::chrono;
+
+BOOST_AUTO_TEST_SUITE(DecodePipelineSuite)
+
+/// Records every analog and binary, and the type of every point, in the order it's published
+class OrderedObserver : public IDataObserver
+{
+public:
+
+	OrderedObserver() : mNumTransactions(0) {}
+
+	// waits until the given number of transactions have completed
+	bool WaitForTransactions(size_t aCount) {
+		std::unique_lock<std::mutex> lock(mMutex);
+		return mCondition.wait_for(lock, seconds(5), [this, aCount]() {
+			return mNumTransactions >= aCount;
+		});
+	}
+
+	std::vector<double> mAnalogs;
+	std::vector<bool> mBinaries;
+	std::vector<DataTypes> mTypes;
+
+private:
+
+	void _Start() {}
+
+	void _End() {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			++mNumTransactions;
+		}
+		mCondition.notify_all();
+	}
+
+	void _Update(const Binary& arPoint, size_t) {
+		mBinaries.push_back(arPoint.GetValue());
+		mTypes.push_back(DT_BINARY);
+	}
+	void _Update(const Analog& arPoint, size_t) {
+		mAnalogs.push_back(arPoint.GetValue());
+		mTypes.push_back(DT_ANALOG);
+	}
+	void _Update(const Counter&, size_t) {
+		mTypes.push_back(DT_COUNTER);
+	}
+	void _Update(const ControlStatus&, size_t) {
+		mTypes.push_back(DT_CONTROL_STATUS);
+	}
+	void _Update(const SetpointStatus&, size_t) {
+		mTypes.push_back(DT_SETPOINT_STATUS);
+	}
+
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+	size_t mNumTransactions;
+};
+
+class PipelineTest
+{
+public:
+
+	PipelineTest(size_t aConcurrency, ChangeFilter* apFilter = NULL) :
+		pool(aConcurrency, []() {}, []() {}),
+		vto(log.GetLogger(LEV_INFO, "vto")),
+		pipeline(log.GetLogger(LEV_INFO, "decode"), &observer, &vto, apFilter)
+	{
+		pipeline.SetPool(&pool);
+	}
+
+	void Submit(const std::string& arHex) {
+		HexSequence hs(arHex);
+		APDU f;
+		f.Write(hs, hs.Size());
+		f.Interpret();
+		pipeline.Submit(f);
+	}
+
+	StackStatistics Statistics() {
+		StackStatistics stats;
+		pipeline.ReadStatistics(stats);
+		return stats;
+	}
+
+	EventLog log;
+	OrderedObserver observer;
+	DecodePool pool;
+	VtoReader vto;
+	DecodePipeline pipeline;
+};
+
+// a response with aCount 16 bit analogs that all have the value aValue
+std::string Analogs(size_t aCount, uint16_t aValue)
+{
+	std::ostringstream oss;
+	oss << std::hex << std::uppercase << std::setfill('0');
+	oss << "C0 81 00 00 1E 02 00 00 " << std::setw(2) << (aCount - 1);
+	for(size_t i = 0; i < aCount; ++i) {
+		oss << " 01 " << std::setw(2) << (aValue & 0xFF) << " " << std::setw(2) << (aValue >> 8);
+	}
+	return oss.str();
+}
+
+BOOST_AUTO_TEST_CASE(PublishesInArrivalOrder)
+{
+	PipelineTest t(4);
+
+	// large and small fragments alternate so later ones often finish decoding first
+	const size_t NUM_FRAGMENTS = 200;
+	for(size_t i = 0; i < NUM_FRAGMENTS; ++i) t.Submit(Analogs((i % 2 == 0) ? 200 : 1, static_cast<uint16_t>(i)));
+
+	BOOST_REQUIRE(t.observer.WaitForTransactions(NUM_FRAGMENTS));
+	BOOST_REQUIRE_EQUAL(t.observer.mAnalogs.size(), 100 * 200 + 100);
+
+	for(size_t i = 1; i < t.observer.mAnalogs.size(); ++i) {
+		BOOST_REQUIRE(t.observer.mAnalogs[i - 1] <= t.observer.mAnalogs[i]);
+	}
+
+	StackStatistics stats = t.Statistics();
+	BOOST_REQUIRE_EQUAL(stats.mNumOffloadedFragments, NUM_FRAGMENTS);
+	BOOST_REQUIRE_EQUAL(stats.mDecodeBacklog, 0);
+}
+
+BOOST_AUTO_TEST_CASE(MixedTypesKeepTheLoaderOrder)
+{
+	// analog 0, binaries 1 and 2, a counter at 0, then analog 1
+	const std::string MIXED = "C0 81 00 00 1E 02 00 00 00 01 05 00 01 01 00 01 02 03 14 06 00 00 00 07 00 1E 02 00 01 01 01 08 00";
+
+	PipelineTest t(2);
+	t.Submit(MIXED);
+	BOOST_REQUIRE(t.observer.WaitForTransactions(1));
+
+	OrderedObserver direct;
+	{
+		HexSequence hs(MIXED);
+		APDU f;
+		f.Write(hs, hs.Size());
+		f.Interpret();
+		ResponseLoader loader(t.log.GetLogger(LEV_INFO, "loader"), &direct, &t.vto);
+		for(HeaderReadIterator hdr = f.BeginRead(); !hdr.IsEnd(); ++hdr) loader.Process(hdr);
+	}
+
+	BOOST_REQUIRE_EQUAL(direct.mTypes.size(), 5);
+	BOOST_REQUIRE(t.observer.mTypes == direct.mTypes);
+	BOOST_REQUIRE(t.observer.mAnalogs == direct.mAnalogs);
+	BOOST_REQUIRE(t.observer.mBinaries == direct.mBinaries);
+}
+
+BOOST_AUTO_TEST_CASE(FilterAppliesToStaticValuesOnly)
+{
+	ChangeFilter filter;
+	PipelineTest t(2, &filter);
+
+	t.Submit("C0 81 00 00 01 01 00 01 03 02");	// static binaries
+	t.Submit("C0 81 00 00 01 01 00 01 03 02");
+	t.Submit("C0 81 00 00 02 01 17 01 03 81");	// the same event twice
+	t.Submit("C0 81 00 00 02 01 17 01 03 81");
+
+	BOOST_REQUIRE(t.observer.WaitForTransactions(4));
+	BOOST_REQUIRE_EQUAL(t.observer.mBinaries.size(), 3 + 2);
+	BOOST_REQUIRE_EQUAL(t.Statistics().mNumSuppressedPoints, 3);
+}
+
+BOOST_AUTO_TEST_CASE(CloseDropsLaterFragments)
+{
+	PipelineTest t(1);
+
+	t.Submit(Analogs(1, 1));
+	BOOST_REQUIRE(t.observer.WaitForTransactions(1));
+
+	t.pipeline.Close();
+	t.Submit(Analogs(1, 2));
+
+	BOOST_REQUIRE_EQUAL(t.Statistics().mNumOffloadedFragments, 1);
+	BOOST_REQUIRE_EQUAL(t.Statistics().mDecodeBacklog, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
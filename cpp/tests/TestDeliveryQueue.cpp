@@ -0,0 +1,297 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/DeliveryPool.h>
+#include <opendnp3/DeliveryQueue.h>
+
+#include "TestHelpers.h"
+#include "FlexibleDataObserver.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace opendnp3;
+using namespace std::chrono;
+
+BOOST_AUTO_TEST_SUITE(DeliveryQueueSuite)
+
+/// Holds every delivery at the start of its transaction until it's opened
+class GatedObserver : public IDataObserver
+{
+public:
+
+	GatedObserver() : mOpen(true), mNumWaiting(0), mNumTransactions(0) {}
+
+	void Close() {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mOpen = false;
+	}
+
+	void Open() {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mOpen = true;
+		}
+		mCondition.notify_all();
+	}
+
+	// waits until a delivery is held at the gate
+	bool WaitForDelivery() {
+		std::unique_lock<std::mutex> lock(mMutex);
+		return mCondition.wait_for(lock, seconds(5), [this]() {
+			return mNumWaiting > 0;
+		});
+	}
+
+	// waits until the given number of transactions have completed
+	bool WaitForTransactions(size_t aCount) {
+		std::unique_lock<std::mutex> lock(mMutex);
+		return mCondition.wait_for(lock, seconds(5), [this, aCount]() {
+			return mNumTransactions >= aCount;
+		});
+	}
+
+	FlexibleDataObserver data;
+	std::thread::id mThread;
+
+private:
+
+	void _Start() {
+		std::unique_lock<std::mutex> lock(mMutex);
+		++mNumWaiting;
+		mCondition.notify_all();
+		mCondition.wait(lock, [this]() {
+			return mOpen;
+		});
+		--mNumWaiting;
+		mThread = std::this_thread::get_id();
+		data.Start();
+	}
+
+	void _End() {
+		data.End();
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			++mNumTransactions;
+		}
+		mCondition.notify_all();
+	}
+
+	void _Update(const Binary& arPoint, size_t aIndex) {
+		data.Update(arPoint, aIndex);
+	}
+	void _Update(const Analog& arPoint, size_t aIndex) {
+		data.Update(arPoint, aIndex);
+	}
+	void _Update(const Counter& arPoint, size_t aIndex) {
+		data.Update(arPoint, aIndex);
+	}
+	void _Update(const ControlStatus& arPoint, size_t aIndex) {
+		data.Update(arPoint, aIndex);
+	}
+	void _Update(const SetpointStatus& arPoint, size_t aIndex) {
+		data.Update(arPoint, aIndex);
+	}
+
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+	bool mOpen;
+	size_t mNumWaiting;
+	size_t mNumTransactions;
+};
+
+void UpdateCounters(IDataObserver& arObserver, uint32_t aValue, size_t aFirst, size_t aCount)
+{
+	Transaction t(arObserver);
+	for(size_t i = aFirst; i < aFirst + aCount; ++i) arObserver.Update(Counter(aValue, CQ_ONLINE), i);
+}
+
+/// Queues one point and waits for the pool to hold it at the gate, so later updates stay queued
+void HoldDelivery(DeliveryQueue& arQueue, GatedObserver& arObserver)
+{
+	arObserver.Close();
+	UpdateCounters(arQueue, 0, 100, 1);
+	BOOST_REQUIRE(arObserver.WaitForDelivery());
+}
+
+StackStatistics Statistics(const DeliveryQueue& arQueue)
+{
+	StackStatistics stats;
+	arQueue.ReadStatistics(stats);
+	return stats;
+}
+
+BOOST_AUTO_TEST_CASE(DeliversOnPoolThread)
+{
+	DeliveryPool pool(1, []() {}, []() {});
+	GatedObserver observer;
+	DeliveryQueue queue(&observer, DeliveryConfig(10), &pool);
+
+	{
+		Transaction t(queue);
+		queue.Update(Binary(true, BQ_ONLINE), 1);
+		queue.Update(Analog(2.5, AQ_ONLINE), 2);
+		queue.Update(ControlStatus(true, TQ_ONLINE), 3);
+		queue.Update(SetpointStatus(4.5, PQ_ONLINE), 4);
+		Counter counter(7, CQ_ONLINE);
+		counter.SetTime(1000);
+		queue.Update(counter, 5);
+	}
+
+	BOOST_REQUIRE(observer.WaitForTransactions(1));
+	BOOST_REQUIRE(observer.mThread != std::this_thread::get_id());
+	BOOST_REQUIRE(observer.data.Check(true, BQ_ONLINE, 1));
+	BOOST_REQUIRE(observer.data.Check(2.5, AQ_ONLINE, 2));
+	BOOST_REQUIRE(observer.data.Check(true, TQ_ONLINE, 3));
+	BOOST_REQUIRE_EQUAL(observer.data.mSetpointStatusMap[4].GetValue(), 4.5);
+	BOOST_REQUIRE(observer.data.Check(7, CQ_ONLINE, 5, 1000));
+	BOOST_REQUIRE_EQUAL(Statistics(queue).mDeliveryQueueMaxDepth, 5);
+}
+
+// measurements that arrive during a delivery are taken together as the next transaction
+BOOST_AUTO_TEST_CASE(BatchesWhileDelivering)
+{
+	DeliveryPool pool(1, []() {}, []() {});
+	GatedObserver observer;
+	DeliveryQueue queue(&observer, DeliveryConfig(10), &pool);
+
+	HoldDelivery(queue, observer);
+	UpdateCounters(queue, 1, 0, 2);
+	UpdateCounters(queue, 2, 2, 2);
+	BOOST_REQUIRE_EQUAL(Statistics(queue).mDeliveryQueueDepth, 4);
+
+	observer.Open();
+	BOOST_REQUIRE(observer.WaitForTransactions(2));
+	BOOST_REQUIRE(observer.data.Check(2, CQ_ONLINE, 3));
+	BOOST_REQUIRE_EQUAL(observer.data.mCounterMap.size(), 5);
+	BOOST_REQUIRE_EQUAL(Statistics(queue).mDeliveryQueueDepth, 0);
+}
+
+BOOST_AUTO_TEST_CASE(DropOldest)
+{
+	DeliveryPool pool(1, []() {}, []() {});
+	GatedObserver observer;
+	DeliveryQueue queue(&observer, DeliveryConfig(4, DP_DROP_OLDEST), &pool);
+
+	HoldDelivery(queue, observer);
+	for(uint32_t i = 0; i < 10; ++i) UpdateCounters(queue, i, i, 1);
+	BOOST_REQUIRE_EQUAL(Statistics(queue).mNumDeliveryDrops, 6);
+	BOOST_REQUIRE_EQUAL(Statistics(queue).mDeliveryQueueDepth, 4);
+
+	observer.data.Clear();
+	observer.Open();
+	BOOST_REQUIRE(observer.WaitForTransactions(2));
+	BOOST_REQUIRE_EQUAL(observer.data.mCounterMap.size(), 5);	// the held point and the newest four
+	for(uint32_t i = 6; i < 10; ++i) BOOST_REQUIRE(observer.data.Check(i, CQ_ONLINE, i));
+}
+
+BOOST_AUTO_TEST_CASE(ConflateByIndex)
+{
+	DeliveryPool pool(1, []() {}, []() {});
+	GatedObserver observer;
+	DeliveryQueue queue(&observer, DeliveryConfig(4, DP_CONFLATE), &pool);
+
+	HoldDelivery(queue, observer);
+	for(uint32_t i = 0; i < 10; ++i) UpdateCounters(queue, i, 0, 3);
+	queue.Start();
+	queue.Update(Binary(true, BQ_ONLINE), 0);	// same index, different type
+	queue.End();
+
+	StackStatistics stats = Statistics(queue);
+	BOOST_REQUIRE_EQUAL(stats.mNumDeliveryConflations, 27);
+	BOOST_REQUIRE_EQUAL(stats.mNumDeliveryDrops, 0);
+	BOOST_REQUIRE_EQUAL(stats.mDeliveryQueueDepth, 4);
+
+	// a fifth point pushes out the oldest
+	UpdateCounters(queue, 10, 3, 1);
+	BOOST_REQUIRE_EQUAL(Statistics(queue).mNumDeliveryDrops, 1);
+
+	observer.data.Clear();
+	observer.Open();
+	BOOST_REQUIRE(observer.WaitForTransactions(2));
+	BOOST_REQUIRE_EQUAL(observer.data.mCounterMap.count(0), 0);
+	BOOST_REQUIRE(observer.data.Check(9, CQ_ONLINE, 1));
+	BOOST_REQUIRE(observer.data.Check(9, CQ_ONLINE, 2));
+	BOOST_REQUIRE(observer.data.Check(10, CQ_ONLINE, 3));
+	BOOST_REQUIRE(observer.data.Check(true, BQ_ONLINE, 0));
+}
+
+BOOST_AUTO_TEST_CASE(BlockUntilDelivered)
+{
+	DeliveryPool pool(1, []() {}, []() {});
+	GatedObserver observer;
+	DeliveryQueue queue(&observer, DeliveryConfig(4, DP_BLOCK), &pool);
+
+	HoldDelivery(queue, observer);
+	UpdateCounters(queue, 1, 0, 3);
+
+	std::mutex mutex;
+	bool queued = false;
+	std::thread producer([&]() {
+		UpdateCounters(queue, 2, 3, 2);
+		std::lock_guard<std::mutex> lock(mutex);
+		queued = true;
+	});
+
+	std::this_thread::sleep_for(milliseconds(50));
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		BOOST_REQUIRE_FALSE(queued);
+	}
+
+	observer.Open();
+	producer.join();
+	BOOST_REQUIRE(observer.WaitForTransactions(3));
+	BOOST_REQUIRE(observer.data.Check(2, CQ_ONLINE, 4));
+	BOOST_REQUIRE_EQUAL(Statistics(queue).mNumDeliveryDrops, 0);
+	BOOST_REQUIRE_EQUAL(Statistics(queue).mDeliveryQueueMaxDepth, 3);
+}
+
+BOOST_AUTO_TEST_CASE(CloseDiscardsQueuedMeasurements)
+{
+	DeliveryPool pool(1, []() {}, []() {});
+	GatedObserver observer;
+	DeliveryQueue queue(&observer, DeliveryConfig(10), &pool);
+
+	HoldDelivery(queue, observer);
+	UpdateCounters(queue, 1, 0, 3);
+
+	std::thread opener([&]() {
+		std::this_thread::sleep_for(milliseconds(20));
+		observer.Open();
+	});
+
+	// waits for the held delivery to finish
+	queue.Close();
+	opener.join();
+	UpdateCounters(queue, 2, 0, 3);
+
+	BOOST_REQUIRE_EQUAL(observer.data.mCounterMap.size(), 1);
+	BOOST_REQUIRE_EQUAL(Statistics(queue).mDeliveryQueueDepth, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
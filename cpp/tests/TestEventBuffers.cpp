@@ -30,6 +30,7 @@
 
 #include <iostream>
 #include <limits>
+#include <vector>
 
 using namespace std;
 using namespace opendnp3;
@@ -51,6 +52,20 @@ BOOST_AUTO_TEST_CASE(SingleIndexSorting)
 	b.Select(PC_CLASS_1);
 	BOOST_REQUIRE_EQUAL(b.Begin()->mValue.GetTime(), 2); //prove the newest value was kept
 }
+
+BOOST_AUTO_TEST_CASE(SingleIndexChangesClass)
+{
+	SingleEventBuffer<AnalogEvent> b(3);
+
+	b.Update(Analog(0), PC_CLASS_1, 0);
+	Analog a(0); a.SetTime(2);
+	b.Update(a, PC_CLASS_2, 0);
+
+	BOOST_REQUIRE_EQUAL(b.Size(), 1);
+	BOOST_REQUIRE_FALSE(b.HasClassData(PC_CLASS_1));
+	BOOST_REQUIRE(b.HasClassData(PC_CLASS_2));
+	BOOST_REQUIRE_EQUAL(b.Select(PC_CLASS_2), 1);
+}
 BOOST_AUTO_TEST_SUITE_END()
 
 // index is irrelevant in these tests, only insertion order matters
@@ -148,6 +163,46 @@ BOOST_AUTO_TEST_CASE(ResetEventsProperlyOnFailure)
 	}
 	b.Deselect();
 }
+
+void RequireSelected(InsertionOrderedEventBuffer<intevt>& arBuffer, const std::vector<int>& arValues)
+{
+	BOOST_REQUIRE_EQUAL(arBuffer.NumSelected(), arValues.size());
+	EvtItr<intevt>::Type itr = arBuffer.Begin();
+	for(size_t i = 0; i < arValues.size(); ++i, ++itr) BOOST_REQUIRE_EQUAL(itr->mValue, arValues[i]);
+}
+
+BOOST_AUTO_TEST_CASE(SelectionKeepsOrderAcrossClasses)
+{
+	InsertionOrderedEventBuffer<intevt> b(10);
+	PointClass classes[6] = {PC_CLASS_1, PC_CLASS_2, PC_CLASS_3, PC_CLASS_1, PC_CLASS_2, PC_CLASS_3};
+	for(int i = 0; i < 6; ++i) b.Update(i, classes[i], 0);
+
+	BOOST_REQUIRE_EQUAL(b.Select(static_cast<PointClass>(PC_CLASS_1 | PC_CLASS_3)), 4);
+	RequireSelected(b, {0, 2, 3, 5});
+
+	// deselected events go back in their original places
+	b.Deselect();
+	BOOST_REQUIRE_EQUAL(b.Select(PC_ALL_EVENTS, 3), 3);
+	RequireSelected(b, {0, 1, 2});
+	BOOST_REQUIRE_EQUAL(b.Select(PC_CLASS_2), 1);
+	RequireSelected(b, {0, 1, 2, 4});
+}
+
+BOOST_AUTO_TEST_CASE(OverflowDropsTheOldestOfAnyClass)
+{
+	InsertionOrderedEventBuffer<intevt> b(3);
+	b.Update(0, PC_CLASS_2, 0);
+	b.Update(1, PC_CLASS_1, 0);
+	b.Update(2, PC_CLASS_3, 0);
+	b.Update(3, PC_CLASS_1, 0);
+
+	BOOST_REQUIRE(b.IsOverflown());
+	BOOST_REQUIRE_EQUAL(b.NumDropped(), 1);
+	BOOST_REQUIRE_FALSE(b.HasClassData(PC_CLASS_2));
+
+	b.Select(PC_ALL_EVENTS);
+	RequireSelected(b, {1, 2, 3});
+}
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(TimeOrderedEventBufferSuite)
@@ -178,6 +233,19 @@ BOOST_AUTO_TEST_CASE(TimeBasedSorting)
 	}
 }
 
+// events with the same time are reported in the order they arrived, whatever their class
+BOOST_AUTO_TEST_CASE(EqualTimesAcrossClasses)
+{
+	TimeOrderedEventBuffer<BinaryEvent> b(10);
+	b.Update(Binary(true), PC_CLASS_3, 0);
+	b.Update(Binary(true), PC_CLASS_1, 1);
+	b.Update(Binary(true), PC_CLASS_2, 2);
+
+	BOOST_REQUIRE_EQUAL(b.Select(PC_ALL_EVENTS), 3);
+	EvtItr<BinaryEvent>::Type itr = b.Begin();
+	for(size_t i = 0; i < 3; ++i, ++itr) BOOST_REQUIRE_EQUAL(itr->mIndex, i);
+}
+
 BOOST_AUTO_TEST_CASE(EventOverflow)
 {
 	TimeOrderedEventBuffer<BinaryEvent> buffer(1);
@@ -0,0 +1,313 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+
+#include <boost/test/unit_test.hpp>
+
+#include "TestHelpers.h"
+#include "StopWatch.h"
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/SlaveEventBuffer.h>
+
+#include <stdio.h>
+#include <iostream>
+
+#ifndef WIN32
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#define OUTPUT_PERF_NUMBERS	(0)
+
+using namespace std;
+using namespace std::chrono;
+using namespace opendnp3;
+
+const char* JOURNAL_PATH = "TestEventJournal.dat";
+
+class JournalFile
+{
+public:
+	JournalFile() {
+		remove(JOURNAL_PATH);
+	}
+	~JournalFile() {
+		remove(JOURNAL_PATH);
+	}
+};
+
+void SelectAndConfirm(SlaveEventBuffer& b, BufferTypes aType, PointClass aClass, size_t aNum)
+{
+	b.Select(aType, aClass, aNum);
+	if(aType == BT_ANALOG) {
+		AnalogEventIter itr;
+		b.Begin(itr);
+		for(size_t i = 0; i < b.NumSelected(BT_ANALOG); ++i, ++itr) itr->mWritten = true;
+	}
+	else if(aType == BT_BINARY) {
+		BinaryEventIter itr;
+		b.Begin(itr);
+		for(size_t i = 0; i < b.NumSelected(BT_BINARY); ++i, ++itr) itr->mWritten = true;
+	}
+	b.ClearWritten();
+	b.Deselect();
+}
+
+BOOST_AUTO_TEST_SUITE(EventJournalSuite)
+
+BOOST_AUTO_TEST_CASE(UnconfirmedEventsSurviveRestart)
+{
+	JournalFile file;
+	EventMaxConfig max(10, 10, 10, 0);
+	EventJournalConfig cfg(JOURNAL_PATH, 100);
+
+	{
+		SlaveEventBuffer b(max, cfg);
+		BOOST_REQUIRE_EQUAL(b.NumRecovered(), 0);
+		b.Update(Binary(true, BQ_ONLINE), PC_CLASS_1, 3);
+		Analog a(42.5, AQ_ONLINE);
+		a.SetTime(1234);
+		b.Update(a, PC_CLASS_2, 7);
+		b.Update(Counter(99, CQ_ONLINE), PC_CLASS_3, 1);
+	}
+
+	SlaveEventBuffer b(max, cfg);
+	BOOST_REQUIRE_EQUAL(b.NumRecovered(), 3);
+	BOOST_REQUIRE_EQUAL(b.NumType(BT_BINARY), 1);
+	BOOST_REQUIRE_EQUAL(b.NumType(BT_ANALOG), 1);
+	BOOST_REQUIRE_EQUAL(b.NumType(BT_COUNTER), 1);
+	BOOST_REQUIRE(b.HasClassData(PC_CLASS_1));
+	BOOST_REQUIRE(b.HasClassData(PC_CLASS_2));
+	BOOST_REQUIRE(b.HasClassData(PC_CLASS_3));
+
+	BOOST_REQUIRE_EQUAL(b.Select(BT_ANALOG, PC_CLASS_2), 1);
+	AnalogEventIter itr;
+	b.Begin(itr);
+	BOOST_REQUIRE_EQUAL(itr->mIndex, 7);
+	BOOST_REQUIRE_EQUAL(itr->mValue.GetValue(), 42.5);
+	BOOST_REQUIRE_EQUAL(itr->mValue.GetQuality(), AQ_ONLINE);
+	BOOST_REQUIRE_EQUAL(itr->mValue.GetTime(), 1234);
+
+	BinaryEventIter bitr;
+	b.Select(BT_BINARY, PC_CLASS_1);
+	b.Begin(bitr);
+	BOOST_REQUIRE(bitr->mValue.GetValue());
+	BOOST_REQUIRE_EQUAL(bitr->mIndex, 3);
+}
+
+BOOST_AUTO_TEST_CASE(ConfirmedEventsAreReleased)
+{
+	JournalFile file;
+	EventMaxConfig max(10, 10, 10, 0);
+	EventJournalConfig cfg(JOURNAL_PATH, 100);
+
+	{
+		SlaveEventBuffer b(max, cfg);
+		for(size_t i = 0; i < 5; ++i) b.Update(Analog(i), PC_CLASS_1, i);
+		SelectAndConfirm(b, BT_ANALOG, PC_CLASS_1, 3);
+		BOOST_REQUIRE_EQUAL(b.GetJournal()->NumLive(), 2);
+	}
+
+	SlaveEventBuffer b(max, cfg);
+	BOOST_REQUIRE_EQUAL(b.NumRecovered(), 2);
+	BOOST_REQUIRE_EQUAL(b.NumType(BT_ANALOG), 2);
+}
+
+BOOST_AUTO_TEST_CASE(OverflowAndReplacementAreReleased)
+{
+	JournalFile file;
+	EventMaxConfig max(0, 2, 2, 0);
+	EventJournalConfig cfg(JOURNAL_PATH, 100);
+
+	SlaveEventBuffer b(max, cfg);
+	for(size_t i = 0; i < 5; ++i) b.Update(Analog(i), PC_CLASS_1, i);
+	BOOST_REQUIRE(b.IsOverflow());
+	BOOST_REQUIRE_EQUAL(b.GetJournal()->NumLive(), 2);
+
+	// counters only keep the newest event per index
+	b.Update(Counter(1), PC_CLASS_1, 0);
+	b.Update(Counter(2), PC_CLASS_1, 0);
+	BOOST_REQUIRE_EQUAL(b.NumType(BT_COUNTER), 1);
+	BOOST_REQUIRE_EQUAL(b.GetJournal()->NumLive(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(PinnedEventIsCarriedForward)
+{
+	JournalFile file;
+	EventMaxConfig max(10, 10, 10, 0);
+	EventJournalConfig cfg(JOURNAL_PATH, 8);
+
+	{
+		SlaveEventBuffer b(max, cfg);
+		b.Update(Binary(true), PC_CLASS_3, 9);
+
+		// wrap the ring several times while the class 3 event stays unconfirmed
+		for(size_t i = 0; i < 50; ++i) {
+			b.Update(Analog(i), PC_CLASS_1, 0);
+			SelectAndConfirm(b, BT_ANALOG, PC_CLASS_1, 1);
+		}
+
+		BOOST_REQUIRE_EQUAL(b.GetJournal()->NumLive(), 1);
+		BOOST_REQUIRE_EQUAL(b.GetJournal()->NumDropped(), 0);
+	}
+
+	SlaveEventBuffer b(max, cfg);
+	BOOST_REQUIRE_EQUAL(b.NumRecovered(), 1);
+	BOOST_REQUIRE(b.HasClassData(PC_CLASS_3));
+}
+
+BOOST_AUTO_TEST_CASE(OldestRecordDroppedWhenJournalIsFull)
+{
+	JournalFile file;
+	EventMaxConfig max(10, 10, 10, 0);
+	EventJournalConfig cfg(JOURNAL_PATH, 4);
+
+	SlaveEventBuffer b(max, cfg);
+	for(size_t i = 0; i < 6; ++i) b.Update(Analog(i), PC_CLASS_1, i);
+
+	BOOST_REQUIRE_EQUAL(b.GetJournal()->NumLive(), 4);
+	BOOST_REQUIRE_EQUAL(b.GetJournal()->NumDropped(), 2);
+
+	// releasing events whose records were already reused has no effect
+	SelectAndConfirm(b, BT_ANALOG, PC_CLASS_1, 2);
+	BOOST_REQUIRE_EQUAL(b.GetJournal()->NumLive(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(CorruptRecordIsDiscarded)
+{
+	JournalFile file;
+	EventMaxConfig max(10, 10, 10, 0);
+	EventJournalConfig cfg(JOURNAL_PATH, 10);
+
+	{
+		SlaveEventBuffer b(max, cfg);
+		b.Update(Analog(1), PC_CLASS_1, 0);
+		b.Update(Analog(2), PC_CLASS_1, 1);
+	}
+
+	// flip a bit in the value of the first record
+	FILE* fp = fopen(JOURNAL_PATH, "r+b");
+	BOOST_REQUIRE(fp != NULL);
+	long offset = sizeof(JournalHeader) + offsetof(JournalRecord, mValue);
+	fseek(fp, offset, SEEK_SET);
+	int c = fgetc(fp);
+	fseek(fp, offset, SEEK_SET);
+	fputc(c ^ 0x01, fp);
+	fclose(fp);
+
+	SlaveEventBuffer b(max, cfg);
+	BOOST_REQUIRE_EQUAL(b.NumRecovered(), 1);
+	BOOST_REQUIRE_EQUAL(b.GetJournal()->NumLive(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(MismatchedCapacityStartsEmpty)
+{
+	JournalFile file;
+	EventMaxConfig max(10, 10, 10, 0);
+
+	{
+		SlaveEventBuffer b(max, EventJournalConfig(JOURNAL_PATH, 10));
+		b.Update(Analog(1), PC_CLASS_1, 0);
+	}
+
+	SlaveEventBuffer b(max, EventJournalConfig(JOURNAL_PATH, 20));
+	BOOST_REQUIRE_EQUAL(b.NumRecovered(), 0);
+	BOOST_REQUIRE_FALSE(b.HasEventData());
+}
+
+BOOST_AUTO_TEST_CASE(InvalidConfiguration)
+{
+	EventMaxConfig max(10, 10, 10, 0);
+	BOOST_REQUIRE_THROW(SlaveEventBuffer b(max, EventJournalConfig(JOURNAL_PATH, 0)), ArgumentException);
+}
+
+#ifndef WIN32
+
+BOOST_AUTO_TEST_CASE(KillAndRecover)
+{
+	JournalFile file;
+	EventMaxConfig max(1000, 1000, 1000, 0);
+	EventJournalConfig cfg(JOURNAL_PATH, 4000, JSP_NONE);
+
+	pid_t pid = fork();
+	BOOST_REQUIRE(pid >= 0);
+
+	if(pid == 0) {
+		// the child never returns to the test framework
+		SlaveEventBuffer b(max, cfg);
+		for(size_t i = 0; i < 500; ++i) {
+			b.Update(Binary(i % 2 == 0), PC_CLASS_1, i);
+			b.Update(Analog(i), PC_CLASS_2, i);
+		}
+		SelectAndConfirm(b, BT_BINARY, PC_CLASS_1, 200);
+		raise(SIGKILL);
+		_exit(0);
+	}
+
+	int status = 0;
+	BOOST_REQUIRE_EQUAL(waitpid(pid, &status, 0), pid);
+	BOOST_REQUIRE(WIFSIGNALED(status));
+
+	SlaveEventBuffer b(max, cfg);
+	BOOST_REQUIRE_EQUAL(b.NumRecovered(), 800);
+	BOOST_REQUIRE_EQUAL(b.NumType(BT_BINARY), 300);
+	BOOST_REQUIRE_EQUAL(b.NumType(BT_ANALOG), 500);
+	BOOST_REQUIRE_EQUAL(b.Select(BT_BINARY, PC_CLASS_1), 300);
+	BOOST_REQUIRE_EQUAL(b.Select(BT_ANALOG, PC_CLASS_2), 500);
+}
+
+#endif
+
+void MeasureThroughput(JournalSyncPolicy aPolicy, const char* apName, size_t aNumEvents)
+{
+	JournalFile file;
+	EventMaxConfig max(0, 1000, 0, 0);
+	EventJournalConfig cfg(JOURNAL_PATH, 2000, aPolicy, 64);
+	SlaveEventBuffer b(max, cfg);
+
+	StopWatch sw;
+	for(size_t i = 0; i < aNumEvents; ++i) {
+		b.Update(Analog(i), PC_CLASS_1, i % 100);
+		if(b.NumType(BT_ANALOG) >= 100) SelectAndConfirm(b, BT_ANALOG, PC_CLASS_1, 100);
+	}
+	b.GetJournal()->Flush();
+
+	BOOST_REQUIRE_EQUAL(b.GetJournal()->NumLive(), b.NumType(BT_ANALOG));
+
+	if (OUTPUT_PERF_NUMBERS) {
+		double elapsed_sec = duration_cast<microseconds>(sw.Elapsed()).count() / 1000000.0;
+		cout << apName << " events/sec: " << aNumEvents / elapsed_sec << endl;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SustainedThroughputBySyncPolicy)
+{
+	MeasureThroughput(JSP_NONE, "JSP_NONE", 100000);
+	MeasureThroughput(JSP_BATCHED, "JSP_BATCHED", 10000);
+	MeasureThroughput(JSP_ALWAYS, "JSP_ALWAYS", 1000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,129 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/AppHeader.h>
+#include <opendnp3/AsyncTaskGroup.h>
+#include <opendnp3/AsyncTaskPeriodic.h>
+#include <opendnp3/BusScheduler.h>
+#include <opendnp3/EventScan.h>
+#include <opendnp3/PointClass.h>
+
+#include "MockExecutor.h"
+#include "MockTimeSource.h"
+
+using namespace opendnp3;
+
+BOOST_AUTO_TEST_SUITE(EventScanSuite)
+
+void ScanEmpty(EventScan& arScan)
+{
+	arScan.OnScan(IINField(), 1, 0, 4);
+}
+
+BOOST_AUTO_TEST_CASE(FixedScanKeepsItsPeriod)
+{
+	EventScan scan(ExceptionScan(PC_CLASS_1, 100));
+	ScanEmpty(scan);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 100);
+	BOOST_REQUIRE_EQUAL(scan.NumScans(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyResponsesBackOffToTheCeiling)
+{
+	EventScan scan(ExceptionScan(PC_CLASS_1, 100, 500));
+	BOOST_REQUIRE_EQUAL(scan.Period(), 100);
+
+	ScanEmpty(scan);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 200);
+	ScanEmpty(scan);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 400);
+	ScanEmpty(scan);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 500);
+	ScanEmpty(scan);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 500);
+}
+
+BOOST_AUTO_TEST_CASE(MoreDataShortensThePeriod)
+{
+	EventScan scan(ExceptionScan(PC_CLASS_1 | PC_CLASS_2, 100, 800));
+	for(size_t i = 0; i < 3; ++i) ScanEmpty(scan);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 800);
+
+	IINField more;
+	more.SetClass2Events(true);
+	scan.OnScan(more, 1, 1, 10);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 400);
+
+	// responses that needed more than one fragment
+	scan.OnScan(IINField(), 2, 20, 2100);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 200);
+	scan.OnScan(IINField(), 3, 30, 4200);
+	scan.OnScan(IINField(), 3, 30, 4200);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(OtherClassesAndDataKeepThePeriod)
+{
+	EventScan scan(ExceptionScan(PC_CLASS_1, 100, 800));
+	ScanEmpty(scan);
+
+	IINField other;
+	other.SetClass3Events(true);
+	scan.OnScan(other, 1, 1, 10);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 200);
+}
+
+BOOST_AUTO_TEST_CASE(SetsTheTaskPeriod)
+{
+	MockExecutor exe;
+	MockTimeSource time;
+	AsyncTaskGroup group(&exe, &time);
+	AsyncTaskPeriodic* pTask = group.AddPeriodic(100, 100, 0, [](ITask*) {});
+
+	EventScan scan(ExceptionScan(PC_CLASS_1, 100, 800));
+	scan.SetTask(pTask);
+	ScanEmpty(scan);
+	BOOST_REQUIRE_EQUAL(pTask->GetPeriod(), 200);
+}
+
+BOOST_AUTO_TEST_CASE(StaysWithinItsShareOfTheBus)
+{
+	// 1ms per byte, shared by two devices
+	MockTimeSource time;
+	BusScheduler bus(&time, 10000, 10);
+	bus.AddDevice(0);
+	bus.AddDevice(0);
+
+	EventScan scan(ExceptionScan(PC_CLASS_1, 100, 800), &bus);
+	IINField more;
+	more.SetClass1Events(true);
+	scan.OnScan(more, 2, 20, 150);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 300);
+
+	scan.OnScan(more, 2, 20, 30);
+	BOOST_REQUIRE_EQUAL(scan.Period(), 150);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -33,6 +33,17 @@
 
 #include "IntegrationTest.h"
 
+#include <opendnp3/IChannel.h>
+#include <opendnp3/ICommandProcessor.h>
+#include <opendnp3/IMaster.h>
+#include <opendnp3/MasterStackConfig.h>
+#include <opendnp3/SlaveStackConfig.h>
+#include <opendnp3/SimpleDataObserver.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #define OUTPUT_PERF_NUMBERS	(0)
 
 using namespace opendnp3;
@@ -87,6 +98,94 @@ BOOST_AUTO_TEST_CASE(MasterToSlaveThroughput)
 
 }
 
+BOOST_AUTO_TEST_CASE(BatchedCommandThroughput)
+{
+	const size_t NUM_COMMANDS = 500;
+	const size_t BATCH_SIZE = 50;
+	const boost::uint16_t port = START_PORT + NUM_PAIRS;
+
+	MockCommandHandler handler;
+	DNP3Manager mgr(std::thread::hardware_concurrency());
+
+	auto pClient = mgr.AddTCPClient("client", FILTER_LEVEL, 1000, "127.0.0.1", port);
+	auto pServer = mgr.AddTCPServer("server", FILTER_LEVEL, 1000, "127.0.0.1", port);
+
+	MasterStackConfig mcfg;
+	mcfg.app.RspTimeout = 20000;
+	mcfg.master.IntegrityRate = -1;
+	auto pMaster = pClient->AddMaster("master", FILTER_LEVEL, NullDataObserver::Inst(), mcfg);
+
+	SlaveStackConfig scfg;
+	scfg.app.RspTimeout = 20000;
+	scfg.slave.mMaxControls = BATCH_SIZE;
+	scfg.device = DeviceTemplate(10, 10, 10, 10, 10);
+	pServer->AddOutstation("outstation", FILTER_LEVEL, &handler, scfg);
+
+	std::mutex mutex;
+	std::condition_variable cv;
+	size_t completed = 0;
+	size_t failures = 0;
+	bool up = false;
+
+	pMaster->AddStateListener([&](StackState aState) {
+		std::unique_lock<std::mutex> lock(mutex);
+		up = (aState == SS_COMMS_UP);
+		cv.notify_all();
+	});
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		BOOST_REQUIRE(cv.wait_for(lock, std::chrono::seconds(10), [&]() {
+			return up;
+		}));
+	}
+
+	auto onResponse = [&](const CommandResponse & arRsp) {
+		std::unique_lock<std::mutex> lock(mutex);
+		++completed;
+		if(arRsp.mResult != CS_SUCCESS) ++failures;
+		cv.notify_all();
+	};
+
+	auto waitForAll = [&]() -> bool {
+		std::unique_lock<std::mutex> lock(mutex);
+		bool success = cv.wait_for(lock, std::chrono::seconds(60), [&]() {
+			return completed == NUM_COMMANDS;
+		});
+		completed = 0;
+		return success;
+	};
+
+	ICommandProcessor* pProcessor = pMaster->GetCommandProcessor();
+
+	StopWatch sw;
+	for(size_t i = 0; i < NUM_COMMANDS; ++i) {
+		pProcessor->DirectOperate(AnalogOutputInt16(static_cast<int16_t>(i)), i % 10, onResponse);
+	}
+	BOOST_REQUIRE(waitForAll());
+	double single_sec = duration_cast<milliseconds>(sw.Elapsed()).count() / 1000.0;
+
+	for(size_t i = 0; i < NUM_COMMANDS; i += BATCH_SIZE) {
+		std::vector< IndexedCommand<AnalogOutputInt16> > batch;
+		for(size_t j = i; j < i + BATCH_SIZE; ++j) {
+			batch.push_back(IndexedCommand<AnalogOutputInt16>(AnalogOutputInt16(static_cast<int16_t>(j)), j % 10));
+		}
+		pProcessor->DirectOperate(batch, [&](std::vector<CommandResponse> aResponses) {
+			for(auto rsp : aResponses) onResponse(rsp);
+		});
+	}
+	BOOST_REQUIRE(waitForAll());
+	double batch_sec = duration_cast<milliseconds>(sw.Elapsed()).count() / 1000.0;
+
+	BOOST_REQUIRE_EQUAL(failures, 0);
+	BOOST_REQUIRE_EQUAL(handler.mNumInvocations, 2 * NUM_COMMANDS);
+
+	if (OUTPUT_PERF_NUMBERS) {
+		cout << "single commands/sec: " << NUM_COMMANDS / single_sec << endl;
+		cout << "batched commands/sec: " << NUM_COMMANDS / batch_sec << endl;
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 /* vim: set ts=4 sw=4: */
@@ -0,0 +1,80 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/Exception.h>
+#include <opendnp3/LatencyHistogram.h>
+
+#include <chrono>
+
+using namespace opendnp3;
+using namespace std::chrono;
+
+BOOST_AUTO_TEST_SUITE(LatencyHistogramSuite)
+
+BOOST_AUTO_TEST_CASE(BucketBoundaries)
+{
+	BOOST_REQUIRE_EQUAL(LatencyHistogram::BucketFor(microseconds(-5)), 0);
+	BOOST_REQUIRE_EQUAL(LatencyHistogram::BucketFor(nanoseconds(999)), 0);
+	BOOST_REQUIRE_EQUAL(LatencyHistogram::BucketFor(microseconds(1)), 1);
+	BOOST_REQUIRE_EQUAL(LatencyHistogram::BucketFor(microseconds(2)), 2);
+	BOOST_REQUIRE_EQUAL(LatencyHistogram::BucketFor(microseconds(3)), 2);
+	BOOST_REQUIRE_EQUAL(LatencyHistogram::BucketFor(microseconds(4)), 3);
+	BOOST_REQUIRE_EQUAL(LatencyHistogram::BucketFor(milliseconds(1)), 10);
+	BOOST_REQUIRE_EQUAL(LatencyHistogram::BucketFor(hours(24 * 365)), LatencyHistogram::NUM_BUCKETS - 1);
+
+	for(size_t i = 0; i < (LatencyHistogram::NUM_BUCKETS - 1); ++i) {
+		BOOST_REQUIRE_EQUAL(LatencyHistogram::BucketFor(LatencyHistogram::UpperBound(i)), i + 1);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Statistics)
+{
+	LatencyHistogram h;
+	BOOST_REQUIRE(h.Percentile(0.5) == timer_clock::duration::zero());
+	BOOST_REQUIRE(h.Mean() == timer_clock::duration::zero());
+
+	for(size_t i = 0; i < 99; ++i) h.Record(milliseconds(1));
+	h.Record(milliseconds(100));
+
+	BOOST_REQUIRE_EQUAL(h.NumSamples(), 100);
+	BOOST_REQUIRE_EQUAL(h.Count(10), 99);
+	BOOST_REQUIRE_EQUAL(h.Count(17), 1);
+	BOOST_REQUIRE(h.Max() == milliseconds(100));
+	BOOST_REQUIRE(h.Mean() == microseconds(1990));
+	BOOST_REQUIRE(h.Percentile(0.5) == microseconds(1024));
+	BOOST_REQUIRE(h.Percentile(0.99) == microseconds(1024));
+	BOOST_REQUIRE(h.Percentile(1.0) == milliseconds(100));
+
+	BOOST_REQUIRE_THROW(h.Percentile(1.5), ArgumentException);
+	BOOST_REQUIRE_THROW(h.Count(LatencyHistogram::NUM_BUCKETS), ArgumentException);
+
+	h.Reset();
+	BOOST_REQUIRE_EQUAL(h.NumSamples(), 0);
+	BOOST_REQUIRE_EQUAL(h.Count(10), 0);
+	BOOST_REQUIRE(h.Max() == timer_clock::duration::zero());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
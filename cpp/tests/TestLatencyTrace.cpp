@@ -0,0 +1,210 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include "TestHelpers.h"
+
+#include <opendnp3/LatencyTrace.h>
+#include <opendnp3/DNP3Manager.h>
+#include <opendnp3/IChannel.h>
+#include <opendnp3/IMaster.h>
+#include <opendnp3/IOutstation.h>
+#include <opendnp3/SimpleCommandHandler.h>
+#include <opendnp3/SimpleDataObserver.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace opendnp3;
+using namespace std::chrono;
+
+BOOST_AUTO_TEST_SUITE(LatencyTraceSuite)
+
+uint64_t Count(const LatencyStatistics& arStats, LatencyStage aStage)
+{
+	return arStats.mStages[aStage].mNumSamples;
+}
+
+uint64_t Total(const LatencyStatistics& arStats, LatencyStage aStage)
+{
+	return arStats.mStages[aStage].mTotalMicros;
+}
+
+BOOST_AUTO_TEST_CASE(TransmitStages)
+{
+	LatencyTrace trace;
+	timer_clock::time_point t0 = timer_clock::now();
+
+	trace.OnApduQueued(t0);
+	trace.OnApduSent(t0 + milliseconds(1));
+	trace.OnTransportSend(t0 + milliseconds(2));
+	trace.OnFinalSegment();
+	BOOST_REQUIRE(trace.OnFrameQueued(true, t0 + milliseconds(4)));
+	trace.OnFrameWritten(true, t0 + milliseconds(4), t0 + milliseconds(7), t0 + milliseconds(11));
+
+	LatencyStatistics stats = trace.Snapshot();
+	BOOST_REQUIRE(stats.mEnabled);
+	BOOST_REQUIRE_EQUAL(Total(stats, LS_TX_QUEUE), 1000);
+	BOOST_REQUIRE_EQUAL(Total(stats, LS_TX_SEGMENT), 2000);
+	BOOST_REQUIRE_EQUAL(Total(stats, LS_TX_LINK_QUEUE), 3000);
+	BOOST_REQUIRE_EQUAL(Total(stats, LS_TX_WIRE), 4000);
+	BOOST_REQUIRE_EQUAL(Total(stats, LS_TX_TOTAL), 11000);
+	BOOST_REQUIRE_EQUAL(stats.mStages[LS_TX_TOTAL].mMaxMicros, 11000);
+	BOOST_REQUIRE_EQUAL(stats.mStages[LS_TX_TOTAL].mBuckets[14], 1);
+}
+
+// Only the first user data frame after the last segment leaves the transport layer carries it
+BOOST_AUTO_TEST_CASE(FinalSegmentIsTheNextUserDataFrame)
+{
+	LatencyTrace trace;
+	timer_clock::time_point t0 = timer_clock::now();
+
+	trace.OnApduQueued(t0);
+	trace.OnApduSent(t0);
+	trace.OnTransportSend(t0);
+	BOOST_REQUIRE_FALSE(trace.OnFrameQueued(true, t0));	// first segment
+	trace.OnFinalSegment();
+	BOOST_REQUIRE_FALSE(trace.OnFrameQueued(false, t0));	// reset link states
+	BOOST_REQUIRE(trace.OnFrameQueued(true, t0));
+	BOOST_REQUIRE_FALSE(trace.OnFrameQueued(true, t0));	// a retry of the final segment
+
+	BOOST_REQUIRE_EQUAL(Count(trace.Snapshot(), LS_TX_SEGMENT), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ReceiveStages)
+{
+	LatencyTrace trace;
+	timer_clock::time_point t0 = timer_clock::now();
+
+	trace.OnApduDispatched(t0); // nothing has been received
+	trace.OnFrameRead(t0);
+	trace.OnFirstSegment();
+	trace.OnFrameRead(t0 + milliseconds(2));
+	trace.OnApduReceived(t0 + milliseconds(3));
+	trace.OnApduDispatched(t0 + milliseconds(5));
+
+	LatencyStatistics stats = trace.Snapshot();
+	BOOST_REQUIRE_EQUAL(Count(stats, LS_RX_REASSEMBLY), 1);
+	BOOST_REQUIRE_EQUAL(Total(stats, LS_RX_REASSEMBLY), 3000);
+	BOOST_REQUIRE_EQUAL(Count(stats, LS_RX_DISPATCH), 1);
+	BOOST_REQUIRE_EQUAL(Total(stats, LS_RX_DISPATCH), 2000);
+}
+
+BOOST_AUTO_TEST_CASE(ResetDiscardsQueuedFragments)
+{
+	LatencyTrace trace;
+	timer_clock::time_point t0 = timer_clock::now();
+
+	trace.OnApduQueued(t0);
+	trace.OnApduQueued(t0);
+	trace.OnTransportSend(t0);
+	trace.OnFinalSegment();
+	trace.Reset();
+	trace.OnApduSent(t0);
+
+	BOOST_REQUIRE_FALSE(trace.OnFrameQueued(true, t0));
+	BOOST_REQUIRE_EQUAL(Count(trace.Snapshot(), LS_TX_QUEUE), 0);
+}
+
+BOOST_AUTO_TEST_CASE(PollRoundTrip)
+{
+	LatencyTrace trace;
+	timer_clock::time_point t0 = timer_clock::now();
+
+	trace.OnPollCompleted(t0); // no poll was started
+	trace.OnPollStarted(t0);
+	trace.OnPollCompleted(t0 + milliseconds(6));
+	trace.OnPollStarted(t0);
+	trace.Reset();
+	trace.OnPollCompleted(t0 + milliseconds(1));
+
+	LatencyStatistics stats = trace.Snapshot();
+	BOOST_REQUIRE_EQUAL(Count(stats, LS_POLL_ROUND_TRIP), 1);
+	BOOST_REQUIRE_EQUAL(Total(stats, LS_POLL_ROUND_TRIP), 6000);
+}
+
+BOOST_AUTO_TEST_CASE(Percentiles)
+{
+	StageHistogram histogram;
+	for(size_t i = 0; i < 99; ++i) histogram.Record(microseconds(100));
+	histogram.Record(milliseconds(10));
+
+	StageLatency latency;
+	histogram.Read(latency);
+	BOOST_REQUIRE_EQUAL(latency.mNumSamples, 100);
+	BOOST_REQUIRE_EQUAL(latency.MeanMicros(), 199);
+	BOOST_REQUIRE_EQUAL(latency.PercentileMicros(0.5), 128);
+	BOOST_REQUIRE_EQUAL(latency.PercentileMicros(1.0), 10000);
+}
+
+#ifdef OPENDNP3_LATENCY_TRACE
+
+bool HasRoundTrip(IStack* apStack)
+{
+	LatencyStatistics stats = apStack->GetLatencyStatistics();
+	return Count(stats, LS_TX_TOTAL) > 0 && Count(stats, LS_RX_REASSEMBLY) > 0 && Count(stats, LS_RX_DISPATCH) > 0;
+}
+
+bool HasPoll(IStack* apStack)
+{
+	return Count(apStack->GetLatencyStatistics(), LS_POLL_ROUND_TRIP) > 0;
+}
+
+// The integrity poll at startup goes through every stage of both stacks
+BOOST_AUTO_TEST_CASE(StacksTraceTheIntegrityPoll)
+{
+	DNP3Manager mgr(1);
+
+	auto pClient = mgr.AddTCPClient("client", LEV_INFO, 500, "127.0.0.1", 20000);
+	auto pServer = mgr.AddTCPServer("server", LEV_INFO, 500, "127.0.0.1", 20000);
+	auto pMaster = pClient->AddMaster("master", LEV_INFO, NullDataObserver::Inst(), MasterStackConfig());
+	auto pOutstation = pServer->AddOutstation("outstation", LEV_INFO, SuccessCommandHandler::Inst(), SlaveStackConfig());
+
+	timer_clock::time_point deadline = timer_clock::now() + seconds(10);
+	while(!(HasRoundTrip(pMaster) && HasPoll(pMaster) && HasRoundTrip(pOutstation)) && timer_clock::now() < deadline) {
+		std::this_thread::sleep_for(milliseconds(10));
+	}
+
+	BOOST_REQUIRE(HasRoundTrip(pMaster));
+	BOOST_REQUIRE(HasPoll(pMaster));
+	BOOST_REQUIRE(HasRoundTrip(pOutstation));
+	BOOST_REQUIRE_FALSE(HasPoll(pOutstation));
+	BOOST_REQUIRE(pMaster->GetLatencyStatistics().mEnabled);
+}
+
+#else
+
+BOOST_AUTO_TEST_CASE(StacksReportTracingDisabled)
+{
+	DNP3Manager mgr(1);
+
+	auto pClient = mgr.AddTCPClient("client", LEV_INFO, 500, "127.0.0.1", 20000);
+	auto pMaster = pClient->AddMaster("master", LEV_INFO, NullDataObserver::Inst(), MasterStackConfig());
+
+	BOOST_REQUIRE_FALSE(pMaster->GetLatencyStatistics().mEnabled);
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
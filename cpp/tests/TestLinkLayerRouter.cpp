@@ -174,6 +174,34 @@ BOOST_AUTO_TEST_CASE(MultiContextSend)
 	BOOST_REQUIRE_EQUAL(t.phys.NumWrites(), 2);
 }
 
+/// Test that the router counts the frames and bytes it moves
+BOOST_AUTO_TEST_CASE(StatisticsCountTraffic)
+{
+	LinkLayerRouterTest t;
+	MockFrameSink mfs;
+	t.router.AddContext(&mfs, LinkRoute(1, 1024));
+	LinkFrame f1; f1.FormatAck(true, false, 1, 1024);
+	LinkFrame f2; f2.FormatAck(true, false, 1, 1024);
+	t.phys.SignalOpenSuccess();
+	t.router.Transmit(f1);
+	t.router.Transmit(f2);
+	BOOST_REQUIRE_EQUAL(t.router.GetStatistics().mTransmitQueueDepth, 2);
+	t.phys.SignalSendSuccess();
+	t.phys.SignalSendSuccess();
+
+	t.phys.TriggerRead("05 64 05 C0 01 00 00 04 E9 21"); // unknown route
+	t.phys.TriggerRead("05 64 05 C0 01 00 00 04 E9 20"); // bad crc
+
+	ChannelStatistics stats = t.router.GetStatistics();
+	BOOST_REQUIRE_EQUAL(stats.mTransmitQueueDepth, 0);
+	BOOST_REQUIRE_EQUAL(stats.mNumFramesTx, 2);
+	BOOST_REQUIRE_EQUAL(stats.mNumBytesTx, f1.GetSize() + f2.GetSize());
+	BOOST_REQUIRE_EQUAL(stats.mNumFramesRx, 1);
+	BOOST_REQUIRE_EQUAL(stats.mNumBytesRx, 20);
+	BOOST_REQUIRE_EQUAL(stats.mNumUnknownRoute, 1);
+	BOOST_REQUIRE_EQUAL(stats.mNumCrcErrors, 1);
+}
+
 /// Test that the router correctly clear the receive buffer when the layer closes
 BOOST_AUTO_TEST_CASE(LinkLayerRouterClearsBufferOnLowerLayerDown)
 {
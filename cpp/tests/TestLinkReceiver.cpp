@@ -271,6 +271,18 @@ BOOST_AUTO_TEST_CASE(Resync0564)
 	BOOST_REQUIRE(t.mSink.CheckLast(FC_PRI_RESET_LINK_STATES, true, 1, 1024));
 }
 
+BOOST_AUTO_TEST_CASE(CountersTrackFramesAndErrors)
+{
+	LinkReceiverTest t;
+	t.WriteData("05 64 05 64 05 C0 01 00 00 04 E9 21");
+	t.WriteData("05 64 14 F3 01 00 00 04 0A 3B C0 C3 01 3C 02 06 3C 03 06 3C 04 06 3C 01 06 9A 11");
+
+	ChannelStatistics stats = t.mCounters.Snapshot();
+	BOOST_REQUIRE_EQUAL(stats.mNumFramesRx, 1);
+	BOOST_REQUIRE_EQUAL(stats.mNumCrcErrors, 2);
+	BOOST_REQUIRE_EQUAL(stats.mNumResyncs, 2);
+}
+
 //////////////////////////////////////////
 // many packets
 //////////////////////////////////////////
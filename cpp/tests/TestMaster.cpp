@@ -24,8 +24,10 @@
 
 #include <opendnp3/Exception.h>
 #include <opendnp3/Clock.h>
+#include <opendnp3/DecodePool.h>
 
 #include <queue>
+#include <thread>
 
 #include "TestHelpers.h"
 #include "MasterTestObject.h"
@@ -56,6 +58,20 @@ void DoControlSelectAndOperate(MasterTestObject& t, std::function<void (CommandR
 	BOOST_REQUIRE_EQUAL(t.Read(), "C0 03 " + crob);
 }
 
+// waits up to 5 seconds for the decode threads to publish every submitted fragment
+StackStatistics WaitForDecode(MasterTestObject& t)
+{
+	StackStatistics stats;
+	timer_clock::time_point deadline = timer_clock::now() + seconds(5);
+	do {
+		std::this_thread::sleep_for(milliseconds(1));
+		stats = StackStatistics();	// the decoder adds to the running totals
+		t.master.ReadDecodeStatistics(stats);
+	}
+	while(stats.mDecodeBacklog > 0 && timer_clock::now() < deadline);
+	return stats;
+}
+
 template <class T>
 void TestAnalogOutputExecution(const std::string& setpointhex, T ao)
 {
@@ -487,6 +503,135 @@ BOOST_AUTO_TEST_CASE(Int16SetpointExecution)
 	TestAnalogOutputExecution("29 02 17 01 01 64 00 00", AnalogOutputInt16(100));
 }
 
+BOOST_AUTO_TEST_CASE(BatchDirectOperate)
+{
+	MasterConfig master_cfg;
+	MasterTestObject t(master_cfg);
+	t.master.OnLowerLayerUp();
+
+	TestForIntegrityPoll(t);
+
+	std::vector< IndexedCommand<AnalogOutputInt16> > batch;
+	batch.push_back(IndexedCommand<AnalogOutputInt16>(AnalogOutputInt16(100), 1));
+	batch.push_back(IndexedCommand<AnalogOutputInt16>(AnalogOutputInt16(200), 3));
+
+	std::vector< std::vector<CommandResponse> > rsps;
+	t.master.GetCommandProcessor()->DirectOperate(batch, [&](std::vector<CommandResponse> rsp) {
+		rsps.push_back(rsp);
+	});
+	t.mts.Dispatch();
+
+	// Group 41 Var2, 1 byte count/index, both setpoints in one request
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 05 29 02 17 02 01 64 00 00 03 C8 00 00");
+	t.RespondToMaster("C0 81 00 00 29 02 17 02 01 64 00 00 03 C8 00 04");
+	t.mts.DispatchOne();
+
+	BOOST_REQUIRE_EQUAL(t.app.NumAPDU(), 0);
+	BOOST_REQUIRE_EQUAL(rsps.size(), 1);
+	BOOST_REQUIRE_EQUAL(rsps[0].size(), 2);
+	BOOST_REQUIRE_EQUAL(rsps[0][0].mResult, CS_SUCCESS);
+	BOOST_REQUIRE_EQUAL(rsps[0][1].mResult, CS_NOT_SUPPORTED);
+}
+
+BOOST_AUTO_TEST_CASE(BatchSelectAndOperateOnlyOperatesSelected)
+{
+	MasterConfig master_cfg;
+	MasterTestObject t(master_cfg);
+	t.master.OnLowerLayerUp();
+
+	TestForIntegrityPoll(t);
+
+	ControlRelayOutputBlock bo(CC_PULSE); bo.mStatus = CS_SUCCESS;
+	std::vector< IndexedCommand<ControlRelayOutputBlock> > batch;
+	batch.push_back(IndexedCommand<ControlRelayOutputBlock>(bo, 1));
+	batch.push_back(IndexedCommand<ControlRelayOutputBlock>(bo, 2));
+
+	std::vector< std::vector<CommandResponse> > rsps;
+	t.master.GetCommandProcessor()->SelectAndOperate(batch, [&](std::vector<CommandResponse> rsp) {
+		rsps.push_back(rsp);
+	});
+	t.mts.Dispatch();
+
+	std::string crob = "01 01 64 00 00 00 64 00 00 00";
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 03 0C 01 17 02 01 " + crob + " 00 02 " + crob + " 00"); // SELECT
+	t.RespondToMaster("C0 81 00 00 0C 01 17 02 01 " + crob + " 00 02 " + crob + " 07"); // index 2 is in local
+	t.mts.DispatchOne();
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 04 0C 01 17 01 01 " + crob + " 00"); // OPERATE
+	BOOST_REQUIRE_EQUAL(rsps.size(), 0);
+	t.RespondToMaster("C0 81 00 00 0C 01 17 01 01 " + crob + " 00");
+	t.mts.DispatchOne();
+
+	BOOST_REQUIRE_EQUAL(t.app.NumAPDU(), 0);
+	BOOST_REQUIRE_EQUAL(rsps.size(), 1);
+	BOOST_REQUIRE_EQUAL(rsps[0][0].mResult, CS_SUCCESS);
+	BOOST_REQUIRE_EQUAL(rsps[0][1].mResult, CS_LOCAL);
+}
+
+BOOST_AUTO_TEST_CASE(BatchSplitsAcrossFragments)
+{
+	MasterConfig master_cfg;
+	master_cfg.FragSize = 16; // a response echoing two Int16 setpoints
+	MasterTestObject t(master_cfg);
+	t.master.OnLowerLayerUp();
+
+	TestForIntegrityPoll(t);
+
+	std::vector< IndexedCommand<AnalogOutputInt16> > batch;
+	for(uint16_t i = 0; i < 3; ++i) batch.push_back(IndexedCommand<AnalogOutputInt16>(AnalogOutputInt16(i), i));
+
+	std::vector< std::vector<CommandResponse> > rsps;
+	t.master.GetCommandProcessor()->DirectOperate(batch, [&](std::vector<CommandResponse> rsp) {
+		rsps.push_back(rsp);
+	});
+	t.mts.Dispatch();
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 05 29 02 17 02 00 00 00 00 01 01 00 00");
+	t.RespondToMaster("C0 81 00 00 29 02 17 02 00 00 00 00 01 01 00 00");
+	t.mts.DispatchOne();
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 05 29 02 17 01 02 02 00 00");
+	BOOST_REQUIRE_EQUAL(rsps.size(), 0);
+	t.master.OnSolFailure();
+	t.mts.DispatchOne();
+
+	BOOST_REQUIRE_EQUAL(rsps.size(), 1);
+	BOOST_REQUIRE_EQUAL(rsps[0][0].mResult, CS_SUCCESS);
+	BOOST_REQUIRE_EQUAL(rsps[0][1].mResult, CS_SUCCESS);
+	BOOST_REQUIRE_EQUAL(rsps[0][2].mResult, CS_HARDWARE_ERROR);
+}
+
+BOOST_AUTO_TEST_CASE(BatchAbortsOnBadEcho)
+{
+	MasterConfig master_cfg;
+	master_cfg.FragSize = 16;
+	MasterTestObject t(master_cfg);
+	t.master.OnLowerLayerUp();
+
+	TestForIntegrityPoll(t);
+
+	std::vector< IndexedCommand<AnalogOutputInt16> > batch;
+	for(uint16_t i = 0; i < 3; ++i) batch.push_back(IndexedCommand<AnalogOutputInt16>(AnalogOutputInt16(i), i));
+
+	std::vector< std::vector<CommandResponse> > rsps;
+	t.master.GetCommandProcessor()->SelectAndOperate(batch, [&](std::vector<CommandResponse> rsp) {
+		rsps.push_back(rsp);
+	});
+	t.mts.Dispatch();
+
+	// only one of the two selected setpoints is echoed
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 03 29 02 17 02 00 00 00 00 01 01 00 00");
+	t.RespondToMaster("C0 81 00 00 29 02 17 01 00 00 00 00");
+	t.mts.DispatchOne();
+
+	BOOST_REQUIRE_EQUAL(t.app.NumAPDU(), 0);
+	BOOST_REQUIRE_EQUAL(rsps.size(), 1);
+	for(size_t i = 0; i < 3; ++i) BOOST_REQUIRE_EQUAL(rsps[0][i].mResult, CS_UNDEFINED);
+
+	std::vector< IndexedCommand<AnalogOutputInt16> > empty;
+	BOOST_REQUIRE_THROW(t.master.GetCommandProcessor()->DirectOperate(empty, [](std::vector<CommandResponse>) {}), ArgumentException);
+}
+
 BOOST_AUTO_TEST_CASE(SolicitedResponseWithData)
 {
 	MasterConfig master_cfg;
@@ -543,6 +688,118 @@ BOOST_AUTO_TEST_CASE(SolicitedMultiFragResponse)
 	BOOST_REQUIRE(t.fdo.Check(false, BQ_RESTART, 3, 0));
 }
 
+BOOST_AUTO_TEST_CASE(CurrentValueTable)
+{
+	MasterConfig master_cfg;
+	CurrentValues values;
+	BOOST_REQUIRE_FALSE(MasterTestObject(master_cfg).master.ReadCurrentValues(values));
+
+	master_cfg.UseCurrentValueTable = true;
+	MasterTestObject t(master_cfg);
+	t.master.OnLowerLayerUp();
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00 01 02 00 02 02 81"); //group 2 var 1, index = 2, 0x81 = Online, true
+
+	// the observer still receives every update
+	BOOST_REQUIRE(t.fdo.Check(true, BQ_ONLINE, 2, 0));
+
+	BOOST_REQUIRE(t.master.ReadCurrentValues(values));
+	BOOST_REQUIRE(values.mVersion > 0);
+	BOOST_REQUIRE_EQUAL(values.mBinary.size(), 3);
+	BOOST_REQUIRE_EQUAL(values.mBinary[0].GetQuality(), BQ_RESTART);
+	BOOST_REQUIRE(values.mBinary[2].GetValue());
+	BOOST_REQUIRE_EQUAL(values.mBinary[2].GetQuality(), BQ_ONLINE | BQ_STATE);
+	BOOST_REQUIRE(values.mAnalog.empty());
+}
+
+BOOST_AUTO_TEST_CASE(PublishChangesOnly)
+{
+	MasterConfig master_cfg; master_cfg.IntegrityRate = 1000;
+	master_cfg.PublishChangesOnly = true;
+	MasterTestObject t(master_cfg);
+	StackCounters counters;
+	t.master.SetCounters(&counters);
+	t.fake_time.SetTime(timer_clock::time_point(milliseconds(0)));
+	t.master.OnLowerLayerUp();
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00 01 01 00 01 03 02");
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 3);
+	BOOST_REQUIRE_EQUAL(counters.Snapshot().mPollSuppressedPoints, 0);
+
+	t.fdo.Clear();
+	t.fake_time.Advance(milliseconds(1000));
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00 01 01 00 01 03 00");	// only index 2 changed
+
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 1);
+	StackStatistics stats = counters.Snapshot();
+	BOOST_REQUIRE_EQUAL(stats.mPollSuppressedPoints, 2);
+	BOOST_REQUIRE_EQUAL(stats.mNumSuppressedPoints, 2);
+}
+
+BOOST_AUTO_TEST_CASE(OffloadDecode)
+{
+	DecodePool pool(2, []() {}, []() {});
+	MasterConfig master_cfg;
+	master_cfg.OffloadDecode = true;
+	MasterTestObject t(master_cfg);
+	t.master.SetDecodePool(&pool);
+	t.master.OnLowerLayerUp();
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00 01 01 00 01 03 02");
+	t.SendUnsolToMaster("C0 82 00 00 02 01 17 01 03 81");
+
+	StackStatistics stats = WaitForDecode(t);
+	BOOST_REQUIRE_EQUAL(stats.mNumOffloadedFragments, 2);
+	BOOST_REQUIRE_EQUAL(stats.mDecodeBacklog, 0);
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 3);
+	BOOST_REQUIRE(t.fdo.Check(true, BQ_ONLINE, 3));
+}
+
+BOOST_AUTO_TEST_CASE(OffloadDecodeCountsSuppressedPointsPerPoll)
+{
+	DecodePool pool(2, []() {}, []() {});
+	MasterConfig master_cfg; master_cfg.IntegrityRate = 1000;
+	master_cfg.PublishChangesOnly = true;
+	master_cfg.OffloadDecode = true;
+	MasterTestObject t(master_cfg);
+	t.master.SetDecodePool(&pool);
+	t.fake_time.SetTime(timer_clock::time_point(milliseconds(0)));
+	t.master.OnLowerLayerUp();
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00 01 01 00 01 03 02");
+	StackStatistics stats = WaitForDecode(t);
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 3);
+	BOOST_REQUIRE_EQUAL(stats.mPollSuppressedPoints, 0);
+
+	t.fdo.Clear();
+	t.fake_time.Advance(milliseconds(1000));
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00 01 01 00 01 03 00");	// only index 2 changed
+	stats = WaitForDecode(t);
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 1);
+	BOOST_REQUIRE_EQUAL(stats.mPollSuppressedPoints, 2);
+	BOOST_REQUIRE_EQUAL(stats.mNumSuppressedPoints, 2);
+
+	// the count covers every fragment of the poll and starts over with the next one
+	t.fdo.Clear();
+	t.fake_time.Advance(milliseconds(1000));
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 01 06");
+	t.RespondToMaster("C0 81 00 00 01 01 00 01 03 00", false);	// nothing changed
+	t.RespondToMaster("C0 81 00 00 01 01 00 02 02 01");			// index 2 changed back
+	stats = WaitForDecode(t);
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 1);
+	BOOST_REQUIRE_EQUAL(stats.mPollSuppressedPoints, 3);
+	BOOST_REQUIRE_EQUAL(stats.mNumSuppressedPoints, 5);
+}
+
 BOOST_AUTO_TEST_CASE(EventPoll)
 {
 	MasterConfig master_cfg;
@@ -567,6 +824,33 @@ BOOST_AUTO_TEST_CASE(EventPoll)
 	BOOST_REQUIRE(t.fdo.Check(true, BQ_ONLINE, 2, 0));
 }
 
+BOOST_AUTO_TEST_CASE(AdaptiveEventScan)
+{
+	MasterConfig master_cfg; master_cfg.IntegrityRate = -1;
+	master_cfg.AddAdaptiveExceptionScan(PC_CLASS_1, 100, 400);
+	MasterTestObject t(master_cfg);
+	StackCounters counters;
+	t.master.SetCounters(&counters);
+	t.master.OnLowerLayerUp();
+	TestForIntegrityPoll(t);
+
+	// an empty response doubles the period
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 02 06");
+	t.RespondToMaster("C0 81 00 00");
+	BOOST_REQUIRE(t.mts.NextTimerTime() == t.fake_time.GetUTC() + milliseconds(200));
+
+	// the outstation has more class 1 data, so the period halves
+	t.fake_time.Advance(milliseconds(200));
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Read(), "C0 01 3C 02 06");
+	t.RespondToMaster("C0 81 02 00 02 01 17 01 02 81");
+	BOOST_REQUIRE(t.mts.NextTimerTime() == t.fake_time.GetUTC() + milliseconds(100));
+
+	StackStatistics stats = counters.Snapshot();
+	BOOST_REQUIRE_EQUAL(stats.mNumEventScans, 2);
+	BOOST_REQUIRE_EQUAL(stats.mEventScanPeriodMillis, 100);
+}
+
 BOOST_AUTO_TEST_CASE(VtoBufferedWhileStackIsOffline)
 {
 	MasterConfig master_cfg; master_cfg.IntegrityRate = -1;
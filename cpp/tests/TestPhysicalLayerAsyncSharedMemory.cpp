@@ -0,0 +1,265 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <boost/asio.hpp>
+
+#include <opendnp3/Log.h>
+
+#ifdef OPENDNP3_SHARED_MEMORY
+
+#include <opendnp3/PhysicalLayerAsyncSharedMemoryClient.h>
+#include <opendnp3/PhysicalLayerAsyncSharedMemoryServer.h>
+#include <opendnp3/PhysicalLayerAsyncTCPClient.h>
+#include <opendnp3/PhysicalLayerAsyncTCPServer.h>
+
+#include "AsyncTestObjectASIO.h"
+#include "BufferHelpers.h"
+#include "LogTester.h"
+#include "LowerLayerToPhysAdapter.h"
+#include "MockUpperLayer.h"
+#include "PhysLoopback.h"
+#include "RandomizedBuffer.h"
+#include "StopWatch.h"
+#include "TestHelpers.h"
+#include "Timeout.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+using namespace opendnp3;
+using namespace std;
+using namespace std::chrono;
+
+#define OUTPUT_PERF_NUMBERS (0)
+
+BOOST_AUTO_TEST_SUITE(PhysicalLayerAsyncSharedMemorySuite)
+
+const char* SEGMENT = "dnp3test_shm";
+
+class SharedMemoryTestObject : public AsyncTestObjectASIO, public LogTester
+{
+public:
+	SharedMemoryTestObject(size_t aCapacity = 65536) :
+		mServer(mLog.GetLogger(LEV_INFO, "server"), this->GetService(), SEGMENT, aCapacity),
+		mClient(mLog.GetLogger(LEV_INFO, "client"), this->GetService(), SEGMENT),
+		mServerAdapter(mLog.GetLogger(LEV_INFO, "ServerAdapter"), &mServer),
+		mClientAdapter(mLog.GetLogger(LEV_INFO, "ClientAdapter"), &mClient),
+		mServerUpper(mLog.GetLogger(LEV_INFO, "MockUpperServer")),
+		mClientUpper(mLog.GetLogger(LEV_INFO, "MockUpperClient")) {
+		mServerAdapter.SetUpperLayer(&mServerUpper);
+		mClientAdapter.SetUpperLayer(&mClientUpper);
+	}
+
+	void Connect() {
+		mServer.AsyncOpen();
+		mClient.AsyncOpen();
+		BOOST_REQUIRE(this->ProceedUntil(std::bind(&MockUpperLayer::IsLowerLayerUp, &mServerUpper)));
+		BOOST_REQUIRE(this->ProceedUntil(std::bind(&MockUpperLayer::IsLowerLayerUp, &mClientUpper)));
+	}
+
+	void Disconnect() {
+		BOOST_REQUIRE(this->ProceedUntilFalse(std::bind(&MockUpperLayer::IsLowerLayerUp, &mServerUpper)));
+		BOOST_REQUIRE(this->ProceedUntilFalse(std::bind(&MockUpperLayer::IsLowerLayerUp, &mClientUpper)));
+	}
+
+	PhysicalLayerAsyncSharedMemoryServer mServer;
+	PhysicalLayerAsyncSharedMemoryClient mClient;
+
+	LowerLayerToPhysAdapter mServerAdapter;
+	LowerLayerToPhysAdapter mClientAdapter;
+
+	MockUpperLayer mServerUpper;
+	MockUpperLayer mClientUpper;
+};
+
+BOOST_AUTO_TEST_CASE(ClientConnectionRejected)
+{
+	SharedMemoryTestObject t;
+
+	for(size_t i = 0; i < 2; ++i) {
+		t.mClient.AsyncOpen();
+		BOOST_REQUIRE(t.ProceedUntil(std::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &t.mClientAdapter, i + 1)));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ServerAcceptCanceled)
+{
+	SharedMemoryTestObject t;
+
+	for(size_t i = 0; i < 2; ++i) {
+		t.mServer.AsyncOpen();
+		t.mServer.AsyncClose();
+		BOOST_REQUIRE(t.ProceedUntil(std::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &t.mServerAdapter, i + 1)));
+
+		// the server is no longer listening
+		t.mClient.AsyncOpen();
+		BOOST_REQUIRE(t.ProceedUntil(std::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &t.mClientAdapter, i + 1)));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ConnectDisconnect)
+{
+	SharedMemoryTestObject t;
+
+	for(size_t i = 0; i < 10; ++i) {
+		t.Connect();
+
+		// since reads are outstanding, closing either end brings both down
+		if( (i % 2) == 0 ) t.mServer.AsyncClose();
+		else t.mClient.AsyncClose();
+		t.Disconnect();
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SecondClientRejected)
+{
+	SharedMemoryTestObject t;
+	t.Connect();
+
+	EventLog log;
+	PhysicalLayerAsyncSharedMemoryClient client(log.GetLogger(LEV_INFO, "client2"), t.GetService(), SEGMENT);
+	LowerLayerToPhysAdapter adapter(log.GetLogger(LEV_INFO, "adapter2"), &client);
+	client.AsyncOpen();
+	BOOST_REQUIRE(t.ProceedUntil(std::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &adapter, 1)));
+
+	t.mClient.AsyncClose();
+	t.Disconnect();
+}
+
+BOOST_AUTO_TEST_CASE(TwoWaySendLargerThanRing)
+{
+	const size_t SEND_SIZE = 1 << 20; // 1 MB
+
+	// a small ring makes the writers block and wait for the reader to free space
+	SharedMemoryTestObject t(4096);
+	t.Connect();
+
+	ByteStr bs(SEND_SIZE, 77);
+	t.mClientUpper.SendDown(bs.Buffer(), bs.Size());
+	t.mServerUpper.SendDown(bs.Buffer(), bs.Size());
+
+	BOOST_REQUIRE(t.ProceedUntil(std::bind(&MockUpperLayer::SizeEquals, &t.mServerUpper, SEND_SIZE)));
+	BOOST_REQUIRE(t.ProceedUntil(std::bind(&MockUpperLayer::SizeEquals, &t.mClientUpper, SEND_SIZE)));
+
+	BOOST_REQUIRE(t.mClientUpper.BufferEquals(bs.Buffer(), bs.Size()));
+	BOOST_REQUIRE(t.mServerUpper.BufferEquals(bs.Buffer(), bs.Size()));
+
+	t.mServer.AsyncClose();
+	t.Disconnect();
+}
+
+BOOST_AUTO_TEST_CASE(PendingDataIsDeliveredBeforeClose)
+{
+	SharedMemoryTestObject t;
+	t.Connect();
+
+	ByteStr bs(1024, 77);
+	t.mClientUpper.SendDown(bs.Buffer(), bs.Size());
+	BOOST_REQUIRE(t.ProceedUntil(std::bind(&MockUpperLayer::CountersEqual, &t.mClientUpper, 1, 0)));
+	t.mClient.AsyncClose();
+
+	t.Disconnect();
+	BOOST_REQUIRE(t.mServerUpper.BufferEquals(bs.Buffer(), bs.Size()));
+}
+
+// Runs the io_service without the sleeps in ProceedUntil so they don't hide the transport latency
+bool Spin(boost::asio::io_service* apService, const std::function<bool ()>& arCondition)
+{
+	Timeout to(std::chrono::seconds(30));
+	while(!arCondition()) {
+		if(to.IsExpired()) return false;
+		apService->poll_one();
+		apService->reset();
+	}
+	return true;
+}
+
+// Echoes frames off a loopback on the server end and times the round trips and the bulk transfer
+void MeasureLoopback(AsyncTestObjectASIO& arTest, IPhysicalLayerAsync* apServer, IPhysicalLayerAsync* apClient, const std::string& arName)
+{
+	const size_t FRAME_SIZE = 292;
+	const size_t ITERATIONS = 1000;
+	const size_t BULK_SIZE = 1 << 20;
+
+	EventLog log;
+	PhysLoopback loopback(log.GetLogger(LEV_INFO, "loopback"), apServer);
+	LowerLayerToPhysAdapter adapter(log.GetLogger(LEV_INFO, "adapter"), apClient);
+	MockUpperLayer upper(log.GetLogger(LEV_INFO, "upper"));
+	adapter.SetUpperLayer(&upper);
+
+	loopback.Start();
+	apClient->AsyncOpen();
+	BOOST_REQUIRE(Spin(arTest.GetService(), std::bind(&MockUpperLayer::IsLowerLayerUp, &upper)));
+
+	RandomizedBuffer rb(FRAME_SIZE);
+	StopWatch sw;
+	for(size_t i = 0; i < ITERATIONS; ++i) {
+		rb.Randomize();
+		upper.SendDown(rb, rb.Size());
+		BOOST_REQUIRE(Spin(arTest.GetService(), std::bind(&MockUpperLayer::SizeEquals, &upper, rb.Size())));
+		BOOST_REQUIRE(Spin(arTest.GetService(), std::bind(&MockUpperLayer::CountersEqual, &upper, i + 1, 0)));
+		BOOST_REQUIRE(upper.BufferEquals(rb.Buffer(), rb.Size()));
+		upper.ClearBuffer();
+	}
+	double latency_usec = duration_cast<microseconds>(sw.Elapsed()).count() / static_cast<double>(ITERATIONS);
+
+	ByteStr bs(BULK_SIZE, 77);
+	upper.SendDown(bs.Buffer(), bs.Size());
+	BOOST_REQUIRE(Spin(arTest.GetService(), std::bind(&MockUpperLayer::SizeEquals, &upper, BULK_SIZE)));
+	BOOST_REQUIRE(upper.BufferEquals(bs.Buffer(), bs.Size()));
+	double elapsed_sec = duration_cast<microseconds>(sw.Elapsed()).count() / 1e6;
+
+	if(OUTPUT_PERF_NUMBERS) {
+		cout << arName << ": " << latency_usec << " usec per round trip, " << BULK_SIZE / elapsed_sec << " bytes/sec echoed" << endl;
+	}
+
+	apClient->AsyncClose();
+	BOOST_REQUIRE(Spin(arTest.GetService(), [&upper]() {
+		return !upper.IsLowerLayerUp();
+	}));
+	loopback.Shutdown();
+	arTest.ProceedForTime(100);
+}
+
+BOOST_AUTO_TEST_CASE(LoopbackVersusTCP)
+{
+	EventLog log;
+	AsyncTestObjectASIO test;
+
+	{
+		PhysicalLayerAsyncSharedMemoryServer server(log.GetLogger(LEV_INFO, "server"), test.GetService(), SEGMENT, 65536);
+		PhysicalLayerAsyncSharedMemoryClient client(log.GetLogger(LEV_INFO, "client"), test.GetService(), SEGMENT);
+		MeasureLoopback(test, &server, &client, "shared memory");
+	}
+
+	{
+		PhysicalLayerAsyncTCPServer server(log.GetLogger(LEV_INFO, "server"), test.GetService(), "127.0.0.1", 30000);
+		PhysicalLayerAsyncTCPClient client(log.GetLogger(LEV_INFO, "client"), test.GetService(), "127.0.0.1", 30000);
+		MeasureLoopback(test, &server, &client, "tcp loopback");
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
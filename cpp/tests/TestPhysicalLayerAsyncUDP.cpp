@@ -0,0 +1,291 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+
+#include <boost/test/unit_test.hpp>
+#include <boost/asio.hpp>
+
+#include <opendnp3/Log.h>
+#include <opendnp3/PhysicalLayerAsyncUDP.h>
+#include <opendnp3/UDPSocketService.h>
+
+#include "AsyncTestObjectASIO.h"
+#include "BufferHelpers.h"
+#include "LowerLayerToPhysAdapter.h"
+#include "MockUpperLayer.h"
+#include "StopWatch.h"
+#include "TestHelpers.h"
+#include "TransportIntegrationStack.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace opendnp3;
+using namespace boost::asio;
+using namespace std;
+using namespace std::chrono;
+
+#define OUTPUT_PERF_NUMBERS (0)
+
+BOOST_AUTO_TEST_SUITE(PhysicalLayerAsyncUDPSuite)
+
+const uint16_t PORT_A = 40000;
+const uint16_t PORT_B = 40001;
+
+ip::udp::endpoint Local(uint16_t aPort)
+{
+	return ip::udp::endpoint(ip::address::from_string("127.0.0.1"), aPort);
+}
+
+// A layer on a shared socket with a mock upper layer attached
+class UDPTestLayer
+{
+public:
+	UDPTestLayer(Logger* apLogger, io_service* apService, UDPSocketService* apSocket, uint16_t aRemotePort, int32_t aLinkAddress = UDPSocketService::ANY_LINK_ADDRESS) :
+		mPhys(apLogger->GetSubLogger("phys"), apService, apSocket, "127.0.0.1", aRemotePort, aLinkAddress),
+		mAdapter(apLogger->GetSubLogger("adapter"), &mPhys),
+		mUpper(apLogger->GetSubLogger("upper")) {
+		mAdapter.SetUpperLayer(&mUpper);
+	}
+
+	PhysicalLayerAsyncUDP mPhys;
+	LowerLayerToPhysAdapter mAdapter;
+	MockUpperLayer mUpper;
+};
+
+class UDPTestObject : public AsyncTestObjectASIO
+{
+public:
+	UDPTestObject() :
+		mpLogger(mLog.GetLogger(LEV_INFO, "test")),
+		mSocketA(mpLogger->GetSubLogger("socketA"), this->GetService(), Local(PORT_A)),
+		mSocketB(mpLogger->GetSubLogger("socketB"), this->GetService(), Local(PORT_B))
+	{}
+
+	~UDPTestObject() {
+		mSocketA.Shutdown();
+		mSocketB.Shutdown();
+		this->GetService()->run();
+	}
+
+	void Open(UDPTestLayer& arLayer) {
+		arLayer.mPhys.AsyncOpen();
+		BOOST_REQUIRE(this->ProceedUntil(std::bind(&MockUpperLayer::IsLowerLayerUp, &arLayer.mUpper)));
+	}
+
+	void Close(UDPTestLayer& arLayer) {
+		arLayer.mPhys.AsyncClose();
+		BOOST_REQUIRE(this->ProceedUntilFalse(std::bind(&MockUpperLayer::IsLowerLayerUp, &arLayer.mUpper)));
+	}
+
+	EventLog mLog;
+	Logger* mpLogger;
+	UDPSocketService mSocketA;
+	UDPSocketService mSocketB;
+};
+
+BOOST_AUTO_TEST_CASE(DatagramsRouteByRemoteEndpoint)
+{
+	UDPTestObject t;
+	UDPTestLayer a(t.mpLogger->GetSubLogger("a"), t.GetService(), &t.mSocketA, PORT_B);
+	UDPTestLayer b(t.mpLogger->GetSubLogger("b"), t.GetService(), &t.mSocketB, PORT_A);
+	t.Open(a);
+	t.Open(b);
+
+	// the buffers have to outlive the writes
+	HexSequence request("01 02 03");
+	HexSequence response("04 05");
+
+	a.mUpper.SendDown(request.Buffer(), request.Size());
+	BOOST_REQUIRE(t.ProceedUntil(std::bind(&MockUpperLayer::SizeEquals, &b.mUpper, 3)));
+	BOOST_REQUIRE(b.mUpper.BufferEqualsHex("01 02 03"));
+
+	b.mUpper.SendDown(response.Buffer(), response.Size());
+	BOOST_REQUIRE(t.ProceedUntil(std::bind(&MockUpperLayer::SizeEquals, &a.mUpper, 2)));
+	BOOST_REQUIRE(a.mUpper.BufferEqualsHex("04 05"));
+
+	t.Close(a);
+	t.Close(b);
+}
+
+BOOST_AUTO_TEST_CASE(FramesRouteByLinkAddress)
+{
+	UDPTestObject t;
+	UDPTestLayer master10(t.mpLogger->GetSubLogger("master10"), t.GetService(), &t.mSocketA, PORT_B, 10);
+	UDPTestLayer master11(t.mpLogger->GetSubLogger("master11"), t.GetService(), &t.mSocketA, PORT_B, 11);
+	UDPTestLayer gateway(t.mpLogger->GetSubLogger("gateway"), t.GetService(), &t.mSocketB, PORT_A);
+	t.Open(master10);
+	t.Open(master11);
+	t.Open(gateway);
+
+	HexSequence from11("05 64 05 00 01 00 0B 00 00 00");
+	HexSequence to10("05 64 05 C0 0A 00 01 00 00 00");
+	HexSequence from12("05 64 05 00 01 00 0C 00 00 00");
+
+	// a response from outstation 11 to master 1, matched on the source
+	gateway.mUpper.SendDown(from11.Buffer(), from11.Size());
+	BOOST_REQUIRE(t.ProceedUntil(std::bind(&MockUpperLayer::SizeEquals, &master11.mUpper, 10)));
+
+	// a frame addressed to outstation 10, matched on the destination
+	gateway.mUpper.SendDown(to10.Buffer(), to10.Size());
+	BOOST_REQUIRE(t.ProceedUntil(std::bind(&MockUpperLayer::SizeEquals, &master10.mUpper, 10)));
+	BOOST_REQUIRE(master11.mUpper.SizeEquals(10));
+
+	// no route for outstation 12
+	gateway.mUpper.SendDown(from12.Buffer(), from12.Size());
+	BOOST_REQUIRE(t.ProceedUntil([&t]() {
+		return t.mSocketA.GetNumDropped() == 1;
+	}));
+
+	t.Close(master10);
+	t.Close(master11);
+	t.Close(gateway);
+}
+
+BOOST_AUTO_TEST_CASE(DuplicateRouteFailsToOpen)
+{
+	UDPTestObject t;
+	UDPTestLayer first(t.mpLogger->GetSubLogger("first"), t.GetService(), &t.mSocketA, PORT_B, 10);
+	UDPTestLayer second(t.mpLogger->GetSubLogger("second"), t.GetService(), &t.mSocketA, PORT_B, 10);
+	t.Open(first);
+
+	second.mPhys.AsyncOpen();
+	BOOST_REQUIRE(t.ProceedUntil(std::bind(&LowerLayerToPhysAdapter::OpenFailureEquals, &second.mAdapter, 1)));
+
+	// the route is free again once the first layer closes
+	t.Close(first);
+	t.Open(second);
+	t.Close(second);
+}
+
+BOOST_AUTO_TEST_CASE(DatagramsAreQueuedUntilRead)
+{
+	UDPTestObject t;
+	UDPTestLayer a(t.mpLogger->GetSubLogger("a"), t.GetService(), &t.mSocketA, PORT_B);
+	UDPTestLayer b(t.mpLogger->GetSubLogger("b"), t.GetService(), &t.mSocketB, PORT_A);
+	t.Open(a);
+	t.Open(b);
+
+	HexSequence data("0A 0B");
+	for(size_t i = 0; i < 10; ++i) {
+		a.mUpper.SendDown(data.Buffer(), data.Size());
+		BOOST_REQUIRE(t.ProceedUntil(std::bind(&MockUpperLayer::CountersEqual, &a.mUpper, i + 1, 0)));
+	}
+
+	BOOST_REQUIRE(t.ProceedUntil(std::bind(&MockUpperLayer::SizeEquals, &b.mUpper, 20)));
+
+	t.Close(a);
+	t.Close(b);
+}
+
+// Polls 1000 outstations from one master socket. Every pair has a full link
+// layer router and transport stack, and each outstation answers each request.
+BOOST_AUTO_TEST_CASE(ThousandOutstationsLoopback)
+{
+	const uint16_t NUM_OUTSTATIONS = 1000;
+	const uint16_t GROUP_SIZE = 50;
+	const uint16_t FIRST_ADDRESS = 10;
+	const size_t ROUNDS = 3;
+
+	EventLog log;
+	Logger* pLogger = log.GetLogger(LEV_WARNING, "test");
+	AsyncTestObjectASIO test;
+	UDPSocketService masterSocket(pLogger->GetSubLogger("master"), test.GetService(), Local(PORT_A));
+	UDPSocketService outstationSocket(pLogger->GetSubLogger("outstation"), test.GetService(), Local(PORT_B));
+
+	vector< shared_ptr<PhysicalLayerAsyncUDP> > layers;
+	vector< shared_ptr<TransportIntegrationStack> > masters;
+	vector< shared_ptr<TransportIntegrationStack> > outstations;
+
+	for(uint16_t i = 0; i < NUM_OUTSTATIONS; ++i) {
+		uint16_t address = FIRST_ADDRESS + i;
+		shared_ptr<PhysicalLayerAsyncUDP> pMasterPhys(new PhysicalLayerAsyncUDP(pLogger, test.GetService(), &masterSocket, "127.0.0.1", PORT_B, address));
+		shared_ptr<PhysicalLayerAsyncUDP> pOutstationPhys(new PhysicalLayerAsyncUDP(pLogger, test.GetService(), &outstationSocket, "127.0.0.1", PORT_A, address));
+		layers.push_back(pMasterPhys);
+		layers.push_back(pOutstationPhys);
+		masters.push_back(shared_ptr<TransportIntegrationStack>(new TransportIntegrationStack(pLogger, pMasterPhys.get(), LinkConfig(true, false, 0, 1, address, 1000))));
+		outstations.push_back(shared_ptr<TransportIntegrationStack>(new TransportIntegrationStack(pLogger, pOutstationPhys.get(), LinkConfig(false, false, 0, address, 1, 1000))));
+	}
+
+	StopWatch sw;
+	for(uint16_t i = 0; i < NUM_OUTSTATIONS; ++i) {
+		masters[i]->mRouter.Start();
+		outstations[i]->mRouter.Start();
+	}
+
+	BOOST_REQUIRE(test.ProceedUntil([&]() {
+		for(uint16_t i = 0; i < NUM_OUTSTATIONS; ++i) {
+			if(!masters[i]->mUpper.IsLowerLayerUp() || !outstations[i]->mUpper.IsLowerLayerUp()) return false;
+		}
+		return true;
+	}));
+	double open_msec = duration_cast<microseconds>(sw.Elapsed()).count() / 1000.0;
+
+	ByteStr request(20, 0x11);
+	ByteStr response(200, 0x22);
+
+	for(size_t round = 0; round < ROUNDS; ++round) {
+		// groups keep each burst within what the socket buffers hold without loss
+		for(uint16_t start = 0; start < NUM_OUTSTATIONS; start += GROUP_SIZE) {
+			for(uint16_t i = start; i < start + GROUP_SIZE; ++i) masters[i]->mUpper.SendDown(request, request.Size());
+			BOOST_REQUIRE(test.ProceedUntil([&]() {
+				for(uint16_t i = start; i < start + GROUP_SIZE; ++i) if(outstations[i]->mUpper.Size() != request.Size()) return false;
+				return true;
+			}));
+
+			for(uint16_t i = start; i < start + GROUP_SIZE; ++i) outstations[i]->mUpper.SendDown(response, response.Size());
+			BOOST_REQUIRE(test.ProceedUntil([&]() {
+				for(uint16_t i = start; i < start + GROUP_SIZE; ++i) if(masters[i]->mUpper.Size() != response.Size()) return false;
+				return true;
+			}));
+
+			for(uint16_t i = start; i < start + GROUP_SIZE; ++i) {
+				BOOST_REQUIRE(outstations[i]->mUpper.BufferEquals(request, request.Size()));
+				BOOST_REQUIRE(masters[i]->mUpper.BufferEquals(response, response.Size()));
+				outstations[i]->mUpper.ClearBuffer();
+				masters[i]->mUpper.ClearBuffer();
+			}
+		}
+	}
+
+	double poll_sec = duration_cast<microseconds>(sw.Elapsed()).count() / 1e6;
+	BOOST_REQUIRE_EQUAL(0, masterSocket.GetNumDropped());
+	BOOST_REQUIRE_EQUAL(0, outstationSocket.GetNumDropped());
+
+	if(OUTPUT_PERF_NUMBERS) {
+		size_t polls = ROUNDS * NUM_OUTSTATIONS;
+		cout << NUM_OUTSTATIONS << " outstations on 2 sockets, all links up in " << open_msec << " ms" << endl;
+		cout << polls << " request/response pairs in " << poll_sec << " sec, " << polls / poll_sec << " per sec" << endl;
+	}
+
+	for(uint16_t i = 0; i < NUM_OUTSTATIONS; ++i) {
+		masters[i]->mRouter.Shutdown();
+		outstations[i]->mRouter.Shutdown();
+	}
+	masterSocket.Shutdown();
+	outstationSocket.Shutdown();
+	test.GetService()->run();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
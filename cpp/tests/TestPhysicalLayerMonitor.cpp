@@ -27,10 +27,19 @@
 #include <opendnp3/PhysicalLayerMonitor.h>
 #include <opendnp3/PhysicalLayerMonitorStates.h>
 
+#include <opendnp3/OpenLimiter.h>
+
 #include "MockExecutor.h"
 #include "MockPhysicalLayerAsync.h"
 #include "TestHelpers.h"
 
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+
+#define OUTPUT_PERF_NUMBERS	(0)
+
 using namespace opendnp3;
 using namespace boost;
 using namespace std::chrono;
@@ -46,6 +55,13 @@ public:
 		mCloseCallbackCount(0) {
 	}
 
+	ConcretePhysicalLayerMonitor(Logger* apLogger, IPhysicalLayerAsync* apPhys, const OpenRetryPolicy& arPolicy, OpenLimiter* apLimiter) :
+		Loggable(apLogger),
+		PhysicalLayerMonitor(mpLogger->GetSubLogger("monitor"), apPhys, arPolicy, apLimiter),
+		mOpenCallbackCount(0),
+		mCloseCallbackCount(0) {
+	}
+
 	void ReachInAndStartOpenTimer() {
 		this->StartOpenTimer();
 	}
@@ -87,6 +103,85 @@ public:
 	ConcretePhysicalLayerMonitor monitor;
 };
 
+// one of many channels that share an executor and an open limiter
+class LimitedChannel
+{
+public:
+
+	LimitedChannel(Logger* apLogger, MockExecutor* apExecutor, const OpenRetryPolicy& arPolicy, OpenLimiter* apLimiter) :
+		phys(apLogger, apExecutor),
+		monitor(apLogger, &phys, arPolicy, apLimiter)
+	{}
+
+	MockPhysicalLayerAsync phys;
+	ConcretePhysicalLayerMonitor monitor;
+};
+
+typedef std::vector< std::shared_ptr<LimitedChannel> > ChannelVector;
+
+void AddChannels(ChannelVector& arChannels, size_t aNum, Logger* apLogger, MockExecutor* apExecutor, const OpenRetryPolicy& arPolicy, OpenLimiter* apLimiter)
+{
+	for(size_t i = 0; i < aNum; ++i) {
+		arChannels.push_back(std::shared_ptr<LimitedChannel>(new LimitedChannel(apLogger, apExecutor, arPolicy, apLimiter)));
+	}
+}
+
+/**
+* Every channel fails every open for a number of rounds. Each channel's retry delays are summed
+* into a virtual clock and the next attempt is counted in a 100ms bucket of that clock.
+* @return the attempt histogram
+*/
+std::map<millis_t, size_t> SimulateReconnectStorm(const OpenRetryPolicy& arPolicy, size_t aNumChannels, size_t aNumRounds, size_t aMaxOpens)
+{
+	EventLog log;
+	MockExecutor exe;
+	exe.SetAutoPost(true);
+	OpenLimiter limiter(aMaxOpens);
+	ChannelVector channels;
+	AddChannels(channels, aNumChannels, log.GetLogger(LEV_WARNING, "channel"), &exe, arPolicy, &limiter);
+
+	std::vector<millis_t> clock(aNumChannels, 0);
+	std::vector<size_t> seen(aNumChannels, 0);
+	std::map<millis_t, size_t> histogram;
+
+	for(size_t i = 0; i < aNumChannels; ++i) channels[i]->monitor.Start();
+
+	for(size_t round = 0; round < aNumRounds; ++round) {
+
+		// fail opens as the limiter lets them through until every channel is waiting on its timer
+		size_t failed = 0;
+		while(failed < aNumChannels) {
+			BOOST_REQUIRE(limiter.GetNumInFlight() <= aMaxOpens);
+			size_t failedThisPass = 0;
+			for(size_t i = 0; i < aNumChannels; ++i) {
+				if(channels[i]->phys.NumOpen() > seen[i]) {
+					++seen[i];
+					channels[i]->phys.SignalOpenFailure();
+					clock[i] += duration_cast<milliseconds>(exe.NextDurationTimer()).count();
+					++histogram[clock[i] / 100];
+					++failedThisPass;
+				}
+			}
+			BOOST_REQUIRE(failedThisPass > 0);
+			failed += failedThisPass;
+		}
+
+		BOOST_REQUIRE_EQUAL(0, limiter.GetNumWaiting());
+		BOOST_REQUIRE_EQUAL(aNumChannels, exe.Dispatch(aNumChannels));
+	}
+
+	// the final round of opens is only as far along as the limiter allows
+	uint64_t attempts = 0;
+for(auto& pChannel: channels) {
+		OpenStatistics stats = pChannel->monitor.GetOpenStatistics();
+		BOOST_REQUIRE_EQUAL(aNumRounds, stats.mNumFailure);
+		attempts += stats.mNumAttempts;
+	}
+	BOOST_REQUIRE_EQUAL(aNumRounds * aNumChannels + std::min(aNumChannels, aMaxOpens), attempts);
+
+	return histogram;
+}
+
 BOOST_AUTO_TEST_SUITE(PhysicalLayerMonitorTestSuite)
 
 BOOST_AUTO_TEST_CASE(StateClosedExceptions)
@@ -380,4 +475,159 @@ BOOST_AUTO_TEST_CASE(SuspendWhileWaitingCancelsTimer)
 	BOOST_REQUIRE_EQUAL(0, test.exe.NumActive());
 }
 
+BOOST_AUTO_TEST_CASE(JitteredBackoffStaysWithinBounds)
+{
+	EventLog log;
+	MockExecutor exe;
+	MockPhysicalLayerAsync phys(log.GetLogger(LEV_INFO, "mock-phys"), &exe);
+	ConcretePhysicalLayerMonitor monitor(log.GetLogger(LEV_INFO, "test"), &phys, OpenRetryPolicy(1000, 8000, 2.0, 0.5), NULL);
+
+	monitor.Start();
+	millis_t expected[] = { 1000, 2000, 4000, 8000, 8000, 8000 };
+	for(millis_t max: expected) {
+		phys.SignalOpenFailure();
+		BOOST_REQUIRE_EQUAL(CS_WAITING, monitor.GetState());
+		millis_t delay = duration_cast<milliseconds>(exe.NextDurationTimer()).count();
+		BOOST_REQUIRE(delay >= max / 2);
+		BOOST_REQUIRE(delay <= max);
+		BOOST_REQUIRE(exe.DispatchOne());
+	}
+
+	phys.SignalOpenSuccess();
+	OpenStatistics stats = monitor.GetOpenStatistics();
+	BOOST_REQUIRE_EQUAL(7, stats.mNumAttempts);
+	BOOST_REQUIRE_EQUAL(1, stats.mNumSuccess);
+	BOOST_REQUIRE_EQUAL(6, stats.mNumFailure);
+	BOOST_REQUIRE_EQUAL(1000, stats.mCurrentRetry);
+}
+
+BOOST_AUTO_TEST_CASE(LimiterDefersOpensBeyondTheLimit)
+{
+	EventLog log;
+	MockExecutor exe;
+	OpenLimiter limiter(2);
+	ChannelVector channels;
+	AddChannels(channels, 3, log.GetLogger(LEV_INFO, "channel"), &exe, OpenRetryPolicy(1000), &limiter);
+
+	for(auto& pChannel: channels) pChannel->monitor.Start();
+	BOOST_REQUIRE_EQUAL(1, channels[0]->phys.NumOpen());
+	BOOST_REQUIRE_EQUAL(1, channels[1]->phys.NumOpen());
+	BOOST_REQUIRE_EQUAL(0, channels[2]->phys.NumOpen());
+	BOOST_REQUIRE_EQUAL(CS_OPENING, channels[2]->monitor.GetState());
+	BOOST_REQUIRE_EQUAL(1, channels[2]->monitor.GetOpenStatistics().mNumDeferred);
+	BOOST_REQUIRE_EQUAL(2, limiter.GetNumInFlight());
+	BOOST_REQUIRE_EQUAL(1, limiter.GetNumWaiting());
+
+	// the token moves to the waiting channel once an open completes
+	channels[0]->phys.SignalOpenSuccess();
+	BOOST_REQUIRE_EQUAL(0, channels[2]->phys.NumOpen());
+	BOOST_REQUIRE_EQUAL(1, exe.Dispatch());
+	BOOST_REQUIRE_EQUAL(1, channels[2]->phys.NumOpen());
+	BOOST_REQUIRE_EQUAL(2, limiter.GetNumInFlight());
+	BOOST_REQUIRE_EQUAL(0, limiter.GetNumWaiting());
+
+	channels[1]->phys.SignalOpenFailure();
+	channels[2]->phys.SignalOpenSuccess();
+	BOOST_REQUIRE_EQUAL(0, limiter.GetNumInFlight());
+}
+
+BOOST_AUTO_TEST_CASE(SuspendWhileDeferredAbandonsOpen)
+{
+	EventLog log;
+	MockExecutor exe;
+	OpenLimiter limiter(1);
+	ChannelVector channels;
+	AddChannels(channels, 2, log.GetLogger(LEV_INFO, "channel"), &exe, OpenRetryPolicy(1000), &limiter);
+
+	channels[0]->monitor.Start();
+	channels[1]->monitor.Start();
+	channels[1]->monitor.Suspend();
+	BOOST_REQUIRE_EQUAL(0, limiter.GetNumWaiting());
+	BOOST_REQUIRE_EQUAL(1, exe.Dispatch());
+	BOOST_REQUIRE_EQUAL(CS_CLOSED, channels[1]->monitor.GetState());
+	BOOST_REQUIRE_EQUAL(0, channels[1]->phys.NumOpen());
+
+	channels[0]->phys.SignalOpenFailure();
+	BOOST_REQUIRE_EQUAL(0, limiter.GetNumInFlight());
+	BOOST_REQUIRE_EQUAL(0, channels[1]->phys.NumOpen());
+}
+
+BOOST_AUTO_TEST_CASE(ShutdownWhileGrantIsPostedReturnsToken)
+{
+	EventLog log;
+	MockExecutor exe;
+	OpenLimiter limiter(1);
+	ChannelVector channels;
+	AddChannels(channels, 2, log.GetLogger(LEV_INFO, "channel"), &exe, OpenRetryPolicy(1000), &limiter);
+
+	channels[0]->monitor.Start();
+	channels[1]->monitor.Start();
+	channels[0]->phys.SignalOpenSuccess(); // posts the grant to channel 1
+	channels[1]->monitor.Shutdown();
+	exe.Dispatch();
+	BOOST_REQUIRE_EQUAL(CS_SHUTDOWN, channels[1]->monitor.GetState());
+	BOOST_REQUIRE_EQUAL(0, channels[1]->phys.NumOpen());
+	BOOST_REQUIRE_EQUAL(0, limiter.GetNumInFlight());
+}
+
+BOOST_AUTO_TEST_CASE(DestroyWhileGrantIsPostedReturnsToken)
+{
+	EventLog log;
+	MockExecutor exe;
+	OpenLimiter limiter(1);
+	ChannelVector channels;
+	AddChannels(channels, 3, log.GetLogger(LEV_INFO, "channel"), &exe, OpenRetryPolicy(1000), &limiter);
+
+	for(auto& pChannel: channels) pChannel->monitor.Start();
+	BOOST_REQUIRE_EQUAL(2, limiter.GetNumWaiting());
+	channels[0]->phys.SignalOpenSuccess(); // posts the grant to channel 1
+	BOOST_REQUIRE_EQUAL(1, limiter.GetNumInFlight());
+
+	// the posted grant outlives its monitor, the destructor returns the token to the next in line
+	channels[1].reset();
+	BOOST_REQUIRE_EQUAL(1, limiter.GetNumInFlight());
+	BOOST_REQUIRE_EQUAL(0, limiter.GetNumWaiting());
+	BOOST_REQUIRE_EQUAL(2, exe.Dispatch());
+	BOOST_REQUIRE_EQUAL(1, channels[2]->phys.NumOpen());
+
+	// a monitor destroyed while queued leaves nothing behind
+	AddChannels(channels, 1, log.GetLogger(LEV_INFO, "channel"), &exe, OpenRetryPolicy(1000), &limiter);
+	channels[3]->monitor.Start();
+	BOOST_REQUIRE_EQUAL(1, limiter.GetNumWaiting());
+	channels[3].reset();
+	BOOST_REQUIRE_EQUAL(0, limiter.GetNumWaiting());
+	channels[2]->phys.SignalOpenSuccess();
+	BOOST_REQUIRE_EQUAL(0, limiter.GetNumInFlight());
+	BOOST_REQUIRE_EQUAL(0, exe.Dispatch());
+}
+
+BOOST_AUTO_TEST_CASE(ThousandChannelReconnectStorm)
+{
+	const size_t NUM_CHANNELS = 1000;
+	const size_t NUM_ROUNDS = 4;
+	const size_t MAX_OPENS = 100;
+
+	auto lockstep = SimulateReconnectStorm(OpenRetryPolicy(1000), NUM_CHANNELS, NUM_ROUNDS, MAX_OPENS);
+	auto jittered = SimulateReconnectStorm(OpenRetryPolicy(1000, 16000, 2.0, 0.5), NUM_CHANNELS, NUM_ROUNDS, MAX_OPENS);
+
+	size_t lockstepPeak = 0;
+	size_t jitteredPeak = 0;
+	for(auto& pair: lockstep) lockstepPeak = std::max(lockstepPeak, pair.second);
+	for(auto& pair: jittered) jitteredPeak = std::max(jitteredPeak, pair.second);
+
+	// a fixed period retries every channel in the same instant, every round
+	BOOST_REQUIRE_EQUAL(NUM_ROUNDS, lockstep.size());
+	BOOST_REQUIRE_EQUAL(NUM_CHANNELS, lockstepPeak);
+
+	// with jitter no 100ms window sees more than a third of the channels
+	BOOST_REQUIRE(jitteredPeak < NUM_CHANNELS / 3);
+
+	if(OUTPUT_PERF_NUMBERS) {
+		std::cout << "open attempts per 100ms, " << NUM_CHANNELS << " channels, peak " << jitteredPeak << " (lockstep " << lockstepPeak << ")" << std::endl;
+		for(auto& pair: jittered) {
+			std::cout << pair.first * 100 << "ms\t" << pair.second << "\t" << std::string(pair.second / 5, '#') << std::endl;
+		}
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -136,5 +136,49 @@ BOOST_AUTO_TEST_CASE(Group40Var2)
 	t.CheckSetpointStatii("C0 81 00 00 28 02 00 00 01 01 04 00 01 09 00");
 }
 
+BOOST_AUTO_TEST_CASE(ChangeFilterSuppressesRepeatedStatics)
+{
+	ChangeFilter filter;
+	ResponseLoaderTestObject t;
+	t.pFilter = &filter;
+
+	t.Load("C0 81 00 00 01 01 00 01 03 02");
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 3);
+	BOOST_REQUIRE_EQUAL(t.numSuppressed, 0);
+
+	t.Load("C0 81 00 00 01 01 00 01 03 02");
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 0);
+	BOOST_REQUIRE_EQUAL(t.numSuppressed, 3);
+
+	// index 2 goes false
+	t.Load("C0 81 00 00 01 01 00 01 03 00");
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 1);
+	BOOST_REQUIRE(t.fdo.Check(false, BQ_ONLINE, 2, 0));
+
+	// a change of quality is published
+	t.Load("C0 81 00 00 1E 01 00 00 01 01 04 00 00 00 01 09 00 00 00");
+	t.Load("C0 81 00 00 1E 01 00 00 01 01 04 00 00 00 03 09 00 00 00");
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 1);
+	BOOST_REQUIRE(t.fdo.Check(9, static_cast<AnalogQuality>(AQ_ONLINE | AQ_RESTART), 1));
+}
+
+BOOST_AUTO_TEST_CASE(ChangeFilterPublishesEvents)
+{
+	ChangeFilter filter;
+	ResponseLoaderTestObject t;
+	t.pFilter = &filter;
+
+	for(size_t i = 0; i < 2; ++i) {
+		t.Load("C0 81 00 00 02 01 17 01 02 81");
+		BOOST_REQUIRE(t.fdo.Check(true, BQ_ONLINE, 2, 0));
+		BOOST_REQUIRE_EQUAL(t.numSuppressed, 0);
+	}
+
+	// a static value matching the last event is unchanged
+	t.Load("C0 81 00 00 01 02 00 02 02 81");
+	BOOST_REQUIRE_EQUAL(t.fdo.GetTotalCount(), 0);
+	BOOST_REQUIRE_EQUAL(t.numSuppressed, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END() //end suite
 
@@ -346,6 +346,124 @@ BOOST_AUTO_TEST_CASE(FlushesMoreVtoEventsAfterSuccess)
 	BOOST_REQUIRE_EQUAL(t.Count(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(ReportVtoStreamViaUnsol)
+{
+	SlaveConfig cfg; cfg.mUnsolPackDelay = 0; cfg.mVtoStreamBufferSize = 1024; cfg.mVtoPackDelay = 0;
+	SlaveTestObject t(cfg);
+	t.slave.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00");
+
+	IVtoWriter* pWriter = t.slave.GetVtoWriter();
+
+	uint8_t pData[3] = {0x13, 0x14, 0x15};
+	pWriter->Write(pData, 3, 0xAA);
+	pWriter->Write(pData, 3, 0xAA);
+	BOOST_REQUIRE_EQUAL(pWriter->NumBytesAvailable(), 1018);
+
+	BOOST_REQUIRE(t.mts.DispatchOne());
+
+	// both writes are cut from the ring as a single object
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00 71 06 17 01 AA 13 14 15 13 14 15");
+	BOOST_REQUIRE_EQUAL(t.Count(), 0);
+
+	// the confirmed bytes are returned to the writer
+	BOOST_REQUIRE_EQUAL(pWriter->NumBytesAvailable(), 1024);
+}
+
+BOOST_AUTO_TEST_CASE(VtoStreamWaitsForPackDelay)
+{
+	SlaveConfig cfg; cfg.mUnsolPackDelay = 0; cfg.mVtoStreamBufferSize = 1024; cfg.mVtoPackDelay = 50;
+	SlaveTestObject t(cfg);
+	t.slave.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00");
+
+	uint8_t pData[3] = {0x13, 0x14, 0x15};
+	t.slave.GetVtoWriter()->Write(pData, 3, 0xAA);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+
+	// a partial fragment waits for more data
+	BOOST_REQUIRE_EQUAL(t.Count(), 0);
+	BOOST_REQUIRE(t.mts.NextDurationTimer() == std::chrono::milliseconds(50));
+
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00 71 03 17 01 AA 13 14 15");
+}
+
+BOOST_AUTO_TEST_CASE(VtoStreamSendsFullFragmentsAtOnce)
+{
+	SlaveConfig cfg; cfg.mUnsolPackDelay = 0; cfg.mVtoStreamBufferSize = 1024; cfg.mVtoPackDelay = 50;
+	cfg.mMaxFragSize = 64;
+	SlaveTestObject t(cfg);
+	t.slave.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00");
+
+	uint8_t pData[3] = {0x13, 0x14, 0x15};
+	t.slave.GetVtoWriter()->Write(pData, 3, 0xAA);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Count(), 0);
+
+	// 55 bytes fill a 64 byte fragment, so the pack timer is cancelled
+	uint8_t pMore[52];
+	for(size_t i = 0; i < 52; ++i) pMore[i] = static_cast<uint8_t>(i);
+	t.slave.GetVtoWriter()->Write(pMore, 52, 0xAA);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+
+	t.Read();
+	BOOST_REQUIRE_EQUAL(t.mAPDU.Size(), 64);
+	BOOST_REQUIRE_EQUAL(t.mts.NumActive(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(EventsDoNotWaitForVtoStream)
+{
+	SlaveConfig cfg; cfg.mUnsolPackDelay = 0; cfg.mVtoStreamBufferSize = 1024; cfg.mVtoPackDelay = 50;
+	SlaveTestObject t(cfg);
+	t.db.Configure(DT_BINARY, 1);
+	t.db.SetClass(DT_BINARY, PC_CLASS_1);
+	t.slave.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00");
+
+	uint8_t pData[3] = {0x13, 0x14, 0x15};
+	t.slave.GetVtoWriter()->Write(pData, 3, 0xAA);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Count(), 0);
+
+	{
+		Transaction tr(t.slave.GetDataObserver());
+		t.slave.GetDataObserver()->Update(Binary(false, BQ_ONLINE), 0);
+	}
+	BOOST_REQUIRE(t.mts.DispatchOne());
+
+	// the event goes out immediately, ahead of the vto data in the same fragment
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00 02 01 17 01 00 01 71 03 17 01 AA 13 14 15");
+	BOOST_REQUIRE_EQUAL(t.mts.NumActive(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ReadVtoStreamMultiFrag)
+{
+	SlaveConfig cfg; cfg.mDisableUnsol = true; cfg.mVtoStreamBufferSize = 1024;
+	cfg.mMaxFragSize = 64;
+	SlaveTestObject t(cfg);
+	t.slave.OnLowerLayerUp();
+
+	IVtoWriter* pWriter = t.slave.GetVtoWriter();
+
+	uint8_t pData[100];
+	for(size_t i = 0; i < 100; ++i) pData[i] = static_cast<uint8_t>(i);
+	pWriter->Write(pData, 100, 0xAA);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+
+	t.SendToSlave("C0 01 3C 02 06"); // Read class 1
+
+	// the first fragment is filled completely and the rest follows in the second
+	t.Read();
+	BOOST_REQUIRE_EQUAL(t.mAPDU.Size(), 64);
+	BOOST_REQUIRE_FALSE(t.mAPDU.GetControl().FIN);
+	t.Read();
+	BOOST_REQUIRE_EQUAL(t.mAPDU.Size(), 4 + 5 + 45);
+	BOOST_REQUIRE(t.mAPDU.GetControl().FIN);
+	BOOST_REQUIRE_EQUAL(t.Count(), 0);
+}
+
 BOOST_AUTO_TEST_CASE(ReadClass0MultiFrag)
 {
 	SlaveConfig cfg; cfg.mDisableUnsol = true;
@@ -565,6 +683,126 @@ BOOST_AUTO_TEST_CASE(UnsolMultiFragments)
 	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00 02 01 17 01 00 01");
 }
 
+void ConfigureAdaptiveUnsol(SlaveConfig& arCfg)
+{
+	arCfg.mUnsolMask.class1 = true;
+	arCfg.mAdaptiveUnsolPack = true;
+	arCfg.mUnsolMaxPackDelay = 200;
+	arCfg.mEventMaxConfig.mMaxBinaryEvents = 2000;
+}
+
+void UpdateBinary(SlaveTestObject& arTest, size_t aNum = 1)
+{
+	static bool value = false;
+	Transaction tr(arTest.slave.GetDataObserver());
+	for(size_t i = 0; i < aNum; ++i) {
+		value = !value;
+		arTest.slave.GetDataObserver()->Update(Binary(value, BQ_ONLINE), 0);
+	}
+}
+
+// Sends an event every 10ms until the slave starts holding them back, confirming each unsol after aRoundTrip
+void RampUpEventRate(SlaveTestObject& arTest, std::chrono::milliseconds aRoundTrip)
+{
+	for(size_t i = 0; i < 50 && arTest.mts.NumActive() == 0; ++i) {
+		arTest.timeSource.Advance(std::chrono::milliseconds(10));
+		UpdateBinary(arTest);
+		BOOST_REQUIRE(arTest.mts.DispatchOne());
+
+		if(arTest.Count() > 0) {
+			arTest.Read();
+			arTest.timeSource.Advance(aRoundTrip);
+			arTest.slave.OnUnsolSendSuccess();
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(arTest.mts.NumActive(), 1);
+	BOOST_REQUIRE_EQUAL(arTest.Count(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveUnsolSendsImmediatelyWhenIdle)
+{
+	SlaveConfig cfg; ConfigureAdaptiveUnsol(cfg);
+	SlaveTestObject t(cfg);
+	t.db.Configure(DT_BINARY, 1);
+	t.db.SetClass(DT_BINARY, PC_CLASS_1);
+	t.slave.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00");
+
+	{
+		Transaction tr(t.slave.GetDataObserver());
+		t.slave.GetDataObserver()->Update(Binary(true, BQ_ONLINE), 0);
+	}
+	BOOST_REQUIRE(t.mts.DispatchOne());
+
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00 02 01 17 01 00 81");
+	BOOST_REQUIRE_EQUAL(t.mts.NumActive(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveUnsolPacksEventsUnderLoad)
+{
+	SlaveConfig cfg; ConfigureAdaptiveUnsol(cfg);
+	SlaveTestObject t(cfg);
+	t.db.Configure(DT_BINARY, 1);
+	t.db.SetClass(DT_BINARY, PC_CLASS_1);
+	t.app.DisableAutoSendCallback();
+	t.slave.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00");
+	t.slave.OnUnsolSendSuccess();
+
+	RampUpEventRate(t, std::chrono::milliseconds(0));
+	BOOST_REQUIRE(t.mts.NextDurationTimer() == std::chrono::milliseconds(200));
+
+	// events arriving while the timer runs join the same fragment
+	t.timeSource.Advance(std::chrono::milliseconds(10));
+	UpdateBinary(t, 2);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.Count(), 0);
+
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	t.Read();
+	BOOST_REQUIRE_EQUAL(t.mAPDU.Size(), 4 + 4 + 3 * 2);
+	BOOST_REQUIRE_EQUAL(t.Count(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveUnsolLeavesRoomForTheRoundTrip)
+{
+	SlaveConfig cfg; ConfigureAdaptiveUnsol(cfg);
+	SlaveTestObject t(cfg);
+	t.db.Configure(DT_BINARY, 1);
+	t.db.SetClass(DT_BINARY, PC_CLASS_1);
+	t.app.DisableAutoSendCallback();
+	t.slave.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00");
+	t.slave.OnUnsolSendSuccess();
+
+	// half of a 100ms round trip comes out of the 200ms ceiling
+	RampUpEventRate(t, std::chrono::milliseconds(100));
+	BOOST_REQUIRE(t.mts.NextDurationTimer() == std::chrono::milliseconds(150));
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveUnsolSendsOnceTheFragmentFills)
+{
+	SlaveConfig cfg; ConfigureAdaptiveUnsol(cfg);
+	SlaveTestObject t(cfg);
+	t.db.Configure(DT_BINARY, 1);
+	t.db.SetClass(DT_BINARY, PC_CLASS_1);
+	t.app.DisableAutoSendCallback();
+	t.slave.OnLowerLayerUp();
+	BOOST_REQUIRE_EQUAL(t.Read(), "F0 82 80 00");
+	t.slave.OnUnsolSendSuccess();
+
+	RampUpEventRate(t, std::chrono::milliseconds(0));
+
+	// a burst of events fills a fragment, so the pack timer is cancelled
+	UpdateBinary(t, 1100);
+	BOOST_REQUIRE(t.mts.DispatchOne());
+	BOOST_REQUIRE_EQUAL(t.mts.NumActive(), 0);
+
+	t.Read();
+	BOOST_REQUIRE(t.mAPDU.Size() > 2000);
+}
+
 // Test that non-read fragments are immediately responded to while waiting for a
 // response to unsolicited data
 BOOST_AUTO_TEST_CASE(WriteDuringUnsol)
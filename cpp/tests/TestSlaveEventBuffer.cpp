@@ -52,8 +52,11 @@ void OverflowTest(const T& first, const T& second)
 	BOOST_REQUIRE_FALSE(b.IsOverflow());
 	BOOST_REQUIRE(b.HasEventData());
 	BOOST_REQUIRE_EQUAL(b.NumType(Convert(T::MeasEnum)), 1);
+	BOOST_REQUIRE_EQUAL(b.NumDropped(), 0);
 	b.Update(second, PC_CLASS_1, 1);
 	BOOST_REQUIRE(b.IsOverflow());
+	BOOST_REQUIRE_EQUAL(b.NumDropped(), 1);
+	BOOST_REQUIRE_EQUAL(b.Size(), 1);
 }
 
 BOOST_AUTO_TEST_CASE(AnalogInsertion)
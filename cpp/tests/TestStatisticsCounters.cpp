@@ -0,0 +1,91 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/StatisticsCounters.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace opendnp3;
+
+BOOST_AUTO_TEST_SUITE(StatisticsCountersSuite)
+
+BOOST_AUTO_TEST_CASE(SnapshotMapsCounters)
+{
+	StackCounters c;
+	c.Increment(SC_LINK_RETRIES);
+	c.Increment(SC_TRANSPORT_DROPS, 2);
+	c.Increment(SC_APP_TIMEOUTS, 3);
+	c.Increment(SC_UNSOL_CONFIRMS, 4);
+	c.Set(SC_EVENT_OVERFLOWS, 5);
+	c.Set(SC_SEND_QUEUE_DEPTH, 6);
+	c.Set(SC_EVENT_BUFFER_DEPTH, 7);
+	c.Set(SC_SEND_QUEUE_DEPTH, 1);
+
+	StackStatistics s = c.Snapshot();
+	BOOST_REQUIRE_EQUAL(s.mNumLinkRetries, 1);
+	BOOST_REQUIRE_EQUAL(s.mNumTransportDrops, 2);
+	BOOST_REQUIRE_EQUAL(s.mNumAppTimeouts, 3);
+	BOOST_REQUIRE_EQUAL(s.mNumUnsolConfirms, 4);
+	BOOST_REQUIRE_EQUAL(s.mNumEventOverflows, 5);
+	BOOST_REQUIRE_EQUAL(s.mSendQueueDepth, 1);
+	BOOST_REQUIRE_EQUAL(s.mEventBufferDepth, 7);
+}
+
+// The writer always bumps the frames before the bytes, so any snapshot taken
+// between two writes has at most one more frame than bytes
+BOOST_AUTO_TEST_CASE(SnapshotsAreConsistentUnderConcurrentWrites)
+{
+	const uint64_t NUM_WRITES = 200000;
+
+	ChannelCounters c;
+	std::atomic<bool> done(false);
+
+	std::thread writer([&]() {
+		for(uint64_t i = 0; i < NUM_WRITES; ++i) {
+			c.Increment(CC_FRAMES_RX);
+			c.Increment(CC_BYTES_RX);
+		}
+		done = true;
+	});
+
+	uint64_t last = 0;
+	size_t reads = 0;
+	while(!done || reads == 0) {
+		ChannelStatistics s = c.Snapshot();
+		BOOST_REQUIRE(s.mNumFramesRx == s.mNumBytesRx || s.mNumFramesRx == s.mNumBytesRx + 1);
+		BOOST_REQUIRE(s.mNumFramesRx >= last);
+		last = s.mNumFramesRx;
+		++reads;
+	}
+
+	writer.join();
+
+	ChannelStatistics s = c.Snapshot();
+	BOOST_REQUIRE_EQUAL(s.mNumFramesRx, NUM_WRITES);
+	BOOST_REQUIRE_EQUAL(s.mNumBytesRx, NUM_WRITES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -27,19 +27,23 @@
 
 #include "TestHelpers.h"
 #include "BufferHelpers.h"
+#include "StopWatch.h"
 
 #include <opendnp3/ProtocolUtil.h>
 #include <opendnp3/Exception.h>
 
+#include <chrono>
 #include <functional>
 
 using namespace std;
+using namespace std::chrono;
 using namespace opendnp3;
 
-BOOST_AUTO_TEST_SUITE(AsyncTransportScalability)
+#define OUTPUT_PERF_NUMBERS (0)
 
+BOOST_AUTO_TEST_SUITE(AsyncTransportScalability)
 
-BOOST_AUTO_TEST_CASE(TestSimpleSend)
+void SendToAllPairs(TransportBackend aBackend)
 {
 	LinkConfig client(true, true);
 	LinkConfig server(false, true);
@@ -59,7 +63,7 @@ BOOST_AUTO_TEST_CASE(TestSimpleSend)
 	uint16_t NUM_PAIRS = 100;
 #endif
 
-	TransportScalabilityTestObject t(client, server, port, NUM_PAIRS);
+	TransportScalabilityTestObject t(client, server, port, NUM_PAIRS, LEV_INFO, false, aBackend);
 
 	t.Start();
 
@@ -67,13 +71,29 @@ BOOST_AUTO_TEST_CASE(TestSimpleSend)
 
 	ByteStr b(2048, 0);
 
+	StopWatch sw;
 	t.SendToAll(b, b.Size());
 
 	BOOST_REQUIRE(t.ProceedUntil(std::bind(&TransportScalabilityTestObject::AllLayerReceived, &t, b.Size()), 120000));
 	BOOST_REQUIRE(t.AllLayerEqual(b, b.Size()));
-}
 
+	if(OUTPUT_PERF_NUMBERS) {
+		double elapsed_sec = duration_cast<microseconds>(sw.Elapsed()).count() / 1e6;
+		size_t bytes = 2 * NUM_PAIRS * b.Size();
+		cout << (aBackend == TB_ASIO ? "asio" : "io_uring") << ": " << bytes << " bytes in " << elapsed_sec << " sec, " << bytes / elapsed_sec << " bytes/sec" << endl;
+	}
+}
 
+BOOST_AUTO_TEST_CASE(TestSimpleSend)
+{
+	SendToAllPairs(TB_ASIO);
+}
 
+#ifdef OPENDNP3_IO_URING
+BOOST_AUTO_TEST_CASE(TestSimpleSendIoUring)
+{
+	SendToAllPairs(TB_IO_URING);
+}
+#endif
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -23,7 +23,13 @@
 #include <boost/test/unit_test.hpp>
 
 #include <opendnp3/Types.h>
+#include <opendnp3/DataTypes.h>
+
+#include "TestHelpers.h"
+
 #include <limits>
+#include <string.h>
+#include <type_traits>
 
 using namespace std;
 using namespace opendnp3;
@@ -45,6 +51,14 @@ void TestType(T min, T max, size_t aBytes)
 	BOOST_CHECK_EQUAL(val, limit);
 }
 
+template <class T>
+void TestMeasurement(size_t aMaxBytes)
+{
+	BOOST_REQUIRE(std::is_trivially_copyable<T>::value);
+	BOOST_REQUIRE(std::is_standard_layout<T>::value);
+	BOOST_REQUIRE(sizeof(T) <= aMaxBytes);
+}
+
 BOOST_AUTO_TEST_SUITE(TestTypes)
 
 BOOST_AUTO_TEST_CASE( UByte )
@@ -87,4 +101,33 @@ BOOST_AUTO_TEST_CASE(Double)
 	BOOST_REQUIRE_EQUAL(8, sizeof(double));
 }
 
+// time, value and quality with nothing else
+BOOST_AUTO_TEST_CASE(MeasurementsArePlainValues)
+{
+	TestMeasurement<Binary>(16);
+	TestMeasurement<ControlStatus>(16);
+	TestMeasurement<Counter>(16);
+	TestMeasurement<Analog>(24);
+	TestMeasurement<SetpointStatus>(24);
+}
+
+BOOST_AUTO_TEST_CASE(BoolStateIsReportedInQuality)
+{
+	Binary b(true, BQ_ONLINE);
+	BOOST_REQUIRE_EQUAL(b.GetQuality(), BQ_ONLINE | BQ_STATE);
+	BOOST_REQUIRE(b.CheckQualityBit(BQ_STATE));
+
+	b.SetQualityValue(BQ_COMM_LOST);
+	BOOST_REQUIRE_FALSE(b.GetValue());
+	BOOST_REQUIRE_EQUAL(b.GetQuality(), BQ_COMM_LOST);
+
+	b.SetQuality(BQ_ONLINE | BQ_STATE);
+	BOOST_REQUIRE(b.GetValue());
+
+	Binary copy;
+	memcpy(&copy, &b, sizeof(b));
+	BOOST_REQUIRE(copy == b);
+	BOOST_REQUIRE_EQUAL(copy.GetType(), DT_BINARY);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/UnsolPackController.h>
+
+using namespace opendnp3;
+using namespace std::chrono;
+
+BOOST_AUTO_TEST_SUITE(UnsolPackControllerSuite)
+
+// one event every aPeriod, ending at the returned time
+timer_clock::time_point Arrive(UnsolPackController& arController, timer_clock::time_point aStart, size_t aNum, milliseconds aPeriod)
+{
+	timer_clock::time_point t = aStart;
+	for(size_t i = 0; i < aNum; ++i) {
+		arController.OnEvents(1, t);
+		t += aPeriod;
+	}
+	return t - aPeriod;
+}
+
+BOOST_AUTO_TEST_CASE(IdleSendsImmediately)
+{
+	UnsolPackController controller(2048, 200);
+	timer_clock::time_point t0 = timer_clock::now();
+	BOOST_REQUIRE_EQUAL(controller.PackDelay(1, t0), 0);
+
+	// a single event doesn't make another one likely within the ceiling
+	controller.OnEvents(1, t0);
+	BOOST_REQUIRE_EQUAL(controller.PackDelay(1, t0), 0);
+	BOOST_REQUIRE_EQUAL(controller.LastDelay(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SustainedRateWaitsUpToTheCeiling)
+{
+	UnsolPackController controller(2048, 200);
+	timer_clock::time_point t = Arrive(controller, timer_clock::now(), 100, milliseconds(10));
+
+	double rate = controller.EventsPerSecond(t);
+	BOOST_REQUIRE(rate > 60 && rate < 66);
+	BOOST_REQUIRE_EQUAL(controller.PackDelay(1, t), 200);
+	BOOST_REQUIRE_EQUAL(controller.LastDelay(), 200);
+}
+
+BOOST_AUTO_TEST_CASE(WaitsOnlyForTheRestOfTheFragment)
+{
+	// 2044 bytes of objects at 8 bytes per event is room for 255.5 events
+	UnsolPackController controller(2048, 1000);
+	timer_clock::time_point t0 = timer_clock::now();
+	controller.OnEvents(1000, t0);
+
+	BOOST_REQUIRE_EQUAL(controller.PackDelay(100, t0), 156);
+	BOOST_REQUIRE_EQUAL(controller.PackDelay(254, t0), 2);
+	BOOST_REQUIRE_EQUAL(controller.PackDelay(255, t0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(RateDecays)
+{
+	UnsolPackController controller(2048, 200);
+	timer_clock::time_point t0 = timer_clock::now();
+	Arrive(controller, t0, 100, milliseconds(10));
+
+	BOOST_REQUIRE_EQUAL(controller.PackDelay(1, t0 + seconds(1)), 200);
+	BOOST_REQUIRE_EQUAL(controller.PackDelay(1, t0 + seconds(10)), 0);
+}
+
+BOOST_AUTO_TEST_CASE(RoundTripShortensTheBudget)
+{
+	UnsolPackController controller(2048, 200);
+	timer_clock::time_point t0 = timer_clock::now();
+	controller.OnSent(100, 12, t0);
+	controller.OnConfirmed(t0 + milliseconds(100));
+	BOOST_REQUIRE_EQUAL(controller.RoundTripMicros(), 100000);
+
+	controller.OnEvents(100, t0);
+	BOOST_REQUIRE_EQUAL(controller.PackDelay(1, t0), 150);
+}
+
+BOOST_AUTO_TEST_CASE(FailureDoesNotMeasureTheRoundTrip)
+{
+	UnsolPackController controller(2048, 200);
+	timer_clock::time_point t0 = timer_clock::now();
+	controller.OnSent(100, 12, t0);
+	controller.OnFailure();
+	controller.OnConfirmed(t0 + milliseconds(100));
+	BOOST_REQUIRE_EQUAL(controller.RoundTripMicros(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(LearnsTheEventSize)
+{
+	UnsolPackController controller(2048, 1000);
+	timer_clock::time_point t0 = timer_clock::now();
+
+	// 20 bytes per event moves the average from 8 to 9.5, room for 215 events
+	controller.OnSent(4 + 10 * 20, 10, t0);
+	controller.OnEvents(1000, t0);
+	BOOST_REQUIRE_EQUAL(controller.PackDelay(15, t0), 201);
+}
+
+BOOST_AUTO_TEST_CASE(SmoothsTheFillRatio)
+{
+	UnsolPackController controller(2048, 200);
+	BOOST_REQUIRE_EQUAL(controller.FillPercent(), 0);
+
+	timer_clock::time_point t0 = timer_clock::now();
+	controller.OnSent(1024, 10, t0);
+	BOOST_REQUIRE_EQUAL(controller.FillPercent(), 50);
+	controller.OnSent(2048, 10, t0);
+	BOOST_REQUIRE_EQUAL(controller.FillPercent(), 56);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,186 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/Log.h>
+
+#include "TestHelpers.h"
+
+#ifdef OPENDNP3_IO_URING
+#include <opendnp3/UringService.h>
+
+#include <chrono>
+#include <climits>
+#include <thread>
+#include <vector>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace opendnp3;
+
+BOOST_AUTO_TEST_SUITE(UringServiceSuite)
+#ifdef OPENDNP3_IO_URING
+
+// Behaves like a kernel that answers EAGAIN while mRefuse is set
+class RefusingUringService : public UringService
+{
+public:
+	RefusingUringService(Logger* apLogger, boost::asio::io_service* apService, size_t aNumBuffers) :
+		UringService(apLogger, apService, 2, aNumBuffers),
+		mRefuse(true),
+		mNumRefused(0)
+	{}
+
+	bool mRefuse;
+	size_t mNumRefused;
+
+protected:
+	int Enter(unsigned aNumEntries) {
+		if(!mRefuse) return UringService::Enter(aNumEntries);
+		++mNumRefused;
+		return -EAGAIN;
+	}
+};
+
+class UringTestObject
+{
+public:
+	UringTestObject(size_t aNumOps, size_t aNumBuffers = 0) :
+		uring(log.GetLogger(LEV_INFO, "io_uring"), &service, aNumBuffers),
+		results(aNumOps, INT_MIN),
+		buffers(aNumOps)
+	{
+		ops.reserve(aNumOps);
+		for(size_t i = 0; i < aNumOps; ++i) {
+			int fds[2];
+			BOOST_REQUIRE_EQUAL(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+			readers.push_back(fds[0]);
+			writers.push_back(fds[1]);
+			ops.push_back(UringOperation([this, i](int aResult) {
+				results[i] = aResult;
+			}));
+		}
+	}
+
+	~UringTestObject() {
+		uring.Shutdown();
+		service.poll();
+		for(int fd: readers) close(fd);
+		for(int fd: writers) close(fd);
+	}
+
+	bool Complete() {
+		for(int result: results) if(result == INT_MIN) return false;
+		return true;
+	}
+
+	bool RunUntilComplete() {
+		auto expiration = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while(!this->Complete() && std::chrono::steady_clock::now() < expiration) {
+			if(service.poll() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return this->Complete();
+	}
+
+	EventLog log;
+	boost::asio::io_service service;
+	RefusingUringService uring;
+	std::vector<int> readers;
+	std::vector<int> writers;
+	std::vector<UringOperation> ops;
+	std::vector<int> results;
+	std::vector<uint8_t> buffers;
+};
+
+BOOST_AUTO_TEST_CASE(FullRingKeepsEveryEntry)
+{
+	const size_t NUM_OPS = 16; // the ring only has room for two entries
+	UringTestObject t(NUM_OPS);
+
+	for(size_t i = 0; i < NUM_OPS; ++i) t.uring.Receive(t.readers[i], &t.buffers[i], 1, &t.ops[i]);
+	t.service.poll();
+	BOOST_REQUIRE(t.uring.mNumRefused > 0);
+	BOOST_REQUIRE_FALSE(t.Complete());
+
+	for(size_t i = 0; i < NUM_OPS; ++i) {
+		uint8_t value = static_cast<uint8_t>(i);
+		BOOST_REQUIRE_EQUAL(write(t.writers[i], &value, 1), 1);
+	}
+
+	t.uring.mRefuse = false;
+	t.uring.Flush();
+	BOOST_REQUIRE(t.RunUntilComplete());
+
+	for(size_t i = 0; i < NUM_OPS; ++i) {
+		BOOST_REQUIRE_EQUAL(t.results[i], 1);
+		BOOST_REQUIRE_EQUAL(t.buffers[i], i);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(CancelCompletesWaitingEntry)
+{
+	UringTestObject t(3);
+
+	for(size_t i = 0; i < 3; ++i) t.uring.Receive(t.readers[i], &t.buffers[i], 1, &t.ops[i]);
+	t.uring.Cancel(&t.ops[2]);
+	t.service.poll();
+	BOOST_REQUIRE_EQUAL(t.results[2], -ECANCELED);
+
+	// the other two reached the ring and still complete normally
+	uint8_t value = 0;
+	BOOST_REQUIRE_EQUAL(write(t.writers[0], &value, 1), 1);
+	BOOST_REQUIRE_EQUAL(write(t.writers[1], &value, 1), 1);
+	t.uring.mRefuse = false;
+	t.uring.Flush();
+	BOOST_REQUIRE(t.RunUntilComplete());
+	BOOST_REQUIRE_EQUAL(t.results[0], 1);
+	BOOST_REQUIRE_EQUAL(t.results[1], 1);
+}
+
+BOOST_AUTO_TEST_CASE(FixedReadLandsInCallerBuffer)
+{
+	UringTestObject t(1, 1);
+	t.uring.mRefuse = false;
+
+	size_t index = t.uring.AcquireBuffer();
+	BOOST_REQUIRE(index != UringService::NO_BUFFER);
+	uint8_t area[8] = {0};
+	BOOST_REQUIRE(t.uring.RegisterBuffer(index, area, sizeof(area)));
+
+	t.uring.ReadFixed(t.readers[0], index, area + 2, 6, &t.ops[0]);
+	BOOST_REQUIRE_EQUAL(write(t.writers[0], "abc", 3), 3);
+	BOOST_REQUIRE(t.RunUntilComplete());
+	BOOST_REQUIRE_EQUAL(t.results[0], 3);
+	BOOST_REQUIRE_EQUAL(memcmp(area + 2, "abc", 3), 0);
+
+	t.uring.ReleaseBuffer(index);
+}
+
+#endif
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
@@ -0,0 +1,248 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include "TestHelpers.h"
+#include "RandomizedBuffer.h"
+
+#include <opendnp3/APDU.h>
+#include <opendnp3/EnhancedVto.h>
+#include <opendnp3/Log.h>
+#include <opendnp3/Objects.h>
+#include <opendnp3/ToHex.h>
+#include <opendnp3/VtoStreamWriter.h>
+
+using namespace std;
+using namespace opendnp3;
+
+class CreditCounter : public IVtoBufferHandler
+{
+public:
+	CreditCounter() : mNumCalls(0) {}
+
+	void OnBufferAvailable() {
+		++mNumCalls;
+	}
+
+	size_t mNumCalls;
+};
+
+// Loads a response fragment and returns the object headers and data that were written
+std::string Load(VtoStreamWriter& arWriter, APDU& arAPDU)
+{
+	arAPDU.Set(FC_RESPONSE);
+	arWriter.Load(arAPDU, Group113Var0::Inst());
+	return toHex(arAPDU.GetBuffer() + 4, arAPDU.Size() - 4, true);
+}
+
+std::string StateChange(bool aOpened, uint8_t aChannelId)
+{
+	VtoData vto = EnhancedVto::CreateVtoData(aOpened, aChannelId);
+	uint8_t size = static_cast<uint8_t>(vto.GetSize());
+	return "71 " + toHex(&size, 1) + " 17 01 FF " + toHex(vto.mpData, vto.GetSize(), true);
+}
+
+BOOST_AUTO_TEST_SUITE(VtoStreamWriterSuite)
+
+BOOST_AUTO_TEST_CASE(WritesAreLimitedByTheChannelRing)
+{
+	EventLog log;
+	VtoStreamWriter writer(log.GetLogger(LEV_WARNING, "writer"), 10);
+	RandomizedBuffer data(15);
+
+	BOOST_REQUIRE_EQUAL(writer.NumBytesAvailable(), 10);
+	BOOST_REQUIRE_EQUAL(writer.Write(data, data.Size(), 1), 10);
+	BOOST_REQUIRE_EQUAL(writer.Write(data, data.Size(), 1), 0);
+	BOOST_REQUIRE_EQUAL(writer.NumBytesAvailable(), 0);
+
+	// each channel has its own ring
+	BOOST_REQUIRE_EQUAL(writer.Write(data, data.Size(), 2), 10);
+}
+
+BOOST_AUTO_TEST_CASE(LoadsOnlyTheSelectedData)
+{
+	EventLog log;
+	VtoStreamWriter writer(log.GetLogger(LEV_WARNING, "writer"), 100);
+	uint8_t data[3] = {0x13, 0x14, 0x15};
+
+	BOOST_REQUIRE_FALSE(writer.HasData());
+	writer.Write(data, 3, 0xAA);
+	BOOST_REQUIRE(writer.HasData());
+	BOOST_REQUIRE_EQUAL(writer.Select(), 3);
+	writer.Write(data, 3, 0xAA);
+
+	APDU apdu;
+	BOOST_REQUIRE_EQUAL(Load(writer, apdu), "71 03 17 01 AA 13 14 15");
+	BOOST_REQUIRE_EQUAL(writer.NumSelected(), 0);
+	BOOST_REQUIRE(writer.HasData());
+}
+
+BOOST_AUTO_TEST_CASE(CutsObjectsOfTheMaximumSize)
+{
+	EventLog log;
+	VtoStreamWriter writer(log.GetLogger(LEV_WARNING, "writer"), 1024);
+	RandomizedBuffer data(600);
+
+	writer.Write(data, data.Size(), 1);
+	writer.Select();
+
+	APDU apdu;
+	apdu.Set(FC_RESPONSE);
+	BOOST_REQUIRE_EQUAL(writer.Load(apdu, Group113Var0::Inst()), 3);
+	BOOST_REQUIRE_EQUAL(apdu.Size(), 4 + 3 * 5 + 600);
+}
+
+BOOST_AUTO_TEST_CASE(FillsEachFragment)
+{
+	EventLog log;
+	VtoStreamWriter writer(log.GetLogger(LEV_WARNING, "writer"), 1024);
+	RandomizedBuffer data(100);
+
+	writer.Write(data, data.Size(), 1);
+	writer.Select();
+
+	APDU apdu(64);
+	Load(writer, apdu);
+	BOOST_REQUIRE_EQUAL(apdu.Size(), 64);
+	BOOST_REQUIRE_EQUAL(writer.NumSelected(), 100 - (64 - 4 - 5));
+
+	Load(writer, apdu);
+	BOOST_REQUIRE_EQUAL(apdu.Size(), 4 + 5 + 45);
+	BOOST_REQUIRE_EQUAL(writer.NumSelected(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ConfirmReturnsCreditToTheWriter)
+{
+	EventLog log;
+	VtoStreamWriter writer(log.GetLogger(LEV_WARNING, "writer"), 10);
+	CreditCounter credit;
+	writer.AddVtoCallback(&credit);
+	RandomizedBuffer data(10);
+
+	writer.Write(data, data.Size(), 1);
+	writer.Select();
+	APDU apdu;
+	Load(writer, apdu);
+
+	// loaded but unconfirmed data still occupies the ring
+	BOOST_REQUIRE_EQUAL(writer.NumBytesAvailable(), 0);
+	BOOST_REQUIRE_EQUAL(credit.mNumCalls, 0);
+
+	BOOST_REQUIRE_EQUAL(writer.ClearWritten(), 10);
+	BOOST_REQUIRE_EQUAL(credit.mNumCalls, 1);
+	BOOST_REQUIRE_EQUAL(writer.NumBytesAvailable(), 10);
+	BOOST_REQUIRE_FALSE(writer.HasData());
+}
+
+BOOST_AUTO_TEST_CASE(DeselectResendsUnconfirmedData)
+{
+	EventLog log;
+	VtoStreamWriter writer(log.GetLogger(LEV_WARNING, "writer"), 100);
+	uint8_t data[3] = {0x13, 0x14, 0x15};
+
+	writer.Write(data, 3, 0xAA);
+	writer.Select();
+	APDU apdu;
+	Load(writer, apdu);
+	writer.Deselect();
+
+	BOOST_REQUIRE(writer.HasData());
+	BOOST_REQUIRE_EQUAL(writer.Select(), 3);
+	BOOST_REQUIRE_EQUAL(Load(writer, apdu), "71 03 17 01 AA 13 14 15");
+}
+
+BOOST_AUTO_TEST_CASE(DataWrapsAroundTheRing)
+{
+	EventLog log;
+	VtoStreamWriter writer(log.GetLogger(LEV_WARNING, "writer"), 8);
+	uint8_t first[6] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05};
+	uint8_t second[6] = {0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B};
+
+	writer.Write(first, 6, 1);
+	writer.Select();
+	APDU apdu;
+	Load(writer, apdu);
+	writer.ClearWritten();
+	writer.Deselect();
+
+	BOOST_REQUIRE_EQUAL(writer.Write(second, 6, 1), 6);
+	writer.Select();
+	BOOST_REQUIRE_EQUAL(Load(writer, apdu), "71 06 17 01 01 06 07 08 09 0A 0B");
+}
+
+BOOST_AUTO_TEST_CASE(StateChangesKeepTheirPlaceInTheStream)
+{
+	EventLog log;
+	VtoStreamWriter writer(log.GetLogger(LEV_WARNING, "writer"), 100);
+	uint8_t data[3] = {0x13, 0x14, 0x15};
+
+	writer.Write(data, 3, 0xAA);
+	writer.SetLocalVtoState(false, 0xAA);
+	writer.Write(data, 2, 0xAA);
+	BOOST_REQUIRE_EQUAL(writer.Select(), 6);
+
+	APDU apdu;
+	BOOST_REQUIRE_EQUAL(Load(writer, apdu), "71 03 17 01 AA 13 14 15 " + StateChange(false, 0xAA) + " 71 02 17 01 AA 13 14");
+
+	// a confirmed state change is not sent again
+	writer.ClearWritten();
+	writer.Deselect();
+	BOOST_REQUIRE_FALSE(writer.HasData());
+}
+
+BOOST_AUTO_TEST_CASE(WindowLimitsUnconfirmedData)
+{
+	EventLog log;
+	VtoStreamWriter writer(log.GetLogger(LEV_WARNING, "writer"), 100);
+	RandomizedBuffer data(60);
+
+	writer.SetWindow(50);
+	BOOST_REQUIRE_EQUAL(writer.NumBytesAvailable(), 50);
+	BOOST_REQUIRE_EQUAL(writer.Write(data, data.Size(), 1), 50);
+
+	// shrinking the window below what is already written stops the writer
+	writer.SetWindow(20);
+	BOOST_REQUIRE_EQUAL(writer.NumBytesAvailable(), 0);
+	BOOST_REQUIRE_EQUAL(writer.Write(data, data.Size(), 1), 0);
+
+	writer.Select();
+	APDU apdu;
+	Load(writer, apdu);
+	BOOST_REQUIRE_EQUAL(writer.NumBytesLoaded(), 50);
+	BOOST_REQUIRE_EQUAL(writer.ClearWritten(), 50);
+	BOOST_REQUIRE_EQUAL(writer.NumBytesAvailable(), 20);
+
+	// the window never exceeds the ring
+	writer.SetWindow(1000);
+	BOOST_REQUIRE_EQUAL(writer.NumBytesAvailable(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(FragmentCapacity)
+{
+	BOOST_REQUIRE_EQUAL(VtoStreamWriter::FragmentCapacity(4), 0);
+	BOOST_REQUIRE_EQUAL(VtoStreamWriter::FragmentCapacity(64), 55);
+	BOOST_REQUIRE_EQUAL(VtoStreamWriter::FragmentCapacity(2048), 7 * 255 + 219);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
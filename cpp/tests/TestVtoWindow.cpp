@@ -0,0 +1,111 @@
+
+//
+// Licensed to Green Energy Corp (www.greenenergycorp.com) under one or
+// more contributor license agreements. See the NOTICE file distributed
+// with this work for additional information regarding copyright ownership.
+// Green Energy Corp licenses this file to you under the Apache License,
+// Version 2.0 (the "License"); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file was forked on 01/01/2013 by Automatak, LLC and modifications
+// have been made to this file. Automatak, LLC licenses these modifications to
+// you under the terms of the License.
+//
+#include <boost/test/unit_test.hpp>
+
+#include <opendnp3/VtoWindow.h>
+
+using namespace opendnp3;
+using namespace std::chrono;
+
+BOOST_AUTO_TEST_SUITE(VtoWindowSuite)
+
+void RoundTrip(VtoWindow& arWindow, timer_clock::time_point aSent, milliseconds aRoundTrip, size_t aNumBytes = 100)
+{
+	arWindow.OnSent(aSent);
+	arWindow.OnConfirmed(aNumBytes, aSent + aRoundTrip);
+}
+
+BOOST_AUTO_TEST_CASE(StartsAtTheBufferSize)
+{
+	VtoWindow window(100, 10000, 1000);
+	BOOST_REQUIRE_EQUAL(window.NumBytes(), 10000);
+	BOOST_REQUIRE_EQUAL(window.RoundTripMicros(), 0);
+	BOOST_REQUIRE_EQUAL(window.BytesPerSecond(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(DrainsWithinTheTargetDelay)
+{
+	VtoWindow window(100, 10000, 1000);
+	RoundTrip(window, timer_clock::now(), milliseconds(100));
+
+	BOOST_REQUIRE_EQUAL(window.RoundTripMicros(), 100000);
+	BOOST_REQUIRE_EQUAL(window.NumBytes(), 10 * 100);
+}
+
+BOOST_AUTO_TEST_CASE(SmoothsTheRoundTrip)
+{
+	VtoWindow window(100, 10000, 1000);
+	timer_clock::time_point t0 = timer_clock::now();
+	RoundTrip(window, t0, milliseconds(100));
+	RoundTrip(window, t0, milliseconds(200));
+
+	BOOST_REQUIRE_EQUAL(window.RoundTripMicros(), 112500);
+	BOOST_REQUIRE_EQUAL(window.NumBytes(), 9 * 100);
+}
+
+BOOST_AUTO_TEST_CASE(NeverSmallerThanTwoFragments)
+{
+	VtoWindow slow(100, 10000, 1000);
+	RoundTrip(slow, timer_clock::now(), milliseconds(2000));
+	BOOST_REQUIRE_EQUAL(slow.NumBytes(), 2 * 100);
+
+	VtoWindow noTarget(100, 10000, 0);
+	RoundTrip(noTarget, timer_clock::now(), milliseconds(1));
+	BOOST_REQUIRE_EQUAL(noTarget.NumBytes(), 2 * 100);
+}
+
+BOOST_AUTO_TEST_CASE(NeverLargerThanTheBuffer)
+{
+	VtoWindow window(100, 1000, 1000);
+	RoundTrip(window, timer_clock::now(), milliseconds(1));
+	BOOST_REQUIRE_EQUAL(window.NumBytes(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(FailuresAreNotSampled)
+{
+	VtoWindow window(100, 10000, 1000);
+	timer_clock::time_point t0 = timer_clock::now();
+
+	window.OnConfirmed(100, t0); // nothing was sent
+	window.OnSent(t0);
+	window.OnFailure();
+	window.OnConfirmed(100, t0 + milliseconds(5000));
+
+	BOOST_REQUIRE_EQUAL(window.RoundTripMicros(), 0);
+	BOOST_REQUIRE_EQUAL(window.NumBytes(), 10000);
+}
+
+BOOST_AUTO_TEST_CASE(ThroughputIsMeasuredOverAnInterval)
+{
+	VtoWindow window(100, 10000, 1000);
+	timer_clock::time_point t0 = timer_clock::now();
+
+	RoundTrip(window, t0, milliseconds(500), 600);
+	BOOST_REQUIRE_EQUAL(window.BytesPerSecond(), 0);
+
+	RoundTrip(window, t0 + milliseconds(500), milliseconds(500), 400);
+	BOOST_REQUIRE_EQUAL(window.BytesPerSecond(), 1000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+/* vim: set ts=4 sw=4: */
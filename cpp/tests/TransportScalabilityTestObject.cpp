@@ -25,6 +25,12 @@
 
 #include <boost/asio.hpp>
 
+#include <opendnp3/Exception.h>
+
+#ifdef OPENDNP3_IO_URING
+#include <opendnp3/UringService.h>
+#endif
+
 using namespace std;
 
 namespace opendnp3
@@ -36,12 +42,21 @@ TransportScalabilityTestObject::TransportScalabilityTestObject(
         boost::uint16_t aPortStart,
         boost::uint16_t aNumPair,
         FilterLevel aLevel,
-        bool aImmediate) :
+        bool aImmediate,
+        TransportBackend aBackend) :
 
 	LogTester(aImmediate),
 	AsyncTestObjectASIO(),
 	mpLogger(mLog.GetLogger(aLevel, "test"))
 {
+	if(aBackend == TB_IO_URING) {
+#ifdef OPENDNP3_IO_URING
+		mpUring.reset(new UringService(mpLogger->GetSubLogger("io_uring"), this->GetService()));
+#else
+		MACRO_THROW_EXCEPTION(ArgumentException, "io_uring support is not compiled in");
+#endif
+	}
+
 	const boost::uint16_t START = aPortStart;
 	const boost::uint16_t STOP = START + aNumPair;
 
@@ -49,7 +64,7 @@ TransportScalabilityTestObject::TransportScalabilityTestObject(
 		ostringstream oss;
 		oss << "pair" << port;
 		Logger* pLogger = mpLogger->GetSubLogger(oss.str());
-		TransportStackPair* pPair = new TransportStackPair(aClientCfg, aServerCfg, pLogger, this->GetService(), port);
+		TransportStackPair* pPair = new TransportStackPair(aClientCfg, aServerCfg, pLogger, this->GetService(), port, mpUring.get());
 		mPairs.push_back(pPair);
 	}
 }
@@ -60,6 +75,9 @@ for(auto pPair: mPairs) {
 		pPair->mClientStack.mRouter.Shutdown();
 		pPair->mServerStack.mRouter.Shutdown();
 	}
+#ifdef OPENDNP3_IO_URING
+	if(mpUring) mpUring->Shutdown();
+#endif
 	this->GetService()->run();
 for(auto pPair: mPairs) delete pPair;
 }
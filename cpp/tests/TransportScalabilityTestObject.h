@@ -28,6 +28,9 @@
 #include "LogTester.h"
 
 #include <opendnp3/ASIOExecutor.h>
+#include <opendnp3/TransportBackend.h>
+
+#include <memory>
 
 namespace opendnp3
 {
@@ -42,7 +45,8 @@ public:
 	        boost::uint16_t aPortStart,
 	        boost::uint16_t aNumPair,
 	        FilterLevel aLevel = LEV_INFO,
-	        bool aImmediate = false);
+	        bool aImmediate = false,
+	        TransportBackend aBackend = TB_ASIO);
 
 	~TransportScalabilityTestObject();
 
@@ -58,6 +62,7 @@ public:
 
 public:
 	Logger* mpLogger;
+	std::shared_ptr<UringService> mpUring;
 	std::vector<TransportStackPair*> mPairs;
 };
 
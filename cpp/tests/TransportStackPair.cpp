@@ -26,20 +26,42 @@
 
 #include <opendnp3/Logger.h>
 
+#ifdef OPENDNP3_IO_URING
+#include <opendnp3/PhysicalLayerAsyncUringTCPClient.h>
+#include <opendnp3/PhysicalLayerAsyncUringTCPServer.h>
+#endif
+
 namespace opendnp3
 {
 
+PhysicalLayerAsyncBase* CreateClient(Logger* apLogger, boost::asio::io_service* apService, boost::uint16_t aPort, UringService* apUring)
+{
+#ifdef OPENDNP3_IO_URING
+	if(apUring != NULL) return new PhysicalLayerAsyncUringTCPClient(apLogger, apService, apUring, "127.0.0.1", aPort);
+#endif
+	return new PhysicalLayerAsyncTCPClient(apLogger, apService, "127.0.0.1", aPort);
+}
+
+PhysicalLayerAsyncBase* CreateServer(Logger* apLogger, boost::asio::io_service* apService, boost::uint16_t aPort, UringService* apUring)
+{
+#ifdef OPENDNP3_IO_URING
+	if(apUring != NULL) return new PhysicalLayerAsyncUringTCPServer(apLogger, apService, apUring, "127.0.0.1", aPort);
+#endif
+	return new PhysicalLayerAsyncTCPServer(apLogger, apService, "127.0.0.1", aPort);
+}
+
 TransportStackPair::TransportStackPair(
         LinkConfig aClientCfg,
         LinkConfig aServerCfg,
         Logger* apLogger,
         boost::asio::io_service* apService,
-        boost::uint16_t aPort) :
+        boost::uint16_t aPort,
+        UringService* apUring) :
 
-	mClient(apLogger->GetSubLogger("TCPClient"), apService, "127.0.0.1", aPort),
-	mServer(apLogger->GetSubLogger("TCPServer"), apService, "127.0.0.1", aPort),
-	mClientStack(apLogger->GetSubLogger("ClientStack"), &mClient, aClientCfg),
-	mServerStack(apLogger->GetSubLogger("ServerStack"), &mServer, aServerCfg)
+	mpClient(CreateClient(apLogger->GetSubLogger("TCPClient"), apService, aPort, apUring)),
+	mpServer(CreateServer(apLogger->GetSubLogger("TCPServer"), apService, aPort, apUring)),
+	mClientStack(apLogger->GetSubLogger("ClientStack"), mpClient.get(), aClientCfg),
+	mServerStack(apLogger->GetSubLogger("ServerStack"), mpServer.get(), aServerCfg)
 {
 
 }
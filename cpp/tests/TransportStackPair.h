@@ -36,11 +36,15 @@ class io_service;
 #include <opendnp3/PhysicalLayerAsyncTCPServer.h>
 #include <opendnp3/IExecutor.h>
 
+#include <memory>
+
 #include "TransportIntegrationStack.h"
 
 namespace opendnp3
 {
 
+class UringService;
+
 class TransportStackPair
 {
 public:
@@ -49,7 +53,8 @@ public:
 	        LinkConfig aServerCfg,
 	        Logger* apLogger,
 	        boost::asio::io_service* apService,
-	        boost::uint16_t aPort);
+	        boost::uint16_t aPort,
+	        UringService* apUring = NULL);
 
 	void Start();
 
@@ -57,8 +62,9 @@ public:
 	bool BothLayersUp();
 
 public:
-	PhysicalLayerAsyncTCPClient mClient;
-	PhysicalLayerAsyncTCPServer mServer;
+	// asio layers unless a ring is supplied
+	std::auto_ptr<PhysicalLayerAsyncBase> mpClient;
+	std::auto_ptr<PhysicalLayerAsyncBase> mpServer;
 
 	TransportIntegrationStack mClientStack;
 	TransportIntegrationStack mServerStack;
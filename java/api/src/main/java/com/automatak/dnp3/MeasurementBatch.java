@@ -0,0 +1,161 @@
+/**
+ * Copyright 2013 Automatak, LLC
+ *
+ * Licensed to Automatak, LLC (www.automatak.com) under one or more
+ * contributor license agreements. See the NOTICE file distributed with this
+ * work for additional information regarding copyright ownership. Automatak, LLC
+ * licenses this file to you under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+package com.automatak.dnp3;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * A reusable batch of outstation measurements that can be published with a single native call.
+ *
+ * Measurements are packed into a direct buffer in native byte order so that the bindings can decode
+ * the whole batch without calling back into the JVM. Use Outstation.publish(...) to apply the batch
+ * as one transaction, then clear() the batch and reuse it for the next scan.
+ */
+public final class MeasurementBatch {
+
+    /**
+     * Size in bytes of each packed record: value (8), time (8), index (4), type (1), quality (1), padding (2)
+     */
+    public static final int RECORD_SIZE = 24;
+
+    static final byte BINARY_INPUT = 0;
+    static final byte ANALOG_INPUT = 1;
+    static final byte COUNTER = 2;
+    static final byte BINARY_OUTPUT_STATUS = 3;
+    static final byte ANALOG_OUTPUT_STATUS = 4;
+
+    private static final long MAX_INDEX = 0xFFFFFFFFL;
+
+    private ByteBuffer buffer;
+    private int count = 0;
+
+    /**
+     * @param capacity number of measurements the batch can hold before it needs to grow
+     */
+    public MeasurementBatch(int capacity)
+    {
+        if(capacity < 1) throw new IllegalArgumentException("Capacity must be greater than zero: " + capacity);
+        this.buffer = allocate(capacity);
+    }
+
+    public void add(BinaryInput meas, long index)
+    {
+        addBinaryInput(meas.getValue(), meas.getQuality(), meas.getMsSinceEpoch(), index);
+    }
+
+    public void add(AnalogInput meas, long index)
+    {
+        addAnalogInput(meas.getValue(), meas.getQuality(), meas.getMsSinceEpoch(), index);
+    }
+
+    public void add(Counter meas, long index)
+    {
+        addCounter(meas.getValue(), meas.getQuality(), meas.getMsSinceEpoch(), index);
+    }
+
+    public void add(BinaryOutputStatus meas, long index)
+    {
+        addBinaryOutputStatus(meas.getValue(), meas.getQuality(), meas.getMsSinceEpoch(), index);
+    }
+
+    public void add(AnalogOutputStatus meas, long index)
+    {
+        addAnalogOutputStatus(meas.getValue(), meas.getQuality(), meas.getMsSinceEpoch(), index);
+    }
+
+    public void addBinaryInput(boolean value, byte quality, long time, long index)
+    {
+        put(BINARY_INPUT, value ? 1 : 0, quality, time, index);
+    }
+
+    public void addAnalogInput(double value, byte quality, long time, long index)
+    {
+        put(ANALOG_INPUT, Double.doubleToRawLongBits(value), quality, time, index);
+    }
+
+    public void addCounter(long value, byte quality, long time, long index)
+    {
+        put(COUNTER, value, quality, time, index);
+    }
+
+    public void addBinaryOutputStatus(boolean value, byte quality, long time, long index)
+    {
+        put(BINARY_OUTPUT_STATUS, value ? 1 : 0, quality, time, index);
+    }
+
+    public void addAnalogOutputStatus(double value, byte quality, long time, long index)
+    {
+        put(ANALOG_OUTPUT_STATUS, Double.doubleToRawLongBits(value), quality, time, index);
+    }
+
+    /**
+     * @return number of measurements in the batch
+     */
+    public int size()
+    {
+        return count;
+    }
+
+    /**
+     * Remove all measurements while keeping the allocated buffer
+     */
+    public void clear()
+    {
+        count = 0;
+    }
+
+    /**
+     * @return direct buffer holding size() packed records, used by the bindings
+     */
+    public ByteBuffer getBuffer()
+    {
+        return buffer;
+    }
+
+    private void put(byte type, long value, byte quality, long time, long index)
+    {
+        if(index < 0 || index > MAX_INDEX) throw new IllegalArgumentException("Index out of range: " + index);
+        if((count + 1) * RECORD_SIZE > buffer.capacity()) grow();
+
+        int offset = count * RECORD_SIZE;
+        buffer.putLong(offset, value);
+        buffer.putLong(offset + 8, time);
+        buffer.putInt(offset + 16, (int) index);
+        buffer.put(offset + 20, type);
+        buffer.put(offset + 21, quality);
+        ++count;
+    }
+
+    private void grow()
+    {
+        ByteBuffer larger = allocate(2 * (buffer.capacity() / RECORD_SIZE));
+        ByteBuffer src = buffer.duplicate();
+        src.position(0);
+        src.limit(count * RECORD_SIZE);
+        larger.put(src);
+        larger.clear();
+        buffer = larger;
+    }
+
+    private static ByteBuffer allocate(int capacity)
+    {
+        return ByteBuffer.allocateDirect(capacity * RECORD_SIZE).order(ByteOrder.nativeOrder());
+    }
+}
@@ -29,5 +29,14 @@ public interface Outstation extends Stack {
      */
     DataObserver getDataObserver();
 
+    /**
+     * Load a batch of measurements into the outstation as a single transaction.
+     * This is equivalent to calling start(), update(...) for each measurement and end()
+     * on the DataObserver, but crosses into native code only once.
+     *
+     * @param batch measurements to load, the batch is not modified
+     */
+    void publish(MeasurementBatch batch);
+
 
 }
@@ -20,6 +20,8 @@ package com.automatak.dnp3.impl;
 
 import com.automatak.dnp3.*;
 
+import java.nio.ByteBuffer;
+
 class DataObserverImpl implements DataObserver {
 
     private final long nativeptr;
@@ -64,6 +66,11 @@ class DataObserverImpl implements DataObserver {
         this.native_end(nativeptr);
     }
 
+    public void update(MeasurementBatch batch)
+    {
+        if(batch.size() > 0) this.native_update_batch(nativeptr, batch.getBuffer(), batch.size());
+    }
+
     private native void native_start(long nativeptr);
     private native void native_update_bi(long nativeptr, boolean value, byte quality, long time, long index);
     private native void native_update_ai(long nativeptr, double value, byte quality, long time, long index);
@@ -71,4 +78,5 @@ class DataObserverImpl implements DataObserver {
     private native void native_update_bos(long nativeptr, boolean value, byte quality, long time, long index);
     private native void native_update_aos(long nativeptr, double value, byte quality, long time, long index);
     private native void native_end(long nativeptr);
+    private native void native_update_batch(long nativeptr, ByteBuffer buffer, int count);
 }
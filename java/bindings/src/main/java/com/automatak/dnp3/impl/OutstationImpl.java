@@ -19,12 +19,13 @@
 package com.automatak.dnp3.impl;
 
 import com.automatak.dnp3.DataObserver;
+import com.automatak.dnp3.MeasurementBatch;
 import com.automatak.dnp3.Outstation;
 
 class OutstationImpl extends StackBase implements Outstation {
 
     private long nativePointer;
-    private final DataObserver obs;
+    private final DataObserverImpl obs;
 
     public OutstationImpl(long nativePointer)
     {
@@ -39,6 +40,12 @@ class OutstationImpl extends StackBase implements Outstation {
         return obs;
     }
 
+    @Override
+    public void publish(MeasurementBatch batch)
+    {
+        obs.update(batch);
+    }
+
     @Override
     public void shutdown()
     {
@@ -0,0 +1,94 @@
+/**
+ * Copyright 2013 Automatak, LLC
+ *
+ * Licensed to Automatak, LLC (www.automatak.com) under one or more
+ * contributor license agreements. See the NOTICE file distributed with this
+ * work for additional information regarding copyright ownership. Automatak, LLC
+ * licenses this file to you under the Apache License Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0.html
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+package com.automatak.dnp3.impl;
+
+import com.automatak.dnp3.*;
+import com.automatak.dnp3.mock.SuccessCommandHandler;
+
+/**
+ * Compares the rate at which an outstation database can be loaded with
+ * per-point DataObserver updates versus a single MeasurementBatch publish.
+ *
+ * Run with the native library on java.library.path, optionally passing the
+ * number of points and the number of scans as arguments.
+ */
+public class DataObserverBenchmark {
+
+    public static void main(String[] args)
+    {
+        final int numPoints = (args.length > 0) ? Integer.parseInt(args[0]) : 30000;
+        final int numScans = (args.length > 1) ? Integer.parseInt(args[1]) : 100;
+
+        DNP3Manager manager = DNP3ManagerFactory.createManager(1);
+        try {
+            Channel channel = manager.addTCPServer("server", LogLevel.WARNING, 5000, "127.0.0.1", 20000);
+            OutstationStackConfig config = new OutstationStackConfig(new DatabaseConfig(0, numPoints, 0, 0, 0));
+            config.outstationConfig.maxAnalogEvents = numPoints;
+            Outstation outstation = channel.addOutstation("outstation", LogLevel.WARNING, SuccessCommandHandler.getInstance(), config);
+
+            DataObserver observer = outstation.getDataObserver();
+            MeasurementBatch batch = new MeasurementBatch(numPoints);
+
+            // warm up both paths so the JIT has compiled them before timing
+            perPoint(observer, numPoints, 10);
+            bulk(outstation, batch, numPoints, 10);
+
+            report("per-point", numPoints, numScans, perPoint(observer, numPoints, numScans));
+            report("bulk", numPoints, numScans, bulk(outstation, batch, numPoints, numScans));
+        }
+        finally {
+            manager.shutdown();
+        }
+    }
+
+    private static long perPoint(DataObserver observer, int numPoints, int numScans)
+    {
+        long start = System.nanoTime();
+        for(int scan = 0; scan < numScans; ++scan) {
+            long time = System.currentTimeMillis();
+            observer.start();
+            for(int i = 0; i < numPoints; ++i) {
+                observer.update(new AnalogInput(scan + i, (byte) 0x01, time), i);
+            }
+            observer.end();
+        }
+        return System.nanoTime() - start;
+    }
+
+    private static long bulk(Outstation outstation, MeasurementBatch batch, int numPoints, int numScans)
+    {
+        long start = System.nanoTime();
+        for(int scan = 0; scan < numScans; ++scan) {
+            long time = System.currentTimeMillis();
+            batch.clear();
+            for(int i = 0; i < numPoints; ++i) {
+                batch.addAnalogInput(scan + i, (byte) 0x01, time, i);
+            }
+            outstation.publish(batch);
+        }
+        return System.nanoTime() - start;
+    }
+
+    private static void report(String name, int numPoints, int numScans, long nanos)
+    {
+        double seconds = nanos / 1e9;
+        long points = (long) numPoints * numScans;
+        System.out.println(String.format("%s: %d points in %.3f sec, %.0f points/sec", name, points, seconds, points / seconds));
+    }
+}
@@ -117,6 +117,34 @@ class DNP3ManagerTestSuite extends FunSuite with ShouldMatchers {
     }
   }
 
+  test("Can publish a measurement batch to an outstation") {
+    fixture { mgr =>
+      val outstation = createOutstation(createServer(mgr))
+      val batch = new MeasurementBatch(1)
+      batch.add(new BinaryInput(true, 0x01.toByte, 0), 0)
+      batch.add(new AnalogInput(42, 0x01.toByte, 0), 1)
+      batch.add(new Counter(7, 0x01.toByte, 0), 2)
+      batch.add(new BinaryOutputStatus(false, 0x01.toByte, 0), 3)
+      batch.add(new AnalogOutputStatus(3.14, 0x01.toByte, 0), 4)
+      batch.size should equal(5)
+      outstation.publish(batch)
+      batch.clear()
+      batch.size should equal(0)
+    }
+  }
+
+  test("Publishing a batch record with an unknown type throws") {
+    fixture { mgr =>
+      val outstation = createOutstation(createServer(mgr))
+      val batch = new MeasurementBatch(1)
+      batch.add(new AnalogInput(42, 0x01.toByte, 0), 1)
+      batch.getBuffer.put(20, 99.toByte) // type byte of the first record
+      intercept[IllegalArgumentException] {
+        outstation.publish(batch)
+      }
+    }
+  }
+
   test("Can add vto routers and automatically shutdown") {
     fixture { mgr =>
       createClientEndpoint(createOutstation(createServer(mgr)))
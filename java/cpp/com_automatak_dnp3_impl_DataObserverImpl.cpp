@@ -20,6 +20,9 @@
 
 #include <opendnp3/IDataObserver.h>
 
+#include <stdint.h>
+#include <string.h>
+
 using namespace opendnp3;
 
 JNIEXPORT void JNICALL Java_com_automatak_dnp3_impl_DataObserverImpl_native_1start
@@ -81,3 +84,88 @@ JNIEXPORT void JNICALL Java_com_automatak_dnp3_impl_DataObserverImpl_native_1end
 	pObs->End();
 }
 
+// record layout and type codes must match com.automatak.dnp3.MeasurementBatch
+enum BatchTypes {
+	BT_BINARY_INPUT = 0,
+	BT_ANALOG_INPUT = 1,
+	BT_COUNTER = 2,
+	BT_BINARY_OUTPUT_STATUS = 3,
+	BT_ANALOG_OUTPUT_STATUS = 4
+};
+
+const size_t BATCH_RECORD_SIZE = 24;
+
+template <class T>
+T ReadField(const uint8_t* apRecord, size_t aOffset)
+{
+	T value;
+	memcpy(&value, apRecord + aOffset, sizeof(T));
+	return value;
+}
+
+void ThrowIllegalArgument(JNIEnv* apEnv, const char* apMessage)
+{
+	jclass exClass = apEnv->FindClass("java/lang/IllegalArgumentException");
+	apEnv->ThrowNew(exClass, apMessage);
+}
+
+JNIEXPORT void JNICALL Java_com_automatak_dnp3_impl_DataObserverImpl_native_1update_1batch
+(JNIEnv* apEnv, jobject, jlong observer, jobject buffer, jint count)
+{
+	auto pObs = (IDataObserver*) observer;
+	auto pBuffer = static_cast<const uint8_t*>(apEnv->GetDirectBufferAddress(buffer));
+	if(pBuffer == NULL) {
+		ThrowIllegalArgument(apEnv, "Measurement batch is not a direct buffer");
+		return;
+	}
+	if(count < 0 || static_cast<jlong>(count) * BATCH_RECORD_SIZE > apEnv->GetDirectBufferCapacity(buffer)) {
+		ThrowIllegalArgument(apEnv, "Measurement batch count exceeds the buffer capacity");
+		return;
+	}
+
+	Transaction t(pObs);
+	for(jint i = 0; i < count; ++i) {
+		const uint8_t* pRecord = pBuffer + i * BATCH_RECORD_SIZE;
+		int64_t value = ReadField<int64_t>(pRecord, 0);
+		int64_t time = ReadField<int64_t>(pRecord, 8);
+		size_t index = ReadField<uint32_t>(pRecord, 16);
+		uint8_t quality = pRecord[21];
+
+		switch(pRecord[20]) {
+		case(BT_BINARY_INPUT): {
+				Binary meas(value != 0, quality);
+				meas.SetTime(time);
+				pObs->Update(meas, index);
+				break;
+			}
+		case(BT_ANALOG_INPUT): {
+				Analog meas(ReadField<double>(pRecord, 0), quality);
+				meas.SetTime(time);
+				pObs->Update(meas, index);
+				break;
+			}
+		case(BT_COUNTER): {
+				Counter meas(static_cast<uint32_t>(value), quality);
+				meas.SetTime(time);
+				pObs->Update(meas, index);
+				break;
+			}
+		case(BT_BINARY_OUTPUT_STATUS): {
+				ControlStatus meas(value != 0, quality);
+				meas.SetTime(time);
+				pObs->Update(meas, index);
+				break;
+			}
+		case(BT_ANALOG_OUTPUT_STATUS): {
+				SetpointStatus meas(ReadField<double>(pRecord, 0), quality);
+				meas.SetTime(time);
+				pObs->Update(meas, index);
+				break;
+			}
+		default:
+			// the records before this one are already applied, the transaction still ends cleanly
+			ThrowIllegalArgument(apEnv, "Measurement batch record has an unknown type");
+			return;
+		}
+	}
+}
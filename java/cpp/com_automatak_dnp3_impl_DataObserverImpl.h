@@ -63,6 +63,14 @@ JNIEXPORT void JNICALL Java_com_automatak_dnp3_impl_DataObserverImpl_native_1upd
 JNIEXPORT void JNICALL Java_com_automatak_dnp3_impl_DataObserverImpl_native_1end
   (JNIEnv *, jobject, jlong);
 
+/*
+ * Class:     com_automatak_dnp3_impl_DataObserverImpl
+ * Method:    native_update_batch
+ * Signature: (JLjava/nio/ByteBuffer;I)V
+ */
+JNIEXPORT void JNICALL Java_com_automatak_dnp3_impl_DataObserverImpl_native_1update_1batch
+  (JNIEnv *, jobject, jlong, jobject, jint);
+
 #ifdef __cplusplus
 }
 #endif